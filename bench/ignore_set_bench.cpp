@@ -0,0 +1,84 @@
+// Compares the compiled .catalystignore matcher against the per-pattern std::regex loop it replaced.
+// Build and run with: catalyst build -p bench && ./build/bench/catalyst_bench
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <print>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/ignore/ignore_set.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// A realistic mix: literals, prefixes, suffixes and a couple of genuine wildcards.
+const std::vector<std::string> patterns = {
+    "catalyst.cpp", "main_win32.cpp", "legacy_.*", ".*_benchmark.cpp", ".*_win32.cpp", ".*_test.cpp",
+    "test_.*.cpp",  "third_party",    "gen_.*_impl.cpp", "experimental", ".*\\.pb\\.cc", "scratch.*\\.c",
+};
+
+std::vector<std::string> makeSubjects(std::size_t count) {
+    const std::vector<std::string> stems = {"parser", "lexer", "writer", "config", "hooks", "dispatch", "walk"};
+    const std::vector<std::string> suffixes = {".cpp", "_test.cpp", "_win32.cpp", "_linux.cpp", ".pb.cc", ".c"};
+    std::vector<std::string> subjects;
+    subjects.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        subjects.push_back(std::format("{}{}{}", stems[i % stems.size()], i / 64, suffixes[i % suffixes.size()]));
+    return subjects;
+}
+
+/// `fn` runs `rounds` passes over `paths` subjects and returns how many were ignored in total.
+template <typename Fn> void report(const char *name, std::size_t paths, std::size_t rounds, Fn &&fn) {
+    const auto start = Clock::now();
+    const std::size_t ignored = fn();
+    const double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    const double matches = static_cast<double>(paths * rounds);
+    std::println("{:<12} {:>8.1f} ns/path {:>12.0f} paths/s  ({} of {} ignored)",
+                 name,
+                 elapsed / matches,
+                 matches * 1e9 / elapsed,
+                 ignored / rounds,
+                 paths);
+}
+} // namespace
+
+int main() {
+    constexpr std::size_t paths = 20'000;
+    constexpr std::size_t rounds = 25;
+    const auto subjects = makeSubjects(paths);
+
+    std::vector<std::regex> regexes;
+    for (const auto &pattern : patterns)
+        regexes.emplace_back(pattern);
+    auto ignore_set = catalyst::utils::ignore::IgnoreSet::compile(patterns);
+    if (!ignore_set) {
+        std::println(stderr, "{}", ignore_set.error());
+        return 1;
+    }
+
+    std::println("{} patterns, {} paths x {} rounds", patterns.size(), paths, rounds);
+    report("std::regex", paths, rounds, [&] {
+        std::size_t ignored = 0;
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (const auto &subject : subjects) {
+                for (const auto &regex : regexes) {
+                    if (std::regex_match(subject, regex)) {
+                        ++ignored;
+                        break;
+                    }
+                }
+            }
+        }
+        return ignored;
+    });
+    report("IgnoreSet", paths, rounds, [&] {
+        std::size_t ignored = 0;
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (const auto &subject : subjects)
+                ignored += ignore_set->matches(subject, false);
+        }
+        return ignored;
+    });
+}
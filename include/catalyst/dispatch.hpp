@@ -3,17 +3,21 @@
 #include "catalyst/globals.hpp"
 #include "catalyst/subcommands/add.hpp"
 #include "catalyst/subcommands/build.hpp"
+#include "catalyst/subcommands/cache.hpp"
 #include "catalyst/subcommands/clean.hpp"
+#include "catalyst/subcommands/config.hpp"
 #include "catalyst/subcommands/download.hpp"
 #include "catalyst/subcommands/fetch.hpp"
 #include "catalyst/subcommands/fmt.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/subcommands/hot_headers.hpp"
 #include "catalyst/subcommands/ide_sync.hpp"
 #include "catalyst/subcommands/init.hpp"
 #include "catalyst/subcommands/install.hpp"
 #include "catalyst/subcommands/run.hpp"
 #include "catalyst/subcommands/test.hpp"
 #include "catalyst/subcommands/tidy.hpp"
+#include "catalyst/subcommands/why_rebuild.hpp"
 #include "catalyst/workspace.hpp"
 
 namespace catalyst {
@@ -29,9 +33,15 @@ struct CliContext {
     CLI::App *build_subc{nullptr};
     std::unique_ptr<catalyst::build::Parse> build_res{nullptr};
 
+    CLI::App *cache_subc{nullptr};
+    std::unique_ptr<catalyst::cache::Parse> cache_res{nullptr};
+
     CLI::App *clean_subc{nullptr};
     std::unique_ptr<catalyst::clean::Parse> clean_res{nullptr};
 
+    CLI::App *config_subc{nullptr};
+    std::unique_ptr<catalyst::config::Parse> config_res{nullptr};
+
     CLI::App *download_subc{nullptr};
     std::unique_ptr<catalyst::download::Parse> download_res{nullptr};
 
@@ -44,6 +54,9 @@ struct CliContext {
     CLI::App *generate_subc{nullptr};
     std::unique_ptr<catalyst::generate::Parse> generate_res{nullptr};
 
+    CLI::App *hot_headers_subc{nullptr};
+    std::unique_ptr<catalyst::hot_headers::Parse> hot_headers_res{nullptr};
+
     CLI::App *ide_sync_subc{nullptr};
     std::unique_ptr<catalyst::ide_sync::Parse> ide_sync_res{nullptr};
 
@@ -62,6 +75,9 @@ struct CliContext {
     CLI::App *tidy_subc{nullptr};
     std::unique_ptr<catalyst::tidy::Parse> tidy_res{nullptr};
 
+    CLI::App *why_rebuild_subc{nullptr};
+    std::unique_ptr<catalyst::why_rebuild::Parse> why_rebuild_res{nullptr};
+
     CLI::App *add_git_subc{nullptr};
     std::unique_ptr<catalyst::add::git::Parse> add_git_res{nullptr};
 
@@ -73,6 +89,15 @@ struct CliContext {
 
     CLI::App *add_vcpkg_subc{nullptr};
     std::unique_ptr<catalyst::add::vcpkg::Parse> add_vcpkg_res{nullptr};
+
+    CLI::App *cache_stats_subc{nullptr};
+    std::unique_ptr<catalyst::cache::stats::Parse> cache_stats_res{nullptr};
+
+    CLI::App *cache_serve_subc{nullptr};
+    std::unique_ptr<catalyst::cache::serve::Parse> cache_serve_res{nullptr};
+
+    CLI::App *config_explain_subc{nullptr};
+    std::unique_ptr<catalyst::config::explain::Parse> config_explain_res{nullptr};
 };
 
 std::pair<int, bool> parseCli(int argc, char **argv, catalyst::CliContext &ctx);
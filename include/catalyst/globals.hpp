@@ -5,6 +5,9 @@
 
 namespace catalyst {
 #ifdef CATALYST_BUILD_SYS
+#if __has_include("catalyst_config.h")
+#include "catalyst_config.h"
+#endif
 constexpr std::string CATALYST_VERSION = TOSTRING(CATALYST_PROJ_VER);
 #else
 constexpr std::string CATALYST_VERSION = "0.0.2-dev";
@@ -5,15 +5,7 @@
 
 #include "catalyst/utils/yaml/configuration.hpp"
 
-#include "yaml-cpp/node/node.h"
-
 namespace catalyst::hooks {
-std::expected<void, std::string> preClean(const YAML::Node &profile_comp);
-std::expected<void, std::string> postClean(const YAML::Node &profile_comp);
-std::expected<void, std::string> preRun(const YAML::Node &profile_comp);
-std::expected<void, std::string> postRun(const YAML::Node &profile_comp);
-std::expected<void, std::string> preTest(const YAML::Node &profile_comp);
-std::expected<void, std::string> postTest(const YAML::Node &profile_comp);
 
 std::expected<void, std::string> preBuild(const utils::yaml::Configuration &profile_comp);
 std::expected<void, std::string> postBuild(const utils::yaml::Configuration &profile_comp);
@@ -1,10 +1,15 @@
 #pragma once
+#include <cstdint>
 #include <expected>
+#include <filesystem>
 #include <string>
 #include <vector>
 
 #include <CLI/App.hpp>
 
+#include "catalyst/utils/exec/executor.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 #include "catalyst/workspace.hpp"
 
 namespace catalyst::build {
@@ -17,9 +22,61 @@ struct Parse {
     std::vector<std::string> profiles;
     std::vector<std::string> enabled_features;
     std::string backend;
+    unsigned jobs = 0; ///< `-j`; 0: from the profile, else the backend's default
+    double load = 0;   ///< `-l`; 0: from the profile, else no cap
+    bool timings;      ///< write a timeline of the build to `<build>/timings`
+    bool watch;
+    std::string watch_then; ///< "test", "run" or empty
     std::optional<Workspace> workspace;
 };
 
 std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app);
 std::expected<void, std::string> action(const Parse &);
+
+/// Build once, then rebuild on every change below the source and include dirs until interrupted.
+/// The composed profiles, the source set and the include digest stay in memory; the build file is only regenerated
+/// when the source set, an include or import, or a profile file changes, and other edits go straight to the backend.
+std::expected<void, std::string> watch(const Parse &parse_args);
+
+/// `manifest.build.cache`.
+struct CacheSettings {
+    bool enabled = false;
+    std::filesystem::path dir;
+    std::uint64_t max_bytes = 0;
+    std::string remote_url;       ///< empty: no remote cache
+    bool remote_writable = false; ///< `mode: write`: upload what is built
+};
+std::expected<CacheSettings, std::string> cacheSettings(const utils::yaml::Configuration &config);
+
+/// `manifest.build.parallel`, with `-j` and `-l` taking precedence.
+struct ParallelSettings {
+    unsigned jobs = 0;            ///< commands at once; 0: the backend's default
+    double load = 0;              ///< no new command while the load average is above this; 0: no cap
+    unsigned memory_percent = 75; ///< native: share of RAM that running commands may be expected to use; 0: no cap
+};
+std::expected<ParallelSettings, std::string> parallelSettings(const utils::yaml::Configuration &config,
+                                                              const Parse &parse_args);
+
+/// Where the backend runs, and what it builds there: a config of a `manifest.build.configs` build graph lives in a
+/// directory below the build file it shares with the others, and is built by its name.
+struct BackendTarget {
+    std::filesystem::path dir;
+    std::string target; ///< empty: the build file's default
+};
+BackendTarget backendTarget(const std::string &generator,
+                            const std::vector<std::string> &profiles,
+                            const utils::yaml::Configuration &config);
+
+/// The command line that runs `generator` in `build_dir` with `settings`' `-j` and `-l`, building `target` if given.
+std::vector<std::string> backendCommand(const std::string &generator,
+                                        const std::filesystem::path &build_dir,
+                                        const ParallelSettings &settings,
+                                        const std::string &target = "");
+
+/// Run the native backend's graph, sharing compile, archive and link outputs through the object cache if
+/// `manifest.build.cache` enables it.
+std::expected<utils::exec::ExecuteSummary, std::string> executeNative(const utils::exec::Graph &graph,
+                                                                      const std::filesystem::path &build_dir,
+                                                                      const utils::yaml::Configuration &config,
+                                                                      const ParallelSettings &parallel);
 } // namespace catalyst::build
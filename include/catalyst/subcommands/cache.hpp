@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include <CLI/App.hpp>
+
+namespace catalyst::cache {
+struct Parse {};
+
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app);
+
+namespace stats {
+struct Parse {
+    std::vector<std::string> profiles{"common"};
+};
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &cache);
+std::expected<void, std::string> action(const Parse &parse_args);
+} // namespace stats
+
+namespace serve {
+struct Parse {
+    std::string dir; ///< empty: `<user cache dir>/remote`
+    std::string bind{"127.0.0.1"};
+    std::uint16_t port{8080};
+};
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &cache);
+std::expected<void, std::string> action(const Parse &parse_args);
+} // namespace serve
+} // namespace catalyst::cache
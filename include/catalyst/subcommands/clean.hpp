@@ -9,7 +9,7 @@
 
 namespace catalyst::clean {
 struct Parse {
-    std::vector<std::string> profiles{"common"};
+    std::vector<std::string> profiles; ///< empty: the last build, else common
     std::optional<Workspace> workspace;
 };
 
@@ -0,0 +1,21 @@
+#pragma once
+#include <expected>
+#include <string>
+#include <vector>
+
+#include <CLI/App.hpp>
+
+namespace catalyst::config {
+struct Parse {};
+
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app);
+
+namespace explain {
+struct Parse {
+    std::string key; ///< a dotted path; a section explains every key under it
+    std::vector<std::string> profiles{"common"};
+};
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &config);
+std::expected<void, std::string> action(const Parse &parse_args);
+} // namespace explain
+} // namespace catalyst::config
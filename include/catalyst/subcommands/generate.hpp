@@ -1,41 +1,183 @@
 #pragma once
+#include <cstdint>
 #include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
 #include <ostream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <CLI/App.hpp>
 #include <yaml-cpp/yaml.h>
 
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+#include "catalyst/utils/fs/scan_cache.hpp"
+#include "catalyst/utils/includes/scanner.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
 namespace catalyst::generate {
 struct Parse {
     std::vector<std::string> profiles;
     std::vector<std::string> enabled_features;
     std::string backend;
+    bool force{false};
+    /// `native` backend: receives the build graph, which is then always generated since there is no build file to
+    /// reuse. Without it, a native generation only validates the project.
+    utils::exec::Graph *graph{nullptr};
 };
 
 struct FindRes {
     std::string lib_path;
     std::string inc_path;
     std::string libs;
+    std::string build_dir{}; ///< absolute; set for dependencies Catalyst builds, whose modules.json lives there
+};
+
+struct DepCacheEntry {
+    std::string stamp;
+    FindRes res;
+};
+
+/// Inputs of the last successful generation, persisted in the build directory so that an
+/// unchanged project can skip regeneration and a partially changed one can reuse dependency lookups.
+struct GenerateState {
+    std::string fingerprint;
+    std::string durations; ///< durationsDigest() of the bucketed ninja durations the build file's edges are ordered by
+    std::unordered_map<std::string, DepCacheEntry> deps; // keyed by depKey()
 };
 
-std::expected<YAML::Node, std::string> profileComposition(const std::vector<std::string> &profiles);
 std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app);
 std::expected<void, std::string> action(const Parse &);
 
-std::expected<std::string, std::string> libPath(const YAML::Node &profile);
+std::expected<std::string, std::string> libPath(const utils::yaml::Configuration &config,
+                                                const std::filesystem::path &build_dir);
 std::expected<FindRes, std::string> findDep(const std::string &build_dir, const YAML::Node &dep);
 std::expected<FindRes, std::string> findLocal(const YAML::Node &dep);
 std::expected<FindRes, std::string> findSystem(const YAML::Node &dep);
 std::expected<FindRes, std::string> findVcpkg(const YAML::Node &dep);
 std::expected<FindRes, std::string> findGit(const std::string &build_dir, const YAML::Node &dep);
 
-std::expected<std::unordered_set<std::filesystem::path>, std::string>
-buildSourceSet(const std::vector<std::string> &source_dirs, const std::vector<std::string> &profiles);
+/// Sorted, deduplicated list of the sources below `source_dirs`, after applying .catalystignore for `profiles`.
+/// With a `scan_cache`, only directories changed since the cached scan are re-listed; the caller saves it.
+std::expected<std::vector<std::filesystem::path>, std::string>
+buildSourceSet(const std::vector<std::string> &source_dirs,
+               const std::vector<std::string> &profiles,
+               utils::fs::ScanCache *scan_cache = nullptr);
+
+std::filesystem::path generateStatePath(const std::filesystem::path &build_dir);
+GenerateState loadGenerateState(const std::filesystem::path &state_path);
+std::expected<void, std::string> saveGenerateState(const std::filesystem::path &state_path, const GenerateState &state);
+std::string depKey(const YAML::Node &dep);
+std::string depStamp(const std::string &build_dir, const YAML::Node &dep);
+std::string inputFingerprint(const utils::yaml::Configuration &config,
+                             const std::vector<std::string> &enabled_features,
+                             const std::string &generator,
+                             const std::vector<std::string> &source_dirs,
+                             const std::vector<std::filesystem::path> &sources,
+                             std::string_view include_digest,
+                             const std::vector<std::string> &dep_stamps);
+
+/// The object file `source` compiles to, relative to the build directory.
+std::string objectPath(const std::filesystem::path &source);
+
+/// `manifest.build.unity`: compile C++ sources in batches of generated translation units that #include them.
+struct UnityOptions {
+    bool enabled = false;
+    std::uint64_t batch_bytes = 256 * 1024; ///< target amount of source per batch
+    std::vector<std::string> exclude;       ///< .catalystignore-style patterns for files that must compile alone
+};
+
+struct UnityBatch {
+    std::filesystem::path unity_file; ///< the generated TU
+    std::vector<std::filesystem::path> members;
+};
+
+std::expected<UnityOptions, std::string> unityOptions(const utils::yaml::Configuration &config);
+/// Group `sources` into size-balanced batches. Boundaries are chosen by content-defined chunking over the sorted
+/// sources, so adding or removing a file only reshapes the batches around it. Files left out of every batch
+/// (C sources, excluded files, singletons) compile on their own.
+std::expected<std::vector<UnityBatch>, std::string> planUnityBatches(const std::vector<std::filesystem::path> &sources,
+                                                                     const UnityOptions &options,
+                                                                     const std::filesystem::path &unity_dir);
+/// Write the batches' TUs into `unity_dir`, touching only changed ones, and delete stale ones.
+std::expected<void, std::string> writeUnitySources(const std::vector<UnityBatch> &batches,
+                                                   const std::filesystem::path &unity_dir);
+
+/// `manifest.build.pch`: precompile a header and force-include it into the C++ compiles that use it: every one for a
+/// named header, those that include all of its headers for `auto`.
+struct PchOptions {
+    std::string header;               ///< empty: off; `auto`: chosen from include statistics; else a project file
+    std::size_t max_headers = 32;     ///< `auto`: at most this many headers
+    int min_percent = 50;             ///< `auto`: only headers all included by at least this share of C++ sources
+    std::vector<std::string> exclude; ///< `auto`: .catalystignore-style patterns for headers to leave out
+};
+
+struct Pch {
+    std::filesystem::path header;          ///< the generated header, absolute
+    std::string output;                    ///< the precompiled header, relative to the build directory
+    std::vector<std::string> deps;         ///< project headers the PCH reads
+    std::unordered_set<std::string> users; ///< the C++ sources compiled with it, as in the source set
+};
+
+std::expected<PchOptions, std::string> pchOptions(const utils::yaml::Configuration &config);
+/// Decide what goes into the PCH and write its header to `<build>/pch/`. Empty if PCH is off or `auto` found
+/// nothing worth precompiling. `cxx` picks the output format: clang's `.pch` or GCC's `.gch`.
+std::expected<std::optional<Pch>, std::string> preparePch(const PchOptions &options,
+                                                          const std::vector<std::filesystem::path> &sources,
+                                                          const utils::includes::IncludeGraph &include_graph,
+                                                          const std::filesystem::path &build_dir,
+                                                          std::string_view cxx);
+
+/// `manifest.build.time_trace`: compile with clang's `-ftime-trace` and sum the traces up after every build.
+struct TimeTraceOptions {
+    bool enabled = false;
+    std::size_t top = 30; ///< rows per table of the report
+};
+/// Fails when tracing is enabled and `CC` or `CXX` is not clang.
+std::expected<TimeTraceOptions, std::string> timeTraceOptions(const utils::yaml::Configuration &config);
+
+/// `manifest.build.config_header`: how the project's name, version and feature flags reach its code.
+struct ConfigHeaderOptions {
+    bool defines = false; ///< `mode: defines`: as `-D` flags on every compile, so that any change rebuilds everything
+    bool split = false;   ///< a header per feature, `catalyst_config/<feature>.h`, instead of all in one
+};
+std::expected<ConfigHeaderOptions, std::string> configHeaderOptions(const utils::yaml::Configuration &config);
+/// Write `<build>/include/catalyst_config.h`, and with `split` the feature headers, touching only changed files.
+/// Returns the compile flags to add: the include directory, or the `-D` flags themselves with `defines`.
+std::expected<std::string, std::string> prepareConfigHeader(const ConfigHeaderOptions &options,
+                                                            const utils::yaml::Configuration &config,
+                                                            const std::vector<std::string> &enabled_features,
+                                                            const std::filesystem::path &build_dir);
+
+/// How the project's C++20 named modules, those of its dependencies and the standard library's are built and found.
+struct ModulePlan {
+    std::unordered_map<std::string, std::filesystem::path> providers; ///< project module -> the unit declaring it
+    std::unordered_map<std::string, std::string> prebuilt; ///< dependency or standard module -> its BMI, absolute
+    std::vector<std::string> link_objects;                 ///< objects of the prebuilt standard modules
+    std::string flags;           ///< `moduleflags`: lets every C++ compile find the BMIs
+    std::string interface_flags; ///< `moduleinterfaceflags`: compiles a unit as an interface and emits its BMI
+
+    bool empty() const {
+        return providers.empty() && prebuilt.empty();
+    }
+};
+
+/// Map every imported module to a project unit, a dependency's BMI (from its `<build>/modules.json`) or a
+/// standard library module, which is prebuilt once per toolchain and flag set in the user's cache directory.
+/// Writes `<build>/modules.json` for dependents and, for GCC, the module mapper. Fails on unknown imports, modules
+/// declared twice and import cycles.
+std::expected<ModulePlan, std::string> prepareModules(const std::vector<std::filesystem::path> &sources,
+                                                      const utils::includes::IncludeGraph &include_graph,
+                                                      const std::vector<FindRes> &dep_results,
+                                                      const std::filesystem::path &build_dir,
+                                                      std::string_view cxx,
+                                                      std::string_view cxxflags);
 
 namespace buildwriters {
 
@@ -77,7 +219,14 @@ public:
                                                      std::string_view command,
                                                      std::string_view description,
                                                      std::string_view depfile = "",
-                                                     std::string_view deps = "") = 0;
+                                                     std::string_view deps = "",
+                                                     // re-check the outputs' mtimes after the command, so a command
+                                                     // that leaves an output untouched does not dirty its dependents
+                                                     bool restat = false,
+                                                     // a pool from addPool that limits the rule's parallelism
+                                                     std::string_view pool = "") = 0;
+    /// At most `depth` commands of the rules in pool `name` run at once. Backends without pools ignore it.
+    virtual std::expected<void, std::string> addPool(std::string_view name, unsigned depth) = 0;
     virtual std::expected<void, std::string> addBuild(const std::vector<std::string> &outputs,
                                                       std::string_view rule,
                                                       const std::vector<std::string> &inputs,
@@ -151,7 +300,14 @@ public:
                                              [[maybe_unused]] std::string_view command,
                                              [[maybe_unused]] std::string_view description,
                                              [[maybe_unused]] std::string_view depfile = "",
-                                             [[maybe_unused]] std::string_view deps = "") override {
+                                             [[maybe_unused]] std::string_view deps = "",
+                                             [[maybe_unused]] bool restat = false,
+                                             [[maybe_unused]] std::string_view pool = "") override {
+        throw std::logic_error("Unimplemented base template method");
+    }
+
+    std::expected<void, std::string> addPool([[maybe_unused]] std::string_view name,
+                                             [[maybe_unused]] unsigned depth) override {
         throw std::logic_error("Unimplemented base template method");
     }
 
@@ -171,5 +327,103 @@ public:
         throw std::logic_error("Unimplemented base template method");
     }
 };
+
+/// Records the build into an in-memory graph for the native executor instead of writing a build file.
+class GraphWriter final : public BaseWriter {
+public:
+    explicit GraphWriter(utils::exec::Graph &graph);
+
+    std::expected<void, std::string> addVariable(std::string_view name, std::string_view value) override;
+    std::expected<void, std::string> addRule(std::string_view name,
+                                             std::string_view command,
+                                             std::string_view description,
+                                             std::string_view depfile = "",
+                                             std::string_view deps = "",
+                                             bool restat = false,
+                                             std::string_view pool = "") override;
+    std::expected<void, std::string> addPool(std::string_view name, unsigned depth) override;
+    std::expected<void, std::string> addBuild(const std::vector<std::string> &outputs,
+                                              std::string_view rule,
+                                              const std::vector<std::string> &inputs,
+                                              const std::vector<std::string> &implicit_deps = {}) override;
+    void addComment(std::string_view comment) override;
+    void addDefault(std::string_view target) override;
+
+private:
+    utils::exec::Graph &graph;
+};
+
+/// Holds the build back and passes it to `target` on `flush`, with every run of consecutive `build` statements
+/// sorted by their longest path to the end of the build by `durations`. Ninja releases, before 1.12, start ready
+/// edges in the order the file lists them, so the long-pole compiles start first instead of wherever they sort.
+class CriticalPathWriter final : public BaseWriter {
+public:
+    CriticalPathWriter(BaseWriter &target, utils::exec::Durations durations);
+
+    std::expected<void, std::string> addVariable(std::string_view name, std::string_view value) override;
+    std::expected<void, std::string> addRule(std::string_view name,
+                                             std::string_view command,
+                                             std::string_view description,
+                                             std::string_view depfile = "",
+                                             std::string_view deps = "",
+                                             bool restat = false,
+                                             std::string_view pool = "") override;
+    std::expected<void, std::string> addPool(std::string_view name, unsigned depth) override;
+    std::expected<void, std::string> addBuild(const std::vector<std::string> &outputs,
+                                              std::string_view rule,
+                                              const std::vector<std::string> &inputs,
+                                              const std::vector<std::string> &implicit_deps = {}) override;
+    void addComment(std::string_view comment) override;
+    void addDefault(std::string_view target) override;
+
+    std::expected<void, std::string> flush();
+
+private:
+    /// Either a deferred call on the target or, if empty, the next of `builds`.
+    using Step = std::function<std::expected<void, std::string>(BaseWriter &)>;
+
+    BaseWriter &target;
+    utils::exec::Durations durations;
+    std::vector<Step> steps;
+    std::vector<utils::exec::Edge> builds;
+};
+
+/// Writes one profile composition's build into a multi-config build file. Its variables and rules get the config's
+/// name as a suffix and the rules' commands refer to the renamed variables. Its outputs, which are relative to the
+/// build directory, get the config's directory as a prefix. Its default target becomes the phony target `name`. The
+/// link pool and the phony edges of headers are shared by the configs, so they are written once, by the first.
+class ConfigWriter final : public BaseWriter {
+public:
+    /// `written`: the pools and phony outputs that the configs written before this one wrote.
+    ConfigWriter(BaseWriter &target, std::string name, std::unordered_set<std::string> &written);
+
+    std::expected<void, std::string> addVariable(std::string_view name, std::string_view value) override;
+    std::expected<void, std::string> addRule(std::string_view name,
+                                             std::string_view command,
+                                             std::string_view description,
+                                             std::string_view depfile = "",
+                                             std::string_view deps = "",
+                                             bool restat = false,
+                                             std::string_view pool = "") override;
+    std::expected<void, std::string> addPool(std::string_view name, unsigned depth) override;
+    std::expected<void, std::string> addBuild(const std::vector<std::string> &outputs,
+                                              std::string_view rule,
+                                              const std::vector<std::string> &inputs,
+                                              const std::vector<std::string> &implicit_deps = {}) override;
+    void addComment(std::string_view comment) override;
+    void addDefault(std::string_view target) override;
+
+private:
+    std::string suffixed(std::string_view name) const;
+    std::string prefixed(const std::string &path) const;
+    std::vector<std::string> prefixed(const std::vector<std::string> &paths) const;
+    /// `command` with its references to this config's variables renamed.
+    std::string renamed(std::string_view command) const;
+
+    BaseWriter &target;
+    std::string name;
+    std::unordered_set<std::string> &written;
+    std::unordered_set<std::string> variables;
+};
 } // namespace buildwriters
 } // namespace catalyst::generate
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include <CLI/App.hpp>
+
+namespace catalyst::hot_headers {
+struct Parse {
+    std::vector<std::string> profiles{"common"};
+    std::string backend;              ///< empty: `meta.generator`
+    std::string since{"90 days ago"}; ///< edits are counted in `git log --since`
+    std::size_t top{20};
+};
+
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app);
+/// Rank headers by how many objects read them times how often they were edited: what a header costs in rebuilds.
+std::expected<void, std::string> action(const Parse &parse_args);
+} // namespace catalyst::hot_headers
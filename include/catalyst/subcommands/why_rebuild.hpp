@@ -0,0 +1,19 @@
+#pragma once
+#include <expected>
+#include <string>
+#include <vector>
+
+#include <CLI/App.hpp>
+
+namespace catalyst::why_rebuild {
+struct Parse {
+    std::string file;
+    std::vector<std::string> profiles{"common"};
+    std::string backend; ///< empty: `meta.generator`
+};
+
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app);
+/// List the objects that read `file` when they were last compiled, slowest first, with what recompiling them costs
+/// by their logged durations.
+std::expected<void, std::string> action(const Parse &parse_args);
+} // namespace catalyst::why_rebuild
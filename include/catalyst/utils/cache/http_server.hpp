@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+
+namespace catalyst::utils::cache {
+/// Serve `dir` as a remote cache over HTTP/1.1 on `bind:port` until the process is stopped. GET and HEAD read
+/// `/ac/<sha256>` and `/cas/<sha256>`; PUT writes them, checking CAS uploads against their digest. The layout is
+/// the one a `file://` remote uses, so the same directory can be served or mounted.
+///
+/// Meant for trying the remote cache offline and for small teams; there is no authentication and no eviction.
+std::expected<void, std::string> serveRemoteCache(const std::filesystem::path &dir, const std::string &bind,
+                                                  std::uint16_t port);
+} // namespace catalyst::utils::cache
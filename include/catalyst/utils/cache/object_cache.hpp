@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catalyst/utils/cache/remote_cache.hpp"
+
+namespace catalyst::utils::cache {
+/// Counters kept in the cache directory, shared by every process using it.
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t stores = 0;
+    std::uint64_t evictions = 0;
+    std::uint64_t bytes = 0;       ///< size of the stored results, as last counted
+    std::uint64_t remote_hits = 0; ///< hits downloaded from the remote cache, also counted in `hits`
+    std::uint64_t uploads = 0;     ///< results uploaded to the remote cache
+};
+
+/// A stored result whose recorded dependencies still hash as they did when it was stored.
+struct CacheHit {
+    std::filesystem::path dir;     ///< holds the outputs as `0`, `1`, ... in the order they were stored
+    std::vector<std::string> deps; ///< what the depfile listed when the result was stored
+};
+
+/// Content hash of a file, or nullopt if it cannot be read.
+using FileHasher = std::function<std::optional<std::uint64_t>(const std::string &path)>;
+
+/// Content-addressed cache of command outputs, ccache's direct mode without a preprocessor fallback.
+///
+/// A lookup key covers what is known before the command runs: the command line, the tool's identity and the
+/// contents of the declared inputs. Each key has a manifest listing the results stored under it, each with the
+/// dependencies its depfile reported and their content hashes. A result is a hit once every one of those
+/// dependencies still hashes the same, so a header edit misses without having to preprocess.
+///
+/// Results are written to a private temporary directory and renamed into place, and manifests and counters are
+/// updated under `flock`, so several processes can share a cache. Whole results are evicted, least recently used
+/// first, once the cache grows past its size cap.
+///
+/// With a remote, a local miss asks the remote for the key's manifest and downloads a matching result, and stored
+/// results are uploaded if the remote is writable. On the remote, a manifest is the action result of its key and a
+/// result is an action result listing its outputs' blobs in the CAS.
+class ObjectCache {
+public:
+    ObjectCache(std::filesystem::path dir, std::uint64_t max_bytes, RemoteCache *remote = nullptr);
+
+    std::optional<CacheHit> lookup(std::uint64_t key, const FileHasher &hash_file);
+    /// Place the hit's outputs at `outputs` by reflink, else hard link, else copy, and give them a fresh mtime.
+    /// Returns, per output, whether it is a hard link into the cache, whose mtime must not be set back.
+    std::expected<std::vector<bool>, std::string> materialize(const CacheHit &hit,
+                                                              const std::vector<std::filesystem::path> &outputs);
+    std::expected<void, std::string>
+    store(std::uint64_t key,
+          const std::vector<std::filesystem::path> &outputs,
+          const std::vector<std::string> &deps,
+          const FileHasher &hash_file);
+
+    /// Add this process's counters to the shared ones and evict if the cache is over its cap.
+    std::expected<void, std::string> flush();
+
+    const std::filesystem::path &directory() const {
+        return dir;
+    }
+
+    /// The shared counters of the cache in `dir`.
+    static std::expected<CacheStats, std::string> stats(const std::filesystem::path &dir);
+
+private:
+    std::optional<CacheHit> match(std::string_view manifest, const FileHasher &hash_file, std::string *matched);
+    bool download(std::uint64_t result_key);
+    void upload(std::uint64_t key, std::uint64_t result_key, std::size_t outputs, const std::string &line);
+    std::expected<void, std::string> addToManifest(std::uint64_t key, const std::string &line);
+    std::filesystem::path tmpPath();
+
+    std::filesystem::path dir;
+    std::uint64_t max_bytes;
+    RemoteCache *remote;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> stores{0};
+    std::atomic<std::uint64_t> stored_bytes{0};
+    std::atomic<std::uint64_t> remote_hits{0};
+    std::atomic<std::uint64_t> uploads{0};
+    std::atomic<std::uint64_t> tmp_counter{0};
+};
+
+/// `<user cache dir>/objects`, unless `CATALYST_CACHE_DIR` is set.
+std::filesystem::path defaultCacheDir();
+} // namespace catalyst::utils::cache
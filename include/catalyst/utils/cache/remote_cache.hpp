@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace catalyst::utils::cache {
+/// A shared cache server speaking Bazel's HTTP remote caching protocol: blobs live under `/cas/<sha256>` and action
+/// results under `/ac/<sha256>`, read with GET and written with PUT. HTTP goes through `curl`, so `https://` and
+/// credentials in `~/.netrc` work. A `file://` URL names a directory with the layout of `catalyst cache serve`
+/// instead, e.g. on a shared mount.
+///
+/// The first request that cannot reach the server turns the remote off for the rest of the process, so an offline
+/// laptop pays for one timeout and not one per command.
+class RemoteCache {
+public:
+    enum class Store { ac, cas };
+
+    RemoteCache(std::string url, bool writable);
+
+    /// Download an entry to `dest`. False if it is absent or the server is unreachable.
+    bool get(Store store, const std::string &hash, const std::filesystem::path &dest);
+    /// Upload `src` as an entry. False if the upload failed or the cache is read-only.
+    bool put(Store store, const std::string &hash, const std::filesystem::path &src);
+
+    bool writable() const {
+        return write;
+    }
+    const std::string &location() const {
+        return url;
+    }
+
+private:
+    bool reachable();
+    void markUnreachable(const std::string &reason);
+
+    std::string url; ///< without a trailing slash
+    bool write;
+    std::atomic<bool> unreachable{false};
+    std::atomic<unsigned> tmp_counter{0};
+};
+
+/// `<dir>/<store>/<first two hex digits>/<hash>`: where a `file://` remote and `catalyst cache serve` keep entries.
+std::filesystem::path remoteEntryPath(const std::filesystem::path &dir, RemoteCache::Store store,
+                                      const std::string &hash);
+/// Whether `hash` looks like a SHA-256 digest, as the protocol requires of every key.
+bool isSha256Hex(std::string_view hash);
+} // namespace catalyst::utils::cache
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace catalyst::utils::exec {
+/// What the native executor remembers about an output it built.
+struct LogEntry {
+    std::int64_t start_ms = 0; ///< since the start of the build that ran the command
+    std::int64_t end_ms = 0;
+    /// When the output counts as last modified: its mtime right after the command finished, even if the executor
+    /// then gave an unchanged output its old mtime back
+    std::int64_t mtime_ns = 0;
+    std::uint64_t command_hash = 0;
+    std::uint64_t content_hash = 0; ///< of the output, if anything depends on it; 0 if it was not hashed
+    std::uint64_t peak_rss_kb = 0;  ///< the command's peak memory, which schedules it next time; 0 if unknown
+};
+
+/// Headers and other files an output was found to read, from the depfile of the command that built it.
+struct DepsEntry {
+    std::int64_t mtime_ns = 0; ///< of the output when the deps were recorded; a mismatch makes them stale
+    std::vector<std::string> deps;
+};
+
+/// The native executor's persistent state: a log of the commands that built each output and a deps database
+/// filled from depfiles, kept in `<build>/.catalyst/native_log` and `native_deps`.
+///
+/// Both files are append-only while a build runs, so progress survives an interrupted build, and are compacted
+/// when opened if superseded records pile up. Lookups and records are thread safe.
+class BuildLog {
+public:
+    /// Loads the files in `state_dir` if they exist; missing, foreign or corrupt files start out empty.
+    explicit BuildLog(std::filesystem::path state_dir);
+
+    /// Compacts the files if needed and opens them for appending. Records are dropped until this succeeds.
+    std::expected<void, std::string> open();
+
+    std::optional<LogEntry> entry(const std::string &output) const;
+    std::optional<DepsEntry> deps(const std::string &output) const;
+    /// Every output in the log.
+    std::vector<std::string> outputs() const;
+
+    std::expected<void, std::string> record(const std::string &output, const LogEntry &entry);
+    std::expected<void, std::string> recordDeps(const std::string &output, DepsEntry deps);
+
+private:
+    std::filesystem::path state_dir;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, LogEntry> entries;
+    std::unordered_map<std::string, DepsEntry> deps_entries;
+    std::size_t log_records = 0; ///< records in the log file, superseded ones included
+    std::size_t deps_records = 0;
+    bool log_valid = false; ///< the file can be appended to as it is
+    bool deps_valid = false;
+    std::ofstream log_file;
+    std::ofstream deps_file;
+};
+
+/// Where the native executor keeps its state for a given build directory.
+std::filesystem::path buildLogDir(const std::filesystem::path &build_dir);
+} // namespace catalyst::utils::exec
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalyst/utils/exec/graph.hpp"
+
+namespace catalyst::utils::exec {
+/// How long each output last took to build, in milliseconds, keyed by the output's path as the build file spells it.
+using Durations = std::unordered_map<std::string, std::int64_t>;
+
+struct NinjaLogEntry {
+    std::int64_t start_ms = 0; ///< since the start of the ninja run that logged it
+    std::int64_t end_ms = 0;
+    std::string output;
+};
+
+/// The lines of `<build>/.ninja_log` from byte `offset` on, which must start a line; 0 reads them all. Empty if there
+/// is no log.
+std::vector<NinjaLogEntry> ninjaLogEntries(const std::filesystem::path &build_dir, std::uintmax_t offset = 0);
+
+/// The durations ninja recorded in `<build>/.ninja_log`; empty if there is none.
+Durations ninjaDurations(const std::filesystem::path &build_dir);
+
+/// The durations the native backend logged in `<build>/.catalyst/native_log`; empty if there is none.
+Durations nativeDurations(const std::filesystem::path &build_dir);
+
+/// The durations `generator` recorded: the native log or `.ninja_log`. Make and CBE record none.
+Durations recordedDurations(const std::filesystem::path &build_dir, const std::string &generator);
+
+/// `durations` rounded down to their two leading bits, e.g. 1000 ms to 768 ms. Timing noise between runs of the same
+/// command rarely moves a duration to another bucket; a command that became much slower or faster does.
+Durations bucketDurations(const Durations &durations);
+
+/// A digest of `durations` that does not depend on their order; empty if there are none.
+std::string durationsDigest(const Durations &durations);
+
+/// The `build` statements of a ninja file as catalyst writes it: no includes, no continued lines.
+std::expected<std::vector<Edge>, std::string> readNinjaEdges(const std::filesystem::path &build_file);
+
+/// For each edge, the longest chain of durations from its start to the end of the build, its own included.
+/// Starting ready edges in descending order of this starts the long poles first. An edge without a duration counts
+/// as the average of its rule's edges that have one, or 0.
+std::vector<std::int64_t> criticalPriorities(const std::vector<Edge> &edges, const Durations &durations);
+
+struct CriticalStep {
+    std::string output;
+    std::int64_t duration_ms = 0;
+};
+
+/// The chain of edges that bounds a full build's wall-clock time, first to last, by the logged durations. Edges
+/// without one count as instant.
+std::vector<CriticalStep> criticalPath(const std::vector<Edge> &edges, const Durations &durations);
+
+/// `Critical path: 12.3s`, then one line per step with its share of the total.
+std::string formatCriticalPath(const std::vector<CriticalStep> &path);
+} // namespace catalyst::utils::exec
@@ -0,0 +1,11 @@
+#pragma once
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace catalyst::utils::exec {
+/// The prerequisites listed in a Makefile-style depfile as written by `-MMD -MF`, in order and without duplicates.
+/// Handles line continuations, `\ ` and `$$` escapes and several rules in one file (their targets are dropped).
+std::expected<std::vector<std::string>, std::string> parseDepfile(std::string_view content);
+} // namespace catalyst::utils::exec
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace catalyst::utils::exec {
+/// Which objects read which files, by the deps the backend recorded when it last compiled each object. Files are
+/// keyed by their absolute, lexically normal path.
+class DepsIndex {
+public:
+    /// From where `generator` keeps the compiles' depfiles: the native deps database, `ninja -t deps`, or the `.d`
+    /// files that make and CBE leave in `<build>/obj`. Relative paths are taken against `build_dir`.
+    static std::expected<DepsIndex, std::string> load(const std::filesystem::path &build_dir,
+                                                      const std::string &generator);
+
+    /// `deps` as its depfile lists them: the source first, then everything it included.
+    void add(const std::string &object, const std::vector<std::string> &deps, const std::filesystem::path &build_dir);
+
+    /// The objects that read `file`, in no particular order; empty if none.
+    const std::vector<std::string> &readers(const std::filesystem::path &file) const;
+    /// Every file some object read, other than the sources compiled themselves.
+    std::vector<std::filesystem::path> headers() const;
+    std::size_t objects() const {
+        return object_count;
+    }
+
+private:
+    std::unordered_map<std::string, std::vector<std::string>> file_readers;
+    std::unordered_set<std::string> sources;
+    std::size_t object_count = 0;
+};
+} // namespace catalyst::utils::exec
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "catalyst/utils/cache/object_cache.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+
+namespace catalyst::utils::exec {
+struct ExecuteOptions {
+    std::filesystem::path build_dir;  ///< commands run here; relative paths in the graph are relative to it
+    unsigned jobs = 0;                ///< commands run at once; 0: one per hardware thread
+    std::vector<std::string> targets; ///< empty: the graph's defaults
+    cache::ObjectCache *cache = nullptr;             ///< holds the outputs of `cacheable_rules` edges
+    std::unordered_set<std::string> cacheable_rules; ///< rules whose outputs depend only on the command and its inputs
+    std::uint64_t memory_budget_kb = 0; ///< cap on the summed expected peak memory of running commands; 0: none
+    double max_load = 0;                ///< no new command while the load average is above this; 0: no cap
+};
+
+struct ExecuteSummary {
+    std::size_t ran = 0;
+    std::size_t up_to_date = 0;
+    std::vector<CriticalStep> critical_path; ///< of a full build, by the latest durations; empty if nothing ran
+};
+
+/// Bring `targets` up to date by running the out-of-date edges of `graph` on a thread pool. Ready edges start in
+/// order of their longest logged path to the end of the build, so the long poles are not left until last.
+///
+/// An edge is out of date if an output is missing, its command differs from the one in the build log, or an
+/// input, implicit dependency or header recorded from its last depfile is newer than its oldest output. This is
+/// re-checked right before the edge would run, once its inputs are built: an input whose command left it untouched
+/// (restat) does not rebuild what depends on it. Depfiles are moved into the deps database and removed.
+///
+/// With a cache, an out-of-date edge of a cacheable rule first looks its outputs up by the command, the tool's
+/// identity and the contents of its inputs, and stores them after it runs.
+///
+/// A command starts only if its rule's pool has room and, unless nothing else is running, if it fits the memory
+/// budget and the load is below `max_load`. Each command's peak RSS is logged and is what it is expected to need
+/// next time; a command never seen before is expected to need the average of its rule's logged commands.
+///
+/// Each command's output is printed in one piece under a `[finished/total]` status line. The first failure stops
+/// new commands from starting; running ones are waited for.
+std::expected<ExecuteSummary, std::string> execute(const Graph &graph, const ExecuteOptions &options);
+} // namespace catalyst::utils::exec
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace catalyst::utils::exec {
+struct Rule {
+    std::string command;     ///< in ninja syntax: `$var`, `${var}`, `$in`, `$out`, `$$`
+    std::string description; ///< same syntax; shown instead of the command
+    std::string depfile;     ///< same syntax; a Makefile-style depfile the command writes, if any
+    std::string pool;        ///< caps how many of the rule's commands run at once; see Graph::addPool
+};
+
+struct Edge {
+    std::vector<std::string> outputs;
+    std::string rule; ///< `phony` edges have no command and complete as soon as their inputs do
+    std::vector<std::string> inputs;
+    std::vector<std::string> implicit_deps;
+};
+
+/// A build graph as the generator describes it, held in memory for the native executor.
+/// Relative paths are relative to the build directory.
+class Graph {
+public:
+    void setVariable(std::string name, std::string value);
+    void addRule(std::string name, Rule rule);
+    void addEdge(Edge edge);
+    void addDefault(std::string target);
+    /// At most `depth` commands of the rules in pool `name` run at once, like a ninja `pool`.
+    void addPool(std::string name, unsigned depth);
+
+    const std::vector<Edge> &edges() const {
+        return all_edges;
+    }
+    /// What to build when nothing is asked for; every edge if empty.
+    const std::vector<std::string> &defaults() const {
+        return default_targets;
+    }
+
+    /// The rule of `edge`, or nullptr for `phony` and unknown rules.
+    const Rule *rule(const Edge &edge) const;
+    /// `edge`'s command, description and depfile with every variable expanded.
+    std::string command(const Edge &edge) const;
+    std::string description(const Edge &edge) const;
+    std::string depfile(const Edge &edge) const;
+    /// The depth of `edge`'s pool, or 0 if its commands are not limited.
+    unsigned poolDepth(const Edge &edge) const;
+
+private:
+    std::string expand(std::string_view text, const Edge &edge) const;
+
+    std::unordered_map<std::string, std::string> variables;
+    std::unordered_map<std::string, Rule> rules;
+    std::vector<Edge> all_edges;
+    std::vector<std::string> default_targets;
+    std::unordered_map<std::string, unsigned> pools;
+};
+} // namespace catalyst::utils::exec
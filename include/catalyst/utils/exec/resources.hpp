@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+
+namespace catalyst::utils::exec {
+/// Installed RAM in KiB, or 0 if it cannot be determined.
+std::uint64_t physicalMemoryKb();
+
+/// The one-minute load average, or nullopt where the system does not report one.
+std::optional<double> loadAverage();
+} // namespace catalyst::utils::exec
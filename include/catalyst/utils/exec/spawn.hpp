@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+
+namespace catalyst::utils::exec {
+struct CommandResult {
+    int exit_code = 0;             ///< 128 + the signal number if the command was killed
+    std::string output;            ///< stdout and stderr, interleaved as written
+    std::uint64_t peak_rss_kb = 0; ///< the largest resident set of the shell or any process it waited for
+};
+
+/// Run `command` through `/bin/sh -c` in `cwd` and wait for it, capturing its output so concurrent commands do
+/// not interleave on the console. Fails only if the command could not be started.
+std::expected<CommandResult, std::string> runCommand(const std::string &command, const std::filesystem::path &cwd);
+} // namespace catalyst::utils::exec
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace catalyst::utils::fs {
+/// What the caches key a file or directory by: enough to tell it changed without reading it.
+struct FileStat {
+    std::int64_t mtime_ns = 0; ///< nanoseconds since the Unix epoch, comparable with `system_clock::now()`
+    std::int64_t size = 0;
+    std::uint64_t inode = 0; ///< 0 where the platform has none
+    bool regular = false;
+};
+
+/// One `stat` of `path`, following symlinks. nullopt if it does not exist or cannot be read.
+std::optional<FileStat> fileStat(const std::filesystem::path &path);
+
+/// Set a file's mtime, as `FileStat::mtime_ns` counts it, leaving its atime alone where the platform allows.
+bool setMtime(const std::filesystem::path &path, std::int64_t mtime_ns);
+} // namespace catalyst::utils::fs
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace catalyst::utils::fs {
+/// Identity of a directory listing: adding, removing or renaming an entry bumps the directory's mtime.
+struct DirStamp {
+    std::int64_t mtime_ns = 0;
+    std::uint64_t inode = 0;
+
+    bool operator==(const DirStamp &) const = default;
+};
+
+struct CachedChild {
+    enum class Kind : char {
+        File = 'f', ///< regular file, or a symlink to one
+        Dir = 'd',  ///< real directory, walked into
+    };
+    std::string name;
+    Kind kind;
+};
+
+/// Directory listings persisted between runs, so a walk only re-lists directories whose mtime changed.
+/// Shared by every command that scans the source tree; the listings are unfiltered, so ignore patterns and
+/// extension checks are still applied by the caller on each run.
+///
+/// Lookups and records are thread safe. Directories modified within the last couple of seconds are never
+/// recorded, since a change in the same mtime tick as the listing would otherwise go unnoticed.
+class ScanCache {
+public:
+    /// Loads `file` if it exists; a missing, foreign or corrupt cache starts out empty.
+    explicit ScanCache(std::filesystem::path file);
+
+    static std::optional<DirStamp> stamp(const std::filesystem::path &dir);
+
+    /// The cached children of `dir`, or nullopt if it was not cached under `stamp`.
+    std::optional<std::vector<CachedChild>> lookup(const std::filesystem::path &dir, const DirStamp &stamp);
+    void record(const std::filesystem::path &dir, const DirStamp &stamp, std::vector<CachedChild> children);
+
+    /// Marks the start of a walk over `roots`: cached directories below them that the walk does not reach are
+    /// dropped on save, while listings for other roots (e.g. include dirs scanned only by fmt) are kept.
+    void beginWalk(const std::vector<std::filesystem::path> &roots);
+
+    /// Writes the cache back if anything changed.
+    std::expected<void, std::string> save();
+
+    std::size_t hits() const {
+        return hit_count.load(std::memory_order_relaxed);
+    }
+    std::size_t misses() const {
+        return miss_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        DirStamp stamp;
+        std::vector<CachedChild> children;
+        std::atomic<bool> visited{false}; ///< reached by a walk in this process
+    };
+
+    std::filesystem::path file;
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::vector<std::string> walked_roots;
+    std::atomic<std::size_t> hit_count{0};
+    std::atomic<std::size_t> miss_count{0};
+    bool dirty = false;
+};
+
+/// Where commands keep the scan cache for a given build directory.
+std::filesystem::path scanCachePath(const std::filesystem::path &build_dir);
+} // namespace catalyst::utils::fs
@@ -0,0 +1,8 @@
+#pragma once
+#include <filesystem>
+
+namespace catalyst::utils::fs {
+/// Catalyst's per-user cache directory: `$XDG_CACHE_HOME/catalyst`, else `~/.cache/catalyst`, else a directory
+/// under the system temp directory. Not created.
+std::filesystem::path userCacheDir();
+} // namespace catalyst::utils::fs
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/fs/scan_cache.hpp"
+
+namespace catalyst::utils::fs {
+struct WalkEntry {
+    std::size_t root;            ///< index into the roots passed to parallelWalk
+    std::filesystem::path path;  ///< absolute path of the entry
+    std::filesystem::path name;  ///< filename component of `path`
+};
+
+struct WalkOptions {
+    /// Return false to prune a subdirectory before it is listed.
+    std::function<bool(const WalkEntry &)> descend = [](const WalkEntry &) { return true; };
+    /// Return true to collect a regular file.
+    std::function<bool(const WalkEntry &)> keep = [](const WalkEntry &) { return true; };
+    /// 0 selects std::thread::hardware_concurrency().
+    unsigned num_threads = 0;
+    /// When set, directories whose mtime is unchanged are served from the cache instead of being re-listed.
+    /// The caller saves the cache once it is done walking.
+    ScanCache *cache = nullptr;
+};
+
+/// Walk every directory below `roots` in parallel, one task per directory, with idle workers stealing
+/// queued directories from busy ones. Symlinked directories are not followed.
+/// Returns the collected files sorted and deduplicated, so the result is stable between runs. Unreadable
+/// directories are skipped with a warning; an exception from a callback stops the walk and is returned as an error.
+std::expected<std::vector<std::filesystem::path>, std::string>
+parallelWalk(const std::vector<std::filesystem::path> &roots, const WalkOptions &options);
+} // namespace catalyst::utils::fs
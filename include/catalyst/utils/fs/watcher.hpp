@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace catalyst::utils::fs {
+struct WatchEvent {
+    enum class Kind {
+        Created,  ///< created, or moved into a watched directory
+        Modified, ///< written and closed, or replaced in place
+        Removed,  ///< deleted, or moved out of a watched directory
+    };
+    std::filesystem::path path;
+    Kind kind;
+    bool is_dir = false;
+};
+
+struct WatchBatch {
+    std::vector<WatchEvent> events; ///< one per path, sorted by path
+    bool overflow = false;          ///< the kernel dropped events; anything may have changed
+};
+
+/// Watcher for whole directory trees and single directories, based on inotify on Linux and on polling the watched
+/// entries' mtimes elsewhere. Subdirectories created below a watched tree are picked up automatically.
+class Watcher {
+public:
+    static std::expected<Watcher, std::string> create();
+
+    Watcher(Watcher &&other) noexcept;
+    Watcher &operator=(Watcher &&other) noexcept;
+    Watcher(const Watcher &) = delete;
+    Watcher &operator=(const Watcher &) = delete;
+    ~Watcher();
+
+    /// Watch `root` and every directory below it; symlinked directories are not followed.
+    std::expected<void, std::string> addTree(const std::filesystem::path &root);
+    /// Watch the entries directly inside `dir` only.
+    std::expected<void, std::string> addDir(const std::filesystem::path &dir);
+
+    std::size_t size() const {
+        return dirs.size();
+    }
+
+    /// Block until something changes, then keep collecting until nothing has happened for `quiet`, or `max_delay`
+    /// has passed since the first event, so that bursts (a checkout, a formatter run) arrive as one batch.
+    /// Events for the same path are coalesced: e.g. a file created and deleted again within a batch is dropped.
+    std::expected<WatchBatch, std::string> wait(std::chrono::milliseconds quiet, std::chrono::milliseconds max_delay);
+
+private:
+    struct WatchedDir {
+        std::filesystem::path path;
+        bool recursive;
+    };
+
+    explicit Watcher(int fd) : fd(fd) {
+    }
+
+    std::expected<void, std::string> add(const std::filesystem::path &dir, bool recursive);
+#if defined(__linux__)
+    void drain(std::unordered_map<std::string, WatchEvent> &pending, bool &overflow);
+#else
+    struct Stamp {
+        std::int64_t mtime_ns = 0;
+        std::int64_t size = 0;
+        bool is_dir = false;
+    };
+    using Snapshot = std::unordered_map<std::string, Stamp>;
+
+    /// Every entry below the watched directories now.
+    Snapshot scan() const;
+    /// Rescan and fold the differences since the last scan into `pending`; false if nothing changed.
+    bool poll(std::unordered_map<std::string, WatchEvent> &pending);
+
+    Snapshot snapshot;
+#endif
+
+    int fd = -1;
+    std::unordered_map<int, WatchedDir> dirs; ///< by watch descriptor (by order of addition when polling)
+};
+} // namespace catalyst::utils::fs
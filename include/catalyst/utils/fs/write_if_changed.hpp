@@ -0,0 +1,12 @@
+#pragma once
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace catalyst::utils::fs {
+/// Write `content` to `path` only if the file does not already hold exactly these bytes.
+/// Leaving an identical file untouched keeps its mtime, so backends do not re-parse or rebuild from it.
+/// Returns true if the file was (re)written.
+std::expected<bool, std::string> writeIfChanged(const std::filesystem::path &path, std::string_view content);
+} // namespace catalyst::utils::fs
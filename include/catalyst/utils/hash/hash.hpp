@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace catalyst::utils::hash {
+/// Incremental 64-bit FNV-1a hasher.
+/// NOTE: not cryptographic. Used to fingerprint build inputs, where speed matters more than collision resistance.
+class Fnv1a {
+public:
+    Fnv1a &update(std::string_view data);
+    Fnv1a &update(std::uint64_t value);
+
+    std::uint64_t digest() const {
+        return state;
+    }
+    std::string hexDigest() const;
+
+private:
+    static constexpr std::uint64_t OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static constexpr std::uint64_t PRIME = 0x100000001b3ULL;
+
+    void mix(const unsigned char *data, std::size_t size);
+
+    std::uint64_t state = OFFSET_BASIS;
+};
+
+/// SHA-256, for content addresses that other tools verify, such as the remote cache's CAS.
+class Sha256 {
+public:
+    Sha256 &update(std::string_view data);
+    std::string hexDigest() const;
+
+private:
+    void compress(const unsigned char *block);
+
+    std::array<std::uint32_t, 8> state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::array<unsigned char, 64> buffer{};
+    std::size_t buffered = 0;
+    std::uint64_t length = 0; ///< bytes hashed so far
+};
+
+std::string toHex(std::uint64_t value);
+std::optional<std::uint64_t> hashFile(const std::filesystem::path &path);
+std::optional<std::string> sha256File(const std::filesystem::path &path);
+} // namespace catalyst::utils::hash
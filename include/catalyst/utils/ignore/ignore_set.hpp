@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace catalyst::utils::ignore {
+/// All .catalystignore patterns active for a profile set, compiled once and matched many times.
+///
+/// Pattern syntax:
+///  - `re:<regex>` or a bare pattern: an ECMAScript regex matched against the file name. It never matches a
+///    directory, so a regex written to drop files cannot prune a whole subtree.
+///  - `glob:<glob>`: a gitignore-style glob. `*` and `?` do not cross `/`, `**` does, and `[...]` is a character
+///    class. A glob containing `/` is anchored to the directory holding the .catalystignore, otherwise it matches
+///    the name at any depth. A trailing `/` only matches directories and a leading `!` re-includes a path.
+///    When patterns overlap, the last matching one wins.
+///
+/// Literal, prefix and suffix patterns are answered from hash lookups; other wildcard patterns are combined into a
+/// single NFA that is run once per path. Only regexes using more than `.`, `.*` and escapes fall back to std::regex.
+class IgnoreSet {
+public:
+    IgnoreSet() = default;
+    static std::expected<IgnoreSet, std::string> compile(const std::vector<std::string> &patterns);
+
+    /// `rel_path` is relative to the directory holding the .catalystignore and uses `/` as separator.
+    bool matches(std::string_view rel_path, bool is_dir) const;
+
+    bool empty() const {
+        return rules.empty();
+    }
+    /// Whether any rule can match a directory, i.e. whether a walk needs to test directories at all.
+    bool prunesDirs() const {
+        return std::ranges::any_of(rules, [](const Rule &rule) { return !rule.files_only; });
+    }
+
+private:
+    struct Rule {
+        bool negate = false;
+        bool dir_only = false;
+        bool files_only = false; ///< regex rules, which only ever matched file names
+    };
+
+    enum class TokenKind : std::uint8_t {
+        Char,       ///< one specific character
+        Any,        ///< any one character
+        AnyNoSlash, ///< any one character except '/'
+        Class,      ///< one character from classes[arg]
+        Star,       ///< any run of characters
+        StarNoSlash,///< any run of characters without '/'
+        DirsEntry,  ///< `(.*/)?` entry state
+        DirsInner,  ///< `(.*/)?` inside a run
+        Accept,     ///< end of a pattern; arg is the rule index
+    };
+
+    struct Token {
+        TokenKind kind;
+        char ch = 0;
+        std::uint32_t arg = 0;
+    };
+
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    /// Patterns aimed at one subject: the entry name, or its path relative to the ignore file.
+    struct Target {
+        std::unordered_map<std::string, std::vector<std::size_t>, StringHash, std::equal_to<>> exact;
+        std::vector<std::pair<std::string, std::size_t>> prefixes;
+        std::vector<std::pair<std::string, std::size_t>> suffixes;
+        std::vector<Token> nfa;            ///< all wildcard programs back to back, each ending in Accept
+        std::vector<std::uint32_t> starts; ///< first token of every program in `nfa`
+        std::vector<std::pair<std::regex, std::size_t>> regexes;
+    };
+
+    void addProgram(Target &target, std::vector<Token> program, std::size_t rule);
+    void collect(const Target &target, std::string_view subject, bool is_dir, std::size_t &best, bool &hit) const;
+    void runNfa(const Target &target, std::string_view subject, bool is_dir, std::size_t &best, bool &hit) const;
+    bool consider(std::size_t rule, bool is_dir, std::size_t &best, bool &hit) const;
+
+    std::vector<Rule> rules;
+    std::vector<std::bitset<256>> classes;
+    Target by_name;
+    Target by_path;
+    bool has_negation = false;
+};
+} // namespace catalyst::utils::ignore
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace catalyst::utils::includes {
+struct Directive {
+    std::string spelling; ///< the text between the quotes or angle brackets
+    bool angled = false;
+    bool conditional = false; ///< inside an `#if`, `#ifdef` or `#ifndef` other than the file's include guard
+
+    bool operator==(const Directive &) const = default;
+};
+
+/// A translation unit's part in C++20 named modules.
+struct ModuleInfo {
+    std::string name;                 ///< `M` or `M:partition` from the module declaration; empty outside modules
+    bool exported = false;            ///< `export module`: an interface unit
+    std::vector<std::string> imports; ///< named modules imported, partitions qualified with their module
+
+    bool empty() const {
+        return name.empty() && imports.empty();
+    }
+    /// Whether compiling the unit produces a BMI: interface units and partitions, not implementation units.
+    bool providesBmi() const {
+        return exported || name.find(':') != std::string::npos;
+    }
+    bool operator==(const ModuleInfo &) const = default;
+};
+
+/// The `#include`, `#include_next` and `#import` directives of `source`, in order. Header units
+/// (`import <header>;`) count as directives too.
+/// This is a lexer, not a preprocessor: comments, string and raw string literals and line continuations are
+/// honoured, but conditionals are not evaluated (both branches count, marked `conditional`) and computed includes
+/// (`#include MACRO`) are skipped.
+std::vector<Directive> extractDirectives(std::string_view source);
+/// The module declaration and named module imports of `source`, found by the same lexer.
+ModuleInfo extractModuleInfo(std::string_view source);
+
+/// Which project files each file includes, found by scanning sources and the headers they reach.
+class IncludeGraph {
+public:
+    /// Scan `sources` and every header reachable from them, in parallel.
+    /// Quoted includes resolve against the including file's directory, then `include_dirs`; angled includes against
+    /// `include_dirs` only. Includes that resolve nowhere (the standard library, system headers) are left out,
+    /// as with -MMD. Directives are cached in `cache_file` by file hash, so unchanged files are not re-read.
+    static IncludeGraph scan(const std::vector<std::filesystem::path> &sources,
+                             const std::vector<std::filesystem::path> &include_dirs,
+                             const std::filesystem::path &cache_file,
+                             unsigned num_threads = 0);
+
+    /// Direct includes of `file`, resolved and sorted.
+    const std::vector<std::filesystem::path> &includes(const std::filesystem::path &file) const;
+    /// Angled includes of `file` that resolve outside the project (the standard library, dependencies), as spelled.
+    const std::vector<std::string> &externalIncludes(const std::filesystem::path &file) const;
+    /// The external includes that every compile of `file` reads whatever the macros: reached from `file` and the
+    /// project headers it includes without passing through an `#if`. Sorted.
+    std::vector<std::string> unconditionalExternalIncludes(const std::filesystem::path &file) const;
+    /// The module declaration and imports of `file`, empty if it uses no named modules.
+    const ModuleInfo &moduleInfo(const std::filesystem::path &file) const;
+    /// Every header `file` reaches, sorted.
+    std::vector<std::filesystem::path> transitiveIncludes(const std::filesystem::path &file) const;
+
+    /// Changes whenever an edge, external include or module declaration is added or removed, or moves in or out of
+    /// an `#if`.
+    std::string digest() const;
+    /// `{"<file>": ["<include>", ...], ...}`, sorted, for other tools.
+    std::string toJson() const;
+
+    std::size_t size() const {
+        return edges.size();
+    }
+
+private:
+    std::unordered_map<std::string, std::vector<std::filesystem::path>> edges; ///< by file path
+    std::unordered_map<std::string, std::vector<std::string>> external;         ///< by file path, if any
+    std::unordered_map<std::string, ModuleInfo> modules;                        ///< by file path, if any
+    /// By file path: the edges and external spellings that only `#if`-ed directives reach, if any.
+    std::unordered_map<std::string, std::vector<std::string>> conditionals;
+};
+
+/// Where generate writes the include graph for a given build directory.
+std::filesystem::path includeGraphPath(const std::filesystem::path &build_dir);
+/// Where the directive cache lives for a given build directory.
+std::filesystem::path includeCachePath(const std::filesystem::path &build_dir);
+} // namespace catalyst::utils::includes
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace catalyst::utils::trace {
+/// A header, template or function summed over every trace it appears in.
+struct TraceTotal {
+    std::string name;
+    std::int64_t total_us = 0;
+    std::size_t count = 0;
+};
+
+/// One translation unit's trace.
+struct TraceUnit {
+    std::filesystem::path trace;
+    std::int64_t total_us = 0; ///< `ExecuteCompiler`
+    std::int64_t frontend_us = 0;
+    std::int64_t backend_us = 0;
+};
+
+/// What a build's `-ftime-trace` files add up to, in the manner of ClangBuildAnalyzer. Times are inclusive: a
+/// header's parse includes the headers it includes, an instantiation the ones it triggers.
+struct TimeTraceReport {
+    std::vector<TraceUnit> units;
+    std::vector<TraceTotal> headers;       ///< `Source` events, by path
+    std::vector<TraceTotal> templates;     ///< `InstantiateClass` and `InstantiateFunction`, by full name
+    std::vector<TraceTotal> template_sets; ///< the same, by the template with its arguments dropped
+    std::vector<TraceTotal> functions;     ///< `CodeGen Function` and `OptFunction`, by name
+    std::vector<std::filesystem::path> unreadable;
+};
+
+/// The clang traces in `obj_dir`: a `.json` next to an object, named after it with or without its `.o`.
+std::vector<std::filesystem::path> findTimeTraces(const std::filesystem::path &obj_dir);
+
+/// Read `traces` on up to `jobs` threads (0: one per hardware thread) and sum them up. Every list is sorted by time,
+/// longest first, then by name, so that the same traces always give the same report.
+TimeTraceReport aggregateTimeTraces(const std::vector<std::filesystem::path> &traces, unsigned jobs);
+
+/// Plain text tables of the `top` longest entries of each list. Paths below `root` are shown relative to it, so
+/// that reports from different checkouts and commits diff cleanly.
+std::string formatTimeTraceReport(const TimeTraceReport &report, const std::filesystem::path &root, std::size_t top);
+} // namespace catalyst::utils::trace
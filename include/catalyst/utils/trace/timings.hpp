@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace catalyst::utils::trace {
+/// One bar of a build's timeline.
+struct Span {
+    std::string name;
+    std::string category;      ///< "phase", "hook", or the rule of a command
+    std::int64_t start_us = 0; ///< since the recorder was created
+    std::int64_t end_us = 0;
+    unsigned lane = 0; ///< 0: catalyst itself; a command: the worker slot that ran it, from 1
+};
+
+/// Collects the spans of `build --timings`. Off unless enabled, when recording costs a branch.
+class Recorder {
+public:
+    static Recorder &instance() {
+        static Recorder recorder_instance;
+        return recorder_instance;
+    }
+
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+    Recorder(Recorder &&) = delete;
+    Recorder &operator=(Recorder &&) = delete;
+
+    void enable();
+    bool enabled() const;
+    std::int64_t nowUs() const;
+    void add(Span span);
+    /// The spans recorded so far, which are forgotten.
+    std::vector<Span> take();
+
+private:
+    Recorder();
+
+    const std::chrono::steady_clock::time_point epoch;
+    mutable std::mutex mutex;
+    bool on = false;
+    std::vector<Span> spans;
+};
+
+inline Recorder &recorder = Recorder::instance();
+
+/// Records the time from its construction to `end()` or its destruction, whichever comes first, on lane 0.
+class Phase {
+public:
+    explicit Phase(std::string name, std::string category = "phase");
+    Phase(const Phase &) = delete;
+    Phase &operator=(const Phase &) = delete;
+    ~Phase();
+    void end();
+
+private:
+    std::string name;
+    std::string category;
+    std::int64_t start_us;
+    bool open;
+};
+
+/// Put commands known only by their start and end (ninja's log) on lanes, each on the lowest one free when it
+/// starts. As many lanes are used as commands ran at once, which is what the worker slots would show.
+void assignLanes(std::vector<Span> &commands);
+
+/// The Chrome trace event format that chrome://tracing and Perfetto load: a complete event per span, a thread per
+/// lane.
+std::string chromeTrace(const std::vector<Span> &spans);
+
+/// A self-contained page with the timeline, the phases, the slowest commands and the concurrency over time.
+std::string htmlReport(const std::vector<Span> &spans, const std::string &title);
+
+/// `catalyst-timing.json` and `catalyst-timing.html` in `dir`; returns the HTML's path.
+std::expected<std::filesystem::path, std::string>
+writeReports(const std::filesystem::path &dir, const std::vector<Span> &spans, const std::string &title);
+} // namespace catalyst::utils::trace
@@ -0,0 +1,33 @@
+#pragma once
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/yaml/snapshot.hpp"
+
+namespace catalyst::utils::yaml {
+/// `manifest.dirs.per_profile`: the directory below `manifest.dirs.build` that `profiles` build into, named after
+/// them and a hash of the list, e.g. `common-asan-1a2b3c4d`. Editing a profile keeps the directory.
+std::string profileDirName(const std::vector<std::string> &profiles);
+
+/// `manifest.build.configs`: the name `profiles` go by in the project's multi-config build graph, if they are one of
+/// its configs: `common` alone, or `common` and one of the listed profiles. Each config builds into `<build>/<name>`.
+std::optional<std::string> multiConfigName(const std::vector<std::string> &profiles, const Snapshot &snapshot);
+/// The same, from the listed `configs`, for the composition itself, which runs before there is a snapshot.
+std::optional<std::string> multiConfigName(const std::vector<std::string> &profiles,
+                                           const std::vector<std::string> &configs);
+
+/// `<build>/current`, next to the per-profile directory `build_dir`.
+std::filesystem::path currentLink(const std::filesystem::path &build_dir);
+
+/// With per-profile build directories, point `<build>/current` at the composition's. Otherwise a no-op.
+std::expected<void, std::string> linkCurrent(const Snapshot &snapshot);
+
+/// The directory that commands acting on a finished build (run, install, clean) look in. With per-profile build
+/// directories and no profiles named on the command line, it is the one `<build>/current` points at, if any: the
+/// last one built. Otherwise it is the composition's own. An error if the last build's composition has another
+/// target name, type, generator or dependencies than `snapshot`, which the caller would read them from.
+std::expected<std::filesystem::path, std::string> builtDir(const Snapshot &snapshot, bool profiles_named);
+} // namespace catalyst::utils::yaml
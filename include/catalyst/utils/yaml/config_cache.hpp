@@ -0,0 +1,26 @@
+#pragma once
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/yaml/snapshot.hpp"
+
+namespace catalyst::utils::yaml {
+/// `<root_dir>/.catalyst/config/<hash>`: the composed snapshot of `profiles`, in `Snapshot::serialize` form behind a
+/// header that stamps (mtime, size, inode) every file the composition read or would have fallen back to.
+std::filesystem::path configCachePath(const std::vector<std::string> &profiles,
+                                      const std::filesystem::path &root_dir);
+
+/// The cached snapshot, mapped and decoded without the YAML parser, or nullopt if there is none, it is corrupt, or a
+/// profile file was edited, added or removed since it was written.
+std::optional<Snapshot> loadConfigCache(const std::vector<std::string> &profiles,
+                                        const std::filesystem::path &root_dir);
+
+/// Caches `snapshot` as the composition of `profiles`. A profile file modified within the last couple of seconds
+/// could change again within the same mtime tick, so the cache is not written then.
+std::expected<void, std::string> saveConfigCache(const std::vector<std::string> &profiles,
+                                                 const std::filesystem::path &root_dir,
+                                                 const Snapshot &snapshot);
+} // namespace catalyst::utils::yaml
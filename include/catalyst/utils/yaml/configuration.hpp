@@ -1,12 +1,33 @@
 #pragma once
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "catalyst/utils/yaml/snapshot.hpp"
 #include "yaml-cpp/yaml.h"
 
 namespace catalyst::utils::yaml {
+/// One step in the history of a configuration key, as the composition resolved it.
+struct Origin {
+    enum class Kind {
+        Default, ///< the built-in value
+        Set,     ///< a profile set the scalar, replacing the previous value
+        Append,  ///< a profile appended to the sequence
+        Remove,  ///< a profile's `null` removed the key
+        Ignored, ///< a profile's value failed validation
+        Derived, ///< the composition computed it, e.g. `manifest.dirs.build` with `per_profile`
+    };
+    Kind kind;
+    std::string profile; ///< empty for Default and Derived
+    std::string value;   ///< the value it set, the items it appended or the value it rejected
+};
+
+/// Every key the composition touched, by dotted path, with its history in merge order.
+using Provenance = std::unordered_map<std::string, std::vector<Origin>>;
+
 class Configuration {
 public:
     Configuration() = default;
@@ -20,11 +41,19 @@ public:
     std::optional<bool> getBool(const std::string &key) const;
     std::optional<std::vector<std::string>> getStringVector(const std::string &key) const;
 
-    const YAML::Node &getRoot() const & {
-        return root;
-    }
+    /// The composition's typed fields; prefer these to walking `getRoot()`.
+    const Snapshot &snapshot() const;
+
+    /// How each key got its value, e.g. for `catalyst config explain`.
+    const Provenance &provenance() const;
+
+    /// The composed YAML tree. A configuration loaded from the cache composes it on first use, so prefer `snapshot()`.
+    const YAML::Node &getRoot() const &;
 
 private:
-    YAML::Node root;
+    struct Composition;
+
+    std::shared_ptr<const Snapshot> compiled;
+    std::shared_ptr<Composition> composition;
 };
 } // namespace catalyst::utils::yaml
@@ -0,0 +1,11 @@
+#pragma once
+#include <filesystem>
+
+#include <yaml-cpp/yaml.h>
+
+namespace catalyst::utils::yaml {
+/// `YAML::LoadFile`, parsed at most once per process for each (path, mtime, size): every profile of a `CATALYST.yaml`
+/// and every lookup of a workspace member shares the same tree. The tree is shared, so treat it as read-only and
+/// `YAML::Clone` the parts that will be edited or merged. Throws like `YAML::LoadFile`.
+YAML::Node loadManifest(const std::filesystem::path &path);
+} // namespace catalyst::utils::yaml
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+namespace catalyst::utils::yaml {
+/// A node of the composed configuration, converted once to each type it reads as.
+struct FlatValue {
+    std::optional<std::string> string; ///< scalars, and `null` for an empty value, as `as<std::string>` reads them
+    std::optional<int> integer;
+    std::optional<bool> boolean;
+    std::optional<std::vector<std::string>> strings; ///< sequences of scalars
+};
+
+/// The composed configuration compiled once, after composition, into typed fields and a flat map from every dotted
+/// path to its value. It is immutable and shared by the copies of its `Configuration`, so a read is a hash lookup or a
+/// field access; the YAML tree is never traversed or cloned again.
+struct Snapshot {
+    struct Meta {
+        std::string min_ver;
+        std::string generator;
+    };
+    struct Tooling {
+        std::string cc;
+        std::string cxx;
+        std::string fmt;
+        std::string linter;
+        std::string ccflags;
+        std::string cxxflags;
+    };
+    struct Dirs {
+        std::vector<std::string> include;
+        std::vector<std::string> source;
+        std::string build;
+        bool per_profile = false;
+    };
+    struct Build {
+        std::vector<std::string> configs; ///< the profiles of the multi-config build graph, if any
+    };
+    struct Manifest {
+        std::string name;
+        std::string type;
+        std::string version;
+        std::string provides;
+        Tooling tooling;
+        Dirs dirs;
+        Build build;
+    };
+    struct Dependency {
+        std::string name;   ///< empty if the entry has none
+        std::string source; ///< empty if the entry has none
+        YAML::Node node;    ///< the source-specific fields
+    };
+    struct Feature {
+        std::string name;
+        bool enabled;
+    };
+    struct HookStep {
+        enum class Kind : char {
+            Command = 'c',
+            Script = 's',
+        };
+        Kind kind;
+        std::string text; ///< run through the shell either way
+    };
+
+    Meta meta;
+    Manifest manifest;
+    std::vector<Dependency> dependencies;
+    std::vector<Feature> features;
+    std::unordered_map<std::string, std::vector<HookStep>> hooks; ///< by hook name, e.g. `pre-build`
+
+    static Snapshot compile(const YAML::Node &root);
+
+    /// A flat binary encoding, length-prefixed and in host byte order, for the on-disk configuration cache. Decoding
+    /// never runs the YAML parser; only the dependency entries are rebuilt as nodes.
+    std::string serialize() const;
+    /// nullopt if `bytes` is truncated or not an encoding of this version.
+    static std::optional<Snapshot> deserialize(std::string_view bytes);
+
+    /// The value at `key`, e.g. `manifest.dirs.build`, or nullptr if there is no such path. Maps have an entry too,
+    /// with no value of any type.
+    const FlatValue *find(std::string_view key) const;
+
+private:
+    struct KeyHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view key) const {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+    std::unordered_map<std::string, FlatValue, KeyHash, std::equal_to<>> values;
+};
+} // namespace catalyst::utils::yaml
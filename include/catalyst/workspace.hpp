@@ -1,11 +1,14 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "catalyst/utils/yaml/configuration.hpp"
+
 namespace catalyst {
 
 struct WorkspaceMember {
@@ -36,9 +39,16 @@ public:
     // Note: This involves loading configuration of members
     std::optional<WorkspaceMember> findPackage(const std::string &package_name) const;
 
+    // The composed configuration of a member, with its profiles or `common`. Composed once per process and shared
+    // by copies of the workspace; throws like `Configuration` if the member's profiles cannot be composed.
+    const utils::yaml::Configuration &memberConfig(const std::string &key) const;
+
 private:
+    struct MemberConfigs;
+
     std::filesystem::path root_path;
     std::unordered_map<std::string, WorkspaceMember> members;
+    std::shared_ptr<MemberConfigs> member_configs;
 };
 
 } // namespace catalyst
@@ -34,21 +34,28 @@ std::pair<int, bool> parseCli(int argc, char **argv, catalyst::CliContext &ctx)
 
     tie(ctx.add_subc, ctx.add_res) = catalyst::add::parse(ctx.app);
     tie(ctx.build_subc, ctx.build_res) = catalyst::build::parse(ctx.app);
+    tie(ctx.cache_subc, ctx.cache_res) = catalyst::cache::parse(ctx.app);
     tie(ctx.clean_subc, ctx.clean_res) = catalyst::clean::parse(ctx.app);
+    tie(ctx.config_subc, ctx.config_res) = catalyst::config::parse(ctx.app);
     tie(ctx.download_subc, ctx.download_res) = catalyst::download::parse(ctx.app);
     tie(ctx.fetch_subc, ctx.fetch_res) = catalyst::fetch::parse(ctx.app);
     tie(ctx.fmt_subc, ctx.fmt_res) = catalyst::fmt::parse(ctx.app);
     tie(ctx.generate_subc, ctx.generate_res) = catalyst::generate::parse(ctx.app);
+    tie(ctx.hot_headers_subc, ctx.hot_headers_res) = catalyst::hot_headers::parse(ctx.app);
     tie(ctx.ide_sync_subc, ctx.ide_sync_res) = catalyst::ide_sync::parse(ctx.app);
     tie(ctx.init_subc, ctx.init_res) = catalyst::init::parse(ctx.app);
     tie(ctx.install_subc, ctx.install_res) = catalyst::install::parse(ctx.app);
     tie(ctx.run_subc, ctx.run_res) = catalyst::run::parse(ctx.app);
     tie(ctx.test_subc, ctx.test_res) = catalyst::test::parse(ctx.app);
     tie(ctx.tidy_subc, ctx.tidy_res) = catalyst::tidy::parse(ctx.app);
+    tie(ctx.why_rebuild_subc, ctx.why_rebuild_res) = catalyst::why_rebuild::parse(ctx.app);
     tie(ctx.add_git_subc, ctx.add_git_res) = catalyst::add::git::parse(*ctx.add_subc);
     tie(ctx.add_system_subc, ctx.add_system_res) = catalyst::add::system::parse(*ctx.add_subc);
     tie(ctx.add_local_subc, ctx.add_local_res) = catalyst::add::local::parse(*ctx.add_subc);
     tie(ctx.add_vcpkg_subc, ctx.add_vcpkg_res) = catalyst::add::vcpkg::parse(*ctx.add_subc);
+    tie(ctx.cache_stats_subc, ctx.cache_stats_res) = catalyst::cache::stats::parse(*ctx.cache_subc);
+    tie(ctx.cache_serve_subc, ctx.cache_serve_res) = catalyst::cache::serve::parse(*ctx.cache_subc);
+    tie(ctx.config_explain_subc, ctx.config_explain_res) = catalyst::config::explain::parse(*ctx.config_subc);
 
     ctx.app.add_flag("-v,--version", ctx.show_version, "current version");
     ctx.app.add_flag("-V,--verbose", catalyst::logger.getVerboseLogging(), "verbose stdout logging output");
@@ -94,8 +101,20 @@ int dispatch(const catalyst::CliContext &ctx) {
     }
     if (*ctx.build_subc)
         return dispatchFN("build", *ctx.build_res, catalyst::build::action);
+    if (*ctx.cache_subc) {
+        if (*ctx.cache_stats_subc)
+            return dispatchFN("cache stats", *ctx.cache_stats_res, catalyst::cache::stats::action);
+        if (*ctx.cache_serve_subc)
+            return dispatchFN("cache serve", *ctx.cache_serve_res, catalyst::cache::serve::action);
+        return 1;
+    }
     if (*ctx.clean_subc)
         return dispatchFN("clean", *ctx.clean_res, catalyst::clean::action);
+    if (*ctx.config_subc) {
+        if (*ctx.config_explain_subc)
+            return dispatchFN("config explain", *ctx.config_explain_res, catalyst::config::explain::action);
+        return 1;
+    }
     if (*ctx.download_subc)
         return dispatchFN("download", *ctx.download_res, catalyst::download::action);
     if (*ctx.fetch_subc)
@@ -104,6 +123,8 @@ int dispatch(const catalyst::CliContext &ctx) {
         return dispatchFN("fmt", *ctx.fmt_res, catalyst::fmt::action);
     if (*ctx.generate_subc)
         return dispatchFN("generate", *ctx.generate_res, catalyst::generate::action);
+    if (*ctx.hot_headers_subc)
+        return dispatchFN("hot-headers", *ctx.hot_headers_res, catalyst::hot_headers::action);
     if (*ctx.ide_sync_subc)
         return dispatchFN("ide_sync", *ctx.ide_sync_res, catalyst::ide_sync::action);
     if (*ctx.init_subc)
@@ -116,6 +137,8 @@ int dispatch(const catalyst::CliContext &ctx) {
         return dispatchFN("test", *ctx.test_res, catalyst::test::action);
     if (*ctx.tidy_subc)
         return dispatchFN("tidy", *ctx.tidy_res, catalyst::tidy::action);
+    if (*ctx.why_rebuild_subc)
+        return dispatchFN("why-rebuild", *ctx.why_rebuild_res, catalyst::why_rebuild::action);
     catalyst::logger.log(catalyst::LogLevel::ERROR, "run catalyst --help for info on available commands.");
     return 1;
 }
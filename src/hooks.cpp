@@ -4,23 +4,18 @@
 #include <vector>
 
 #include <catalyst/hooks.hpp>
-#include <yaml-cpp/yaml.h>
 
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/process_exec.hpp"
+#include "catalyst/utils/trace/timings.hpp"
 #include "catalyst/utils/yaml/configuration.hpp"
 
-#include "yaml-cpp/node/node.h"
-
 namespace catalyst::hooks {
 
 namespace {
-std::expected<void, std::string> executeHook(const YAML::Node &profile_comp, const std::string &hook_name) {
-    catalyst::logger.log(LogLevel::DEBUG, "Executing hook: {}", hook_name);
-    if (!profile_comp["hooks"] || !profile_comp["hooks"][hook_name]) {
-        catalyst::logger.log(LogLevel::DEBUG, "No hook defined for: {}", hook_name);
-        return {}; // No hook defined, so we do nothing.
-    }
+std::expected<void, std::string> runHook(const std::vector<utils::yaml::Snapshot::HookStep> &steps,
+                                         const std::string &hook_name) {
+    utils::trace::Phase span{hook_name, "hook"};
 
     auto shell_cmd = [](const std::string &cmd) -> std::vector<std::string> {
 #if defined(_WIN32)
@@ -30,121 +25,90 @@ std::expected<void, std::string> executeHook(const YAML::Node &profile_comp, con
 #endif
     };
 
-    const YAML::Node &hook_node = profile_comp["hooks"][hook_name];
-    if (hook_node.IsSequence()) {
-        for (const auto &item : hook_node) {
-            if (item["command"]) {
-                auto command = item["command"].as<std::string>();
-                catalyst::logger.log(LogLevel::DEBUG, "[Catalyst Hook: {}] Running command: {}", hook_name, command);
-                if (catalyst::processExec(shell_cmd(command)).value().get() != 0) {
-                    catalyst::logger.log(LogLevel::ERROR, "Hook '{}' command failed: {}", hook_name, command);
-                    return std::unexpected(std::format("Hook '{}' command failed: {}", hook_name, command));
-                }
-            } else if (item["script"]) {
-                auto script = item["script"].as<std::string>();
-                catalyst::logger.log(LogLevel::DEBUG, "[Catalyst Hook: {}] Running script: {}", hook_name, script);
-                if (catalyst::processExec(shell_cmd(script)).value().get() != 0) {
-                    catalyst::logger.log(LogLevel::ERROR, "Hook '{}' script failed: {}", hook_name, script);
-                    return std::unexpected(std::format("Hook '{}' script failed: {}", hook_name, script));
-                }
-            }
-        }
-    } else if (hook_node.IsScalar()) {
-        auto command = hook_node.as<std::string>();
-        catalyst::logger.log(LogLevel::DEBUG, "[Catalyst Hook: {}] Running command: {}", hook_name, command);
-        if (catalyst::processExec(shell_cmd(command)).value().get() != 0) {
-            catalyst::logger.log(LogLevel::ERROR, "Hook '{}' command failed: {}", hook_name, command);
-            return std::unexpected("Hook '" + hook_name + "' command failed: " + command);
+    for (const auto &step : steps) {
+        const char *what = step.kind == utils::yaml::Snapshot::HookStep::Kind::Script ? "script" : "command";
+        catalyst::logger.log(LogLevel::DEBUG, "[Catalyst Hook: {}] Running {}: {}", hook_name, what, step.text);
+        if (catalyst::processExec(shell_cmd(step.text)).value().get() != 0) {
+            catalyst::logger.log(LogLevel::ERROR, "Hook '{}' {} failed: {}", hook_name, what, step.text);
+            return std::unexpected(std::format("Hook '{}' {} failed: {}", hook_name, what, step.text));
         }
     }
 
     catalyst::logger.log(LogLevel::DEBUG, "Hook finished successfully: {}", hook_name);
     return {};
 }
-} // namespace
-
-std::expected<void, std::string> preClean(const YAML::Node &profile_comp) {
-    return executeHook(profile_comp, "pre-clean");
-}
-
-std::expected<void, std::string> postClean(const YAML::Node &profile_comp) {
-    return executeHook(profile_comp, "post-clean");
-}
-
-std::expected<void, std::string> preRun(const YAML::Node &profile_comp) {
-    return executeHook(profile_comp, "pre-run");
-}
-
-std::expected<void, std::string> postRun(const YAML::Node &profile_comp) {
-    return executeHook(profile_comp, "post-run");
-}
-
-std::expected<void, std::string> preTest(const YAML::Node &profile_comp) {
-    return executeHook(profile_comp, "pre-test");
-}
 
-std::expected<void, std::string> postTest(const YAML::Node &profile_comp) {
-    return executeHook(profile_comp, "post-test");
+std::expected<void, std::string> executeHook(const utils::yaml::Configuration &profile_comp,
+                                             const std::string &hook_name) {
+    catalyst::logger.log(LogLevel::DEBUG, "Executing hook: {}", hook_name);
+    const auto &hooks = profile_comp.snapshot().hooks;
+    auto hook = hooks.find(hook_name);
+    if (hook == hooks.end()) {
+        catalyst::logger.log(LogLevel::DEBUG, "No hook defined for: {}", hook_name);
+        return {}; // No hook defined, so we do nothing.
+    }
+    return runHook(hook->second, hook_name);
 }
+} // namespace
 
 std::expected<void, std::string> preBuild(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-build");
+    return executeHook(profile_comp, "pre-build");
 }
 
 std::expected<void, std::string> postBuild(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-build");
+    return executeHook(profile_comp, "post-build");
 }
 
 std::expected<void, std::string> onBuildFailure(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "on-build-failure");
+    return executeHook(profile_comp, "on-build-failure");
 }
 
 std::expected<void, std::string> preGenerate(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-generate");
+    return executeHook(profile_comp, "pre-generate");
 }
 
 std::expected<void, std::string> postGenerate(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-generate");
+    return executeHook(profile_comp, "post-generate");
 }
 
 std::expected<void, std::string> preFetch(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-fetch");
+    return executeHook(profile_comp, "pre-fetch");
 }
 
 std::expected<void, std::string> postFetch(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-fetch");
+    return executeHook(profile_comp, "post-fetch");
 }
 
 std::expected<void, std::string> preClean(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-clean");
+    return executeHook(profile_comp, "pre-clean");
 }
 
 std::expected<void, std::string> postClean(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-clean");
+    return executeHook(profile_comp, "post-clean");
 }
 
 std::expected<void, std::string> preRun(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-run");
+    return executeHook(profile_comp, "pre-run");
 }
 
 std::expected<void, std::string> postRun(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-run");
+    return executeHook(profile_comp, "post-run");
 }
 
 std::expected<void, std::string> preTest(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-test");
+    return executeHook(profile_comp, "pre-test");
 }
 
 std::expected<void, std::string> postTest(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-test");
+    return executeHook(profile_comp, "post-test");
 }
 
 std::expected<void, std::string> preLink(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "pre-link");
+    return executeHook(profile_comp, "pre-link");
 }
 
 std::expected<void, std::string> postLink(const utils::yaml::Configuration &profile_comp) {
-    return executeHook(profile_comp.getRoot(), "post-link");
+    return executeHook(profile_comp, "post-link");
 }
 
 std::expected<void, std::string> onCompile([[maybe_unused]] const std::filesystem::path &file) {
@@ -1,13 +1,16 @@
 #include <algorithm>
+#include <cstdint>
 #include <expected>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <nlohmann/json.hpp>
 #include <yaml-cpp/node/node.h>
 
 #include "catalyst/hooks.hpp"
@@ -17,6 +20,13 @@
 #include "catalyst/subcommands/fetch.hpp"
 #include "catalyst/subcommands/generate.hpp"
 #include "catalyst/workspace.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/executor.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/trace/time_trace.hpp"
+#include "catalyst/utils/trace/timings.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
 #include "catalyst/utils/yaml/configuration.hpp"
 
 namespace catalyst::build {
@@ -38,11 +48,7 @@ std::vector<WorkspaceMember> buildOrderTopSort(const Workspace &ws) {
 
     for (const auto &[key, member] : ws.getMembers()) {
         try {
-            std::vector<std::string> profiles = member.profiles;
-            if (profiles.empty())
-                profiles.emplace_back("common");
-
-            utils::yaml::Configuration config(profiles, member.path);
+            const utils::yaml::Configuration &config = ws.memberConfig(key);
             auto name_opt = config.getString("manifest.name");
             if (!name_opt) {
                 catalyst::logger.log(LogLevel::WARN, "Member {} has no manifest.name", key);
@@ -54,12 +60,9 @@ std::vector<WorkspaceMember> buildOrderTopSort(const Workspace &ws) {
             info.name = name;
             info.workspace_member_key = key;
 
-            const auto &root = config.getRoot();
-            if (root["dependencies"]) {
-                for (const auto &dep : root["dependencies"]) {
-                    if (dep["name"]) {
-                        info.dependencies.push_back(dep["name"].as<std::string>());
-                    }
+            for (const auto &dep : config.snapshot().dependencies) {
+                if (!dep.name.empty()) {
+                    info.dependencies.push_back(dep.name);
                 }
             }
             packages[name] = info;
@@ -110,17 +113,17 @@ std::vector<WorkspaceMember> buildOrderTopSort(const Workspace &ws) {
 bool depMissing(const utils::yaml::Configuration &config) {
     catalyst::logger.log(LogLevel::DEBUG, "Checking for missing dependencies.");
     fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
-    if (!config.has("dependencies")) {
+    const auto &deps = config.snapshot().dependencies;
+    if (deps.empty()) {
         catalyst::logger.log(LogLevel::DEBUG, "No dependencies declared, skipping check.");
         return false;
     }
     // TODO: needs to be updated to respect actual dependency types
-    const auto &pc = config.getRoot();
-    return std::any_of(pc["dependencies"].begin(), pc["dependencies"].end(), [&](const YAML::Node &dep) {
-        if (auto type = dep["source"].as<std::string>(); type == "git") {
-            bool missing = !fs::exists(build_dir / "catalyst-libs" / dep["name"].as<std::string>());
+    return std::ranges::any_of(deps, [&](const utils::yaml::Snapshot::Dependency &dep) {
+        if (dep.source == "git") {
+            bool missing = !fs::exists(build_dir / "catalyst-libs" / dep.name);
             if (missing) {
-                catalyst::logger.log(LogLevel::WARN, "Missing dependency: {}", dep["name"].as<std::string>());
+                catalyst::logger.log(LogLevel::WARN, "Missing dependency: {}", dep.name);
             }
             return missing;
         }
@@ -128,15 +131,46 @@ bool depMissing(const utils::yaml::Configuration &config) {
     });
 }
 
-std::expected<void, std::string> generateCompileCommands(const fs::path &build_dir, const std::string &generator) {
+/// The compile edges of the native backend's graph, as `ninja -t compdb` would list them.
+std::expected<void, std::string> writeCompileCommands(const fs::path &build_dir, const utils::exec::Graph &graph) {
+    const std::string directory = fs::absolute(build_dir).string();
+    nlohmann::json compdb = nlohmann::json::array();
+    for (const auto &edge : graph.edges()) {
+        if (edge.rule != "cc_compile" && edge.rule != "cxx_compile" && edge.rule != "cxx_compile_pch" &&
+            edge.rule != "cxx_module")
+            continue;
+        compdb.push_back({{"directory", directory},
+                          {"command", graph.command(edge)},
+                          {"file", edge.inputs.front()},
+                          {"output", edge.outputs.front()}});
+    }
+    if (auto res = utils::fs::writeIfChanged(build_dir / "compile_commands.json", compdb.dump(2) + "\n"); !res)
+        return std::unexpected(res.error());
+    return {};
+}
+
+std::expected<void, std::string> generateCompileCommands(const fs::path &build_dir,
+                                                         const std::string &generator,
+                                                         const BackendTarget &backend,
+                                                         const utils::exec::Graph &graph) {
+    if (generator == "native")
+        return writeCompileCommands(build_dir, graph);
     if (generator != "ninja") {
         if (auto res = catalyst::processExec({"cbe", "-C", build_dir, "--compdb"}); !res)
             return std::unexpected(res.error());
         return {};
     }
     catalyst::logger.log(LogLevel::INFO, "Generating compile commands database.");
-    auto res =
-        catalyst::processExecStdout({"ninja", "-C", build_dir.string(), "-t", "compdb", "cc_compile", "cxx_compile"});
+    // a config of a shared build graph names its rules after itself
+    const std::string suffix = backend.target.empty() ? "" : "_" + backend.target;
+    auto res = catalyst::processExecStdout({"ninja",
+                                            "-C",
+                                            backend.dir.string(),
+                                            "-t",
+                                            "compdb",
+                                            "cc_compile" + suffix,
+                                            "cxx_compile" + suffix,
+                                            "cxx_compile_pch" + suffix});
     if (!res)
         return std::unexpected(res.error());
 
@@ -149,11 +183,107 @@ std::expected<void, std::string> generateCompileCommands(const fs::path &build_d
     return {};
 }
 
+/// From the build file's edges and `.ninja_log`, if ninja ran anything; the native backend reports its own.
+void reportNinjaCriticalPath(const fs::path &build_dir, fs::file_time_type log_before) {
+    std::error_code ec;
+    if (fs::last_write_time(build_dir / ".ninja_log", ec) == log_before || ec)
+        return;
+    auto edges = utils::exec::readNinjaEdges(build_dir / "build.ninja");
+    if (!edges) {
+        catalyst::logger.log(LogLevel::DEBUG, "No critical path: {}", edges.error());
+        return;
+    }
+    auto path = utils::exec::criticalPath(*edges, utils::exec::ninjaDurations(build_dir));
+    if (!path.empty())
+        catalyst::logger.log(LogLevel::INFO, "{}", utils::exec::formatCriticalPath(path));
+}
+
+/// The commands ninja ran this time, from the lines it appended to `.ninja_log` after `log_size`, with their times
+/// moved from ninja's clock to the recorder's by when ninja was started. Ninja has no worker slots; lanes are
+/// assigned by overlap.
+void recordNinjaCommands(const fs::path &build_dir, std::uintmax_t log_size, std::int64_t started_us) {
+    std::error_code ec;
+    if (auto size = fs::file_size(build_dir / ".ninja_log", ec); ec || size < log_size) {
+        catalyst::logger.log(LogLevel::DEBUG, "No command timings: .ninja_log is missing or was recompacted.");
+        return;
+    }
+    std::unordered_map<std::string, std::string> rules;
+    if (auto edges = utils::exec::readNinjaEdges(build_dir / "build.ninja")) {
+        for (const auto &edge : *edges) {
+            for (const auto &output : edge.outputs)
+                rules.emplace(output, edge.rule);
+        }
+    }
+    std::vector<utils::trace::Span> commands;
+    for (auto &entry : utils::exec::ninjaLogEntries(build_dir, log_size)) {
+        auto rule = rules.find(entry.output);
+        commands.push_back({.name = std::move(entry.output),
+                            .category = rule != rules.end() ? rule->second : "command",
+                            .start_us = started_us + entry.start_ms * 1000,
+                            .end_us = started_us + entry.end_ms * 1000,
+                            .lane = 0});
+    }
+    utils::trace::assignLanes(commands);
+    for (auto &command : commands)
+        utils::trace::recorder.add(std::move(command));
+}
+
+/// `manifest.build.time_trace`: sum up the traces the compiles left next to their objects into
+/// `<build>/timings/time-trace.txt`.
+std::expected<void, std::string> reportTimeTraces(const utils::yaml::Configuration &config,
+                                                  const fs::path &build_dir,
+                                                  const ParallelSettings &parallel) {
+    auto options = generate::timeTraceOptions(config);
+    if (!options)
+        return std::unexpected(options.error());
+    if (!options->enabled)
+        return {};
+    utils::trace::Phase span{"time trace report"};
+    auto traces = utils::trace::findTimeTraces(build_dir / "obj");
+    if (traces.empty()) {
+        catalyst::logger.log(LogLevel::WARN,
+                             "manifest.build.time_trace is enabled, but no compile wrote a trace; it needs clang.");
+        return {};
+    }
+    auto report = utils::trace::aggregateTimeTraces(traces, parallel.jobs);
+    const fs::path report_path = build_dir / "timings" / "time-trace.txt";
+    std::error_code ec;
+    fs::create_directories(report_path.parent_path(), ec);
+    if (auto res = utils::fs::writeIfChanged(
+            report_path, utils::trace::formatTimeTraceReport(report, fs::current_path(), options->top));
+        !res)
+        return std::unexpected(res.error());
+    catalyst::logger.log(
+        LogLevel::INFO, "Summed up {} compile time traces in {}", report.units.size(), report_path.string());
+    return {};
+}
+
+/// `--timings`: what was recorded while building the package, as a Chrome trace and an HTML page in `<build>/timings`.
+void writeTimings(const fs::path &build_dir, const utils::yaml::Configuration &config, const Parse &parse_args) {
+    std::string profiles;
+    for (const auto &profile : parse_args.profiles)
+        profiles += (profiles.empty() ? "" : ",") + profile;
+    auto html = utils::trace::writeReports(
+        build_dir / "timings",
+        utils::trace::recorder.take(),
+        std::format("Build timings: {} ({})", config.getString("manifest.name").value_or("name"), profiles));
+    if (!html)
+        catalyst::logger.log(LogLevel::WARN, "Failed to write timings: {}", html.error());
+    else
+        catalyst::logger.log(LogLevel::INFO, "Timings written to {}", html->string());
+}
+
+std::expected<void, std::string>
+buildPackage(const Parse &parse_args, const utils::yaml::Configuration &config, const fs::path &build_dir);
+
 } // namespace
 
 std::expected<void, std::string> action(const Parse &parse_args) {
     catalyst::logger.log(LogLevel::DEBUG, "Build subcommand invoked.");
 
+    if (parse_args.watch)
+        return watch(parse_args);
+
     if (parse_args.workspace) {
         fs::path current = fs::current_path();
         bool is_root = false;
@@ -169,21 +299,15 @@ std::expected<void, std::string> action(const Parse &parse_args) {
 
             std::vector<WorkspaceMember> targets;
             if (!parse_args.package.empty()) {
-                // Find specific package
-                // We need to match manifest name, but order contains WorkspaceMembers which have keys/paths
-                // get_build_order returns members sorted.
-                // We need to map package name -> member.
-                // Re-loading config is inefficient but safe.
-                // Optimization: get_build_order could return (Member, PackageName) pair.
-                // For now, let's just loop.
+                // the member configurations are composed once, by buildOrderTopSort, and shared with findPackage
                 bool found = false;
-                for (const auto &m : order) {
-                    utils::yaml::Configuration c(m.profiles.empty() ? std::vector<std::string>{"common"} : m.profiles,
-                                                m.path);
-                    if (c.getString("manifest.name").value_or("") == parse_args.package) {
-                        targets.push_back(m);
-                        found = true;
-                        break;
+                if (auto member = parse_args.workspace->findPackage(parse_args.package)) {
+                    for (const auto &m : order) {
+                        if (m.name == member->name) {
+                            targets.push_back(m);
+                            found = true;
+                            break;
+                        }
                     }
                 }
                 if (!found)
@@ -217,9 +341,23 @@ std::expected<void, std::string> action(const Parse &parse_args) {
         }
     }
 
+    if (parse_args.timings)
+        utils::trace::recorder.enable();
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
+    utils::trace::Phase compose_span{"compose profiles"};
     utils::yaml::Configuration config{parse_args.profiles};
+    compose_span.end();
 
+    fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
+    auto res = buildPackage(parse_args, config, build_dir);
+    if (parse_args.timings)
+        writeTimings(build_dir, config, parse_args);
+    return res;
+}
+
+namespace {
+std::expected<void, std::string>
+buildPackage(const Parse &parse_args, const utils::yaml::Configuration &config, const fs::path &build_dir) {
     catalyst::logger.log(LogLevel::INFO, "Running pre-build hooks.");
     if (auto res = hooks::preBuild(config); !res) {
         catalyst::logger.log(LogLevel::ERROR, "Pre-build hook failed: {}", res.error());
@@ -231,15 +369,24 @@ std::expected<void, std::string> action(const Parse &parse_args) {
         return res;
     }
 
-    fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
-    std::string generator = config.getString("meta.generator").value_or("cbe");
-    std::string build_filename = (generator == "ninja") ? "build.ninja" : "catalyst.build";
-
-    if (!fs::exists(build_dir / build_filename) || parse_args.regen) {
-        catalyst::logger.log(LogLevel::INFO, "Generating build files.");
+    std::string generator =
+        parse_args.backend.empty() ? config.getString("meta.generator").value_or("cbe") : parse_args.backend;
+    const BackendTarget backend = backendTarget(generator, parse_args.profiles, config);
+    // the native backend has no build file to come back to: its graph is regenerated, mostly from caches, every time
+    const bool native = generator == "native";
+    utils::exec::Graph graph;
+
+    // generation runs on every build: it compares the generate fingerprint (profiles, sources, includes and imports)
+    // and only writes the build file again, and runs the generate hooks, when that changed, so an edited #include or
+    // import is never missed
+    {
+        catalyst::logger.log(LogLevel::INFO, "Checking build files.");
+        utils::trace::Phase generate_span{"generate"};
         auto res = catalyst::generate::action({.profiles = parse_args.profiles,
                                                .enabled_features = parse_args.enabled_features,
-                                               .backend = parse_args.backend});
+                                               .backend = parse_args.backend,
+                                               .force = parse_args.regen,
+                                               .graph = native ? &graph : nullptr});
         if (!res) {
             catalyst::logger.log(LogLevel::ERROR, "Failed to generate build files: {}", res.error());
             if (auto hook_res = hooks::onBuildFailure(config); !hook_res) {
@@ -258,6 +405,7 @@ std::expected<void, std::string> action(const Parse &parse_args) {
             fs::remove_all(fs::path{build_dir / "catalyst-libs"}); // cleanup
         }
         catalyst::logger.log(LogLevel::INFO, "Fetching dependencies.");
+        utils::trace::Phase fetch_span{"fetch"};
         if (auto res = catalyst::fetch::action({.profiles = parse_args.profiles, .workspace = parse_args.workspace});
             !res) {
             catalyst::logger.log(LogLevel::ERROR, "Failed to fetch dependencies: {}", res.error());
@@ -270,22 +418,60 @@ std::expected<void, std::string> action(const Parse &parse_args) {
         }
     }
 
-    catalyst::logger.log(LogLevel::INFO, "Building project.");
-    std::vector<std::string> build_command = {generator, "-C", build_dir};
+    auto parallel = parallelSettings(config, parse_args);
+    if (!parallel)
+        return std::unexpected(parallel.error());
 
-    if (int res = catalyst::processExec(std::move(build_command)).value().get(); res != 0) {
-        catalyst::logger.log(LogLevel::ERROR, "Failed to build project.");
-        if (auto hook_res = hooks::onBuildFailure(config); !hook_res) {
-            catalyst::logger.log(LogLevel::ERROR, "on_build_failure hook failed: {}", hook_res.error());
-            return std::unexpected(
-                "Failed to build project.\nAdditionally, the on_build_failure hook failed with error: " +
-                hook_res.error());
+    std::error_code ec;
+    const auto ninja_log_before = fs::last_write_time(backend.dir / ".ninja_log", ec);
+    std::uintmax_t ninja_log_size = fs::file_size(backend.dir / ".ninja_log", ec);
+    if (ec)
+        ninja_log_size = 0;
+    catalyst::logger.log(LogLevel::INFO, "Building project.");
+    utils::trace::Phase build_span{"build"};
+    if (native) {
+        auto summary = executeNative(graph, build_dir, config, *parallel);
+        if (!summary) {
+            catalyst::logger.log(LogLevel::ERROR, "Failed to build project.");
+            if (auto hook_res = hooks::onBuildFailure(config); !hook_res) {
+                catalyst::logger.log(LogLevel::ERROR, "on_build_failure hook failed: {}", hook_res.error());
+                return std::unexpected(
+                    "Failed to build project.\nAdditionally, the on_build_failure hook failed with error: " +
+                    hook_res.error());
+            }
+            return std::unexpected(std::format("Build process failed. {}", summary.error()));
+        }
+        catalyst::logger.log(
+            LogLevel::DEBUG, "Ran {} commands, {} were up to date.", summary->ran, summary->up_to_date);
+        if (summary->ran != 0 && !summary->critical_path.empty())
+            catalyst::logger.log(LogLevel::INFO, "{}", utils::exec::formatCriticalPath(summary->critical_path));
+    } else {
+        const std::int64_t started_us = utils::trace::recorder.nowUs();
+        int res =
+            catalyst::processExec(backendCommand(generator, backend.dir, *parallel, backend.target)).value().get();
+        if (generator == "ninja" && utils::trace::recorder.enabled())
+            recordNinjaCommands(backend.dir, ninja_log_size, started_us);
+        if (res != 0) {
+            catalyst::logger.log(LogLevel::ERROR, "Failed to build project.");
+            if (auto hook_res = hooks::onBuildFailure(config); !hook_res) {
+                catalyst::logger.log(LogLevel::ERROR, "on_build_failure hook failed: {}", hook_res.error());
+                return std::unexpected(
+                    "Failed to build project.\nAdditionally, the on_build_failure hook failed with error: " +
+                    hook_res.error());
+            }
+            return std::unexpected(std::format("Build process failed. {} exited with code: {}", generator, res));
         }
-        return std::unexpected(std::format("Build process failed. {} exited with code: {}", generator, res));
     }
+    build_span.end();
+
+    if (generator == "ninja")
+        reportNinjaCriticalPath(backend.dir, ninja_log_before);
+    if (auto res = reportTimeTraces(config, build_dir, *parallel); !res)
+        catalyst::logger.log(LogLevel::WARN, "No time trace report: {}", res.error());
 
     catalyst::logger.log(LogLevel::INFO, "Generating compile commands.");
-    if (auto res = generateCompileCommands(build_dir, generator); !res) {
+    utils::trace::Phase compdb_span{"compile commands"};
+    if (auto res = generateCompileCommands(build_dir, generator, backend, graph); !res) {
         catalyst::logger.log(LogLevel::ERROR, "Failed to generate compile commands: {}", res.error());
         if (auto hook_res = hooks::onBuildFailure(config); !hook_res) {
             catalyst::logger.log(LogLevel::ERROR, "on_build_failure hook failed: {}", hook_res.error());
@@ -294,6 +480,10 @@ std::expected<void, std::string> action(const Parse &parse_args) {
         }
         return res;
     }
+    compdb_span.end();
+
+    if (auto res = utils::yaml::linkCurrent(config.snapshot()); !res)
+        catalyst::logger.log(LogLevel::WARN, "{}", res.error());
 
     catalyst::logger.log(LogLevel::INFO, "Running post-build hooks.");
     if (auto res = hooks::postBuild(config); !res) {
@@ -309,4 +499,6 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     return {};
 }
 
+} // namespace
+
 } // namespace catalyst::build
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+
+#include "catalyst/subcommands/build.hpp"
+#include "catalyst/utils/cache/object_cache.hpp"
+#include "catalyst/utils/cache/remote_cache.hpp"
+#include "catalyst/utils/exec/executor.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+#include "catalyst/utils/exec/resources.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::build {
+namespace fs = std::filesystem;
+
+namespace {
+constexpr int default_cache_mb = 5 * 1024;
+} // namespace
+
+std::expected<CacheSettings, std::string> cacheSettings(const utils::yaml::Configuration &config) {
+    CacheSettings settings;
+    settings.enabled = config.getBool("manifest.build.cache.enabled").value_or(false);
+    settings.dir = config.getString("manifest.build.cache.dir").value_or("");
+    if (settings.dir.empty())
+        settings.dir = utils::cache::defaultCacheDir();
+    int max_mb = config.getInt("manifest.build.cache.max_size_mb").value_or(default_cache_mb);
+    if (max_mb <= 0)
+        return std::unexpected(std::format("manifest.build.cache.max_size_mb must be positive, got {}", max_mb));
+    settings.max_bytes = static_cast<std::uint64_t>(max_mb) * 1024 * 1024;
+
+    settings.remote_url = config.getString("manifest.build.cache.remote.url").value_or("");
+    if (!settings.remote_url.empty() && !settings.remote_url.starts_with("http://") &&
+        !settings.remote_url.starts_with("https://") && !settings.remote_url.starts_with("file://"))
+        return std::unexpected(std::format("manifest.build.cache.remote.url must be an http://, https:// or file:// "
+                                           "URL, got '{}'",
+                                           settings.remote_url));
+    std::string mode = config.getString("manifest.build.cache.remote.mode").value_or("read");
+    if (mode != "read" && mode != "write")
+        return std::unexpected(std::format("manifest.build.cache.remote.mode must be read or write, got '{}'", mode));
+    settings.remote_writable = mode == "write";
+    return settings;
+}
+
+std::expected<utils::exec::ExecuteSummary, std::string> executeNative(const utils::exec::Graph &graph,
+                                                                      const fs::path &build_dir,
+                                                                      const utils::yaml::Configuration &config,
+                                                                      const ParallelSettings &parallel) {
+    utils::exec::ExecuteOptions options{.build_dir = build_dir,
+                                        .jobs = parallel.jobs,
+                                        .targets = {},
+                                        .cache = nullptr,
+                                        .cacheable_rules = {},
+                                        .memory_budget_kb = utils::exec::physicalMemoryKb() / 100 *
+                                                            parallel.memory_percent,
+                                        .max_load = parallel.load};
+    if (options.memory_budget_kb != 0)
+        catalyst::logger.log(LogLevel::DEBUG, "Memory budget: {} MiB.", options.memory_budget_kb / 1024);
+    auto settings = cacheSettings(config);
+    if (!settings)
+        return std::unexpected(settings.error());
+    std::optional<utils::cache::RemoteCache> remote;
+    std::optional<utils::cache::ObjectCache> cache;
+    if (settings->enabled) {
+        if (!settings->remote_url.empty()) {
+            remote.emplace(settings->remote_url, settings->remote_writable);
+            catalyst::logger.log(LogLevel::DEBUG,
+                                 "Using the remote cache at {} ({}).",
+                                 settings->remote_url,
+                                 settings->remote_writable ? "read-write" : "read-only");
+        }
+        cache.emplace(settings->dir, settings->max_bytes, remote ? &*remote : nullptr);
+        catalyst::logger.log(LogLevel::DEBUG, "Using the object cache in {}.", settings->dir.string());
+        options.cache = &*cache;
+        // not module interfaces or precompiled headers: compilers validate them against the files and flags that
+        // made them, so a copy from another tree is likely to be rejected
+        options.cacheable_rules = {
+            "cc_compile", "cxx_compile", "cxx_compile_pch", "static_link", "shared_link", "binary_link"};
+    }
+    return utils::exec::execute(graph, options);
+}
+} // namespace catalyst::build
@@ -0,0 +1,74 @@
+#include <charconv>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "catalyst/subcommands/build.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::build {
+namespace fs = std::filesystem;
+
+std::expected<ParallelSettings, std::string> parallelSettings(const utils::yaml::Configuration &config,
+                                                              const Parse &parse_args) {
+    ParallelSettings settings;
+    settings.jobs = parse_args.jobs;
+    if (auto jobs = config.getInt("manifest.build.parallel.jobs"); jobs && settings.jobs == 0) {
+        if (*jobs < 0)
+            return std::unexpected(std::format("manifest.build.parallel.jobs must not be negative, got {}", *jobs));
+        settings.jobs = static_cast<unsigned>(*jobs);
+    }
+
+    settings.load = parse_args.load;
+    if (auto load = config.getString("manifest.build.parallel.load"); load && settings.load == 0) {
+        auto [ptr, ec] = std::from_chars(load->data(), load->data() + load->size(), settings.load);
+        if (ec != std::errc{} || ptr != load->data() + load->size() || settings.load < 0)
+            return std::unexpected(
+                std::format("manifest.build.parallel.load must be a non-negative number, got '{}'", *load));
+    }
+
+    if (auto percent = config.getInt("manifest.build.parallel.memory_percent")) {
+        if (*percent < 0 || *percent > 100)
+            return std::unexpected(
+                std::format("manifest.build.parallel.memory_percent must be between 0 and 100, got {}", *percent));
+        settings.memory_percent = static_cast<unsigned>(*percent);
+    }
+    return settings;
+}
+
+BackendTarget backendTarget(const std::string &generator,
+                            const std::vector<std::string> &profiles,
+                            const utils::yaml::Configuration &config) {
+    const fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
+    if (generator == "ninja") {
+        if (auto name = utils::yaml::multiConfigName(profiles, config.snapshot()))
+            return {.dir = build_dir.parent_path(), .target = *name};
+    }
+    return {.dir = build_dir, .target = ""};
+}
+
+std::vector<std::string> backendCommand(const std::string &generator,
+                                        const fs::path &build_dir,
+                                        const ParallelSettings &settings,
+                                        const std::string &target) {
+    std::vector<std::string> command{generator, "-C", build_dir.string()};
+    if (generator == "cbe") {
+        if (settings.jobs != 0 || settings.load != 0)
+            catalyst::logger.log(LogLevel::WARN, "cbe chooses its own parallelism; ignoring the jobs and load limits.");
+    } else {
+        // ninja and make spell them alike
+        if (settings.jobs != 0)
+            command.push_back(std::format("-j{}", settings.jobs));
+        if (settings.load != 0)
+            command.push_back(std::format("-l{}", settings.load));
+    }
+    if (!target.empty())
+        command.push_back(target);
+    return command;
+}
+} // namespace catalyst::build
@@ -1,6 +1,7 @@
 #include <vector>
 
 #include <CLI/App.hpp>
+#include <CLI/Validators.hpp>
 
 #include "catalyst/subcommands/build.hpp"
 
@@ -18,7 +19,17 @@ std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app) {
         ->default_val(std::vector{"common"});
     build->add_option("-f,--features", ret->enabled_features, "Features to enable.")
         ->default_val(std::vector<std::string>{});
-    build->add_option("--backend", ret->backend, "Backend to use for generation (ninja, gmake, cbe).");
+    build->add_option("--backend", ret->backend, "Backend to use for generation (ninja, gmake, cbe, native).");
+    build->add_option("-j,--jobs", ret->jobs, "Commands to run at once (0: the backend's default).")
+        ->check(CLI::NonNegativeNumber);
+    build->add_option("-l,--load", ret->load, "Start no new command while the load average is above this.")
+        ->check(CLI::NonNegativeNumber);
+    build->add_flag("--timings", ret->timings, "Write a timeline of the build to <build>/timings.")
+        ->default_val(false);
+    build->add_flag("-w,--watch", ret->watch, "Rebuild whenever a source, header or profile changes.")
+        ->default_val(false);
+    build->add_option("--then", ret->watch_then, "With --watch, run this after every successful build (test, run).")
+        ->check(CLI::IsMember({"test", "run"}));
     return {build, std::move(ret)};
 }
 } // namespace catalyst::build
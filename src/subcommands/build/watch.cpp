@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <chrono>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/process_exec.hpp"
+#include "catalyst/subcommands/build.hpp"
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/subcommands/run.hpp"
+#include "catalyst/subcommands/test.hpp"
+#include "catalyst/utils/exec/executor.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+#include "catalyst/utils/fs/scan_cache.hpp"
+#include "catalyst/utils/fs/watcher.hpp"
+#include "catalyst/utils/includes/scanner.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::build {
+namespace fs = std::filesystem;
+
+namespace {
+/// Changes in one batch must be quiet this long before a build starts.
+constexpr std::chrono::milliseconds debounce{150};
+/// A continuous stream of changes (e.g. a large checkout) is still built at least this often.
+constexpr std::chrono::milliseconds max_batch_delay{2000};
+
+/// Everything a build cycle needs, composed once and kept until the profiles change.
+struct Resident {
+    utils::yaml::Configuration config;
+    fs::path build_dir;
+    std::string generator;
+    BackendTarget backend;
+    ParallelSettings parallel;
+    std::vector<std::string> source_dirs;  ///< absolute
+    std::vector<std::string> include_dirs; ///< absolute
+    std::vector<fs::path> source_set;
+    std::string include_digest; ///< of the include graph the build file was generated from
+    std::optional<utils::exec::Graph> graph; ///< native backend: generated on first use, dropped on regeneration
+};
+
+bool isProfileFile(const fs::path &path) {
+    std::string name = path.filename().string();
+    return name == "CATALYST.yaml" || name == "catalyst.yaml" ||
+           (name.starts_with("catalyst_") && name.ends_with(".yaml"));
+}
+
+/// The include and import digest of the resident source set. Only files changed since the last scan are read again,
+/// through the same cache generate fills, so this costs a stat per file rather than a generation.
+std::string includeDigest(const Resident &resident) {
+    std::vector<fs::path> include_dirs{resident.include_dirs.begin(), resident.include_dirs.end()};
+    return utils::includes::IncludeGraph::scan(
+               resident.source_set, include_dirs, utils::includes::includeCachePath(resident.build_dir))
+        .digest();
+}
+
+std::expected<Resident, std::string> loadResident(const Parse &parse_args) {
+    Resident resident;
+    try {
+        resident.config = utils::yaml::Configuration{parse_args.profiles};
+    } catch (const std::runtime_error &err) {
+        return std::unexpected(err.what());
+    }
+    resident.build_dir = resident.config.getString("manifest.dirs.build").value_or("build");
+    resident.generator = parse_args.backend;
+    if (resident.generator.empty())
+        resident.generator = resident.config.getString("meta.generator").value_or("cbe");
+    resident.backend = backendTarget(resident.generator, parse_args.profiles, resident.config);
+    auto parallel = parallelSettings(resident.config, parse_args);
+    if (!parallel)
+        return std::unexpected(parallel.error());
+    resident.parallel = *parallel;
+
+    fs::path current_dir = fs::current_path();
+    for (const auto &dir : resident.config.getStringVector("manifest.dirs.source").value_or(std::vector<std::string>{}))
+        resident.source_dirs.push_back((current_dir / dir).string());
+    for (const auto &dir : resident.config.getStringVector("manifest.dirs.include").value_or(std::vector<std::string>{}))
+        resident.include_dirs.push_back((current_dir / dir).string());
+
+    utils::fs::ScanCache scan_cache{utils::fs::scanCachePath(resident.build_dir)};
+    auto source_set = generate::buildSourceSet(resident.source_dirs, parse_args.profiles, &scan_cache);
+    if (!source_set)
+        return std::unexpected(source_set.error());
+    resident.source_set = std::move(*source_set);
+    if (auto res = scan_cache.save(); !res)
+        catalyst::logger.log(LogLevel::WARN, "Failed to save scan cache: {}", res.error());
+    resident.include_digest = includeDigest(resident);
+    return resident;
+}
+
+std::expected<utils::fs::Watcher, std::string> watchResident(const Resident &resident) {
+    auto watcher = utils::fs::Watcher::create();
+    if (!watcher)
+        return watcher;
+    // the project root only for profile files; the source and include trees in full
+    if (auto res = watcher->addDir(fs::current_path()); !res)
+        return std::unexpected(res.error());
+    for (const auto &dirs : {resident.source_dirs, resident.include_dirs}) {
+        for (const auto &dir : dirs) {
+            if (!fs::is_directory(dir))
+                continue;
+            if (auto res = watcher->addTree(dir); !res)
+                return std::unexpected(res.error());
+        }
+    }
+    catalyst::logger.log(LogLevel::DEBUG, "Watching {} directories.", watcher->size());
+    return watcher;
+}
+
+std::expected<void, std::string> runBackend(Resident &resident, const Parse &parse_args) {
+    if (resident.generator == "native") {
+        if (!resident.graph) {
+            utils::exec::Graph graph;
+            if (auto res = generate::action({.profiles = parse_args.profiles,
+                                             .enabled_features = parse_args.enabled_features,
+                                             .backend = parse_args.backend,
+                                             .graph = &graph});
+                !res)
+                return std::unexpected(std::format("Failed to generate build files: {}", res.error()));
+            resident.graph = std::move(graph);
+        }
+        catalyst::logger.log(LogLevel::INFO, "Building project.");
+        auto summary = executeNative(*resident.graph, resident.build_dir, resident.config, resident.parallel);
+        if (!summary)
+            return std::unexpected(std::format("Build process failed. {}", summary.error()));
+        return {};
+    }
+    catalyst::logger.log(LogLevel::INFO, "Building project.");
+    auto proc = catalyst::processExec(
+        backendCommand(resident.generator, resident.backend.dir, resident.parallel, resident.backend.target));
+    if (!proc)
+        return std::unexpected(proc.error());
+    if (int res = proc->get(); res != 0)
+        return std::unexpected(std::format("Build process failed. {} exited with code: {}", resident.generator, res));
+    return {};
+}
+
+std::expected<void, std::string> runAfterBuild(const Parse &parse_args) {
+    if (parse_args.watch_then == "test")
+        return test::action({});
+    if (parse_args.watch_then == "run")
+        return run::action({.profile = parse_args.profiles.back(), .params = {}});
+    return {};
+}
+
+/// The per-cycle outcome is only logged: a broken build must not end the watch.
+void report(const std::expected<void, std::string> &res, const Parse &parse_args) {
+    if (!res) {
+        catalyst::logger.log(LogLevel::ERROR, "{}", res.error());
+        return;
+    }
+    if (auto then_res = runAfterBuild(parse_args); !then_res)
+        catalyst::logger.log(LogLevel::ERROR, "{}", then_res.error());
+}
+} // namespace
+
+std::expected<void, std::string> watch(const Parse &parse_args) {
+    if (parse_args.workspace_build || !parse_args.package.empty())
+        return std::unexpected("--watch builds a single package; run it from the member's directory.");
+
+    // the first build goes through the full pipeline: hooks, generation and fetching
+    Parse once = parse_args;
+    once.watch = false;
+    report(action(once), parse_args);
+
+    auto resident = loadResident(parse_args);
+    if (!resident)
+        return std::unexpected(resident.error());
+    auto watcher = watchResident(*resident);
+    if (!watcher)
+        return std::unexpected(watcher.error());
+    catalyst::logger.log(LogLevel::INFO, "Watching for changes. Press Ctrl-C to stop.");
+
+    while (true) {
+        auto batch = watcher->wait(debounce, max_batch_delay);
+        if (!batch)
+            return std::unexpected(batch.error());
+
+        bool profiles_changed = false;
+        bool tree_changed = batch->overflow;
+        bool contents_changed = batch->overflow;
+        for (const auto &event : batch->events) {
+            if (event.path.parent_path() == fs::current_path()) {
+                profiles_changed |= isProfileFile(event.path);
+                continue; // other files in the project root are not inputs
+            }
+            if (event.path.filename() == ".catalystignore" || event.is_dir ||
+                event.kind != utils::fs::WatchEvent::Kind::Modified)
+                tree_changed = true;
+            else
+                contents_changed = true;
+        }
+
+        if (profiles_changed) {
+            // the composition itself changed: hooks, dependencies and directories may all differ
+            catalyst::logger.log(LogLevel::INFO, "Profiles changed, reloading.");
+            Parse reload = once;
+            reload.regen = true;
+            report(action(reload), parse_args);
+            if (auto reloaded = loadResident(parse_args); reloaded) {
+                resident = std::move(reloaded);
+                if (auto rewatched = watchResident(*resident); rewatched)
+                    watcher = std::move(rewatched);
+                else
+                    catalyst::logger.log(LogLevel::ERROR, "{}", rewatched.error());
+            } else {
+                catalyst::logger.log(LogLevel::ERROR, "Failed to reload profiles: {}", reloaded.error());
+            }
+            continue;
+        }
+
+        bool regenerate = false;
+        if (tree_changed) {
+            utils::fs::ScanCache scan_cache{utils::fs::scanCachePath(resident->build_dir)};
+            auto source_set = generate::buildSourceSet(resident->source_dirs, parse_args.profiles, &scan_cache);
+            if (!source_set) {
+                catalyst::logger.log(LogLevel::ERROR, "Failed to build source set: {}", source_set.error());
+                continue;
+            }
+            if (auto res = scan_cache.save(); !res)
+                catalyst::logger.log(LogLevel::WARN, "Failed to save scan cache: {}", res.error());
+            regenerate = *source_set != resident->source_set;
+            resident->source_set = std::move(*source_set);
+        }
+        if (!regenerate && !contents_changed && !tree_changed)
+            continue;
+
+        if (regenerate)
+            catalyst::logger.log(LogLevel::INFO, "Source set changed, regenerating build files.");
+        // an edit may have added an #include or import, which the build file must know about; the resident digest
+        // answers that without composing profiles or running hooks
+        std::string include_digest = includeDigest(*resident);
+        if (!regenerate && include_digest != resident->include_digest) {
+            catalyst::logger.log(LogLevel::INFO, "Includes or imports changed, regenerating build files.");
+            regenerate = true;
+        }
+        if (regenerate && resident->generator == "native") {
+            resident->graph.reset(); // runBackend generates it again
+        } else if (regenerate) {
+            if (auto res = generate::action({.profiles = parse_args.profiles,
+                                             .enabled_features = parse_args.enabled_features,
+                                             .backend = parse_args.backend});
+                !res) {
+                catalyst::logger.log(LogLevel::ERROR, "Failed to generate build files: {}", res.error());
+                continue;
+            }
+        }
+        resident->include_digest = std::move(include_digest);
+        report(runBackend(*resident, parse_args), parse_args);
+    }
+}
+} // namespace catalyst::build
@@ -0,0 +1,30 @@
+#include "catalyst/subcommands/cache.hpp"
+
+namespace catalyst::cache {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app) {
+    CLI::App *cache = app.add_subcommand("cache", "Inspect the object cache.");
+    cache->require_subcommand(1);
+    auto ret = std::make_unique<Parse>();
+    return {cache, std::move(ret)};
+}
+
+namespace stats {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &cache) {
+    CLI::App *stats = cache.add_subcommand("stats", "Show the object cache's size and hit rate.");
+    auto ret = std::make_unique<Parse>();
+    stats->add_option("-p,--profiles", ret->profiles, "Profiles that configure the cache (default: common)");
+    return {stats, std::move(ret)};
+}
+} // namespace stats
+
+namespace serve {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &cache) {
+    CLI::App *serve = cache.add_subcommand("serve", "Serve a directory as a remote cache over HTTP.");
+    auto ret = std::make_unique<Parse>();
+    serve->add_option("-d,--dir", ret->dir, "Directory to serve (default: ~/.cache/catalyst/remote)");
+    serve->add_option("--bind", ret->bind, "IPv4 address to listen on")->capture_default_str();
+    serve->add_option("--port", ret->port, "Port to listen on")->capture_default_str();
+    return {serve, std::move(ret)};
+}
+} // namespace serve
+} // namespace catalyst::cache
@@ -0,0 +1,18 @@
+#include <expected>
+#include <filesystem>
+#include <string>
+
+#include "catalyst/subcommands/cache.hpp"
+#include "catalyst/utils/cache/http_server.hpp"
+#include "catalyst/utils/fs/user_cache_dir.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::cache::serve {
+namespace fs = std::filesystem;
+
+std::expected<void, std::string> action(const Parse &parse_args) {
+    catalyst::logger.log(LogLevel::DEBUG, "Cache serve subcommand invoked.");
+    const fs::path dir = parse_args.dir.empty() ? utils::fs::userCacheDir() / "remote" : fs::path{parse_args.dir};
+    return utils::cache::serveRemoteCache(dir, parse_args.bind, parse_args.port);
+}
+} // namespace catalyst::cache::serve
@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <print>
+#include <stdexcept>
+#include <string>
+
+#include "catalyst/subcommands/build.hpp"
+#include "catalyst/subcommands/cache.hpp"
+#include "catalyst/utils/cache/object_cache.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::cache::stats {
+namespace fs = std::filesystem;
+
+namespace {
+std::string humanBytes(std::uint64_t bytes) {
+    constexpr const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double size = static_cast<double>(bytes);
+    std::size_t unit = 0;
+    while (size >= 1024 && unit + 1 < std::size(units)) {
+        size /= 1024;
+        ++unit;
+    }
+    return unit == 0 ? std::format("{} B", bytes) : std::format("{:.1f} {}", size, units[unit]);
+}
+} // namespace
+
+std::expected<void, std::string> action(const Parse &parse_args) {
+    catalyst::logger.log(LogLevel::DEBUG, "Cache stats subcommand invoked.");
+
+    // outside a project there is no configuration, only the default cache
+    std::optional<build::CacheSettings> settings;
+    if (fs::exists("CATALYST.yaml") || fs::exists("catalyst.yaml")) {
+        try {
+            auto configured = build::cacheSettings(utils::yaml::Configuration{parse_args.profiles});
+            if (!configured)
+                return std::unexpected(configured.error());
+            settings = std::move(*configured);
+        } catch (const std::runtime_error &err) {
+            return std::unexpected(err.what());
+        }
+    }
+    const fs::path dir = settings ? settings->dir : utils::cache::defaultCacheDir();
+
+    auto stats = utils::cache::ObjectCache::stats(dir);
+    if (!stats)
+        return std::unexpected(stats.error());
+    const std::uint64_t lookups = stats->hits + stats->misses;
+    const double hit_rate = lookups == 0 ? 0.0 : 100.0 * static_cast<double>(stats->hits) / lookups;
+
+    std::println(std::cout, "Cache directory: {}", dir.string());
+    if (settings) {
+        std::println(std::cout, "Enabled:         {}", settings->enabled ? "yes" : "no");
+        std::println(std::cout, "Size:            {} of {}", humanBytes(stats->bytes), humanBytes(settings->max_bytes));
+    } else {
+        std::println(std::cout, "Size:            {}", humanBytes(stats->bytes));
+    }
+    std::println(std::cout, "Hits:            {}", stats->hits);
+    std::println(std::cout, "Misses:          {}", stats->misses);
+    std::println(std::cout, "Hit rate:        {:.1f}%", hit_rate);
+    std::println(std::cout, "Stores:          {}", stats->stores);
+    std::println(std::cout, "Evictions:       {}", stats->evictions);
+    if (settings && !settings->remote_url.empty()) {
+        std::println(std::cout,
+                     "Remote:          {} ({})",
+                     settings->remote_url,
+                     settings->remote_writable ? "read-write" : "read-only");
+    }
+    std::println(std::cout, "Remote hits:     {}", stats->remote_hits);
+    std::println(std::cout, "Uploads:         {}", stats->uploads);
+    return {};
+}
+} // namespace catalyst::cache::stats
@@ -1,14 +1,19 @@
+#include <exception>
+#include <filesystem>
 #include <format>
 #include <string>
+#include <system_error>
 #include <tuple>
 
 #include <catalyst/hooks.hpp>
 #include <catalyst/subcommands/clean.hpp>
-#include <yaml-cpp/node/node.h>
 
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/process_exec.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/exec/build_log.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 namespace catalyst::clean {
 namespace fs = std::filesystem;
@@ -54,13 +59,20 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     }
 
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
-    YAML::Node profile_comp;
-    auto res = generate::profileComposition(profiles);
-    if (!res) {
-        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", res.error());
-        return std::unexpected(res.error());
+    utils::yaml::Configuration profile_comp;
+    try {
+        profile_comp = utils::yaml::Configuration{profiles};
+    } catch (const std::exception &err) {
+        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", err.what());
+        return std::unexpected(err.what());
     }
-    profile_comp = res.value();
+
+    auto built_dir = utils::yaml::builtDir(profile_comp.snapshot(), !parse_args.profiles.empty());
+    if (!built_dir) {
+        catalyst::logger.log(LogLevel::ERROR, "{}", built_dir.error());
+        return std::unexpected(built_dir.error());
+    }
+    const std::string build_dir = built_dir->string();
 
     catalyst::logger.log(LogLevel::DEBUG, "Running pre-clean hooks.");
     if (auto res = hooks::preClean(profile_comp); !res) {
@@ -68,8 +80,7 @@ std::expected<void, std::string> action(const Parse &parse_args) {
         return res;
     }
 
-    auto build_dir = profile_comp["manifest"]["dirs"]["build"].as<std::string>();
-    auto generator = profile_comp["meta"]["generator"].as<std::string>();
+    const std::string &generator = profile_comp.snapshot().meta.generator;
     catalyst::logger.log(LogLevel::DEBUG, "Cleaning build directory: {}", build_dir);
     if (generator == "ninja") {
         if (int rtn = catalyst::processExec({"ninja", "-C", build_dir, "-t", "clean"}).value().get(); rtn != 0) {
@@ -82,6 +93,16 @@ std::expected<void, std::string> action(const Parse &parse_args) {
             catalyst::logger.log(LogLevel::ERROR, "Failed to clean project.");
             return std::unexpected(std::format("Command: cbe -d {} --clean failed with exit code: {}", build_dir, rtn));
         }
+    } else if (generator == "native") {
+        // everything the native executor built is in its log; forgetting the log makes the next build a full one
+        const fs::path log_dir = utils::exec::buildLogDir(build_dir);
+        std::error_code ec;
+        for (const auto &output : utils::exec::BuildLog{log_dir}.outputs()) {
+            fs::path path{output};
+            fs::remove(path.is_absolute() ? path : fs::path{build_dir} / path, ec);
+        }
+        fs::remove(log_dir / "native_log", ec);
+        fs::remove(log_dir / "native_deps", ec);
     }
 
     catalyst::logger.log(LogLevel::DEBUG, "Running post-clean hooks.");
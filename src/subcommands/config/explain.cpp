@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <expected>
+#include <format>
+#include <iostream>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catalyst/subcommands/config.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::config::explain {
+namespace {
+using utils::yaml::Origin;
+
+std::string describe(const Origin &origin) {
+    std::string label;
+    switch (origin.kind) {
+    case Origin::Kind::Default:
+        label = "default";
+        break;
+    case Origin::Kind::Set:
+        label = "set by " + origin.profile;
+        break;
+    case Origin::Kind::Append:
+        label = "appended by " + origin.profile;
+        break;
+    case Origin::Kind::Remove:
+        return "removed by " + origin.profile;
+    case Origin::Kind::Ignored:
+        label = "ignored from " + origin.profile;
+        break;
+    case Origin::Kind::Derived:
+        label = "derived";
+        break;
+    }
+    // appended items are listed bare, a scalar is quoted so an empty one still shows
+    if (origin.kind == Origin::Kind::Append)
+        return std::format("{:<24} {}", label, origin.value);
+    return std::format("{:<24} '{}'", label, origin.value);
+}
+} // namespace
+
+std::expected<void, std::string> action(const Parse &parse_args) {
+    catalyst::logger.log(LogLevel::DEBUG, "Config explain subcommand invoked.");
+
+    utils::yaml::Configuration config;
+    try {
+        config = utils::yaml::Configuration{parse_args.profiles};
+    } catch (const std::exception &err) {
+        return std::unexpected(err.what());
+    }
+
+    // the key itself, or every key of the section it names
+    const std::string prefix = parse_args.key + '.';
+    std::vector<std::string> keys;
+    for (const auto &[key, history] : config.provenance()) {
+        if (key == parse_args.key || key.starts_with(prefix))
+            keys.push_back(key);
+    }
+    if (keys.empty())
+        return std::unexpected(std::format("No profile or default sets '{}'.", parse_args.key));
+    std::ranges::sort(keys);
+
+    for (const auto &key : keys) {
+        const auto &history = config.provenance().at(key);
+        std::println(std::cout, "{}", key);
+        // a rejected value leaves the one before it in effect
+        std::size_t effective = history.size() - 1;
+        while (effective > 0 && history[effective].kind == Origin::Kind::Ignored)
+            --effective;
+        for (std::size_t ii = 0; ii < history.size(); ++ii)
+            std::println(std::cout, "  {} {}", ii == effective ? "=>" : "  ", describe(history[ii]));
+    }
+    return {};
+}
+} // namespace catalyst::config::explain
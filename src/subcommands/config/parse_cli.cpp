@@ -0,0 +1,20 @@
+#include "catalyst/subcommands/config.hpp"
+
+namespace catalyst::config {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app) {
+    CLI::App *config = app.add_subcommand("config", "Inspect the composed configuration.");
+    config->require_subcommand(1);
+    auto ret = std::make_unique<Parse>();
+    return {config, std::move(ret)};
+}
+
+namespace explain {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &config) {
+    CLI::App *explain = config.add_subcommand("explain", "Show which profile set a key and what it overrode.");
+    auto ret = std::make_unique<Parse>();
+    explain->add_option("key", ret->key, "Dotted key or section, e.g. manifest.tooling.CXX")->required();
+    explain->add_option("-p,--profiles", ret->profiles, "Profiles to compose (default: common)");
+    return {explain, std::move(ret)};
+}
+} // namespace explain
+} // namespace catalyst::config
@@ -74,6 +74,11 @@ std::expected<void, std::string> action(const Parse &args) {
         .profiles = args.profiles,
         .enabled_features = args.enabled_features,
         .backend = "",
+        .jobs = 0,
+        .load = 0,
+        .timings = false,
+        .watch = false,
+        .watch_then = "",
         .workspace = std::nullopt,
     };
 
@@ -131,91 +131,88 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     }
 
     std::string build_dir = config.getString("manifest.dirs.build").value_or("build");
-    if (auto deps = config.getRoot()["dependencies"]; deps && deps.IsSequence()) {
-        for (int ii = 0; auto dep : deps) {
-            if (!dep["name"]) {
-                catalyst::logger.log(LogLevel::ERROR, "Dependency: {} does not define field: name", ii);
-                return std::unexpected(std::format("Dependency: {} does not define field: name", ii));
-            }
-            if (!dep["source"]) {
-                catalyst::logger.log(
-                    LogLevel::ERROR, "Dependency: {} does not define field: source", dep["name"].as<std::string>());
-                return std::unexpected(
-                    std::format("Dependency: {} does not define field: source", dep["name"].as<std::string>()));
-            }
-            auto name = dep["name"].as<std::string>();
-            auto source = dep["source"].as<std::string>();
-
-            if (parse_args.workspace) {
-                if (auto member = parse_args.workspace->findPackage(name)) {
-                    catalyst::logger.log(LogLevel::INFO,
-                                         "Dependency '{}' found in workspace at '{}'. Linking...",
-                                         name,
-                                         member->path.string());
-                    fs::path lib_path = fs::path(build_dir) / "catalyst-libs" / name;
-
-                    try {
-                        if (fs::exists(lib_path) || fs::is_symlink(lib_path)) {
-                            if (fs::is_symlink(lib_path)) {
-                                if (fs::read_symlink(lib_path) != member->path) {
-                                    fs::remove(lib_path);
-                                    fs::create_directory_symlink(member->path, lib_path);
-                                }
-                            } else {
-                                fs::remove_all(lib_path);
+    for (int ii = 0; const auto &entry : config.snapshot().dependencies) {
+        const YAML::Node &dep = entry.node;
+        if (entry.name.empty()) {
+            catalyst::logger.log(LogLevel::ERROR, "Dependency: {} does not define field: name", ii);
+            return std::unexpected(std::format("Dependency: {} does not define field: name", ii));
+        }
+        if (entry.source.empty()) {
+            catalyst::logger.log(LogLevel::ERROR, "Dependency: {} does not define field: source", entry.name);
+            return std::unexpected(std::format("Dependency: {} does not define field: source", entry.name));
+        }
+        const std::string &name = entry.name;
+        const std::string &source = entry.source;
+
+        if (parse_args.workspace) {
+            if (auto member = parse_args.workspace->findPackage(name)) {
+                catalyst::logger.log(LogLevel::INFO,
+                                     "Dependency '{}' found in workspace at '{}'. Linking...",
+                                     name,
+                                     member->path.string());
+                fs::path lib_path = fs::path(build_dir) / "catalyst-libs" / name;
+
+                try {
+                    if (fs::exists(lib_path) || fs::is_symlink(lib_path)) {
+                        if (fs::is_symlink(lib_path)) {
+                            if (fs::read_symlink(lib_path) != member->path) {
+                                fs::remove(lib_path);
                                 fs::create_directory_symlink(member->path, lib_path);
                             }
                         } else {
-                            fs::create_directories(lib_path.parent_path());
+                            fs::remove_all(lib_path);
                             fs::create_directory_symlink(member->path, lib_path);
                         }
-                    } catch (const std::exception &e) {
-                        catalyst::logger.log(LogLevel::ERROR, "Failed to link workspace dependency: {}", e.what());
-                        return std::unexpected(e.what());
+                    } else {
+                        fs::create_directories(lib_path.parent_path());
+                        fs::create_directory_symlink(member->path, lib_path);
                     }
-                    continue;
+                } catch (const std::exception &e) {
+                    catalyst::logger.log(LogLevel::ERROR, "Failed to link workspace dependency: {}", e.what());
+                    return std::unexpected(e.what());
                 }
+                continue;
             }
+        }
 
-            catalyst::logger.log(LogLevel::DEBUG, "Fetching dependency '{}' from '{}'", name, source);
-            if (source == "vcpkg") {
-                if (!dep["version"]) {
-                    return std::unexpected(std::format("vcpkg dependency '{}' is missing version.", name));
-                }
-                if (!dep["triplet"]) {
-                    return std::unexpected(std::format("vcpkg dependency '{}' is missing triplet.", name));
-                }
-                if (auto res = fetchVcpkg(name); !res)
-                    return std::unexpected(res.error());
-            } else if (source == "system") {
-                if (auto res = fetchSystem(name); !res)
-                    return std::unexpected(res.error());
-            } else if (source == "local") {
-                if (!dep["path"]) {
-                    return std::unexpected(std::format("Local dependency '{}' is missing path.", name));
-                }
-                auto path = dep["path"].as<std::string>();
-                std::vector<std::string> profiles_vec;
-                if (dep["profiles"] && dep["profiles"].IsSequence()) {
-                    profiles_vec = dep["profiles"].as<std::vector<std::string>>();
-                }
-                if (auto res = fetchLocal(name, path, profiles_vec); !res)
-                    return std::unexpected(res.error());
+        catalyst::logger.log(LogLevel::DEBUG, "Fetching dependency '{}' from '{}'", name, source);
+        if (source == "vcpkg") {
+            if (!dep["version"]) {
+                return std::unexpected(std::format("vcpkg dependency '{}' is missing version.", name));
+            }
+            if (!dep["triplet"]) {
+                return std::unexpected(std::format("vcpkg dependency '{}' is missing triplet.", name));
+            }
+            if (auto res = fetchVcpkg(name); !res)
+                return std::unexpected(res.error());
+        } else if (source == "system") {
+            if (auto res = fetchSystem(name); !res)
+                return std::unexpected(res.error());
+        } else if (source == "local") {
+            if (!dep["path"]) {
+                return std::unexpected(std::format("Local dependency '{}' is missing path.", name));
+            }
+            auto path = dep["path"].as<std::string>();
+            std::vector<std::string> profiles_vec;
+            if (dep["profiles"] && dep["profiles"].IsSequence()) {
+                profiles_vec = dep["profiles"].as<std::vector<std::string>>();
+            }
+            if (auto res = fetchLocal(name, path, profiles_vec); !res)
+                return std::unexpected(res.error());
+        } else {
+            fs::path dep_path = fs::path(build_dir) / "catalyst-libs" / name;
+            if (fs::exists(dep_path)) {
+                std::println(std::cout, "Skipping fetch for existing git dependency: {}", name);
             } else {
-                fs::path dep_path = fs::path(build_dir) / "catalyst-libs" / name;
-                if (fs::exists(dep_path)) {
-                    std::println(std::cout, "Skipping fetch for existing git dependency: {}", name);
-                } else {
-                    if (!dep["version"] || !dep["version"].IsScalar()) {
-                        return std::unexpected(std::format("git dependency '{}' is missing version.", name));
-                    }
-                    auto version = dep["version"].as<std::string>();
-                    if (auto res = fetchGit(build_dir, name, source, version); !res)
-                        return std::unexpected(res.error());
+                if (!dep["version"] || !dep["version"].IsScalar()) {
+                    return std::unexpected(std::format("git dependency '{}' is missing version.", name));
                 }
+                auto version = dep["version"].as<std::string>();
+                if (auto res = fetchGit(build_dir, name, source, version); !res)
+                    return std::unexpected(res.error());
             }
-            ++ii;
         }
+        ++ii;
     }
 
     catalyst::logger.log(LogLevel::DEBUG, "Running post-fetch hooks.");
@@ -1,70 +1,67 @@
 #include <algorithm>
 #include <atomic>
+#include <exception>
 #include <execution>
 #include <filesystem>
 #include <format>
 #include <mutex>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
-#include <yaml-cpp/yaml.h>
-
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/process_exec.hpp"
 #include "catalyst/subcommands/fmt.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/scan_cache.hpp"
+#include "catalyst/utils/fs/walk.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 namespace catalyst::fmt {
 std::expected<void, std::string> action(const Parse &parse_args) {
     catalyst::logger.log(LogLevel::DEBUG, "Fmt subcommand invoked.");
     const std::vector<std::string> &profiles = parse_args.profiles;
-    YAML::Node profile_comp;
+    utils::yaml::Configuration profile_comp;
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
-    auto res = generate::profileComposition(profiles);
-    if (!res) {
-        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", res.error());
-        return std::unexpected(res.error());
+    try {
+        profile_comp = utils::yaml::Configuration{profiles};
+    } catch (const std::exception &err) {
+        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", err.what());
+        return std::unexpected(err.what());
     }
-    profile_comp = res.value();
+    const auto &manifest = profile_comp.snapshot().manifest;
 
-    auto formatter = profile_comp["manifest"]["tooling"]["FMT"].as<std::string>();
+    const std::string &formatter = manifest.tooling.fmt;
     catalyst::logger.log(LogLevel::DEBUG, "Using formatter: {}", formatter);
 
     namespace fs = std::filesystem;
 
-    std::unordered_set<fs::path> source_dirs;
-    std::unordered_set<fs::path> include_dirs;
-
-    for (const auto &node : profile_comp["manifest"]["dirs"]["source"]) {
-        source_dirs.insert(node.as<std::string>());
+    // one walk over both kinds of directory; roots before `num_source_dirs` are source dirs, the rest include dirs
+    fs::path current_dir = fs::current_path();
+    std::vector<fs::path> roots;
+    for (const auto &dir : manifest.dirs.source) {
+        roots.push_back(current_dir / dir);
     }
-
-    for (const auto &node : profile_comp["manifest"]["dirs"]["include"]) {
-        include_dirs.insert(node.as<std::string>());
-    }
-
-    std::vector<std::filesystem::path> files_to_format;
-    for (const auto &dir : source_dirs) {
-        for (const auto &entry : std::filesystem::recursive_directory_iterator(dir)) {
-            if (entry.is_regular_file()) {
-                if (std::string extension = entry.path().extension();
-                    extension == ".cc" || extension == ".cpp" || extension == ".c") {
-                    files_to_format.push_back(entry.path());
-                }
-            }
-        }
+    const std::size_t num_source_dirs = roots.size();
+    for (const auto &dir : manifest.dirs.include) {
+        roots.push_back(current_dir / dir);
     }
 
-    for (const auto &dir : include_dirs) {
-        for (const auto &entry : std::filesystem::recursive_directory_iterator(dir)) {
-            if (entry.is_regular_file()) {
-                if (std::string extension = entry.path().extension(); extension == ".hpp" || extension == ".h") {
-                    files_to_format.push_back(entry.path());
-                }
-            }
-        }
-    }
+    fs::path build_dir = manifest.dirs.build;
+    utils::fs::ScanCache scan_cache{utils::fs::scanCachePath(build_dir)};
+    utils::fs::WalkOptions options;
+    options.cache = &scan_cache;
+    options.keep = [num_source_dirs](const utils::fs::WalkEntry &entry) {
+        std::string extension = entry.name.extension().string();
+        if (entry.root < num_source_dirs)
+            return extension == ".cc" || extension == ".cpp" || extension == ".c";
+        return extension == ".hpp" || extension == ".h";
+    };
+    auto walked = utils::fs::parallelWalk(roots, options);
+    if (!walked)
+        return std::unexpected(walked.error());
+    std::vector<std::filesystem::path> files_to_format = std::move(*walked);
+    if (auto save_res = scan_cache.save(); !save_res)
+        catalyst::logger.log(LogLevel::WARN, "Failed to save scan cache: {}", save_res.error());
 
     std::atomic<bool> formatting_error = false;
     std::string error_message;
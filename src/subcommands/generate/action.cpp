@@ -1,10 +1,18 @@
 #include <sys/wait.h>
 
+#include <algorithm>
 #include <expected>
 #include <filesystem>
-#include <fstream>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -13,6 +21,13 @@
 #include "catalyst/hooks.hpp"
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+#include "catalyst/utils/exec/resources.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/includes/scanner.hpp"
+#include "catalyst/utils/trace/timings.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
 #include "catalyst/utils/yaml/configuration.hpp"
 
 #include "yaml-cpp/node/node.h"
@@ -22,12 +37,61 @@ namespace fs = std::filesystem;
 
 namespace {
 
+/// Work that does not depend on the profiles, shared by the configs of a multi-config build graph: include scans
+/// of the same sources and include directories, and dependency lookups.
+struct SharedWork {
+    std::unordered_map<std::string, std::shared_ptr<const utils::includes::IncludeGraph>> include_graphs;
+    std::unordered_map<std::string, FindRes> deps; ///< by depKey() and depStamp()
+    std::unordered_set<std::string> written;       ///< for buildwriters::ConfigWriter
+};
+
+/// A profile composition's inputs: enough to tell whether its build must be generated again.
+struct ConfigScan {
+    std::vector<std::string> profiles;
+    utils::yaml::Configuration config;
+    fs::path build_dir;
+    std::vector<fs::path> sources;
+    std::shared_ptr<const utils::includes::IncludeGraph> include_graph;
+    std::vector<YAML::Node> deps;
+    std::vector<std::string> dep_keys;
+    std::vector<std::string> dep_stamps;
+    GenerateState prev_state;
+    GenerateState state;
+};
+
+std::expected<ConfigScan, std::string> scanConfig(const std::vector<std::string> &profiles,
+                                                  const utils::yaml::Configuration &config,
+                                                  const std::vector<std::string> &enabled_features,
+                                                  const std::string &generator,
+                                                  SharedWork &shared);
+std::expected<void, std::string> writeConfig(ConfigScan &scan,
+                                             catalyst::generate::buildwriters::BaseWriter &writer,
+                                             const std::vector<std::string> &enabled_features,
+                                             const std::string &generator,
+                                             const fs::path &output_dir,
+                                             SharedWork &shared);
+std::expected<void, std::string> finishConfig(const ConfigScan &scan);
+std::expected<void, std::string> generateMultiConfig(const Parse &parse_args,
+                                                     const utils::yaml::Configuration &config);
+std::expected<bool, std::string> preGenerateHooks(const utils::yaml::Configuration &config);
+std::expected<void, std::string> postGenerateHooks(const utils::yaml::Configuration &config);
+
 void writeVariables(const catalyst::utils::yaml::Configuration &config,
                     catalyst::generate::buildwriters::BaseWriter &writer,
-                    const std::vector<std::string> &enabled_features);
-void writeRules(catalyst::generate::buildwriters::BaseWriter &writer);
+                    const std::string &config_flags,
+                    const std::vector<FindRes> &dep_results,
+                    const std::optional<Pch> &pch,
+                    const ModulePlan &modules,
+                    bool time_trace,
+                    const fs::path &output_dir);
+std::expected<unsigned, std::string> linkJobs(const catalyst::utils::yaml::Configuration &config);
+void writeRules(catalyst::generate::buildwriters::BaseWriter &writer, bool early_cutoff, unsigned link_jobs);
 std::vector<std::string> intermediateTargets(catalyst::generate::buildwriters::BaseWriter &writer,
-                                             const std::unordered_set<fs::path> &source_set);
+                                             const std::vector<fs::path> &source_set,
+                                             const utils::includes::IncludeGraph &include_graph,
+                                             const std::vector<UnityBatch> &unity_batches,
+                                             const std::optional<Pch> &pch,
+                                             const ModulePlan &modules);
 void finalTarget(const utils::yaml::Configuration &config,
                  const auto &object_files,
                  catalyst::generate::buildwriters::BaseWriter &writer);
@@ -40,17 +104,155 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
     utils::yaml::Configuration config;
 
+    utils::trace::Phase compose_span{"compose profiles"};
     try {
         config = utils::yaml::Configuration(parse_args.profiles);
     } catch (std::runtime_error &err) {
         return std::unexpected(err.what());
     }
+    compose_span.end();
+
+    std::string generator = parse_args.backend;
+    if (generator.empty()) {
+        generator = config.getString("meta.generator").value_or("cbe");
+    }
+
+    if (generator == "ninja" && utils::yaml::multiConfigName(parse_args.profiles, config.snapshot())) {
+        return generateMultiConfig(parse_args, config);
+    }
+
+    SharedWork shared;
+    auto scan = scanConfig(parse_args.profiles, config, parse_args.enabled_features, generator, shared);
+    if (!scan) {
+        return std::unexpected(scan.error());
+    }
+
+    // the native backend keeps its graph in memory and writes no build file
+    const bool native = generator == "native";
+    std::string build_filename;
+    if (generator == "ninja") {
+        build_filename = "build.ninja";
+    } else if (generator == "gmake" || generator == "make") {
+        build_filename = "Makefile";
+    } else if (!native) {
+        build_filename = "catalyst.build";
+    }
+    const fs::path build_dir = scan->build_dir;
+    const fs::path buildfile_path = build_dir / build_filename;
+
+    // ninja starts ready edges in file order, so the file is rewritten once the recorded durations reorder it
+    const utils::exec::Durations durations =
+        generator == "ninja" ? utils::exec::bucketDurations(utils::exec::ninjaDurations(build_dir))
+                             : utils::exec::Durations{};
+    const std::string durations_digest = utils::exec::durationsDigest(durations);
+
+    // the fingerprint is checked before any hook runs: a reused build file runs neither hook phase, and neither does
+    // a native graph that is only rebuilt in memory from unchanged inputs
+    const bool regenerate = parse_args.force || scan->state.fingerprint != scan->prev_state.fingerprint ||
+                            durations_digest != scan->prev_state.durations ||
+                            (!native && !fs::exists(buildfile_path)) ||
+                            !fs::exists(build_dir / "profile_composition.yaml");
+    if (!regenerate && parse_args.graph == nullptr) {
+        if (native)
+            catalyst::logger.log(LogLevel::INFO, "Project is unchanged since the last generation.");
+        else
+            catalyst::logger.log(LogLevel::INFO, "Build file {} is up to date.", buildfile_path.string());
+        return {};
+    }
+    if (regenerate) {
+        auto hooked = preGenerateHooks(config);
+        if (!hooked) {
+            return std::unexpected(hooked.error());
+        }
+        if (*hooked) {
+            // a hook may have written sources or headers, which the scan above predates
+            shared = SharedWork{};
+            scan = scanConfig(parse_args.profiles, config, parse_args.enabled_features, generator, shared);
+            if (!scan) {
+                return std::unexpected(scan.error());
+            }
+        }
+    }
+
+    scan->state.durations = durations_digest;
+
+    std::ostringstream buildfile;
+    auto generate_build = [&](buildwriters::BaseWriter &writer) {
+        return writeConfig(*scan, writer, parse_args.enabled_features, generator, "", shared);
+    };
+    std::expected<void, std::string> generated;
+    if (generator == "ninja") {
+        buildwriters::DerivedWriter<buildwriters::TargetType::Ninja> ninja_writer(buildfile);
+        buildwriters::CriticalPathWriter writer(ninja_writer, durations);
+        generated = generate_build(writer);
+        if (generated)
+            generated = writer.flush();
+    } else if (generator == "gmake" || generator == "make") {
+        buildwriters::DerivedWriter<buildwriters::TargetType::Make> writer(buildfile);
+        generated = generate_build(writer);
+    } else if (native) {
+        utils::exec::Graph discarded;
+        buildwriters::GraphWriter writer(parse_args.graph != nullptr ? *parse_args.graph : discarded);
+        generated = generate_build(writer);
+    } else {
+        buildwriters::DerivedWriter<buildwriters::TargetType::CBE> writer(buildfile);
+        generated = generate_build(writer);
+    }
+    if (!generated) {
+        return std::unexpected(generated.error());
+    }
+
+    if (!native) {
+        catalyst::logger.log(LogLevel::DEBUG, "Writing build file to: {}", buildfile_path.string());
+        auto written = utils::fs::writeIfChanged(buildfile_path, buildfile.str());
+        if (!written) {
+            return std::unexpected(written.error());
+        }
+        if (!*written) {
+            catalyst::logger.log(LogLevel::DEBUG, "Build file contents unchanged, leaving it untouched.");
+        }
+    }
+    if (auto res = finishConfig(*scan); !res) {
+        return res;
+    }
+    if (regenerate) {
+        if (auto res = postGenerateHooks(config); !res) {
+            return res;
+        }
+    }
+    catalyst::logger.log(LogLevel::DEBUG, "Generate subcommand finished successfully.");
+    return {};
+}
 
+namespace {
+/// Run the pre-generate hooks. True if the profiles define any, since they may have written files that a scan
+/// taken before them missed.
+std::expected<bool, std::string> preGenerateHooks(const utils::yaml::Configuration &config) {
     catalyst::logger.log(LogLevel::DEBUG, "Running pre-generate hooks.");
     if (auto res = hooks::preGenerate(config); !res) {
         catalyst::logger.log(LogLevel::ERROR, "Pre-generate hook failed: {}", res.error());
+        return std::unexpected(res.error());
+    }
+    return config.snapshot().hooks.contains("pre-generate");
+}
+
+std::expected<void, std::string> postGenerateHooks(const utils::yaml::Configuration &config) {
+    catalyst::logger.log(LogLevel::DEBUG, "Running post-generate hooks.");
+    if (auto res = hooks::postGenerate(config); !res) {
+        catalyst::logger.log(LogLevel::ERROR, "Post-generate hook failed: {}", res.error());
         return res;
     }
+    return {};
+}
+
+std::expected<ConfigScan, std::string> scanConfig(const std::vector<std::string> &profiles,
+                                                  const utils::yaml::Configuration &config,
+                                                  const std::vector<std::string> &enabled_features,
+                                                  const std::string &generator,
+                                                  SharedWork &shared) {
+    ConfigScan scan;
+    scan.profiles = profiles;
+    scan.config = config;
 
     fs::path current_dir = fs::current_path();
     std::vector<std::string> relative_source_dirs;
@@ -64,17 +266,50 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     for (const auto &dir : relative_source_dirs)
         absolute_source_dirs.push_back((current_dir / dir).string());
 
+    scan.build_dir = config.getString("manifest.dirs.build").value();
+    const fs::path &build_dir = scan.build_dir;
+    fs::path obj_dir = build_dir / "obj";
+
     catalyst::logger.log(LogLevel::DEBUG, "Building source set.");
-    auto source_set_res = buildSourceSet(absolute_source_dirs, parse_args.profiles);
+    utils::trace::Phase scan_span{"scan sources"};
+    utils::fs::ScanCache scan_cache{utils::fs::scanCachePath(build_dir)};
+    auto source_set_res = buildSourceSet(absolute_source_dirs, profiles, &scan_cache);
     if (!source_set_res) {
         catalyst::logger.log(LogLevel::ERROR, "Failed to build source set: {}", source_set_res.error());
         return std::unexpected(source_set_res.error());
     }
-
-    std::unordered_set<std::filesystem::path> source_set = source_set_res.value();
-
-    fs::path build_dir = config.getString("manifest.dirs.build").value();
-    fs::path obj_dir = build_dir / "obj";
+    if (auto res = scan_cache.save(); !res)
+        catalyst::logger.log(LogLevel::WARN, "Failed to save scan cache: {}", res.error());
+
+    scan.sources = std::move(*source_set_res);
+    const std::vector<fs::path> &source_set = scan.sources;
+    scan_span.end();
+
+    // header edges for every backend, so even a first build or a depfile-less backend rebuilds precisely
+    catalyst::logger.log(LogLevel::DEBUG, "Scanning includes.");
+    utils::trace::Phase include_span{"scan includes"};
+    std::vector<fs::path> include_dirs;
+    std::string include_key;
+    for (const auto &dir : config.getStringVector("manifest.dirs.include").value_or(std::vector<std::string>{})) {
+        include_dirs.push_back(fs::absolute(dir));
+        include_key += include_dirs.back().string() + '\n';
+    }
+    include_key += '\n';
+    for (const auto &src : source_set)
+        include_key += src.string() + '\n';
+    auto &include_graph = shared.include_graphs[include_key];
+    if (!include_graph) {
+        include_graph = std::make_shared<const utils::includes::IncludeGraph>(utils::includes::IncludeGraph::scan(
+            source_set, include_dirs, utils::includes::includeCachePath(build_dir)));
+    } else {
+        catalyst::logger.log(LogLevel::DEBUG, "Reusing the include scan of another config.");
+    }
+    scan.include_graph = include_graph;
+    if (auto res = utils::fs::writeIfChanged(utils::includes::includeGraphPath(build_dir), include_graph->toJson());
+        !res) {
+        catalyst::logger.log(LogLevel::WARN, "Failed to write include graph: {}", res.error());
+    }
+    include_span.end();
 
     catalyst::logger.log(LogLevel::DEBUG, "Creating object directory: {}", obj_dir.string());
     fs::create_directories(obj_dir);
@@ -83,82 +318,355 @@ std::expected<void, std::string> action(const Parse &parse_args) {
         return std::unexpected("Failed to create object directory: " + obj_dir.string());
     }
 
-    std::string generator = parse_args.backend;
-    if (generator.empty()) {
-        generator = config.getString("meta.generator").value_or("cbe");
+    for (const auto &dep : config.snapshot().dependencies) {
+        scan.deps.push_back(dep.node);
+        scan.dep_keys.push_back(depKey(dep.node));
+        scan.dep_stamps.push_back(depStamp(build_dir.string(), dep.node));
     }
 
-    std::string build_filename;
-    if (generator == "ninja") {
-        build_filename = "build.ninja";
-    } else if (generator == "gmake" || generator == "make") {
-        build_filename = "Makefile";
-    } else {
-        build_filename = "catalyst.build";
+    scan.prev_state = loadGenerateState(generateStatePath(build_dir));
+    scan.state.fingerprint = inputFingerprint(config,
+                                              enabled_features,
+                                              generator,
+                                              absolute_source_dirs,
+                                              source_set,
+                                              include_graph->digest(),
+                                              scan.dep_stamps);
+    return scan;
+}
+
+std::expected<void, std::string> writeConfig(ConfigScan &scan,
+                                             catalyst::generate::buildwriters::BaseWriter &writer,
+                                             const std::vector<std::string> &enabled_features,
+                                             const std::string &generator,
+                                             const fs::path &output_dir,
+                                             SharedWork &shared) {
+    const utils::yaml::Configuration &config = scan.config;
+    const fs::path &build_dir = scan.build_dir;
+    const std::vector<fs::path> &source_set = scan.sources;
+    const utils::includes::IncludeGraph &include_graph = *scan.include_graph;
+
+    catalyst::logger.log(LogLevel::DEBUG, "Resolving dependencies.");
+    std::vector<FindRes> dep_results;
+    dep_results.reserve(scan.deps.size());
+    for (size_t ii = 0; ii < scan.deps.size(); ++ii) {
+        const std::string &dep_key = scan.dep_keys[ii];
+        const std::string &dep_stamp = scan.dep_stamps[ii];
+        if (auto it = scan.prev_state.deps.find(dep_key);
+            it != scan.prev_state.deps.end() && it->second.stamp == dep_stamp) {
+            catalyst::logger.log(LogLevel::DEBUG, "Reusing resolution of unchanged dependency {}.", dep_key);
+            dep_results.push_back(it->second.res);
+            scan.state.deps.insert(*it);
+            continue;
+        }
+        const std::string shared_key = dep_key + '\n' + dep_stamp;
+        if (auto it = shared.deps.find(shared_key); it != shared.deps.end()) {
+            catalyst::logger.log(LogLevel::DEBUG, "Reusing resolution of dependency {} from another config.", dep_key);
+            dep_results.push_back(it->second);
+            scan.state.deps[dep_key] = DepCacheEntry{.stamp = dep_stamp, .res = it->second};
+            continue;
+        }
+        utils::trace::Phase find_span{std::format("findDep {}", dep_key)};
+        auto find_dep_res = findDep(build_dir.string(), scan.deps[ii]);
+        find_span.end();
+        if (!find_dep_res) {
+            catalyst::logger.log(LogLevel::ERROR, "{}", find_dep_res.error());
+            scan.state.fingerprint.clear(); // retry the lookup next time instead of caching a broken build file
+            continue;
+        }
+        dep_results.push_back(*find_dep_res);
+        shared.deps.emplace(shared_key, *find_dep_res);
+        scan.state.deps[dep_key] = DepCacheEntry{.stamp = dep_stamp, .res = *find_dep_res};
     }
 
-    const fs::path buildfile_path = build_dir / build_filename;
-    catalyst::logger.log(LogLevel::DEBUG, "Writing build file to: {}", buildfile_path.string());
-    std::ofstream buildfile{buildfile_path};
+    auto unity_options = unityOptions(config);
+    if (!unity_options) {
+        return std::unexpected(unity_options.error());
+    }
+    std::vector<UnityBatch> unity_batches;
+    if (unity_options->enabled) {
+        // module units and importers must stay separate translation units
+        std::vector<fs::path> unity_candidates;
+        std::ranges::copy_if(source_set, std::back_inserter(unity_candidates), [&](const fs::path &src) {
+            return include_graph.moduleInfo(src).empty();
+        });
+        const fs::path unity_dir = fs::absolute(build_dir / "unity");
+        auto planned = planUnityBatches(unity_candidates, *unity_options, unity_dir);
+        if (!planned) {
+            return std::unexpected(planned.error());
+        }
+        unity_batches = std::move(*planned);
+        if (auto res = writeUnitySources(unity_batches, unity_dir); !res) {
+            return std::unexpected(res.error());
+        }
+    }
 
-    if (!buildfile) {
-        return std::unexpected(std::format("Failed to open {} for writing", buildfile_path.string()));
+    auto pch_options = pchOptions(config);
+    if (!pch_options) {
+        return std::unexpected(pch_options.error());
+    }
+    if (generator == "cbe" && !pch_options->header.empty()) {
+        // CBE's compile steps are built in and take no extra flags, so the PCH would never be used
+        return std::unexpected("manifest.build.pch is not supported by the cbe generator; use ninja, gmake or native");
+    }
+    const std::string cxx = config.getString("manifest.tooling.CXX").value_or("clang++");
+    auto pch = preparePch(*pch_options, source_set, include_graph, build_dir, cxx);
+    if (!pch) {
+        return std::unexpected(pch.error());
     }
 
-    auto generate_build = [&](buildwriters::BaseWriter &writer) {
-        writer.addComment("Build file generated by Catalyst");
-        writeVariables(config, writer, parse_args.enabled_features);
-        writeRules(writer);
-        std::vector<std::string> object_files = intermediateTargets(writer, source_set);
-        finalTarget(config, object_files, writer);
-    };
+    const bool has_module_units =
+        std::ranges::any_of(source_set, [&](const fs::path &src) { return !include_graph.moduleInfo(src).empty(); });
+    if (generator == "cbe" && has_module_units) {
+        // CBE's compile steps are built in: they cannot emit a BMI or be told where one is
+        return std::unexpected("C++20 modules are not supported by the cbe generator; use ninja, gmake or native");
+    }
 
-    if (generator == "ninja") {
-        buildwriters::DerivedWriter<buildwriters::TargetType::Ninja> writer(buildfile);
-        generate_build(writer);
-    } else if (generator == "gmake" || generator == "make") {
-        buildwriters::DerivedWriter<buildwriters::TargetType::Make> writer(buildfile);
-        generate_build(writer);
-    } else {
-        buildwriters::DerivedWriter<buildwriters::TargetType::CBE> writer(buildfile);
-        generate_build(writer);
+    const std::string user_cxxflags = config.getString("manifest.tooling.CXXFLAGS").value_or("");
+    auto modules = prepareModules(source_set, include_graph, dep_results, build_dir, cxx, user_cxxflags);
+    if (!modules) {
+        return std::unexpected(modules.error());
+    }
+    if (*pch && !modules->providers.empty()) {
+        // -include would put the header ahead of the module declaration
+        return std::unexpected("manifest.build.pch cannot be combined with module units; import the headers instead");
+    }
+    if (!output_dir.empty() && !modules->empty()) {
+        // the module flags name BMIs by paths that would have to move into the config's directory
+        return std::unexpected("manifest.build.configs cannot be combined with C++20 modules yet");
     }
 
-    catalyst::logger.log(
-        LogLevel::DEBUG, "Writing profile composition to: {}", (build_dir / "profile_composition.yaml").string());
-    std::ofstream profile_comp_file{build_dir / "profile_composition.yaml"};
-    if (!profile_comp_file) {
-        return std::unexpected("Failed to open profile_composition.yaml for writing in " + build_dir.string());
+    auto link_jobs = linkJobs(config);
+    if (!link_jobs) {
+        return std::unexpected(link_jobs.error());
+    }
+    auto time_trace = timeTraceOptions(config);
+    if (!time_trace) {
+        return std::unexpected(time_trace.error());
+    }
+    auto config_header = configHeaderOptions(config);
+    if (!config_header) {
+        return std::unexpected(config_header.error());
+    }
+    auto config_flags = prepareConfigHeader(*config_header, config, enabled_features, build_dir);
+    if (!config_flags) {
+        return std::unexpected(config_flags.error());
     }
-    profile_comp_file << config.getRoot();
 
-    catalyst::logger.log(LogLevel::DEBUG, "Running post-generate hooks.");
-    if (auto res = hooks::postGenerate(config); !res) {
-        catalyst::logger.log(LogLevel::ERROR, "Post-generate hook failed: {}", res.error());
-        return res;
+    utils::trace::Phase write_span{generator == "native" ? "build graph" : "write build file"};
+    writer.addComment("Build file generated by Catalyst");
+    writeVariables(config, writer, *config_flags, dep_results, *pch, *modules, time_trace->enabled, output_dir);
+#if defined(_WIN32)
+    // ninja runs commands through CreateProcess there, without the shell that the cutoff's cmp and mv need
+    const bool early_cutoff = false;
+#else
+    const bool early_cutoff = generator == "ninja";
+#endif
+    writeRules(writer, early_cutoff, *link_jobs);
+    std::vector<std::string> object_files =
+        intermediateTargets(writer, source_set, include_graph, unity_batches, *pch, *modules);
+    if (config.getString("manifest.type").value_or("BINARY") != "STATICLIB") {
+        // the standard modules' objects belong to the final link, not to every archive on the way
+        object_files.insert(object_files.end(), modules->link_objects.begin(), modules->link_objects.end());
+    }
+    finalTarget(config, object_files, writer);
+    return {};
+}
+
+std::expected<void, std::string> finishConfig(const ConfigScan &scan) {
+    const fs::path profile_comp_path = scan.build_dir / "profile_composition.yaml";
+    catalyst::logger.log(LogLevel::DEBUG, "Writing profile composition to: {}", profile_comp_path.string());
+    YAML::Emitter profile_comp;
+    profile_comp << scan.config.getRoot();
+    if (auto res = utils::fs::writeIfChanged(profile_comp_path, profile_comp.c_str()); !res) {
+        return std::unexpected("Failed to write profile_composition.yaml in " + scan.build_dir.string());
+    }
+
+    if (auto res = saveGenerateState(generateStatePath(scan.build_dir), scan.state); !res) {
+        catalyst::logger.log(LogLevel::WARN, "Failed to save generate state: {}", res.error());
     }
-    catalyst::logger.log(LogLevel::DEBUG, "Generate subcommand finished successfully.");
     return {};
 }
 
+/// `manifest.build.configs` with ninja: a single build file, in the directory above the configs', for `common` and
+/// each listed profile composed over it. Every config keeps its own state, so one that changed is rescanned while
+/// the others are compared by fingerprint; the file is written again if any of them changed.
+std::expected<void, std::string> generateMultiConfig(const Parse &parse_args,
+                                                     const utils::yaml::Configuration &config) {
+    std::vector<std::string> names{"common"};
+    for (const auto &name : config.getStringVector("manifest.build.configs").value_or(std::vector<std::string>{})) {
+        if (std::ranges::find(names, name) == names.end())
+            names.push_back(name);
+    }
+
+    SharedWork shared;
+    std::vector<ConfigScan> scans;
+    for (const auto &name : names) {
+        std::vector<std::string> profiles{"common"};
+        if (name != "common")
+            profiles.push_back(name);
+        utils::yaml::Configuration config_of;
+        try {
+            config_of = utils::yaml::Configuration(profiles);
+        } catch (std::runtime_error &err) {
+            return std::unexpected(std::format("config {}: {}", name, err.what()));
+        }
+        auto scan = scanConfig(profiles, config_of, parse_args.enabled_features, "ninja", shared);
+        if (!scan) {
+            return std::unexpected(std::format("config {}: {}", name, scan.error()));
+        }
+        scans.push_back(std::move(*scan));
+    }
+
+    const fs::path graph_dir = scans.front().build_dir.parent_path();
+    const fs::path buildfile_path = graph_dir / "build.ninja";
+    const utils::exec::Durations durations = utils::exec::bucketDurations(utils::exec::ninjaDurations(graph_dir));
+    const std::string durations_digest = utils::exec::durationsDigest(durations);
+    if (!parse_args.force && fs::exists(buildfile_path) && std::ranges::all_of(scans, [&](const ConfigScan &scan) {
+            return scan.state.fingerprint == scan.prev_state.fingerprint &&
+                   durations_digest == scan.prev_state.durations &&
+                   fs::exists(scan.build_dir / "profile_composition.yaml");
+        })) {
+        catalyst::logger.log(LogLevel::INFO, "Build file {} is up to date.", buildfile_path.string());
+        return {};
+    }
+
+    auto hooked = preGenerateHooks(config);
+    if (!hooked) {
+        return std::unexpected(hooked.error());
+    }
+    if (*hooked) {
+        // a hook may have written sources or headers, which the scans above predate
+        shared = SharedWork{};
+        for (std::size_t ii = 0; ii < scans.size(); ++ii) {
+            auto scan =
+                scanConfig(scans[ii].profiles, scans[ii].config, parse_args.enabled_features, "ninja", shared);
+            if (!scan) {
+                return std::unexpected(std::format("config {}: {}", names[ii], scan.error()));
+            }
+            scans[ii] = std::move(*scan);
+        }
+    }
+
+    for (auto &scan : scans)
+        scan.state.durations = durations_digest;
+
+    catalyst::logger.log(LogLevel::INFO, "Generating a build file for configs {}.", names);
+    std::ostringstream buildfile;
+    buildwriters::DerivedWriter<buildwriters::TargetType::Ninja> ninja_writer(buildfile);
+    buildwriters::CriticalPathWriter writer(ninja_writer, durations);
+    for (std::size_t ii = 0; ii < scans.size(); ++ii) {
+        buildwriters::ConfigWriter config_writer(writer, names[ii], shared.written);
+        if (auto res = writeConfig(scans[ii], config_writer, parse_args.enabled_features, "ninja", names[ii], shared);
+            !res) {
+            return std::unexpected(std::format("config {}: {}", names[ii], res.error()));
+        }
+    }
+    if (auto res = writer.flush(); !res) {
+        return std::unexpected(res.error());
+    }
+
+    catalyst::logger.log(LogLevel::DEBUG, "Writing build file to: {}", buildfile_path.string());
+    if (auto written = utils::fs::writeIfChanged(buildfile_path, buildfile.str()); !written) {
+        return std::unexpected(written.error());
+    }
+    for (const auto &scan : scans) {
+        if (auto res = finishConfig(scan); !res) {
+            return res;
+        }
+    }
+    return postGenerateHooks(config);
+}
+} // namespace
+
+std::string objectPath(const fs::path &source) {
+    std::string obj_name = fs::relative(source, fs::current_path()).string();
+    std::replace(obj_name.begin(), obj_name.end(), '/', '_');
+    std::replace(obj_name.begin(), obj_name.end(), '\\', '_'); // For Windows paths
+    obj_name = obj_name.substr(0, obj_name.find_last_of('.')) + ".o";
+    return (fs::path{"obj"} / obj_name).string();
+}
+
 namespace {
 std::vector<std::string> intermediateTargets(catalyst::generate::buildwriters::BaseWriter &writer,
-                                             const std::unordered_set<std::filesystem::path> &source_set) {
+                                             const std::vector<fs::path> &source_set,
+                                             const utils::includes::IncludeGraph &include_graph,
+                                             const std::vector<UnityBatch> &unity_batches,
+                                             const std::optional<Pch> &pch,
+                                             const ModulePlan &modules) {
     catalyst::logger.log(LogLevel::DEBUG, "Generate subcommand invoked.");
-    fs::path current_dir = fs::current_path();
     writer.addComment("Source File Compilation");
+
+    std::unordered_map<std::string, const UnityBatch *> batch_of;
+    for (const auto &batch : unity_batches) {
+        for (const auto &member : batch.members)
+            batch_of.emplace(member.string(), &batch);
+    }
+
     std::vector<std::string> object_files;
+    std::set<std::string> all_headers;
+    if (pch) {
+        writer.addBuild({pch->output}, "cxx_pch", {pch->header.string()}, pch->deps);
+        all_headers.insert(pch->deps.begin(), pch->deps.end());
+    }
     for (const auto &src : source_set) {
-        fs::path relative_src_path = fs::relative(src, current_dir);
-        std::string obj_name = relative_src_path.string();
-        std::replace(obj_name.begin(), obj_name.end(), '/', '_');
-        std::replace(obj_name.begin(), obj_name.end(), '\\', '_'); // For Windows paths
-        obj_name = obj_name.substr(0, obj_name.find_last_of('.')) + ".o";
-        object_files.push_back((fs::path{"obj"} / obj_name).string());
-        writer.addBuild({object_files.back()},
-                        ((src.extension() == ".c" || src.extension() == ".cu") ? "cc_compile" : "cxx_compile"),
-                        {src.string()});
+        if (auto it = batch_of.find(src.string()); it != batch_of.end()) {
+            // the batch is emitted in place of its first member, so objects keep source order on the link line
+            const UnityBatch &batch = *it->second;
+            if (batch.members.front() != src)
+                continue;
+            std::set<std::string> deps;
+            for (const auto &member : batch.members) {
+                deps.insert(member.string());
+                for (const auto &header : include_graph.transitiveIncludes(member))
+                    deps.insert(header.string());
+            }
+            for (const auto &dep : deps) {
+                if (!batch_of.contains(dep))
+                    all_headers.insert(dep);
+            }
+            // the batch inherits its members' includes, so the PCH adds nothing new only if they all use it
+            const bool uses_pch = pch && std::ranges::all_of(batch.members, [&](const fs::path &member) {
+                                      return pch->users.contains(member.string());
+                                  });
+            if (uses_pch)
+                deps.insert(pch->output);
+            object_files.push_back((fs::path{"obj"} / batch.unity_file.stem()).string() + ".o");
+            writer.addBuild({object_files.back()},
+                            uses_pch ? "cxx_compile_pch" : "cxx_compile",
+                            {batch.unity_file.string()},
+                            std::vector<std::string>(deps.begin(), deps.end()));
+            continue;
+        }
+
+        object_files.push_back(objectPath(src));
+        std::vector<std::string> headers;
+        for (const auto &header : include_graph.transitiveIncludes(src))
+            headers.push_back(header.string());
+        all_headers.insert(headers.begin(), headers.end());
+        const bool is_c = src.extension() == ".c" || src.extension() == ".cu";
+        const bool uses_pch = pch && !is_c && pch->users.contains(src.string());
+        if (uses_pch)
+            headers.push_back(pch->output);
+        // an import needs the BMI, which comes with the providing unit's object
+        const auto &module = include_graph.moduleInfo(src);
+        for (const auto &import : module.imports) {
+            if (auto provider = modules.providers.find(import); provider != modules.providers.end())
+                headers.push_back(objectPath(provider->second));
+            else if (auto prebuilt = modules.prebuilt.find(import); prebuilt != modules.prebuilt.end())
+                headers.push_back(prebuilt->second);
+        }
+        std::string_view rule = is_c ? "cc_compile" : module.providesBmi() ? "cxx_module" : "cxx_compile";
+        if (uses_pch)
+            rule = "cxx_compile_pch"; // never a module unit: PCH and modules are mutually exclusive
+        writer.addBuild({object_files.back()}, rule, {src.string()}, headers);
     }
+
+    // like -MP: a header that is deleted along with its #include must not fail the build before regeneration
+    if (!all_headers.empty())
+        writer.addComment("Headers");
+    for (const auto &header : all_headers)
+        writer.addBuild({header}, "phony", {});
     return object_files;
 }
 
@@ -213,21 +721,21 @@ void finalTarget(const utils::yaml::Configuration &config,
 
 void writeVariables(const catalyst::utils::yaml::Configuration &config,
                     catalyst::generate::buildwriters::BaseWriter &writer,
-                    const std::vector<std::string> &enabled_features) {
+                    const std::string &config_flags,
+                    const std::vector<FindRes> &dep_results,
+                    const std::optional<Pch> &pch,
+                    const ModulePlan &modules,
+                    bool time_trace,
+                    const fs::path &output_dir) {
 
     catalyst::logger.log(LogLevel::DEBUG, "Writing variables to build file.");
-    std::string build_dir_str = config.getString("manifest.dirs.build").value_or("build");
-
-    std::string cxxflags =
-        std::format(R"({} -DCATALYST_BUILD_SYS=1 -DCATALYST_PROJ_NAME="{}" -DCATALYST_PROJ_VER="{}")",
-                    config.getString("manifest.tooling.CXXFLAGS").value_or(""),
-                    config.getString("manifest.name").value_or("name"),
-                    config.getString("manifest.version").value_or("0.0.0"));
-    std::string ccflags = std::format(R"({} -DCATALYST_BUILD_SYS=1 -DCATALYST_PROJ_NAME="{}" -DCATALYST_PROJ_VER="{}")",
-                                      config.getString("manifest.tooling.CCFLAGS").value_or(""),
-                                      config.getString("manifest.name").value_or("name"),
-                                      config.getString("manifest.version").value_or("0.0.0"));
-    std::string ldflags = "-Lcatalyst-libs";
+
+    // only the constant -D stays global; the rest changes with the version and features and is in config_flags
+    std::string cxxflags = config.getString("manifest.tooling.CXXFLAGS").value_or("") + " -DCATALYST_BUILD_SYS=1" +
+                           config_flags;
+    std::string ccflags = config.getString("manifest.tooling.CCFLAGS").value_or("") + " -DCATALYST_BUILD_SYS=1" +
+                          config_flags;
+    std::string ldflags = "-L" + (output_dir / "catalyst-libs").string();
 
     if (const char *vcpkg_root = std::getenv("VCPKG_ROOT"); vcpkg_root != nullptr) {
 #if defined(_WIN32)
@@ -244,51 +752,20 @@ void writeVariables(const catalyst::utils::yaml::Configuration &config,
         logger.log(LogLevel::WARN, "VCPKG_ROOT environment variable is not defined.");
     }
 
-    if (const auto &features_node = config.getRoot()["features"]; features_node && features_node.IsSequence()) {
-        for (const auto &feature_map : features_node) {
-            if (feature_map.IsMap()) {
-                for (auto it = feature_map.begin(); it != feature_map.end(); ++it) {
-                    auto feature = it->first.as<std::string>();
-                    bool default_enabled = it->second.as<bool>();
-                    bool explicitly_enabled =
-                        std::find(enabled_features.begin(), enabled_features.end(), feature) != enabled_features.end();
-                    bool explicitly_disabled =
-                        std::find(enabled_features.begin(), enabled_features.end(), "no-" + feature) !=
-                        enabled_features.end();
-
-                    bool is_enabled = default_enabled;
-                    if (explicitly_enabled) {
-                        is_enabled = true;
-                    } else if (explicitly_disabled) {
-                        is_enabled = false;
-                    }
-
-                    std::string flag = std::format(" -DFF_{}__{}={}",
-                                                   config.getString("manifest.name").value_or("name"),
-                                                   feature,
-                                                   is_enabled ? "1" : "0");
-                    cxxflags += flag;
-                    ccflags += flag;
-                }
-            }
-            // reaching this is technically an error but we allow it
-        }
-    }
-
     std::vector<std::string> inc_dirs = config.getStringVector("manifest.dirs.include").value();
     for (const auto &inc_dir : inc_dirs) {
         cxxflags += std::format(" -I{}", fs::absolute(inc_dir).string());
         ccflags += std::format(" -I{}", fs::absolute(inc_dir).string());
     }
 
+    if (time_trace) {
+        // clang writes each trace next to the object, where the build picks them up
+        cxxflags += " -ftime-trace";
+        ccflags += " -ftime-trace";
+    }
+
     std::string ldlibs;
-    for (const auto &dep : config.getRoot()["dependencies"]) {
-        auto find_dep_res = findDep(build_dir_str, dep);
-        if (!find_dep_res) {
-            catalyst::logger.log(LogLevel::ERROR, "{}", find_dep_res.error());
-            continue;
-        }
-        auto [lib_path, inc_path, libs] = find_dep_res.value();
+    for (const auto &[lib_path, inc_path, libs, dep_build_dir] : dep_results) {
         ldflags += " " + lib_path;
         ldlibs += " " + libs;
         ccflags += " " + inc_path;
@@ -300,20 +777,63 @@ void writeVariables(const catalyst::utils::yaml::Configuration &config,
     writer.addVariable("cxx", config.getString("manifest.tooling.CXX").value_or("clang++"));
     writer.addVariable("cxxflags", cxxflags);
     writer.addVariable("cflags", ccflags);
+    // C++ only: -include picks up the precompiled form next to the header; -Winvalid-pch says when it cannot
+    writer.addVariable("pchflags", pch ? std::format("-Winvalid-pch -include {}", pch->header.string()) : "");
+    writer.addVariable("moduleflags", modules.flags);
+    writer.addVariable("moduleinterfaceflags", modules.interface_flags);
     writer.addVariable("ldflags", ldflags);
     writer.addVariable("ldlibs", ldlibs); // place compiled libraries here
 }
 
-void writeRules(catalyst::generate::buildwriters::BaseWriter &writer) {
+/// `manifest.build.parallel.link_jobs`, by default one link per 4 GiB of RAM: links, LTO ones above all, are the
+/// memory-hungriest commands, and several at once are what runs a machine out of memory.
+std::expected<unsigned, std::string> linkJobs(const catalyst::utils::yaml::Configuration &config) {
+    if (auto jobs = config.getInt("manifest.build.parallel.link_jobs")) {
+        if (*jobs <= 0)
+            return std::unexpected(std::format("manifest.build.parallel.link_jobs must be positive, got {}", *jobs));
+        return static_cast<unsigned>(*jobs);
+    }
+    constexpr std::uint64_t kb_per_link = 4ULL * 1024 * 1024;
+    return static_cast<unsigned>(std::max<std::uint64_t>(1, utils::exec::physicalMemoryKb() / kb_per_link));
+}
+
+/// With `early_cutoff`, objects are compiled next to their target and only moved over it when they differ, and the
+/// rules restat: an edit that leaves the object byte-identical (a comment, whitespace) does not relink. Only for
+/// ninja outside Windows; make has no restat, and the native executor compares output contents itself.
+void writeRules(catalyst::generate::buildwriters::BaseWriter &writer, bool early_cutoff, unsigned link_jobs) {
     catalyst::logger.log(LogLevel::DEBUG, "Writing rules to build file.");
+    // -MT keeps the depfile's target the object itself rather than the temporary; a failed compile removes the
+    // partial temporary
+    auto compile = [&](std::string_view compiler) {
+        return early_cutoff ? std::format("{} -MMD -MF $out.d -MT $out -c $in -o $out.tmp || "
+                                          "{{ rm -f $out.tmp; exit 1; }}; "
+                                          "cmp -s $out.tmp $out && rm -f $out.tmp || mv -f $out.tmp $out",
+                                          compiler)
+                            : std::format("{} -MMD -MF $out.d -c $in -o $out", compiler);
+    };
     writer.addComment("Rules for compiling");
-    writer.addRule("cxx_compile", "$cxx $cxxflags -MMD -MF $out.d -c $in -o $out", "CXX $out", "$out.d", "gcc");
-    writer.addRule("cc_compile", "$cc $cflags -MMD -MF $out.d -c $in -o $out", "CC $out", "$out.d", "gcc");
+    writer.addRule(
+        "cxx_compile", compile("$cxx $cxxflags $moduleflags"), "CXX $out", "$out.d", "gcc", early_cutoff);
+    writer.addRule("cxx_compile_pch",
+                   compile("$cxx $cxxflags $pchflags $moduleflags"),
+                   "CXX $out",
+                   "$out.d",
+                   "gcc",
+                   early_cutoff);
+    writer.addRule("cxx_module",
+                   "$cxx $cxxflags $moduleflags -MMD -MF $out.d $moduleinterfaceflags -c $in -o $out",
+                   "CXXM $out",
+                   "$out.d",
+                   "gcc");
+    writer.addRule(
+        "cxx_pch", "$cxx $cxxflags -x c++-header -MMD -MF $out.d -c $in -o $out", "PCH $out", "$out.d", "gcc");
+    writer.addRule("cc_compile", compile("$cc $cflags"), "CC $out", "$out.d", "gcc", early_cutoff);
 
     writer.addComment("Rules for linking");
-    writer.addRule("binary_link", "$cxx $in -o $out $ldflags $ldlibs", "LINK $out");
+    writer.addPool("link_pool", link_jobs);
+    writer.addRule("binary_link", "$cxx $in -o $out $ldflags $ldlibs", "LINK $out", "", "", false, "link_pool");
     writer.addRule("static_link", "ar rcs $out $in", "LINK $out");
-    writer.addRule("shared_link", "$cxx -shared $in -o $out", "LINK $out");
+    writer.addRule("shared_link", "$cxx -shared $in -o $out", "LINK $out", "", "", false, "link_pool");
 }
 } // namespace
 
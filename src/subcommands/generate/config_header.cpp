@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <set>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::generate {
+namespace fs = std::filesystem;
+
+namespace {
+using Feature = utils::yaml::Snapshot::Feature;
+
+/// The `features` of the composition, each as its profile sets it unless `enabled_features` names it or `no-` it.
+std::vector<Feature> resolveFeatures(const utils::yaml::Configuration &config,
+                                     const std::vector<std::string> &enabled_features) {
+    std::vector<Feature> features = config.snapshot().features;
+    for (auto &feature : features) {
+        if (std::ranges::find(enabled_features, feature.name) != enabled_features.end()) {
+            feature.enabled = true;
+        } else if (std::ranges::find(enabled_features, "no-" + feature.name) != enabled_features.end()) {
+            feature.enabled = false;
+        }
+    }
+    return features;
+}
+
+std::string featureMacro(const std::string &project, const Feature &feature) {
+    return std::format("FF_{}__{}", project, feature.name);
+}
+
+std::expected<void, std::string> writeHeader(const fs::path &path, const std::string &body) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", path.parent_path().string(), ec.message()));
+    auto written = utils::fs::writeIfChanged(
+        path, "// Generated by Catalyst: project configuration. Do not edit.\n#pragma once\n" + body);
+    if (!written)
+        return std::unexpected(written.error());
+    if (*written)
+        catalyst::logger.log(LogLevel::DEBUG, "Wrote {}.", path.string());
+    return {};
+}
+
+/// Remove the per-feature headers of features that are gone, or all of them when `keep` is empty.
+void removeStaleFeatureHeaders(const fs::path &dir, const std::set<std::string> &keep) {
+    std::error_code ec;
+    std::vector<fs::path> stale;
+    for (fs::directory_iterator it{dir, ec}, end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == ".h" && !keep.contains(it->path().filename().string()))
+            stale.push_back(it->path());
+    }
+    for (const auto &path : stale) {
+        catalyst::logger.log(LogLevel::DEBUG, "Removing stale {}.", path.string());
+        fs::remove(path, ec);
+    }
+    if (keep.empty())
+        fs::remove(dir, ec); // only if empty
+}
+} // namespace
+
+std::expected<ConfigHeaderOptions, std::string> configHeaderOptions(const utils::yaml::Configuration &config) {
+    ConfigHeaderOptions options;
+    const std::string mode = config.getString("manifest.build.config_header.mode").value_or("header");
+    if (mode != "header" && mode != "defines")
+        return std::unexpected(
+            std::format("manifest.build.config_header.mode must be header or defines, got {}", mode));
+    options.defines = mode == "defines";
+    options.split = config.getBool("manifest.build.config_header.split").value_or(false);
+    return options;
+}
+
+std::expected<std::string, std::string> prepareConfigHeader(const ConfigHeaderOptions &options,
+                                                            const utils::yaml::Configuration &config,
+                                                            const std::vector<std::string> &enabled_features,
+                                                            const fs::path &build_dir) {
+    const std::string name = config.getString("manifest.name").value_or("name");
+    const std::string version = config.getString("manifest.version").value_or("0.0.0");
+    const std::vector<Feature> features = resolveFeatures(config, enabled_features);
+
+    if (options.defines) {
+        std::string flags = std::format(R"( -DCATALYST_PROJ_NAME="{}" -DCATALYST_PROJ_VER="{}")", name, version);
+        for (const auto &feature : features)
+            flags += std::format(" -D{}={}", featureMacro(name, feature), feature.enabled ? "1" : "0");
+        return flags;
+    }
+
+    // the shell strips the quotes of the -D flags, so the macros expand to bare tokens; keep it that way
+    const fs::path include_dir = fs::absolute(build_dir / "include");
+    std::string body = std::format("#define CATALYST_PROJ_NAME {}\n#define CATALYST_PROJ_VER {}\n", name, version);
+    std::set<std::string> split_headers;
+    for (const auto &feature : features) {
+        std::string define = std::format("#define {} {}\n", featureMacro(name, feature), feature.enabled ? "1" : "0");
+        if (!options.split) {
+            body += define;
+            continue;
+        }
+        const std::string filename = feature.name + ".h";
+        if (auto res = writeHeader(include_dir / "catalyst_config" / filename, define); !res)
+            return std::unexpected(res.error());
+        split_headers.insert(filename);
+    }
+    if (auto res = writeHeader(include_dir / "catalyst_config.h", body); !res)
+        return std::unexpected(res.error());
+    removeStaleFeatureHeaders(include_dir / "catalyst_config", split_headers);
+    return std::format(" -I{}", include_dir.string());
+}
+} // namespace catalyst::generate
@@ -1,11 +1,14 @@
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <format>
 #include <string>
+#include <vector>
 
 #include "catalyst/dir_guard.hpp"
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 #include "yaml-cpp/node/node.h"
 
@@ -25,39 +28,32 @@ std::expected<FindRes, std::string> findGit(const std::string &build_dir, const
         profiles = dep["profiles"].as<std::vector<std::string>>();
 
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles for git dependency.");
-    std::expected<YAML::Node, std::string> pc = catalyst::generate::profileComposition(profiles);
-
-    if (!pc) {
-        return std::unexpected(pc.error());
+    utils::yaml::Configuration config;
+    try {
+        config = utils::yaml::Configuration{profiles};
+    } catch (const std::exception &err) {
+        return std::unexpected(err.what());
     }
-
-    YAML::Node profile = *pc;
+    const auto &manifest = config.snapshot().manifest;
 
     std::string include_path_flags;
-    if (auto dep_includes_node = profile["manifest"]["dirs"]["include"];
-        dep_includes_node && dep_includes_node.IsSequence()) {
-        for (const auto &include_dir : dep_includes_node.as<std::vector<std::string>>()) {
-            fs::path abs_include_path = fs::absolute(dep_path / include_dir);
-            catalyst::logger.log(LogLevel::DEBUG, "Adding include path: {}", abs_include_path.string());
-            include_path_flags += std::format(" -I{}", abs_include_path.string());
-        }
+    for (const auto &include_dir : manifest.dirs.include) {
+        fs::path abs_include_path = fs::absolute(dep_path / include_dir);
+        catalyst::logger.log(LogLevel::DEBUG, "Adding include path: {}", abs_include_path.string());
+        include_path_flags += std::format(" -I{}", abs_include_path.string());
     }
 
-    std::string library_path_flags;
-    if (auto dep_build_dir_node = profile["manifest"]["dirs"]["build"]) {
-        auto dep_build_dir = dep_build_dir_node.as<std::string>();
-        fs::path lib_path = fs::absolute(dep_path / dep_build_dir);
-        catalyst::logger.log(LogLevel::DEBUG, "Adding library path: {}", lib_path.string());
-        library_path_flags += std::format(" -L{}", lib_path.string());
-    }
+    fs::path lib_path = fs::absolute(dep_path / manifest.dirs.build);
+    catalyst::logger.log(LogLevel::DEBUG, "Adding library path: {}", lib_path.string());
+    std::string library_path_flags = std::format(" -L{}", lib_path.string());
+    std::string build_dir_path = fs::absolute(manifest.dirs.build).string(); // the guard has us inside dep_path
 
-    std::string libs_flags;
-    if (auto dep_name_node = profile["manifest"]["name"]) {
-        auto lib_name = dep_name_node.as<std::string>();
-        catalyst::logger.log(LogLevel::DEBUG, "Adding library: {}", lib_name);
-        libs_flags += std::format(" -l{}", lib_name);
-    }
+    catalyst::logger.log(LogLevel::DEBUG, "Adding library: {}", manifest.name);
+    std::string libs_flags = std::format(" -l{}", manifest.name);
 
-    return FindRes{.lib_path = library_path_flags, .inc_path = include_path_flags, .libs = libs_flags};
+    return FindRes{.lib_path = library_path_flags,
+                   .inc_path = include_path_flags,
+                   .libs = libs_flags,
+                   .build_dir = build_dir_path};
 }
 } // namespace catalyst::generate
@@ -1,10 +1,13 @@
+#include <exception>
 #include <expected>
 #include <format>
 #include <string>
+#include <vector>
 
 #include "catalyst/dir_guard.hpp"
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 #include "yaml-cpp/node/node.h"
 
@@ -34,42 +37,34 @@ std::expected<FindRes, std::string> findLocal(const YAML::Node &dep) {
     if (dep["using"] && dep["using"].IsSequence())
         features = dep["using"].as<std::vector<std::string>>();
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles for local dependency.");
-    auto pc = catalyst::generate::profileComposition(profiles);
-
-    if (!pc) {
-        return std::unexpected(pc.error());
+    utils::yaml::Configuration config;
+    try {
+        config = utils::yaml::Configuration{profiles};
+    } catch (const std::exception &err) {
+        return std::unexpected(err.what());
     }
-    YAML::Node profile = pc.value();
+    const auto &manifest = config.snapshot().manifest;
 
     // DO NOT rebuild here. This should have been done in fetch::fetch_local or something.
 
     // Add include directories
     std::string include_path;
-    if (auto includes = profile["manifest"]["dirs"]["include"]; includes && includes.IsSequence()) {
-        for (const auto &dir : includes.as<std::vector<std::string>>()) {
-            auto curr = fs::absolute(dep_path / dir);
-            catalyst::logger.log(LogLevel::DEBUG, "Adding include path: {}", curr.string());
-            include_path += std::format(" -I{}", curr.string());
-        }
+    for (const auto &dir : manifest.dirs.include) {
+        auto curr = fs::absolute(dep_path / dir);
+        catalyst::logger.log(LogLevel::DEBUG, "Adding include path: {}", curr.string());
+        include_path += std::format(" -I{}", curr.string());
     }
 
     // Add library directory
-    std::string library_path;
-    if (auto build_dir_node = profile["manifest"]["dirs"]["build"]) {
-        auto build_dir = build_dir_node.as<std::string>();
-        auto lib_path = fs::absolute(dep_path / build_dir);
-        catalyst::logger.log(LogLevel::DEBUG, "Adding library path: {}", lib_path.string());
-        library_path += std::format(" -L{}", lib_path.string());
-    }
+    auto lib_path = fs::absolute(dep_path / manifest.dirs.build);
+    catalyst::logger.log(LogLevel::DEBUG, "Adding library path: {}", lib_path.string());
+    std::string library_path = std::format(" -L{}", lib_path.string());
+    std::string build_dir_path = fs::absolute(manifest.dirs.build).string(); // the guard has us inside dep_path
 
     // Add library
-    std::string libs;
-    if (auto dep_name_node = profile["manifest"]["name"]) {
-        auto dep_name = dep_name_node.as<std::string>();
-        catalyst::logger.log(LogLevel::DEBUG, "Adding library: {}", dep_name);
-        libs += std::format(" -l{}", dep_name);
-    }
+    catalyst::logger.log(LogLevel::DEBUG, "Adding library: {}", manifest.name);
+    std::string libs = std::format(" -l{}", manifest.name);
 
-    return FindRes{.lib_path = library_path, .inc_path = include_path, .libs = libs};
+    return FindRes{.lib_path = library_path, .inc_path = include_path, .libs = libs, .build_dir = build_dir_path};
 }
 } // namespace catalyst::generate
@@ -0,0 +1,182 @@
+#include <chrono>
+#include <cstdlib>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include "catalyst/globals.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+
+namespace catalyst::generate {
+namespace fs = std::filesystem;
+
+namespace {
+using utils::hash::Fnv1a;
+
+void stampPath(Fnv1a &hasher, const fs::path &path) {
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    hasher.update(path.string());
+    hasher.update(ec ? std::uint64_t{0} : static_cast<std::uint64_t>(mtime.time_since_epoch().count()));
+}
+
+/// Stamp every profile file a dependency's composition may read.
+void stampManifests(Fnv1a &hasher, const fs::path &dir) {
+    stampPath(hasher, dir); // catches added/removed profile files
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(dir, ec)) {
+        auto name = entry.path().filename().string();
+        if (name == "CATALYST.yaml" || (name.starts_with("catalyst") && name.ends_with(".yaml")))
+            stampPath(hasher, entry.path());
+    }
+}
+
+std::string envOrEmpty(const char *name) {
+    const char *value = std::getenv(name);
+    return value == nullptr ? "" : value;
+}
+} // namespace
+
+fs::path generateStatePath(const fs::path &build_dir) {
+    return build_dir / ".catalyst" / "generate.json";
+}
+
+GenerateState loadGenerateState(const fs::path &state_path) {
+    GenerateState state;
+    std::ifstream file{state_path};
+    if (!file)
+        return state;
+
+    try {
+        nlohmann::json j = nlohmann::json::parse(file);
+        state.fingerprint = j.value("fingerprint", "");
+        state.durations = j.value("durations", "");
+        for (const auto &[key, entry] : j.value("deps", nlohmann::json::object()).items()) {
+            state.deps[key] = DepCacheEntry{.stamp = entry.at("stamp").get<std::string>(),
+                                            .res = FindRes{.lib_path = entry.at("lib_path").get<std::string>(),
+                                                           .inc_path = entry.at("inc_path").get<std::string>(),
+                                                           .libs = entry.at("libs").get<std::string>(),
+                                                           .build_dir = entry.value("build_dir", "")}};
+        }
+    } catch (const nlohmann::json::exception &err) {
+        catalyst::logger.log(LogLevel::DEBUG, "Discarding unreadable generate state {}: {}", state_path.string(), err.what());
+        return {};
+    }
+    return state;
+}
+
+std::expected<void, std::string> saveGenerateState(const fs::path &state_path, const GenerateState &state) {
+    nlohmann::json j;
+    j["fingerprint"] = state.fingerprint;
+    j["durations"] = state.durations;
+    j["deps"] = nlohmann::json::object();
+    for (const auto &[key, entry] : state.deps) {
+        j["deps"][key] = {{"stamp", entry.stamp},
+                          {"lib_path", entry.res.lib_path},
+                          {"inc_path", entry.res.inc_path},
+                          {"libs", entry.res.libs},
+                          {"build_dir", entry.res.build_dir}};
+    }
+
+    std::error_code ec;
+    fs::create_directories(state_path.parent_path(), ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", state_path.parent_path().string(), ec.message()));
+    if (auto res = utils::fs::writeIfChanged(state_path, j.dump(2)); !res)
+        return std::unexpected(res.error());
+    return {};
+}
+
+std::string depKey(const YAML::Node &dep) {
+    return Fnv1a{}.update(YAML::Dump(dep)).hexDigest();
+}
+
+std::string depStamp(const std::string &build_dir, const YAML::Node &dep) {
+    Fnv1a hasher;
+    std::string source = dep["source"] && dep["source"].IsScalar() ? dep["source"].Scalar() : "";
+    std::string name = dep["name"] && dep["name"].IsScalar() ? dep["name"].Scalar() : "";
+    hasher.update(source);
+
+    if (source == "local" && dep["path"]) {
+        stampManifests(hasher, dep["path"].as<std::string>());
+    } else if (source == "git") {
+        stampManifests(hasher, fs::path{build_dir} / "catalyst-libs" / name);
+    } else if (source == "vcpkg") {
+        std::string vcpkg_root = envOrEmpty("VCPKG_ROOT");
+        std::string triplet = dep["triplet"] && dep["triplet"].IsScalar() ? dep["triplet"].Scalar() : "";
+        hasher.update(vcpkg_root);
+        if (!vcpkg_root.empty()) {
+            stampPath(hasher, fs::path{vcpkg_root} / "packages" / std::format("{}_{}", name, triplet));
+            stampPath(hasher, fs::path{vcpkg_root} / "installed" / triplet / "lib");
+        }
+    } else if (source == "system") {
+        // pkg-config answers change when .pc files are (re)installed, which touches their directory
+        std::string search_path = envOrEmpty("PKG_CONFIG_PATH");
+        hasher.update(search_path);
+        std::vector<fs::path> pc_dirs{"/usr/lib/pkgconfig",
+                                      "/usr/share/pkgconfig",
+                                      "/usr/local/lib/pkgconfig",
+                                      "/usr/local/share/pkgconfig",
+                                      "/usr/lib/x86_64-linux-gnu/pkgconfig",
+                                      "/usr/lib/aarch64-linux-gnu/pkgconfig",
+                                      "/opt/homebrew/lib/pkgconfig"};
+        for (std::size_t begin = 0; begin < search_path.size();) {
+            std::size_t end = search_path.find(':', begin);
+            if (end == std::string::npos)
+                end = search_path.size();
+            if (end > begin)
+                pc_dirs.emplace_back(search_path.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        for (const auto &dir : pc_dirs)
+            stampPath(hasher, dir);
+    }
+    return hasher.hexDigest();
+}
+
+std::string inputFingerprint(const utils::yaml::Configuration &config,
+                             const std::vector<std::string> &enabled_features,
+                             const std::string &generator,
+                             const std::vector<std::string> &source_dirs,
+                             const std::vector<fs::path> &sources,
+                             std::string_view include_digest,
+                             const std::vector<std::string> &dep_stamps) {
+    Fnv1a hasher;
+    hasher.update(CATALYST_VERSION);
+    hasher.update(generator);
+    hasher.update(fs::current_path().string());
+    hasher.update(envOrEmpty("VCPKG_ROOT"));
+    hasher.update(YAML::Dump(config.getRoot()));
+
+    hasher.update(enabled_features.size());
+    for (const auto &feature : enabled_features)
+        hasher.update(feature);
+
+    for (const auto &dir : source_dirs) {
+        hasher.update(dir);
+        if (auto ignore_hash = utils::hash::hashFile(fs::path{dir} / ".catalystignore"))
+            hasher.update(*ignore_hash);
+    }
+
+    hasher.update(sources.size());
+    for (const auto &src : sources)
+        hasher.update(src.string());
+    hasher.update(include_digest);
+
+    for (const auto &stamp : dep_stamps)
+        hasher.update(stamp);
+
+    return hasher.hexDigest();
+}
+} // namespace catalyst::generate
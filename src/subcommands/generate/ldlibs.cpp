@@ -6,8 +6,7 @@
 
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/subcommands/generate.hpp"
-
-#include "yaml-cpp/yaml.h"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 namespace fs = std::filesystem;
 namespace catalyst::generate {
@@ -39,10 +38,8 @@ std::string ld_filter(std::string &ldflags) {
 } // namespace
 
 // NOTE: used for run::action. Needs to be updated to use find_*.
-std::expected<std::string, std::string> libPath(const YAML::Node &profile) {
+std::expected<std::string, std::string> libPath(const utils::yaml::Configuration &config, const fs::path &build_dir) {
     catalyst::logger.log(LogLevel::DEBUG, "Calculating LD_LIBRARY_PATH.");
-    fs::path current_dir = fs::current_path();
-    fs::path build_dir{profile["manifest"]["dirs"]["build"].as<std::string>()};
     std::string ldflags = "-Lcatalyst-libs";
 
     if (const char *vcpkg_root = std::getenv("VCPKG_ROOT"); vcpkg_root != nullptr) {
@@ -58,14 +55,11 @@ std::expected<std::string, std::string> libPath(const YAML::Node &profile) {
         logger.log(LogLevel::WARN, "VCPKG_ROOT environment variable is not defined.");
     }
 
-    if (auto deps = profile["dependencies"]; deps && deps.IsSequence()) {
-        for (const auto &dep : deps) {
-            if (auto res = findDep(build_dir.string(), dep); !res) {
-                catalyst::logger.log(
-                    LogLevel::ERROR, "Failed to resolve dependency {}: {}", dep["name"].as<std::string>(), res.error());
-            } else {
-                ldflags += " " + res.value().lib_path;
-            }
+    for (const auto &dep : config.snapshot().dependencies) {
+        if (auto res = findDep(build_dir.string(), dep.node); !res) {
+            catalyst::logger.log(LogLevel::ERROR, "Failed to resolve dependency {}: {}", dep.name, res.error());
+        } else {
+            ldflags += " " + res.value().lib_path;
         }
     }
     return ld_filter(ldflags);
@@ -0,0 +1,338 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/process_exec.hpp"
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/user_cache_dir.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/includes/scanner.hpp"
+
+namespace catalyst::generate {
+namespace fs = std::filesystem;
+
+namespace {
+bool isClang(std::string_view cxx) {
+    return cxx.find("clang") != std::string_view::npos;
+}
+
+/// `M:part` -> `M-part`, the file name compilers use for a partition's BMI.
+std::string bmiStem(std::string_view module) {
+    std::string stem{module};
+    std::ranges::replace(stem, ':', '-');
+    return stem;
+}
+
+std::string trim(std::string str) {
+    if (auto last = str.find_last_not_of(" \t\n"); last != std::string::npos)
+        str.erase(last + 1);
+    else
+        str.clear();
+    return str;
+}
+
+std::vector<std::string> splitFlags(std::string_view flags) {
+    std::vector<std::string> split;
+    for (auto word : flags | std::views::split(' ')) {
+        if (!word.empty())
+            split.emplace_back(word.begin(), word.end());
+    }
+    return split;
+}
+
+std::expected<void, std::string> run(std::vector<std::string> &&args) {
+    std::string command = args.front();
+    auto proc = catalyst::processExec(std::move(args));
+    if (!proc)
+        return std::unexpected(proc.error());
+    if (int res = proc->get(); res != 0)
+        return std::unexpected(std::format("{} exited with code {}", command, res));
+    return {};
+}
+
+/// The standard library's module manifest (P3286), as printed by `-print-file-name`.
+std::optional<fs::path> stdModuleManifest(std::string_view cxx) {
+    for (const char *name : {"libc++.modules.json", "libstdc++.modules.json"}) {
+        auto printed = catalyst::processExecStdout({std::string{cxx}, std::format("-print-file-name={}", name)});
+        if (!printed)
+            continue;
+        fs::path path = trim(*printed);
+        if (path.is_absolute() && fs::is_regular_file(path))
+            return path; // otherwise the compiler just echoes the name back
+    }
+    return std::nullopt;
+}
+
+/// Build `wanted` standard modules (`std`, `std.compat`) into the user's cache, once per compiler, compiler version
+/// and flag set, and add them to `plan`. Later projects with the same toolchain reuse them.
+std::expected<void, std::string> prebuildStdModules(const std::vector<std::string> &wanted,
+                                                    std::string_view cxx,
+                                                    std::string_view cxxflags,
+                                                    ModulePlan &plan) {
+    auto manifest_path = stdModuleManifest(cxx);
+    if (!manifest_path)
+        return std::unexpected(
+            std::format("import {}: {} ships no standard library module manifest", wanted.front(), cxx));
+
+    struct StdModule {
+        fs::path source;
+        std::vector<std::string> include_dirs;
+    };
+    std::unordered_map<std::string, StdModule> available;
+    try {
+        std::ifstream file{*manifest_path};
+        nlohmann::json manifest = nlohmann::json::parse(file);
+        for (const auto &module : manifest.at("modules")) {
+            StdModule std_module{.source = manifest_path->parent_path() / module.at("source-path").get<std::string>(),
+                                 .include_dirs = {}};
+            if (auto args = module.find("local-arguments"); args != module.end()) {
+                for (const auto &dir : args->value("system-include-directories", std::vector<std::string>{}))
+                    std_module.include_dirs.push_back((manifest_path->parent_path() / dir).lexically_normal());
+            }
+            available.emplace(module.at("logical-name").get<std::string>(), std::move(std_module));
+        }
+    } catch (const nlohmann::json::exception &err) {
+        return std::unexpected(std::format("Failed to read {}: {}", manifest_path->string(), err.what()));
+    }
+
+    auto version = catalyst::processExecStdout({std::string{cxx}, "--version"});
+    const std::string key = utils::hash::Fnv1a{}
+                                .update(cxx)
+                                .update(version.value_or(""))
+                                .update(cxxflags)
+                                .update(manifest_path->string())
+                                .hexDigest();
+    const fs::path dir = utils::fs::userCacheDir() / "std_modules" / key;
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", dir.string(), ec.message()));
+
+    const std::string bmi_ext = isClang(cxx) ? ".pcm" : ".gcm";
+    const fs::path mapper = dir / "modules.map";
+    if (!isClang(cxx)) {
+        std::string mapping;
+        for (const auto &[name, module] : available)
+            mapping += std::format("{} {}\n", name, (dir / (name + bmi_ext)).string());
+        if (auto res = utils::fs::writeIfChanged(mapper, mapping); !res)
+            return std::unexpected(res.error());
+    }
+
+    // std.compat imports std, so std is always built, and first
+    std::vector<std::string> order{"std"};
+    if (std::ranges::find(wanted, "std.compat") != wanted.end())
+        order.emplace_back("std.compat");
+    for (const auto &name : order) {
+        auto module = available.find(name);
+        if (module == available.end())
+            return std::unexpected(std::format("{} does not provide module {}", manifest_path->string(), name));
+        const fs::path bmi = dir / (name + bmi_ext);
+        const fs::path object = dir / (name + ".o");
+        // the object is renamed into place last, so its presence means both are complete
+        if (!fs::exists(object)) {
+            catalyst::logger.log(LogLevel::INFO, "Prebuilding module {} for {}.", name, cxx);
+            std::vector<std::string> flags = splitFlags(cxxflags);
+            if (isClang(cxx))
+                flags.emplace_back("-Wno-reserved-module-identifier");
+            for (const auto &include_dir : module->second.include_dirs) {
+                flags.emplace_back("-isystem");
+                flags.push_back(include_dir);
+            }
+            const std::string tmp_suffix = std::format(".tmp{}", ::getpid());
+            auto command = [&](std::vector<std::string> args) {
+                std::vector<std::string> full{std::string{cxx}};
+                full.insert(full.end(), flags.begin(), flags.end());
+                full.insert(full.end(), args.begin(), args.end());
+                return full;
+            };
+            if (isClang(cxx)) {
+                std::vector<std::string> imports;
+                if (name != "std")
+                    imports.push_back(std::format("-fmodule-file=std={}", (dir / ("std" + bmi_ext)).string()));
+                std::vector<std::string> precompile = imports;
+                precompile.insert(precompile.end(),
+                                  {"--precompile",
+                                   "-x",
+                                   "c++-module",
+                                   module->second.source.string(),
+                                   "-o",
+                                   bmi.string() + tmp_suffix});
+                if (auto res = run(command(std::move(precompile))); !res)
+                    return std::unexpected(std::format("Failed to prebuild module {}: {}", name, res.error()));
+                fs::rename(bmi.string() + tmp_suffix, bmi, ec);
+                std::vector<std::string> compile = imports;
+                compile.insert(compile.end(), {"-c", bmi.string(), "-o", object.string() + tmp_suffix});
+                if (auto res = run(command(std::move(compile))); !res)
+                    return std::unexpected(std::format("Failed to prebuild module {}: {}", name, res.error()));
+            } else {
+                // GCC writes the BMI where the mapper says, as a side effect of compiling the object
+                if (auto res = run(command({"-fmodules-ts",
+                                            std::format("-fmodule-mapper={}", mapper.string()),
+                                            "-x",
+                                            "c++",
+                                            "-c",
+                                            module->second.source.string(),
+                                            "-o",
+                                            object.string() + tmp_suffix}));
+                    !res)
+                    return std::unexpected(std::format("Failed to prebuild module {}: {}", name, res.error()));
+            }
+            fs::rename(object.string() + tmp_suffix, object, ec);
+            if (ec)
+                return std::unexpected(std::format("Failed to store {}: {}", object.string(), ec.message()));
+        }
+        plan.prebuilt[name] = bmi.string();
+        plan.link_objects.push_back(object.string());
+    }
+    return {};
+}
+
+/// Modules a dependency built by Catalyst provides, from the modules.json its generate step wrote.
+void addDependencyModules(const std::vector<FindRes> &dep_results, ModulePlan &plan) {
+    for (const auto &dep : dep_results) {
+        if (dep.build_dir.empty())
+            continue;
+        const fs::path manifest_path = fs::path{dep.build_dir} / "modules.json";
+        std::ifstream file{manifest_path};
+        if (!file)
+            continue;
+        try {
+            for (const auto &[name, bmi] : nlohmann::json::parse(file).items())
+                plan.prebuilt.emplace(name, bmi.get<std::string>());
+        } catch (const nlohmann::json::exception &err) {
+            catalyst::logger.log(LogLevel::WARN, "Ignoring unreadable {}: {}", manifest_path.string(), err.what());
+        }
+    }
+}
+
+std::expected<void, std::string> checkCycles(const ModulePlan &plan,
+                                             const utils::includes::IncludeGraph &include_graph) {
+    enum class Mark : std::uint8_t { Visiting, Done };
+    std::unordered_map<std::string, Mark> marks;
+    std::vector<std::string> chain;
+    auto visit = [&](auto &self, const std::string &module) -> std::expected<void, std::string> {
+        auto provider = plan.providers.find(module);
+        if (provider == plan.providers.end())
+            return {};
+        if (auto mark = marks.find(module); mark != marks.end()) {
+            if (mark->second == Mark::Done)
+                return {};
+            std::string cycle;
+            for (const auto &link : chain | std::views::drop_while([&](const auto &m) { return m != module; }))
+                cycle += link + " -> ";
+            return std::unexpected(std::format("Module import cycle: {}{}", cycle, module));
+        }
+        marks[module] = Mark::Visiting;
+        chain.push_back(module);
+        for (const auto &import : include_graph.moduleInfo(provider->second).imports) {
+            if (import == module)
+                continue;
+            if (auto res = self(self, import); !res)
+                return res;
+        }
+        chain.pop_back();
+        marks[module] = Mark::Done;
+        return {};
+    };
+    for (const auto &[module, source] : plan.providers) {
+        if (auto res = visit(visit, module); !res)
+            return res;
+    }
+    return {};
+}
+} // namespace
+
+std::expected<ModulePlan, std::string> prepareModules(const std::vector<fs::path> &sources,
+                                                      const utils::includes::IncludeGraph &include_graph,
+                                                      const std::vector<FindRes> &dep_results,
+                                                      const fs::path &build_dir,
+                                                      std::string_view cxx,
+                                                      std::string_view cxxflags) {
+    ModulePlan plan;
+    const fs::path abs_build_dir = fs::absolute(build_dir);
+    std::unordered_map<std::string, std::string> bmis; // every module a compile may import -> its BMI
+
+    for (const auto &source : sources) {
+        const auto &info = include_graph.moduleInfo(source);
+        if (!info.providesBmi())
+            continue;
+        if (auto [it, inserted] = plan.providers.emplace(info.name, source); !inserted)
+            return std::unexpected(std::format(
+                "Module {} is declared by both {} and {}", info.name, it->second.string(), source.string()));
+        // clang's -fmodule-output puts the BMI next to the object; GCC's goes wherever the mapper says
+        bmis[info.name] = isClang(cxx) ? (abs_build_dir / objectPath(source)).replace_extension(".pcm").string()
+                                       : (abs_build_dir / "bmi" / (bmiStem(info.name) + ".gcm")).string();
+    }
+
+    addDependencyModules(dep_results, plan);
+    std::vector<std::string> std_wanted;
+    for (const auto &source : sources) {
+        for (const auto &import : include_graph.moduleInfo(source).imports) {
+            if (plan.providers.contains(import) || plan.prebuilt.contains(import))
+                continue;
+            if (import == "std" || import == "std.compat") {
+                if (std::ranges::find(std_wanted, import) == std_wanted.end())
+                    std_wanted.push_back(import);
+                continue;
+            }
+            return std::unexpected(std::format(
+                "Module {} imported by {} is not provided by any source or dependency", import, source.string()));
+        }
+    }
+    if (!std_wanted.empty()) {
+        if (auto res = prebuildStdModules(std_wanted, cxx, cxxflags, plan); !res)
+            return std::unexpected(res.error());
+    }
+    if (auto res = checkCycles(plan, include_graph); !res)
+        return std::unexpected(res.error());
+
+    // dependents find our interfaces here, whether or not we have any
+    nlohmann::json exported = nlohmann::json::object();
+    for (const auto &[name, source] : plan.providers) {
+        if (include_graph.moduleInfo(source).exported && name.find(':') == std::string::npos)
+            exported[name] = bmis[name];
+    }
+    if (auto res = utils::fs::writeIfChanged(build_dir / "modules.json", exported.dump(2)); !res)
+        return std::unexpected(res.error());
+
+    if (plan.empty())
+        return plan;
+    bmis.insert(plan.prebuilt.begin(), plan.prebuilt.end());
+    if (isClang(cxx)) {
+        // loaded lazily: a compile only reads the BMIs it imports
+        for (const auto &[name, bmi] : std::map<std::string, std::string>{bmis.begin(), bmis.end()})
+            plan.flags += std::format("{}-fmodule-file={}={}", plan.flags.empty() ? "" : " ", name, bmi);
+        plan.interface_flags = "-fmodule-output -x c++-module";
+    } else {
+        std::string mapping;
+        for (const auto &[name, bmi] : std::map<std::string, std::string>{bmis.begin(), bmis.end()})
+            mapping += std::format("{} {}\n", name, bmi);
+        std::error_code ec;
+        fs::create_directories(build_dir / "bmi", ec);
+        if (auto res = utils::fs::writeIfChanged(build_dir / "modules.map", mapping); !res)
+            return std::unexpected(res.error());
+        plan.flags = std::format("-fmodules-ts -fmodule-mapper={}", (abs_build_dir / "modules.map").string());
+        plan.interface_flags = "-x c++";
+    }
+    return plan;
+}
+} // namespace catalyst::generate
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/ignore/ignore_set.hpp"
+#include "catalyst/utils/includes/scanner.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::generate {
+namespace fs = std::filesystem;
+
+namespace {
+bool isCxxSource(const fs::path &path) {
+    const std::string extension = path.extension().string();
+    return extension == ".cpp" || extension == ".cxx" || extension == ".cc";
+}
+
+/// What `auto` precompiles and for whom.
+struct Picked {
+    std::vector<std::string> headers;
+    std::unordered_set<std::string> users; ///< the C++ sources that include every picked header
+};
+
+/// External headers that at least `min_percent` of the C++ sources all include outside any `#if`, most used first,
+/// and those sources. Each header is only added while the sources that include all of the picks stay that many, so
+/// the PCH never brings a header into a source that did not include it.
+/// Project headers are never picked: editing one would rebuild the PCH and, with it, every object.
+std::expected<Picked, std::string> pickHeaders(const PchOptions &options,
+                                               const std::vector<fs::path> &sources,
+                                               const utils::includes::IncludeGraph &include_graph) {
+    auto exclude = utils::ignore::IgnoreSet::compile(options.exclude);
+    if (!exclude)
+        return std::unexpected(std::format("manifest.build.pch.exclude: {}", exclude.error()));
+
+    std::unordered_map<std::string, std::unordered_set<std::string>> reached_by; ///< by spelling
+    std::size_t cxx_sources = 0;
+    for (const auto &source : sources) {
+        if (!isCxxSource(source))
+            continue;
+        ++cxx_sources;
+        for (auto &spelling : include_graph.unconditionalExternalIncludes(source))
+            reached_by[std::move(spelling)].insert(source.string());
+    }
+    if (cxx_sources < 2)
+        return Picked{}; // nothing to share
+    auto enough = [&](std::size_t count) {
+        return count * 100 >= static_cast<std::size_t>(options.min_percent) * cxx_sources;
+    };
+
+    std::vector<std::pair<std::string, std::size_t>> ranked;
+    for (const auto &[spelling, users] : reached_by) {
+        if (!enough(users.size()))
+            continue;
+        if (!exclude->empty() && exclude->matches(spelling, false))
+            continue;
+        ranked.emplace_back(spelling, users.size());
+    }
+    std::ranges::sort(ranked, [](const auto &lhs, const auto &rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    });
+
+    Picked picked;
+    for (const auto &[spelling, count] : ranked) {
+        if (picked.headers.size() == options.max_headers)
+            break;
+        const auto &users = reached_by.at(spelling);
+        std::unordered_set<std::string> remaining;
+        if (picked.headers.empty()) {
+            remaining = users;
+        } else {
+            for (const auto &source : picked.users) {
+                if (users.contains(source))
+                    remaining.insert(source);
+            }
+        }
+        if (!enough(remaining.size()))
+            continue;
+        catalyst::logger.log(
+            LogLevel::DEBUG, "PCH: <{}> is included by {} of {} sources.", spelling, count, cxx_sources);
+        picked.headers.push_back(spelling);
+        picked.users = std::move(remaining);
+    }
+    return picked;
+}
+} // namespace
+
+std::expected<PchOptions, std::string> pchOptions(const utils::yaml::Configuration &config) {
+    PchOptions options;
+    options.header = config.getString("manifest.build.pch.header").value_or("");
+    if (auto max_headers = config.getInt("manifest.build.pch.max_headers")) {
+        if (*max_headers <= 0)
+            return std::unexpected(
+                std::format("manifest.build.pch.max_headers must be positive, got {}", *max_headers));
+        options.max_headers = static_cast<std::size_t>(*max_headers);
+    }
+    if (auto min_percent = config.getInt("manifest.build.pch.min_percent")) {
+        if (*min_percent < 0 || *min_percent > 100)
+            return std::unexpected(
+                std::format("manifest.build.pch.min_percent must be between 0 and 100, got {}", *min_percent));
+        options.min_percent = *min_percent;
+    }
+    options.exclude = config.getStringVector("manifest.build.pch.exclude").value_or(std::vector<std::string>{});
+    return options;
+}
+
+std::expected<std::optional<Pch>, std::string> preparePch(const PchOptions &options,
+                                                          const std::vector<fs::path> &sources,
+                                                          const utils::includes::IncludeGraph &include_graph,
+                                                          const fs::path &build_dir,
+                                                          std::string_view cxx) {
+    if (options.header.empty())
+        return std::nullopt;
+
+    Pch pch;
+    // not .hpp: Make's $in leaves headers out of $^
+    pch.header = fs::absolute(build_dir / "pch" / "catalyst_pch.hxx");
+    // the compiler finds the PCH next to the header named by -include, under its own suffix
+    pch.output = (fs::path{"pch"} / pch.header.filename()).string() +
+                 (cxx.find("clang") != std::string_view::npos ? ".pch" : ".gch");
+
+    std::string content = "// Generated by Catalyst: precompiled header. Do not edit.\n";
+    if (options.header == "auto") {
+        auto picked = pickHeaders(options, sources, include_graph);
+        if (!picked)
+            return std::unexpected(picked.error());
+        if (picked->headers.empty()) {
+            catalyst::logger.log(LogLevel::INFO, "No header is shared widely enough to precompile.");
+            return std::nullopt;
+        }
+        catalyst::logger.log(LogLevel::DEBUG,
+                             "Precompiling {} headers for {} sources.",
+                             picked->headers.size(),
+                             picked->users.size());
+        for (const auto &spelling : picked->headers)
+            content += std::format("#include <{}>\n", spelling);
+        pch.users = std::move(picked->users);
+    } else {
+        fs::path header = fs::absolute(options.header).lexically_normal();
+        if (!fs::is_regular_file(header))
+            return std::unexpected(std::format("manifest.build.pch.header: {} does not exist", options.header));
+        content += std::format("#include \"{}\"\n", header.string());
+        pch.deps.push_back(header.string());
+        for (const auto &dep : include_graph.transitiveIncludes(header))
+            pch.deps.push_back(dep.string());
+        for (const auto &source : sources) {
+            if (isCxxSource(source))
+                pch.users.insert(source.string());
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(pch.header.parent_path(), ec);
+    if (ec)
+        return std::unexpected(
+            std::format("Failed to create {}: {}", pch.header.parent_path().string(), ec.message()));
+    if (auto res = utils::fs::writeIfChanged(pch.header, content); !res)
+        return std::unexpected(res.error());
+    return pch;
+}
+} // namespace catalyst::generate
@@ -1,28 +1,28 @@
-#include <sys/wait.h>
-
 #include <expected>
 #include <filesystem>
-#include <ranges>
-#include <regex>
+#include <format>
+#include <optional>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 #include <yaml-cpp/yaml.h>
 
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/walk.hpp"
+#include "catalyst/utils/ignore/ignore_set.hpp"
 
 namespace fs = std::filesystem;
 
 namespace {
 
-std::optional<std::unordered_set<std::string>> createIgnorePatterns(const fs::path &dir,
-                                                                    const std::vector<std::string> &profiles) {
+// NOTE: patterns keep their file order, since for globs the last matching pattern wins
+std::optional<std::vector<std::string>> createIgnorePatterns(const fs::path &dir,
+                                                             const std::vector<std::string> &profiles) {
     using catalyst::LogLevel, catalyst::logger;
 
     fs::path ignore_file = dir / ".catalystignore";
-    std::unordered_set<std::string> ignore_patterns;
+    std::vector<std::string> ignore_patterns;
 
     if (!fs::exists(ignore_file)) {
         logger.log(LogLevel::DEBUG, "No .catalystignore file found in: {}", dir.string());
@@ -35,90 +35,99 @@ std::optional<std::unordered_set<std::string>> createIgnorePatterns(const fs::pa
             for (const auto &ignore_pattern : ignore_config[profile]) {
                 auto pattern = ignore_pattern.as<std::string>();
                 logger.log(LogLevel::DEBUG, "Ignoring pattern: {}", pattern);
-                ignore_patterns.insert(pattern);
+                ignore_patterns.push_back(pattern);
             }
         }
     }
     return ignore_patterns;
 }
 
-std::expected<std::unordered_set<fs::path>, std::string> buildSourceSet(const fs::path &dir,
-                                                                        const std::vector<std::string> &profiles) {
-    using catalyst::LogLevel, catalyst::logger;
-
-    logger.log(LogLevel::DEBUG, "Processing source directory: {}", dir.string());
-
-    if (!fs::exists(dir) || !fs::is_directory(dir)) {
-        return std::unexpected(std::format("Source directory not found or is not a directory: {}", dir.string()));
-    }
-
-    auto ignore_patterns_opt = createIgnorePatterns(dir, profiles);
-    if (!ignore_patterns_opt) {
-        return {};
-    }
-
-    std::unordered_set<std::string> ignore_patterns = *ignore_patterns_opt;
-
-    std::unordered_set<fs::path> source_set;
-
-    const std::vector<std::regex> ignore_regexes = [&ignore_patterns]() {
-        std::vector<std::regex> ret_vec;
-        ret_vec.reserve(ignore_patterns.size());
-        for (const auto &ignore_pattern : ignore_patterns) {
-            logger.log(LogLevel::DEBUG, "Compiled ignore pattern: {}", ignore_pattern);
-            ret_vec.emplace_back(ignore_pattern);
-        }
-        return ret_vec;
-    }();
-
-    for (const auto &entry : fs::recursive_directory_iterator(dir)) {
-        if (entry.is_regular_file()) {
-            bool ignored = false;
-            for (const auto &ignore_regex : ignore_regexes) {
-                if (std::regex_match(entry.path().filename().string(), ignore_regex)) {
-                    logger.log(LogLevel::DEBUG, "Ignoring file: {}", entry.path().string());
-                    ignored = true;
-                    break;
-                }
-            }
-            if (!ignored) {
-                const auto &path = entry.path();
-                const std::string extension = path.extension().string();
-                if (extension == ".cpp" || extension == ".cxx" || extension == ".cc" || extension == ".c" ||
-                    extension == ".cu" || extension == ".cupp") {
-                    logger.log(LogLevel::DEBUG, "Adding file to source set: {}", path.string());
-                    source_set.insert(path);
-                }
-            }
-        }
-    }
+bool isSourceFile(const fs::path &name) {
+    const std::string extension = name.extension().string();
+    return extension == ".cpp" || extension == ".cxx" || extension == ".cc" || extension == ".c" ||
+           extension == ".cu" || extension == ".cupp";
+}
 
-    return source_set;
+/// `path` relative to `root`, with '/' separators, as IgnoreSet expects.
+std::string relativeTo(const fs::path &root, const fs::path &path) {
+    std::string rel = path.generic_string().substr(root.generic_string().size());
+    if (rel.starts_with('/'))
+        rel.erase(0, 1);
+    return rel;
 }
 } // namespace
 
 namespace catalyst::generate {
-std::expected<std::unordered_set<fs::path>, std::string> buildSourceSet(const std::vector<std::string> &source_dirs,
-                                                                        const std::vector<std::string> &profiles) {
+std::expected<std::vector<fs::path>, std::string> buildSourceSet(const std::vector<std::string> &source_dirs,
+                                                                 const std::vector<std::string> &profiles,
+                                                                 utils::fs::ScanCache *scan_cache) {
     catalyst::logger.log(LogLevel::DEBUG, "Building source set.");
-    namespace sv = std::views;
-    auto paths = source_dirs | sv::transform([](const std::string &str) { return fs::path{str}; }) |
-                 std::ranges::to<std::vector>();
-    std::unordered_set<fs::path> source_set;
-
-    for (const auto &dir : paths) {
-        auto source_set_ex = ::buildSourceSet(dir, profiles);
-        if (!source_set_ex) {
-            catalyst::logger.log(LogLevel::ERROR,
-                                 "Failed to build source set for directory {}: {}",
-                                 dir.string(),
-                                 source_set_ex.error());
-            return std::unexpected(source_set_ex.error());
+
+    std::vector<fs::path> roots;
+    std::vector<utils::ignore::IgnoreSet> ignore_sets; // one per root
+    roots.reserve(source_dirs.size());
+    ignore_sets.reserve(source_dirs.size());
+
+    for (const auto &source_dir : source_dirs) {
+        fs::path dir = fs::path{source_dir}.lexically_normal();
+        if (!dir.has_filename())
+            dir = dir.parent_path(); // drop a trailing separator so relative paths start cleanly
+        catalyst::logger.log(LogLevel::DEBUG, "Processing source directory: {}", dir.string());
+        if (!fs::exists(dir) || !fs::is_directory(dir)) {
+            auto err = std::format("Source directory not found or is not a directory: {}", dir.string());
+            catalyst::logger.log(LogLevel::ERROR, "Failed to build source set for directory {}: {}", dir.string(), err);
+            return std::unexpected(err);
         }
-        source_set.insert(source_set_ex->begin(), source_set_ex->end());
+
+        utils::ignore::IgnoreSet ignore_set;
+        if (auto ignore_patterns_opt = createIgnorePatterns(dir, profiles)) {
+            auto compiled = utils::ignore::IgnoreSet::compile(*ignore_patterns_opt);
+            if (!compiled) {
+                catalyst::logger.log(LogLevel::ERROR, "{}/.catalystignore: {}", dir.string(), compiled.error());
+                return std::unexpected(std::format("{}/.catalystignore: {}", dir.string(), compiled.error()));
+            }
+            catalyst::logger.log(
+                LogLevel::DEBUG, "Compiled {} ignore patterns for {}", ignore_patterns_opt->size(), dir.string());
+            ignore_set = std::move(*compiled);
+        }
+        roots.push_back(std::move(dir));
+        ignore_sets.push_back(std::move(ignore_set));
     }
 
-    catalyst::logger.log(LogLevel::DEBUG, "Source set built successfully.");
+    utils::fs::WalkOptions options;
+    options.cache = scan_cache;
+    options.descend = [&](const utils::fs::WalkEntry &entry) {
+        // only globs prune directories; regex rules match file names, as they always have
+        const auto &ignore_set = ignore_sets[entry.root];
+        if (ignore_set.prunesDirs() && ignore_set.matches(relativeTo(roots[entry.root], entry.path), true)) {
+            catalyst::logger.log(LogLevel::DEBUG, "Pruning ignored directory: {}", entry.path.string());
+            return false;
+        }
+        return true;
+    };
+    options.keep = [&](const utils::fs::WalkEntry &entry) {
+        // cheap extension test first, so the patterns only ever see candidate sources
+        if (!isSourceFile(entry.name))
+            return false;
+        const auto &ignore_set = ignore_sets[entry.root];
+        if (!ignore_set.empty() && ignore_set.matches(relativeTo(roots[entry.root], entry.path), false)) {
+            catalyst::logger.log(LogLevel::DEBUG, "Ignoring file: {}", entry.path.string());
+            return false;
+        }
+        return true;
+    };
+
+    auto walked = utils::fs::parallelWalk(roots, options);
+    if (!walked)
+        return std::unexpected(walked.error());
+    std::vector<fs::path> source_set = std::move(*walked);
+
+    if (scan_cache != nullptr)
+        catalyst::logger.log(LogLevel::DEBUG,
+                             "Scan cache: {} directories reused, {} re-listed.",
+                             scan_cache->hits(),
+                             scan_cache->misses());
+    catalyst::logger.log(LogLevel::DEBUG, "Source set built successfully with {} files.", source_set.size());
     return source_set;
 }
 } // namespace catalyst::generate
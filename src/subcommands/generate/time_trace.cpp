@@ -0,0 +1,30 @@
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::generate {
+std::expected<TimeTraceOptions, std::string> timeTraceOptions(const utils::yaml::Configuration &config) {
+    TimeTraceOptions options;
+    options.enabled = config.getBool("manifest.build.time_trace.enabled").value_or(false);
+    if (auto top = config.getInt("manifest.build.time_trace.top")) {
+        if (*top <= 0)
+            return std::unexpected(std::format("manifest.build.time_trace.top must be positive, got {}", *top));
+        options.top = static_cast<std::size_t>(*top);
+    }
+    if (!options.enabled)
+        return options;
+    // -ftime-trace is clang's; GCC rejects the flag and would fail every compile
+    for (std::string_view key : {"CC", "CXX"}) {
+        const std::string path = std::format("manifest.tooling.{}", key);
+        const std::string compiler = config.getString(path).value_or(key == "CC" ? "clang" : "clang++");
+        if (compiler.find("clang") == std::string::npos)
+            return std::unexpected(
+                std::format("manifest.build.time_trace needs clang, but {} is '{}'", path, compiler));
+    }
+    return options;
+}
+} // namespace catalyst::generate
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/ignore/ignore_set.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::generate {
+namespace fs = std::filesystem;
+
+namespace {
+bool isCxxSource(const fs::path &path) {
+    const std::string extension = path.extension().string();
+    return extension == ".cpp" || extension == ".cxx" || extension == ".cc";
+}
+
+/// Uniform in [0, 1), derived from the path only, so a file's boundary vote never depends on its neighbours.
+double boundaryRoll(const fs::path &path) {
+    std::uint64_t hash = utils::hash::Fnv1a{}.update(path.string()).digest();
+    hash ^= hash >> 29; // FNV's low bits are weak for similar strings
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 32;
+    return static_cast<double>(hash >> 11) / static_cast<double>(1ULL << 53);
+}
+} // namespace
+
+std::expected<UnityOptions, std::string> unityOptions(const utils::yaml::Configuration &config) {
+    UnityOptions options;
+    options.enabled = config.getBool("manifest.build.unity.enabled").value_or(false);
+    if (auto bytes = config.getInt("manifest.build.unity.batch_bytes")) {
+        if (*bytes <= 0)
+            return std::unexpected(std::format("manifest.build.unity.batch_bytes must be positive, got {}", *bytes));
+        options.batch_bytes = static_cast<std::uint64_t>(*bytes);
+    }
+    options.exclude = config.getStringVector("manifest.build.unity.exclude").value_or(std::vector<std::string>{});
+    return options;
+}
+
+std::expected<std::vector<UnityBatch>, std::string>
+planUnityBatches(const std::vector<fs::path> &sources, const UnityOptions &options, const fs::path &unity_dir) {
+    auto exclude = utils::ignore::IgnoreSet::compile(options.exclude);
+    if (!exclude)
+        return std::unexpected(std::format("manifest.build.unity.exclude: {}", exclude.error()));
+
+    struct Candidate {
+        const fs::path *path;
+        std::uint64_t weight;
+    };
+    std::vector<Candidate> candidates;
+    const fs::path current_dir = fs::current_path();
+    for (const auto &source : sources) {
+        if (!isCxxSource(source))
+            continue;
+        if (!exclude->empty() && exclude->matches(source.lexically_relative(current_dir).generic_string(), false)) {
+            catalyst::logger.log(LogLevel::DEBUG, "Excluded from unity build: {}", source.string());
+            continue;
+        }
+        std::error_code ec;
+        std::uint64_t size = fs::file_size(source, ec);
+        std::uint64_t weight = ec ? 1 : std::max<std::uint64_t>(size, 1);
+        candidates.push_back({.path = &source, .weight = weight});
+    }
+    if (candidates.empty())
+        return std::vector<UnityBatch>{};
+
+    // A batch closes once it holds at least half the target and a file's roll falls under its cut chance, or
+    // unconditionally at twice the target. The chance is the file's size times a per-byte rate fixed by the target
+    // alone, so batches average out near the target and no file's vote depends on the rest of the source set.
+    const std::uint64_t min_weight = options.batch_bytes / 2;
+    const std::uint64_t max_weight = options.batch_bytes * 2;
+    const double cut_per_byte = 1.0 / static_cast<double>(options.batch_bytes - min_weight);
+
+    std::vector<UnityBatch> batches;
+    std::vector<fs::path> current;
+    std::uint64_t weight = 0;
+    std::size_t batched = 0;
+    auto close = [&] {
+        if (current.size() > 1) {
+            // named after the first member, so unrelated batches keep their names (and objects) across changes
+            std::uint64_t id = utils::hash::Fnv1a{}.update(current.front().string()).digest();
+            fs::path unity_file = unity_dir / std::format("unity_{}.cpp", utils::hash::toHex(id));
+            batched += current.size();
+            batches.push_back(UnityBatch{.unity_file = std::move(unity_file), .members = std::move(current)});
+        }
+        current.clear(); // a lone file compiles on its own
+        weight = 0;
+    };
+    for (const auto &[path, file_weight] : candidates) {
+        current.push_back(*path);
+        weight += file_weight;
+        const double cut_chance = std::min(static_cast<double>(file_weight) * cut_per_byte, 1.0);
+        if ((weight >= min_weight && boundaryRoll(*path) < cut_chance) || weight >= max_weight)
+            close();
+    }
+    close();
+
+    catalyst::logger.log(
+        LogLevel::DEBUG, "Planned {} unity batches for {} of {} sources.", batches.size(), batched, sources.size());
+    return batches;
+}
+
+std::expected<void, std::string> writeUnitySources(const std::vector<UnityBatch> &batches, const fs::path &unity_dir) {
+    std::error_code ec;
+    fs::create_directories(unity_dir, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", unity_dir.string(), ec.message()));
+
+    std::unordered_set<std::string> current;
+    for (const auto &batch : batches) {
+        std::string content = "// Generated by Catalyst: unity batch. Do not edit.\n";
+        for (const auto &member : batch.members)
+            content += std::format("#include \"{}\"\n", member.string());
+        if (auto res = utils::fs::writeIfChanged(batch.unity_file, content); !res)
+            return std::unexpected(res.error());
+        current.insert(batch.unity_file.filename().string());
+    }
+
+    for (const auto &entry : fs::directory_iterator(unity_dir, ec)) {
+        if (!current.contains(entry.path().filename().string()))
+            fs::remove(entry.path(), ec);
+    }
+    return {};
+}
+} // namespace catalyst::generate
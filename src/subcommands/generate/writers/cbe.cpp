@@ -36,13 +36,22 @@ std::expected<void, std::string> DerivedWriter<TargetType::CBE>::addRule([[maybe
                                                                          [[maybe_unused]] std::string_view command,
                                                                          [[maybe_unused]] std::string_view description,
                                                                          [[maybe_unused]] std::string_view depfile,
-                                                                         [[maybe_unused]] std::string_view deps) {
+                                                                         [[maybe_unused]] std::string_view deps,
+                                                                         [[maybe_unused]] bool restat,
+                                                                         [[maybe_unused]] std::string_view pool) {
     // CBE has built-in rules mapped to specific keys (cc, cxx, etc.).
     // We do not need to define them in the manifest, but we rely on the
     // generator to pass the correct standard rule names in add_build.
     return {};
 }
 
+template <>
+std::expected<void, std::string> DerivedWriter<TargetType::CBE>::addPool([[maybe_unused]] std::string_view name,
+                                                                         [[maybe_unused]] unsigned depth) {
+    // CBE schedules its built-in rules itself
+    return {};
+}
+
 template <>
 std::expected<void, std::string>
 DerivedWriter<TargetType::CBE>::addBuild(const std::vector<std::string> &outputs,
@@ -58,7 +67,9 @@ DerivedWriter<TargetType::CBE>::addBuild(const std::vector<std::string> &outputs
     std::string_view output_file = outputs[0];
 
     std::string step_type;
-    if (rule == "cxx_compile") {
+    if (rule == "phony") {
+        return {}; // CBE has no phony steps
+    } else if (rule == "cxx_compile") {
         step_type = "cxx";
     } else if (rule == "cc_compile") {
         step_type = "cc";
@@ -87,6 +98,7 @@ DerivedWriter<TargetType::CBE>::addBuild(const std::vector<std::string> &outputs
         }
     }
 
+    // the step format is strict and has no field for implicit dependencies such as headers; CBE tracks those itself
     std::println(stream, "{}|{}|{}", step_type, input_list, output_file);
     return {};
 }
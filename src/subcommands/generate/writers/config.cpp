@@ -0,0 +1,116 @@
+#include <cctype>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "catalyst/subcommands/generate.hpp"
+
+namespace catalyst::generate::buildwriters {
+namespace {
+bool isVariableChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '-';
+}
+} // namespace
+
+ConfigWriter::ConfigWriter(BaseWriter &target, std::string name, std::unordered_set<std::string> &written)
+    : BaseWriter(target), target(target), name(std::move(name)), written(written) {
+}
+
+std::string ConfigWriter::suffixed(std::string_view base) const {
+    return std::format("{}_{}", base, name);
+}
+
+std::string ConfigWriter::prefixed(const std::string &path) const {
+    return std::filesystem::path{path}.is_absolute() ? path : (std::filesystem::path{name} / path).string();
+}
+
+std::vector<std::string> ConfigWriter::prefixed(const std::vector<std::string> &paths) const {
+    std::vector<std::string> result;
+    result.reserve(paths.size());
+    for (const auto &path : paths)
+        result.push_back(prefixed(path));
+    return result;
+}
+
+std::string ConfigWriter::renamed(std::string_view command) const {
+    std::string result;
+    result.reserve(command.size() + command.size() / 4);
+    for (std::size_t ii = 0; ii < command.size();) {
+        if (command[ii] != '$' || ii + 1 == command.size()) {
+            result.push_back(command[ii++]);
+            continue;
+        }
+        if (command[ii + 1] == '$') { // an escaped dollar
+            result.append("$$");
+            ii += 2;
+            continue;
+        }
+        const bool braced = command[ii + 1] == '{';
+        std::size_t begin = ii + (braced ? 2 : 1);
+        std::size_t end = begin;
+        while (end < command.size() && isVariableChar(command[end]))
+            ++end;
+        const std::string_view variable = command.substr(begin, end - begin);
+        if (braced && end < command.size() && command[end] == '}')
+            ++end;
+        // $in, $out and the like are not ours
+        result += variables.contains(std::string{variable}) ? std::format("${{{}}}", suffixed(variable))
+                                                            : std::string{command.substr(ii, end - ii)};
+        ii = end;
+    }
+    return result;
+}
+
+std::expected<void, std::string> ConfigWriter::addVariable(std::string_view variable, std::string_view value) {
+    variables.emplace(variable);
+    return target.addVariable(suffixed(variable), value);
+}
+
+std::expected<void, std::string> ConfigWriter::addRule(std::string_view rule,
+                                                       std::string_view command,
+                                                       std::string_view description,
+                                                       std::string_view depfile,
+                                                       std::string_view deps,
+                                                       bool restat,
+                                                       std::string_view pool) {
+    return target.addRule(suffixed(rule), renamed(command), description, depfile, deps, restat, pool);
+}
+
+std::expected<void, std::string> ConfigWriter::addPool(std::string_view pool, unsigned depth) {
+    if (!written.emplace(std::format("pool {}", pool)).second)
+        return {};
+    return target.addPool(pool, depth);
+}
+
+std::expected<void, std::string> ConfigWriter::addBuild(const std::vector<std::string> &outputs,
+                                                        std::string_view rule,
+                                                        const std::vector<std::string> &inputs,
+                                                        const std::vector<std::string> &implicit_deps) {
+    if (rule == "phony") {
+        std::vector<std::string> fresh;
+        for (const auto &output : prefixed(outputs)) {
+            if (written.insert(output).second)
+                fresh.push_back(output);
+        }
+        if (fresh.empty())
+            return {};
+        return target.addBuild(fresh, rule, prefixed(inputs), prefixed(implicit_deps));
+    }
+    return target.addBuild(prefixed(outputs), suffixed(rule), prefixed(inputs), prefixed(implicit_deps));
+}
+
+void ConfigWriter::addComment(std::string_view comment) {
+    target.addComment(std::format("[{}] {}", name, comment));
+}
+
+void ConfigWriter::addDefault(std::string_view default_target) {
+    // no `default`: a plain `ninja` builds every config, `ninja <name>` one of them
+    target.addBuild({name}, "phony", {prefixed(std::string{default_target})});
+}
+} // namespace catalyst::generate::buildwriters
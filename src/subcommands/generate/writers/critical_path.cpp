@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+
+namespace catalyst::generate::buildwriters {
+CriticalPathWriter::CriticalPathWriter(BaseWriter &target, utils::exec::Durations durations)
+    : BaseWriter(target), target(target), durations(std::move(durations)) {
+}
+
+std::expected<void, std::string> CriticalPathWriter::addVariable(std::string_view name, std::string_view value) {
+    steps.emplace_back([name = std::string{name}, value = std::string{value}](BaseWriter &writer) {
+        return writer.addVariable(name, value);
+    });
+    return {};
+}
+
+std::expected<void, std::string> CriticalPathWriter::addRule(std::string_view name,
+                                                             std::string_view command,
+                                                             std::string_view description,
+                                                             std::string_view depfile,
+                                                             std::string_view deps,
+                                                             bool restat,
+                                                             std::string_view pool) {
+    steps.emplace_back([name = std::string{name},
+                        command = std::string{command},
+                        description = std::string{description},
+                        depfile = std::string{depfile},
+                        deps = std::string{deps},
+                        restat,
+                        pool = std::string{pool}](BaseWriter &writer) {
+        return writer.addRule(name, command, description, depfile, deps, restat, pool);
+    });
+    return {};
+}
+
+std::expected<void, std::string> CriticalPathWriter::addPool(std::string_view name, unsigned depth) {
+    steps.emplace_back([name = std::string{name}, depth](BaseWriter &writer) { return writer.addPool(name, depth); });
+    return {};
+}
+
+std::expected<void, std::string> CriticalPathWriter::addBuild(const std::vector<std::string> &outputs,
+                                                              std::string_view rule,
+                                                              const std::vector<std::string> &inputs,
+                                                              const std::vector<std::string> &implicit_deps) {
+    builds.push_back(utils::exec::Edge{
+        .outputs = outputs, .rule = std::string{rule}, .inputs = inputs, .implicit_deps = implicit_deps});
+    steps.emplace_back();
+    return {};
+}
+
+void CriticalPathWriter::addComment(std::string_view comment) {
+    steps.emplace_back([comment = std::string{comment}](BaseWriter &writer) -> std::expected<void, std::string> {
+        writer.addComment(comment);
+        return {};
+    });
+}
+
+void CriticalPathWriter::addDefault(std::string_view target) {
+    steps.emplace_back([target = std::string{target}](BaseWriter &writer) -> std::expected<void, std::string> {
+        writer.addDefault(target);
+        return {};
+    });
+}
+
+std::expected<void, std::string> CriticalPathWriter::flush() {
+    const std::vector<std::int64_t> priorities = utils::exec::criticalPriorities(builds, durations);
+    std::size_t next_build = 0;
+    for (std::size_t ii = 0; ii < steps.size();) {
+        if (steps[ii]) {
+            if (auto res = steps[ii](target); !res)
+                return res;
+            ++ii;
+            continue;
+        }
+        // a run of build statements; stable, so without durations the order is the generator's
+        std::size_t run_end = ii;
+        while (run_end < steps.size() && !steps[run_end])
+            ++run_end;
+        std::vector<std::size_t> run(run_end - ii);
+        for (std::size_t jj = 0; jj < run.size(); ++jj)
+            run[jj] = next_build + jj;
+        std::ranges::stable_sort(
+            run, [&](std::size_t lhs, std::size_t rhs) { return priorities[lhs] > priorities[rhs]; });
+        for (std::size_t build : run) {
+            const auto &edge = builds[build];
+            if (auto res = target.addBuild(edge.outputs, edge.rule, edge.inputs, edge.implicit_deps); !res)
+                return res;
+        }
+        next_build += run.size();
+        ii = run_end;
+    }
+    steps.clear();
+    builds.clear();
+    return {};
+}
+} // namespace catalyst::generate::buildwriters
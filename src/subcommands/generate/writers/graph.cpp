@@ -0,0 +1,73 @@
+#include <expected>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catalyst/subcommands/generate.hpp"
+#include "catalyst/utils/exec/graph.hpp"
+
+namespace catalyst::generate::buildwriters {
+namespace {
+std::ostream &nullStream() {
+    static std::ostream stream{nullptr};
+    return stream;
+}
+} // namespace
+
+GraphWriter::GraphWriter(utils::exec::Graph &graph) : BaseWriter(nullStream()), graph(graph) {
+}
+
+std::expected<void, std::string> GraphWriter::addVariable(std::string_view name, std::string_view value) {
+    // commands go through /bin/sh as they do under ninja, so quotes are escaped the same way
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '"')
+            escaped += '\\';
+        escaped += c;
+    }
+    graph.setVariable(std::string{name}, std::move(escaped));
+    return {};
+}
+
+std::expected<void, std::string> GraphWriter::addRule(std::string_view name,
+                                                      std::string_view command,
+                                                      std::string_view description,
+                                                      std::string_view depfile,
+                                                      [[maybe_unused]] std::string_view deps,
+                                                      // the native executor restats every output, and keeps the old
+                                                      // mtime of an output rebuilt with identical contents
+                                                      [[maybe_unused]] bool restat,
+                                                      std::string_view pool) {
+    graph.addRule(std::string{name},
+                  utils::exec::Rule{.command = std::string{command},
+                                    .description = std::string{description},
+                                    .depfile = std::string{depfile},
+                                    .pool = std::string{pool}});
+    return {};
+}
+
+std::expected<void, std::string> GraphWriter::addPool(std::string_view name, unsigned depth) {
+    graph.addPool(std::string{name}, depth);
+    return {};
+}
+
+std::expected<void, std::string> GraphWriter::addBuild(const std::vector<std::string> &outputs,
+                                                       std::string_view rule,
+                                                       const std::vector<std::string> &inputs,
+                                                       const std::vector<std::string> &implicit_deps) {
+    if (outputs.empty())
+        return std::unexpected("build edge without outputs");
+    graph.addEdge(utils::exec::Edge{
+        .outputs = outputs, .rule = std::string{rule}, .inputs = inputs, .implicit_deps = implicit_deps});
+    return {};
+}
+
+void GraphWriter::addComment([[maybe_unused]] std::string_view comment) {
+}
+
+void GraphWriter::addDefault(std::string_view target) {
+    graph.addDefault(std::string{target});
+}
+} // namespace catalyst::generate::buildwriters
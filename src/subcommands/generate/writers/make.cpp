@@ -17,7 +17,9 @@ std::string translateNinjaToMake(std::string_view command) {
     result = std::regex_replace(result, std::regex(R"(\$([a-zA-Z0-9_]+))"), "$$($1)");
 
     // 3. Replace placeholders with their Make equivalents
-    result = std::regex_replace(result, std::regex("___CATALYST_IN___"), "$$(filter-out %.h %.hpp, $$^)");
+    // implicit dependencies are real prerequisites in Make, so keep them off the command line
+    result = std::regex_replace(
+        result, std::regex("___CATALYST_IN___"), "$$(filter-out %.h %.hpp $$(implicit_deps), $$^)");
     result = std::regex_replace(result, std::regex("___CATALYST_OUT___"), "$$@");
 
     return result;
@@ -49,12 +51,21 @@ std::expected<void, std::string> DerivedWriter<TargetType::Make>::addRule(std::s
                                                                           std::string_view command,
                                                                           [[maybe_unused]] std::string_view description,
                                                                           [[maybe_unused]] std::string_view depfile,
-                                                                          [[maybe_unused]] std::string_view deps) {
+                                                                          [[maybe_unused]] std::string_view deps,
+                                                                          [[maybe_unused]] bool restat,
+                                                                          [[maybe_unused]] std::string_view pool) {
     // In Make, we define a variable that holds the command.
     std::println(stream, "{} = {}", name, translateNinjaToMake(command));
     return {};
 }
 
+template <>
+std::expected<void, std::string> DerivedWriter<TargetType::Make>::addPool([[maybe_unused]] std::string_view name,
+                                                                          [[maybe_unused]] unsigned depth) {
+    // Make has no per-rule limit; `-j` caps every recipe alike
+    return {};
+}
+
 template <>
 std::expected<void, std::string>
 DerivedWriter<TargetType::Make>::addBuild(const std::vector<std::string> &outputs,
@@ -64,18 +75,33 @@ DerivedWriter<TargetType::Make>::addBuild(const std::vector<std::string> &output
     if (outputs.empty())
         return {};
 
-    for (const auto &out : outputs) {
-        std::print(stream, "{} ", escape(out));
+    if (rule == "phony" && inputs.empty()) {
+        // a rule without prerequisites or recipe: the target is considered updated even if it does not exist
+        for (const auto &out : outputs) {
+            std::println(stream, "{}:", escape(out));
+        }
+        return {};
     }
-    std::print(stream, ":");
-    for (const auto &in : inputs) {
-        std::print(stream, " {}", escape(in));
+
+    std::string targets;
+    for (const auto &out : outputs) {
+        targets += escape(out) + " ";
     }
     if (!implicit_deps.empty()) {
-        std::print(stream, " |");
+        // a target-specific variable lets the recipe tell inputs and implicit dependencies apart
+        std::print(stream, "{}: implicit_deps :=", targets);
         for (const auto &dep : implicit_deps) {
             std::print(stream, " {}", escape(dep));
         }
+        std::println(stream);
+    }
+    std::print(stream, "{}:", targets);
+    for (const auto &in : inputs) {
+        std::print(stream, " {}", escape(in));
+    }
+    // normal prerequisites, not order-only ones: a changed header must rebuild the target
+    for (const auto &dep : implicit_deps) {
+        std::print(stream, " {}", escape(dep));
     }
     std::println(stream);
     std::println(stream, "\t$({})", rule);
@@ -89,7 +115,7 @@ template <> void DerivedWriter<TargetType::Make>::addComment(std::string_view co
 
 template <> void DerivedWriter<TargetType::Make>::addDefault(std::string_view target) {
     std::println(stream, ".DEFAULT_GOAL := {}", escape(target));
-    std::println(stream, "-include $(wildcard obj/*.d)");
+    std::println(stream, "-include $(wildcard obj/*.d pch/*.d)");
 }
 
 template class DerivedWriter<TargetType::Make>;
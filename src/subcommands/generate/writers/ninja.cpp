@@ -65,7 +65,9 @@ std::expected<void, std::string> DerivedWriter<TargetType::Ninja>::addRule(std::
                                                                            std::string_view command,
                                                                            std::string_view description,
                                                                            std::string_view depfile,
-                                                                           std::string_view deps) {
+                                                                           std::string_view deps,
+                                                                           bool restat,
+                                                                           std::string_view pool) {
     std::println(stream, "rule {}\n  command = {} ", name, command);
     if (!description.empty()) {
         std::println(stream, "  description = {}", description);
@@ -76,10 +78,22 @@ std::expected<void, std::string> DerivedWriter<TargetType::Ninja>::addRule(std::
     if (!deps.empty()) {
         std::println(stream, "  deps = {}", deps);
     }
+    if (restat) {
+        std::println(stream, "  restat = 1");
+    }
+    if (!pool.empty()) {
+        std::println(stream, "  pool = {}", pool);
+    }
     std::println(stream);
     return {};
 }
 
+template <>
+std::expected<void, std::string> DerivedWriter<TargetType::Ninja>::addPool(std::string_view name, unsigned depth) {
+    std::println(stream, "pool {}\n  depth = {}\n", name, depth);
+    return {};
+}
+
 template <>
 std::expected<void, std::string>
 DerivedWriter<TargetType::Ninja>::addBuild(const std::vector<std::string> &outputs,
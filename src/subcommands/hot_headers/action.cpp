@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalyst/process_exec.hpp"
+#include "catalyst/subcommands/hot_headers.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/deps_index.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::hot_headers {
+namespace fs = std::filesystem;
+
+namespace {
+/// How many commits since `since` touched each file, by absolute path; nullopt outside a git repository.
+std::optional<std::unordered_map<std::string, std::size_t>> gitEdits(const std::string &since) {
+    auto toplevel = catalyst::processExecStdout({"git", "rev-parse", "--show-toplevel"});
+    if (!toplevel || toplevel->empty())
+        return std::nullopt;
+    toplevel->erase(toplevel->find_last_not_of("\r\n") + 1);
+    auto log =
+        catalyst::processExecStdout({"git", "-C", *toplevel, "log", "--since=" + since, "--format=", "--name-only"});
+    if (!log)
+        return std::nullopt;
+    std::unordered_map<std::string, std::size_t> edits;
+    std::istringstream in{*log};
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty())
+            ++edits[(fs::path{*toplevel} / line).lexically_normal().string()];
+    }
+    return edits;
+}
+
+struct Row {
+    fs::path header;
+    std::size_t objects = 0;
+    std::size_t edits = 0;
+    std::int64_t rebuild_ms = 0; ///< what one edit costs in compile time, by the logged durations
+    std::size_t score = 0;
+};
+} // namespace
+
+std::expected<void, std::string> action(const Parse &parse_args) {
+    catalyst::logger.log(LogLevel::DEBUG, "Hot-headers subcommand invoked.");
+
+    utils::yaml::Configuration config;
+    try {
+        config = utils::yaml::Configuration(parse_args.profiles);
+    } catch (std::runtime_error &err) {
+        return std::unexpected(err.what());
+    }
+    const fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
+    const std::string generator =
+        parse_args.backend.empty() ? config.getString("meta.generator").value_or("cbe") : parse_args.backend;
+
+    auto index = utils::exec::DepsIndex::load(build_dir, generator);
+    if (!index)
+        return std::unexpected(index.error());
+    if (index->objects() == 0)
+        return std::unexpected(std::format(
+            "{} has no recorded dependencies; build the project with {} first", build_dir.string(), generator));
+
+    const auto durations = utils::exec::recordedDurations(build_dir, generator);
+    const auto edits = gitEdits(parse_args.since);
+    if (!edits)
+        catalyst::logger.log(LogLevel::WARN, "Not in a git repository; ranking headers by the objects reading them.");
+
+    std::vector<Row> rows;
+    for (auto &header : index->headers()) {
+        Row row{.header = std::move(header), .objects = 0, .edits = 0, .rebuild_ms = 0, .score = 0};
+        const auto &readers = index->readers(row.header);
+        row.objects = readers.size();
+        for (const auto &object : readers) {
+            if (auto it = durations.find(object); it != durations.end())
+                row.rebuild_ms += it->second;
+        }
+        if (edits) {
+            auto it = edits->find(row.header.string());
+            row.edits = it == edits->end() ? 0 : it->second;
+            if (row.edits == 0)
+                continue; // untouched, or not the project's own
+        }
+        row.score = row.objects * (edits ? row.edits : 1);
+        rows.push_back(std::move(row));
+    }
+    std::ranges::sort(rows, [](const Row &lhs, const Row &rhs) {
+        if (lhs.score != rhs.score)
+            return lhs.score > rhs.score;
+        if (lhs.rebuild_ms != rhs.rebuild_ms)
+            return lhs.rebuild_ms > rhs.rebuild_ms;
+        return lhs.header < rhs.header;
+    });
+    if (rows.empty()) {
+        std::println(std::cout, "No header read by the build was edited since {}.", parse_args.since);
+        return {};
+    }
+
+    const fs::path root = fs::current_path();
+    std::println(std::cout,
+                 "{:>7}  {:>7}  {:>5}  {:>9}  {}",
+                 "score",
+                 "objects",
+                 "edits",
+                 "rebuild",
+                 edits ? std::format("header (edits since {})", parse_args.since) : std::string{"header"});
+    for (std::size_t ii = 0; ii < std::min(parse_args.top, rows.size()); ++ii) {
+        const Row &row = rows[ii];
+        auto relative = row.header.lexically_relative(root);
+        std::println(std::cout,
+                     "{:>7}  {:>7}  {:>5}  {:>8.1f}s  {}",
+                     row.score,
+                     row.objects,
+                     edits ? std::to_string(row.edits) : std::string{"-"},
+                     static_cast<double>(row.rebuild_ms) / 1000,
+                     relative.empty() || relative.string().starts_with("..") ? row.header.string()
+                                                                              : relative.string());
+    }
+    return {};
+}
+} // namespace catalyst::hot_headers
@@ -0,0 +1,17 @@
+#include <CLI/Validators.hpp>
+
+#include "catalyst/subcommands/hot_headers.hpp"
+
+namespace catalyst::hot_headers {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app) {
+    CLI::App *hot_headers = app.add_subcommand("hot-headers", "Rank headers by the rebuilds their edits cause.");
+    auto ret = std::make_unique<Parse>();
+    hot_headers->add_option("-p,--profiles", ret->profiles, "Profile composition that was built (default: common).");
+    hot_headers->add_option("--backend", ret->backend, "Backend that built it (ninja, gmake, cbe, native).");
+    hot_headers->add_option("--since", ret->since, "Count edits in git log since this date.")->capture_default_str();
+    hot_headers->add_option("-n,--top", ret->top, "Headers to list.")
+        ->check(CLI::PositiveNumber)
+        ->capture_default_str();
+    return {hot_headers, std::move(ret)};
+}
+} // namespace catalyst::hot_headers
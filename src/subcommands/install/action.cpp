@@ -6,6 +6,7 @@
 #include "catalyst/dir_guard.hpp"
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/subcommands/install.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
 #include "catalyst/utils/yaml/configuration.hpp"
 
 namespace catalyst::install {
@@ -28,12 +29,17 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
     utils::yaml::Configuration config;
     try {
-        config = utils::yaml::Configuration(parse_args.profiles);
+        config = utils::yaml::Configuration(parse_args.profiles.empty() ? std::vector<std::string>{"common"}
+                                                                        : parse_args.profiles);
     } catch (const std::exception &e) {
         return std::unexpected(e.what());
     }
 
-    fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
+    auto built_dir = utils::yaml::builtDir(config.snapshot(), !parse_args.profiles.empty());
+    if (!built_dir) {
+        return std::unexpected(built_dir.error());
+    }
+    fs::path build_dir = *built_dir;
 
     if (!fs::exists(build_dir)) {
         return std::unexpected(
@@ -1,17 +1,18 @@
 #include <cctype>
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <format>
 #include <string>
 #include <vector>
 
-#include <yaml-cpp/yaml.h>
-
 #include "catalyst/hooks.hpp"
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/process_exec.hpp"
 #include "catalyst/subcommands/generate.hpp"
 #include "catalyst/subcommands/run.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 namespace fs = std::filesystem;
 
@@ -30,20 +31,20 @@ std::string commandStr(const fs::path &executable, const std::vector<std::string
 
 std::expected<void, std::string> action(const Parse &args) {
     catalyst::logger.log(LogLevel::DEBUG, "Run subcommand invoked.");
-    std::vector<std::string> profiles;
-    if (args.profile != "common") {
-        profiles.emplace_back("common");
+    std::vector<std::string> profiles{"common"};
+    if (!args.profile.empty() && args.profile != "common") {
+        profiles.push_back(args.profile);
     }
-    profiles.push_back(args.profile);
 
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
-    YAML::Node profile_comp;
-    std::expected<YAML::Node, std::string> res = generate::profileComposition(profiles);
-    if (!res) {
-        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", res.error());
-        return std::unexpected(res.error());
+    utils::yaml::Configuration profile_comp;
+    try {
+        profile_comp = utils::yaml::Configuration{profiles};
+    } catch (const std::exception &err) {
+        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", err.what());
+        return std::unexpected(err.what());
     }
-    profile_comp = res.value();
+    const auto &manifest = profile_comp.snapshot().manifest;
 
     catalyst::logger.log(LogLevel::DEBUG, "Running pre-run hooks.");
     if (std::expected<void, std::string> res = hooks::preRun(profile_comp); !res) {
@@ -52,17 +53,16 @@ std::expected<void, std::string> action(const Parse &args) {
     }
 
     std::string exe;
-    std::string build_dir;
     auto str_to_lower = [](std::string &input) -> void {
         auto lower = [](const char c) -> char { return static_cast<char>(std::tolower(c)); };
         std::transform(input.begin(), input.end(), input.begin(), lower);
         return;
     };
-    std::string target_type = profile_comp["manifest"]["type"].Scalar();
+    std::string target_type = manifest.type;
     str_to_lower(target_type);
 
-    if (!profile_comp["manifest"]["type"].IsDefined() || target_type != "binary") {
-        if (!profile_comp["manifest"]["type"].IsDefined()) {
+    if (target_type != "binary") {
+        if (target_type.empty()) {
             catalyst::logger.log(LogLevel::ERROR, "Profile: {} does not define field: 'manifest.type'.", args.profile);
             return std::unexpected(std::format("Profile: {} does not define field: 'manifest.type'.", args.profile));
         }
@@ -70,16 +70,17 @@ std::expected<void, std::string> action(const Parse &args) {
             "Profile: {} defines 'manifest.type' = {}. Expected 'manifest.type' = BINARY", args.profile, target_type));
     }
 
-    if (!profile_comp["manifest"]["dirs"]["build"]) {
-        catalyst::logger.log(LogLevel::ERROR, "Build directory is not defined in profile: {}.", args.profile);
-        return std::unexpected(std::format("Build directory is not defined in profile: {}.", args.profile));
+    auto built_dir = utils::yaml::builtDir(profile_comp.snapshot(), !args.profile.empty());
+    if (!built_dir) {
+        catalyst::logger.log(LogLevel::ERROR, "{}", built_dir.error());
+        return std::unexpected(built_dir.error());
     }
-    build_dir = profile_comp["manifest"]["dirs"]["build"].as<std::string>();
+    const std::string build_dir = built_dir->string();
 
-    if (profile_comp["manifest"]["provides"] && profile_comp["manifest"]["provides"].as<std::string>() != "") {
-        exe = profile_comp["manifest"]["provides"].as<std::string>();
-    } else if (profile_comp["manifest"]["name"] && profile_comp["manifest"]["name"].as<std::string>() != "") {
-        exe = profile_comp["manifest"]["name"].as<std::string>();
+    if (!manifest.provides.empty()) {
+        exe = manifest.provides;
+    } else if (!manifest.name.empty()) {
+        exe = manifest.name;
     } else {
         catalyst::logger.log(LogLevel::ERROR, "Unable to determine executable name.");
         return std::unexpected("Unable to figure out executable name."
@@ -88,7 +89,7 @@ std::expected<void, std::string> action(const Parse &args) {
 
     fs::path exe_path = fs::absolute(fs::path(std::format("{}/{}", build_dir, exe)));
     std::string command = commandStr(exe_path, args.params);
-    std::expected<std::string, std::string> lib_path_res = catalyst::generate::libPath(profile_comp);
+    std::expected<std::string, std::string> lib_path_res = catalyst::generate::libPath(profile_comp, build_dir);
     if (!lib_path_res) {
         return std::unexpected("Failed to generate LD_LIBRARY_PATH");
     }
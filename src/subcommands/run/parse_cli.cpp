@@ -5,7 +5,7 @@ namespace catalyst::run {
 std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app) {
     CLI::App *run = app.add_subcommand("run", "Run a built executable.");
     auto ret = std::make_unique<Parse>();
-    run->add_option("-p,--profile", ret->profile)->default_val("common");
+    run->add_option("-p,--profile", ret->profile, "Profile to run (default: the last one built, else common).");
     run->add_option("-P,--params", ret->params)->default_val(std::vector<std::string>{});
     return {run, std::move(ret)};
 }
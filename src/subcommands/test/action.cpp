@@ -1,4 +1,5 @@
 #include <cctype>
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <format>
@@ -6,13 +7,12 @@
 #include <tuple>
 #include <vector>
 
-#include <yaml-cpp/yaml.h>
-
 #include "catalyst/hooks.hpp"
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/process_exec.hpp"
 #include "catalyst/subcommands/generate.hpp"
 #include "catalyst/subcommands/test.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 namespace fs = std::filesystem;
 
@@ -70,13 +70,14 @@ std::expected<void, std::string> action(const Parse &args) {
     std::vector<std::string> profiles{"common", "test"};
 
     catalyst::logger.log(LogLevel::DEBUG, "Composing profiles.");
-    YAML::Node profile_comp;
-    auto res = generate::profileComposition(profiles);
-    if (!res) {
-        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", res.error());
-        return std::unexpected(res.error());
+    utils::yaml::Configuration profile_comp;
+    try {
+        profile_comp = utils::yaml::Configuration{profiles};
+    } catch (const std::exception &err) {
+        catalyst::logger.log(LogLevel::ERROR, "Failed to compose profiles: {}", err.what());
+        return std::unexpected(err.what());
     }
-    profile_comp = res.value();
+    const auto &manifest = profile_comp.snapshot().manifest;
 
     catalyst::logger.log(LogLevel::DEBUG, "Running pre-test hooks.");
     if (auto res = hooks::preTest(profile_comp); !res) {
@@ -85,30 +86,25 @@ std::expected<void, std::string> action(const Parse &args) {
     }
 
     std::string exe;
-    std::string build_dir;
     auto str_to_lower = [](std::string &input) -> void {
         auto lower = [](const char c) -> char { return static_cast<char>(std::tolower(c)); };
         std::transform(input.begin(), input.end(), input.begin(), lower);
         return;
     };
-    std::string target_type = profile_comp["manifest"]["type"].Scalar();
+    std::string target_type = manifest.type;
     str_to_lower(target_type);
 
-    if (!profile_comp["manifest"]["type"].IsDefined() || target_type != "binary") {
+    if (target_type != "binary") {
         catalyst::logger.log(LogLevel::ERROR, "Profile does not build a binary target.");
         return std::unexpected("profile does not build a binary target");
     }
 
-    if (!profile_comp["manifest"]["dirs"]["build"]) {
-        catalyst::logger.log(LogLevel::ERROR, "Build directory is not defined.");
-        return std::unexpected("build directory is not defined");
-    }
-    build_dir = profile_comp["manifest"]["dirs"]["build"].as<std::string>();
+    const std::string &build_dir = manifest.dirs.build;
 
-    if (profile_comp["manifest"]["provides"] && profile_comp["manifest"]["provides"].as<std::string>() != "") {
-        exe = profile_comp["manifest"]["provides"].as<std::string>();
-    } else if (profile_comp["manifest"]["name"] && profile_comp["manifest"]["name"].as<std::string>() != "") {
-        exe = profile_comp["manifest"]["name"].as<std::string>();
+    if (!manifest.provides.empty()) {
+        exe = manifest.provides;
+    } else if (!manifest.name.empty()) {
+        exe = manifest.name;
     } else {
         catalyst::logger.log(LogLevel::ERROR, "Unable to determine executable name.");
         return std::unexpected("unable to figure out executable name. "
@@ -1,5 +1,6 @@
 #include <atomic>
 #include <deque>
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <format>
@@ -7,28 +8,29 @@
 #include <queue>
 #include <string>
 #include <thread>
-#include <unordered_set>
 #include <vector>
 
 #include "catalyst/utils/log/log.hpp"
 #include "catalyst/process_exec.hpp"
 #include "catalyst/subcommands/generate.hpp"
 #include "catalyst/subcommands/tidy.hpp"
-
-#include "yaml-cpp/node/node.h"
+#include "catalyst/utils/fs/scan_cache.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
 
 namespace catalyst::tidy {
 std::expected<void, std::string> action(const Parse &parse_args) {
-    YAML::Node profile_comp;
-    auto res = catalyst::generate::profileComposition(parse_args.profiles);
-    if (!res)
-        return std::unexpected(res.error());
-    profile_comp = *res;
+    utils::yaml::Configuration profile_comp;
+    try {
+        profile_comp = utils::yaml::Configuration{parse_args.profiles};
+    } catch (const std::exception &err) {
+        return std::unexpected(err.what());
+    }
+    const auto &manifest = profile_comp.snapshot().manifest;
 
-    if (!profile_comp["manifest"]["tooling"]["LINTER"] || !profile_comp["manifest"]["tooling"]["LINTER"].IsScalar())
+    const std::string &linter = manifest.tooling.linter;
+    if (linter.empty())
         return std::unexpected("field: manifest.tooling.LINTER is not defined");
 
-    auto linter = profile_comp["manifest"]["tooling"]["LINTER"].as<std::string>();
     // call the linter on the source_set (we can expect clang-tidy like arg syntax) and go on about our day
 
     catalyst::logger.log(LogLevel::DEBUG, "Building source set.");
@@ -36,20 +38,24 @@ std::expected<void, std::string> action(const Parse &parse_args) {
     namespace fs = std::filesystem;
 
     fs::path current_dir = fs::current_path();
-    auto relative_source_dirs = profile_comp["manifest"]["dirs"]["source"].as<std::vector<std::string>>();
+    const auto &relative_source_dirs = manifest.dirs.source;
     std::vector<std::string> absolute_source_dirs;
     absolute_source_dirs.reserve(relative_source_dirs.size());
     for (const auto &dir : relative_source_dirs) {
         absolute_source_dirs.push_back((current_dir / dir).string());
     }
 
-    std::unordered_set<std::filesystem::path> source_set;
-    auto source_set_res = generate::buildSourceSet(absolute_source_dirs, parse_args.profiles);
+    std::vector<std::filesystem::path> source_set;
+    fs::path build_dir = manifest.dirs.build;
+    utils::fs::ScanCache scan_cache{utils::fs::scanCachePath(build_dir)};
+    auto source_set_res = generate::buildSourceSet(absolute_source_dirs, parse_args.profiles, &scan_cache);
     if (!source_set_res) {
         catalyst::logger.log(LogLevel::ERROR, "Failed to build source set: {}", source_set_res.error());
         return std::unexpected(source_set_res.error());
     }
     source_set = *source_set_res;
+    if (auto save_res = scan_cache.save(); !save_res)
+        catalyst::logger.log(LogLevel::WARN, "Failed to save scan cache: {}", save_res.error());
 
     unsigned int num_threads = std::thread::hardware_concurrency();
     catalyst::logger.log(
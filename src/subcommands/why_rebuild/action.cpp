@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catalyst/subcommands/why_rebuild.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/deps_index.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+
+namespace catalyst::why_rebuild {
+namespace fs = std::filesystem;
+
+std::expected<void, std::string> action(const Parse &parse_args) {
+    catalyst::logger.log(LogLevel::DEBUG, "Why-rebuild subcommand invoked.");
+
+    utils::yaml::Configuration config;
+    try {
+        config = utils::yaml::Configuration(parse_args.profiles);
+    } catch (std::runtime_error &err) {
+        return std::unexpected(err.what());
+    }
+    const fs::path build_dir = config.getString("manifest.dirs.build").value_or("build");
+    const std::string generator =
+        parse_args.backend.empty() ? config.getString("meta.generator").value_or("cbe") : parse_args.backend;
+
+    auto index = utils::exec::DepsIndex::load(build_dir, generator);
+    if (!index)
+        return std::unexpected(index.error());
+    if (index->objects() == 0)
+        return std::unexpected(std::format(
+            "{} has no recorded dependencies; build the project with {} first", build_dir.string(), generator));
+    if (!fs::exists(parse_args.file))
+        catalyst::logger.log(LogLevel::WARN, "{} does not exist.", parse_args.file);
+
+    const auto durations = utils::exec::recordedDurations(build_dir, generator);
+    auto duration = [&](const std::string &object) -> std::int64_t {
+        auto it = durations.find(object);
+        return it == durations.end() ? -1 : it->second;
+    };
+    std::vector<std::string> readers = index->readers(parse_args.file);
+    if (readers.empty()) {
+        std::println(std::cout, "{} is read by none of the {} objects.", parse_args.file, index->objects());
+        return {};
+    }
+    std::ranges::sort(readers, [&](const std::string &lhs, const std::string &rhs) {
+        return duration(lhs) != duration(rhs) ? duration(lhs) > duration(rhs) : lhs < rhs;
+    });
+
+    std::int64_t total = 0;
+    std::int64_t longest = 0;
+    std::size_t unknown = 0;
+    for (const auto &object : readers) {
+        if (std::int64_t ms = duration(object); ms >= 0) {
+            total += ms;
+            longest = std::max(longest, ms);
+        } else {
+            ++unknown;
+        }
+    }
+    std::println(std::cout, "{} is read by {} of {} objects.", parse_args.file, readers.size(), index->objects());
+    if (unknown < readers.size()) {
+        // a lower bound on the wall-clock time: perfect packing, and never less than the slowest compile
+        const unsigned threads = std::max(1U, std::thread::hardware_concurrency());
+        const std::int64_t wall = std::max(longest, total / threads);
+        std::println(std::cout,
+                     "Recompiling them takes {:.1f}s of compile time, at least {:.1f}s on {} threads.",
+                     static_cast<double>(total) / 1000,
+                     static_cast<double>(wall) / 1000,
+                     threads);
+    }
+    for (const auto &object : readers) {
+        const std::int64_t ms = duration(object);
+        std::println(std::cout,
+                     "  {:>8}  {}",
+                     ms >= 0 ? std::format("{:.1f}s", static_cast<double>(ms) / 1000) : std::string{"-"},
+                     object);
+    }
+    if (unknown != 0)
+        std::println(std::cout, "{} of them have no logged duration.", unknown);
+    return {};
+}
+} // namespace catalyst::why_rebuild
@@ -0,0 +1,12 @@
+#include "catalyst/subcommands/why_rebuild.hpp"
+
+namespace catalyst::why_rebuild {
+std::pair<CLI::App *, std::unique_ptr<Parse>> parse(CLI::App &app) {
+    CLI::App *why_rebuild = app.add_subcommand("why-rebuild", "List the objects a change to a file recompiles.");
+    auto ret = std::make_unique<Parse>();
+    why_rebuild->add_option("file", ret->file, "Header or source to look up.")->required();
+    why_rebuild->add_option("-p,--profiles", ret->profiles, "Profile composition that was built (default: common).");
+    why_rebuild->add_option("--backend", ret->backend, "Backend that built it (ninja, gmake, cbe, native).");
+    return {why_rebuild, std::move(ret)};
+}
+} // namespace catalyst::why_rebuild
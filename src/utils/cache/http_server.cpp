@@ -0,0 +1,469 @@
+#include "catalyst/utils/cache/http_server.hpp"
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <stop_token>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/cache/remote_cache.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::cache {
+namespace fs = std::filesystem;
+
+#if !defined(_WIN32)
+namespace {
+/// Larger uploads are refused; the biggest results are linked binaries.
+constexpr std::uint64_t max_upload = 4ULL << 30;
+constexpr std::size_t max_header = 64 * 1024;
+/// A client that sends or reads nothing for this long is dropped, so a stalled one cannot hold a worker forever.
+constexpr std::chrono::seconds idle_timeout{30};
+/// Accepted connections waiting for a worker; beyond this, new ones are turned away with a 503.
+constexpr std::size_t max_queued = 256;
+#if defined(MSG_NOSIGNAL)
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0; // SIGPIPE is ignored for the whole process instead
+#endif
+
+struct Request {
+    std::string method;
+    std::string path;
+    std::uint64_t content_length = 0;
+    bool expect_continue = false;
+    bool keep_alive = true;
+};
+
+bool iequals(std::string_view lhs, std::string_view rhs) {
+    if (lhs.size() != rhs.size())
+        return false;
+    for (std::size_t ii = 0; ii < lhs.size(); ++ii) {
+        if (std::tolower(static_cast<unsigned char>(lhs[ii])) != std::tolower(static_cast<unsigned char>(rhs[ii])))
+            return false;
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+        text.remove_suffix(1);
+    return text;
+}
+
+/// One client connection. Reads are buffered, since a request's head and the start of its body arrive together.
+class Connection {
+public:
+    explicit Connection(int fd) : fd(fd) {
+    }
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+    ~Connection() {
+        ::close(fd);
+    }
+
+    std::optional<Request> readRequest() {
+        std::size_t end;
+        while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (buffer.size() > max_header || !fill())
+                return std::nullopt;
+        }
+        std::string head = buffer.substr(0, end);
+        buffer.erase(0, end + 4);
+
+        Request request;
+        std::size_t line_end = head.find("\r\n");
+        std::string_view line = std::string_view{head}.substr(0, line_end);
+        std::size_t first = line.find(' ');
+        std::size_t second = line.find(' ', first + 1);
+        if (first == std::string_view::npos || second == std::string_view::npos)
+            return std::nullopt;
+        request.method = line.substr(0, first);
+        request.path = line.substr(first + 1, second - first - 1);
+        request.keep_alive = line.substr(second + 1) != "HTTP/1.0";
+
+        std::string_view headers = line_end == std::string::npos ? "" : std::string_view{head}.substr(line_end + 2);
+        while (!headers.empty()) {
+            std::size_t next = headers.find("\r\n");
+            std::string_view header = headers.substr(0, next);
+            headers = next == std::string_view::npos ? "" : headers.substr(next + 2);
+            std::size_t colon = header.find(':');
+            if (colon == std::string_view::npos)
+                continue;
+            std::string_view name = trim(header.substr(0, colon));
+            std::string_view value = trim(header.substr(colon + 1));
+            if (iequals(name, "content-length")) {
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), request.content_length);
+                if (ec != std::errc{})
+                    return std::nullopt;
+            } else if (iequals(name, "expect")) {
+                request.expect_continue = iequals(value, "100-continue");
+            } else if (iequals(name, "connection")) {
+                request.keep_alive = !iequals(value, "close");
+            } else if (iequals(name, "transfer-encoding")) {
+                return std::nullopt; // chunked uploads are not supported; the clients send a length
+            }
+        }
+        return request;
+    }
+
+    /// Copy the request body into `out`.
+    bool readBody(std::uint64_t length, std::ofstream &out) {
+        while (length > 0) {
+            if (buffer.empty() && !fill())
+                return false;
+            std::size_t take = static_cast<std::size_t>(std::min<std::uint64_t>(length, buffer.size()));
+            out.write(buffer.data(), static_cast<std::streamsize>(take));
+            buffer.erase(0, take);
+            length -= take;
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool discardBody(std::uint64_t length) {
+        while (length > 0) {
+            if (buffer.empty() && !fill())
+                return false;
+            std::size_t take = static_cast<std::size_t>(std::min<std::uint64_t>(length, buffer.size()));
+            buffer.erase(0, take);
+            length -= take;
+        }
+        return true;
+    }
+
+    bool send(std::string_view data) {
+        while (!data.empty()) {
+            ssize_t sent = ::send(fd, data.data(), data.size(), send_flags);
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (sent <= 0)
+                return false;
+            data.remove_prefix(static_cast<std::size_t>(sent));
+        }
+        return true;
+    }
+
+    bool sendFile(int file, std::uint64_t size) {
+#if defined(__linux__)
+        off_t offset = 0;
+        while (static_cast<std::uint64_t>(offset) < size) {
+            ssize_t sent = ::sendfile(fd, file, &offset, size - static_cast<std::uint64_t>(offset));
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (sent <= 0)
+                return false;
+        }
+        return true;
+#else
+        // sendfile's signature differs between the BSDs and macOS; copy through a buffer instead
+        std::array<char, 64 * 1024> chunk{};
+        while (size > 0) {
+            const auto want = static_cast<std::size_t>(std::min<std::uint64_t>(size, chunk.size()));
+            ssize_t count = ::read(file, chunk.data(), want);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0 || !send({chunk.data(), static_cast<std::size_t>(count)}))
+                return false;
+            size -= static_cast<std::uint64_t>(count);
+        }
+        return true;
+#endif
+    }
+
+    bool respond(int status, std::string_view reason, bool keep_alive, std::uint64_t length = 0) {
+        return send(std::format("HTTP/1.1 {} {}\r\nContent-Length: {}\r\nConnection: {}\r\n\r\n",
+                                status,
+                                reason,
+                                length,
+                                keep_alive ? "keep-alive" : "close"));
+    }
+
+private:
+    bool fill() {
+        std::array<char, 64 * 1024> chunk{};
+        while (true) {
+            ssize_t count = ::recv(fd, chunk.data(), chunk.size(), 0);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return false;
+            buffer.append(chunk.data(), static_cast<std::size_t>(count));
+            return true;
+        }
+    }
+
+    int fd;
+    std::string buffer;
+};
+
+/// `/<anything>/ac/<sha256>` or `/<anything>/cas/<sha256>`, the prefix being an optional instance name.
+std::optional<std::pair<RemoteCache::Store, std::string>> parseEntry(std::string_view path) {
+    path = path.substr(0, path.find('?'));
+    std::size_t slash = path.rfind('/');
+    if (slash == std::string_view::npos || slash == 0)
+        return std::nullopt;
+    std::string_view hash = path.substr(slash + 1);
+    std::string_view rest = path.substr(0, slash);
+    std::string_view store = rest.substr(rest.rfind('/') + 1);
+    if (!isSha256Hex(hash))
+        return std::nullopt;
+    if (store == "ac")
+        return std::pair{RemoteCache::Store::ac, std::string{hash}};
+    if (store == "cas")
+        return std::pair{RemoteCache::Store::cas, std::string{hash}};
+    return std::nullopt;
+}
+
+class Server {
+public:
+    explicit Server(fs::path dir) : dir(std::move(dir)) {
+    }
+
+    void serve(int fd) {
+        Connection connection{fd};
+        while (auto request = connection.readRequest()) {
+            if (!handle(connection, *request) || !request->keep_alive)
+                return;
+        }
+    }
+
+private:
+    /// False once the connection cannot carry another request.
+    bool handle(Connection &connection, const Request &request) {
+        auto entry = parseEntry(request.path);
+        catalyst::logger.log(LogLevel::DEBUG, "{} {}", request.method, request.path);
+        if (request.method == "GET" || request.method == "HEAD") {
+            if (!entry)
+                return connection.respond(404, "Not Found", request.keep_alive);
+            return get(connection, request, remoteEntryPath(dir, entry->first, entry->second));
+        }
+        if (request.method != "PUT") {
+            return connection.respond(405, "Method Not Allowed", request.keep_alive) &&
+                   connection.discardBody(request.content_length);
+        }
+        if (!entry || request.content_length > max_upload) {
+            // refused before a 100 Continue, so the client does not send the body
+            connection.respond(request.content_length > max_upload ? 413 : 400, "Rejected", false);
+            return false;
+        }
+        return put(connection, request, entry->first, entry->second);
+    }
+
+    bool get(Connection &connection, const Request &request, const fs::path &path) {
+        int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (file < 0 || ::fstat(file, &st) != 0) {
+            if (file >= 0)
+                ::close(file);
+            return connection.respond(404, "Not Found", request.keep_alive);
+        }
+        const auto size = static_cast<std::uint64_t>(st.st_size);
+        bool ok = connection.respond(200, "OK", request.keep_alive, size) &&
+                  (request.method == "HEAD" || connection.sendFile(file, size));
+        ::close(file);
+        return ok;
+    }
+
+    bool put(Connection &connection, const Request &request, RemoteCache::Store store, const std::string &hash) {
+        if (request.expect_continue && !connection.send("HTTP/1.1 100 Continue\r\n\r\n"))
+            return false;
+        const fs::path entry = remoteEntryPath(dir, store, hash);
+        std::error_code ec;
+        fs::create_directories(entry.parent_path(), ec);
+        const fs::path tmp = entry.parent_path() / std::format(".{}.{}", hash, tmp_counter++);
+        bool received = false;
+        {
+            std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+            received = out && connection.readBody(request.content_length, out);
+        }
+        if (!received) {
+            fs::remove(tmp, ec);
+            return false;
+        }
+        // blobs must be what their address says; action results are opaque
+        if (store == RemoteCache::Store::cas && hash::sha256File(tmp) != hash) {
+            fs::remove(tmp, ec);
+            return connection.respond(400, "Digest Mismatch", request.keep_alive);
+        }
+        fs::rename(tmp, entry, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            return connection.respond(500, "Internal Server Error", request.keep_alive);
+        }
+        return connection.respond(200, "OK", request.keep_alive);
+    }
+
+    fs::path dir;
+    std::atomic<std::uint64_t> tmp_counter{0};
+};
+
+/// A fixed set of workers serving accepted connections in order.
+class WorkerPool {
+public:
+    WorkerPool(Server &server, unsigned count) {
+        for (unsigned ii = 0; ii < count; ++ii)
+            workers.emplace_back([this, &server](std::stop_token stop) { work(stop, server); });
+    }
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    ~WorkerPool() {
+        for (auto &worker : workers)
+            worker.request_stop();
+        workers.clear(); // joins; a worker inside a connection leaves it within the idle timeout
+        while (!queue.empty()) {
+            ::close(queue.front());
+            queue.pop();
+        }
+    }
+
+    /// False if the queue is full, in which case `client` is left to the caller.
+    bool push(int client) {
+        {
+            std::scoped_lock lock{mutex};
+            if (queue.size() >= max_queued)
+                return false;
+            queue.push(client);
+        }
+        ready.notify_one();
+        return true;
+    }
+
+private:
+    void work(std::stop_token stop, Server &server) {
+        while (true) {
+            int client = -1;
+            {
+                std::unique_lock lock{mutex};
+                if (!ready.wait(lock, stop, [&] { return !queue.empty(); }))
+                    return;
+                client = queue.front();
+                queue.pop();
+            }
+            server.serve(client);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable_any ready;
+    std::queue<int> queue;
+    std::vector<std::jthread> workers; ///< last, so they are joined before the queue goes away
+};
+
+/// Apply `idle_timeout` to both directions of `client`.
+void setTimeouts(int client) {
+    timeval timeout{.tv_sec = idle_timeout.count(), .tv_usec = 0};
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+/// A socket of `type` that is closed on exec.
+int cloexecSocket(int type) {
+#if defined(SOCK_CLOEXEC)
+    return ::socket(AF_INET, type | SOCK_CLOEXEC, 0);
+#else
+    int fd = ::socket(AF_INET, type, 0);
+    if (fd >= 0)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+#endif
+}
+
+int cloexecAccept(int listener) {
+#if defined(__linux__)
+    return ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+#else
+    int fd = ::accept(listener, nullptr, nullptr);
+    if (fd >= 0)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+#endif
+}
+} // namespace
+
+std::expected<void, std::string> serveRemoteCache(const fs::path &dir, const std::string &bind, std::uint16_t port) {
+    std::signal(SIGPIPE, SIG_IGN);
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", dir.string(), ec.message()));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, bind.c_str(), &address.sin_addr) != 1)
+        return std::unexpected(std::format("Not an IPv4 address: {}", bind));
+
+    int listener = cloexecSocket(SOCK_STREAM);
+    if (listener < 0)
+        return std::unexpected(std::format("Failed to create a socket: {}", std::strerror(errno)));
+    int reuse = 1;
+    ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, SOMAXCONN) != 0) {
+        std::string error = std::strerror(errno);
+        ::close(listener);
+        return std::unexpected(std::format("Failed to listen on {}:{}: {}", bind, port, error));
+    }
+    catalyst::logger.log(LogLevel::INFO, "Serving {} on http://{}:{}", dir.string(), bind, port);
+
+    Server server{dir};
+    // each connection carries a few requests at most (the client runs curl per entry), so a worker frees up quickly
+    WorkerPool pool{server, std::max(16U, 4 * std::thread::hardware_concurrency())};
+    while (true) {
+        int client = cloexecAccept(listener);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EMFILE || errno == ENFILE)
+                continue;
+            std::string error = std::strerror(errno);
+            ::close(listener);
+            return std::unexpected(std::format("Failed to accept a connection: {}", error));
+        }
+        setTimeouts(client);
+        if (!pool.push(client)) {
+            Connection rejected{client};
+            rejected.respond(503, "Service Unavailable", false);
+        }
+    }
+}
+#else
+std::expected<void, std::string> serveRemoteCache(const fs::path &, const std::string &, std::uint16_t) {
+    return std::unexpected("The cache server is not available on Windows");
+}
+#endif
+} // namespace catalyst::utils::cache
@@ -0,0 +1,574 @@
+#include "catalyst/utils/cache/object_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/fs/user_cache_dir.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::cache {
+namespace fs = std::filesystem;
+
+namespace {
+/// Manifests are trimmed to the newest `manifest_keep` results once they exceed twice that.
+constexpr std::size_t manifest_keep = 16;
+/// Eviction frees space down to this share of the cap, so it does not run again on the next store.
+constexpr double evict_to = 0.9;
+constexpr fs::perms write_perms = fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write;
+
+/// An `flock`ed file descriptor, released and closed on destruction.
+class LockedFile {
+public:
+    LockedFile(const fs::path &path, int operation) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return;
+        while (::flock(fd, operation) != 0) {
+            if (errno != EINTR) {
+                ::close(std::exchange(fd, -1));
+                return;
+            }
+        }
+    }
+    LockedFile(const LockedFile &) = delete;
+    LockedFile &operator=(const LockedFile &) = delete;
+    ~LockedFile() {
+        if (fd >= 0)
+            ::close(fd); // releases the lock
+    }
+
+    bool ok() const {
+        return fd >= 0;
+    }
+
+    std::string read() const {
+        std::string content;
+        std::array<char, 8192> buffer{};
+        off_t offset = 0;
+        while (true) {
+            ssize_t count = ::pread(fd, buffer.data(), buffer.size(), offset);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                break;
+            content.append(buffer.data(), static_cast<std::size_t>(count));
+            offset += count;
+        }
+        return content;
+    }
+
+    bool write(std::string_view content) const {
+        if (::ftruncate(fd, 0) != 0)
+            return false;
+        return writeAt(content, 0);
+    }
+
+    bool append(std::string_view content) const {
+        struct stat st {};
+        if (::fstat(fd, &st) != 0)
+            return false;
+        return writeAt(content, st.st_size);
+    }
+
+private:
+    bool writeAt(std::string_view content, off_t offset) const {
+        while (!content.empty()) {
+            ssize_t count = ::pwrite(fd, content.data(), content.size(), offset);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return false;
+            content.remove_prefix(static_cast<std::size_t>(count));
+            offset += count;
+        }
+        return true;
+    }
+
+    int fd = -1;
+};
+
+std::string shardedName(std::uint64_t key) {
+    std::string hex = hash::toHex(key);
+    return hex.substr(0, 2) + "/" + hex;
+}
+
+/// The remote protocol keys everything by SHA-256; these derive such keys from the local ones.
+std::string remoteManifestName(std::uint64_t key) {
+    return hash::Sha256{}.update("catalyst-manifest 1 ").update(hash::toHex(key)).hexDigest();
+}
+std::string remoteResultName(std::uint64_t result_key) {
+    return hash::Sha256{}.update("catalyst-result 1 ").update(hash::toHex(result_key)).hexDigest();
+}
+
+std::string readFile(const fs::path &path) {
+    std::ifstream in{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+bool writeFile(const fs::path &path, std::string_view content) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    return static_cast<bool>(out);
+}
+
+template <typename Int> bool parseInt(std::string_view text, Int &out, int base = 10) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out, base);
+    return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+std::vector<std::string_view> split(std::string_view text, char separator) {
+    std::vector<std::string_view> parts;
+    while (true) {
+        std::size_t end = text.find(separator);
+        parts.push_back(text.substr(0, end));
+        if (end == std::string_view::npos)
+            return parts;
+        text.remove_prefix(end + 1);
+    }
+}
+
+/// Copy-on-write clone, on filesystems that support it (btrfs, XFS, APFS). Keeps the permissions.
+bool reflink([[maybe_unused]] const fs::path &from, [[maybe_unused]] const fs::path &to) {
+#if defined(__APPLE__)
+    return ::clonefile(from.c_str(), to.c_str(), 0) == 0;
+#elif defined(__linux__)
+    int src = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src < 0)
+        return false;
+    struct stat st {};
+    int dst = -1;
+    if (::fstat(src, &st) == 0)
+        dst = ::open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 07777);
+    bool cloned = dst >= 0 && ::ioctl(dst, FICLONE, src) == 0;
+    ::close(src);
+    if (dst >= 0) {
+        ::close(dst);
+        if (!cloned)
+            ::unlink(to.c_str());
+    }
+    return cloned;
+#else
+    return false; // no clone ioctl; the caller falls back to a hard link or a copy
+#endif
+}
+
+bool copyFile(const fs::path &from, const fs::path &to) {
+    std::error_code ec;
+    return fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec) && !ec;
+}
+
+/// `manifest` with `line` appended, trimmed to the newest `manifest_keep` lines once it exceeds twice that.
+std::string withLine(std::string manifest, const std::string &line) {
+    manifest += line;
+    auto lines = split(manifest, '\n');
+    lines.pop_back(); // after the final newline
+    if (lines.size() <= 2 * manifest_keep)
+        return manifest;
+    std::string trimmed;
+    for (auto it = lines.end() - static_cast<std::ptrdiff_t>(manifest_keep); it != lines.end(); ++it) {
+        trimmed += *it;
+        trimmed += '\n';
+    }
+    return trimmed;
+}
+
+bool touch(const fs::path &path) {
+    return ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0) == 0;
+}
+
+std::string formatStats(const CacheStats &stats) {
+    return std::format("hits {}\nmisses {}\nstores {}\nevictions {}\nbytes {}\nremote_hits {}\nuploads {}\n",
+                       stats.hits,
+                       stats.misses,
+                       stats.stores,
+                       stats.evictions,
+                       stats.bytes,
+                       stats.remote_hits,
+                       stats.uploads);
+}
+
+CacheStats parseStats(std::string_view content) {
+    CacheStats stats;
+    for (auto line : split(content, '\n')) {
+        std::size_t space = line.find(' ');
+        if (space == std::string_view::npos)
+            continue;
+        std::string_view name = line.substr(0, space);
+        std::uint64_t value = 0;
+        if (!parseInt(line.substr(space + 1), value))
+            continue;
+        if (name == "hits")
+            stats.hits = value;
+        else if (name == "misses")
+            stats.misses = value;
+        else if (name == "stores")
+            stats.stores = value;
+        else if (name == "evictions")
+            stats.evictions = value;
+        else if (name == "bytes")
+            stats.bytes = value;
+        else if (name == "remote_hits")
+            stats.remote_hits = value;
+        else if (name == "uploads")
+            stats.uploads = value;
+    }
+    return stats;
+}
+
+/// Delete the least recently used results until the cache fits in `target` bytes. Returns the results deleted
+/// and the bytes left.
+std::pair<std::uint64_t, std::uint64_t> evict(const fs::path &results_dir, std::uint64_t target) {
+    struct Result {
+        fs::path path;
+        fs::file_time_type used;
+        std::uint64_t bytes;
+    };
+    std::vector<Result> results;
+    std::uint64_t total = 0;
+    std::error_code ec;
+    for (const auto &shard : fs::directory_iterator(results_dir, ec)) {
+        for (const auto &result : fs::directory_iterator(shard.path(), ec)) {
+            Result entry{.path = result.path(), .used = fs::last_write_time(result.path(), ec), .bytes = 0};
+            for (const auto &file : fs::directory_iterator(result.path(), ec))
+                entry.bytes += file.file_size(ec);
+            total += entry.bytes;
+            results.push_back(std::move(entry));
+        }
+    }
+    std::ranges::sort(results, {}, &Result::used);
+
+    std::uint64_t evicted = 0;
+    for (const auto &result : results) {
+        if (total <= target)
+            break;
+        // a concurrent hard link keeps its inode; a concurrent copy fails and counts as a miss
+        fs::remove_all(result.path, ec);
+        total -= result.bytes;
+        ++evicted;
+    }
+    return {evicted, total};
+}
+} // namespace
+
+ObjectCache::ObjectCache(fs::path dir, std::uint64_t max_bytes, RemoteCache *remote)
+    : dir(std::move(dir)), max_bytes(max_bytes), remote(remote) {
+}
+
+std::optional<CacheHit> ObjectCache::lookup(std::uint64_t key, const FileHasher &hash_file) {
+    const fs::path manifest = dir / "manifests" / shardedName(key);
+    std::string content;
+    if (std::error_code ec; fs::exists(manifest, ec)) {
+        LockedFile file{manifest, LOCK_SH};
+        if (file.ok())
+            content = file.read();
+    }
+    if (auto hit = match(content, hash_file, nullptr)) {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return hit;
+    }
+
+    if (remote != nullptr) {
+        const fs::path fetched = tmpPath();
+        std::string remote_content;
+        if (remote->get(RemoteCache::Store::ac, remoteManifestName(key), fetched))
+            remote_content = readFile(fetched);
+        std::error_code ec;
+        fs::remove(fetched, ec);
+        std::string line;
+        if (auto hit = match(remote_content, hash_file, &line)) {
+            // kept locally, so the next lookup needs no round trip
+            if (auto res = addToManifest(key, line); !res)
+                catalyst::logger.log(LogLevel::DEBUG, "{}", res.error());
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return hit;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+}
+
+/// The newest result in `manifest` whose dependencies still hash as recorded, downloaded from the remote if it is
+/// not stored locally. Its manifest line is put in `matched`.
+std::optional<CacheHit>
+ObjectCache::match(std::string_view manifest, const FileHasher &hash_file, std::string *matched) {
+    // newest first: after an edit, the latest result is the likeliest match
+    auto lines = split(manifest, '\n');
+    for (auto line = lines.rbegin(); line != lines.rend(); ++line) {
+        auto fields = split(*line, '\t');
+        std::uint64_t result_key = 0;
+        if (fields.size() % 2 != 1 || !parseInt(fields.front(), result_key, 16))
+            continue;
+        CacheHit hit{.dir = dir / "results" / shardedName(result_key), .deps = {}};
+        bool matches = true;
+        for (std::size_t ii = 1; matches && ii < fields.size(); ii += 2) {
+            std::uint64_t recorded = 0;
+            auto current = hash_file(std::string{fields[ii]});
+            matches = parseInt(fields[ii + 1], recorded, 16) && current && *current == recorded;
+            hit.deps.emplace_back(fields[ii]);
+        }
+        if (!matches)
+            continue;
+        if (!touch(hit.dir)) { // the touch is the LRU clock, and fails for evicted results
+            if (remote == nullptr || !download(result_key))
+                continue;
+            remote_hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (matched != nullptr)
+            *matched = std::format("{}\n", *line);
+        return hit;
+    }
+    return std::nullopt;
+}
+
+/// Fetch a result's blobs from the remote into a private directory, check them against their digests and rename
+/// the directory into place.
+bool ObjectCache::download(std::uint64_t result_key) {
+    const fs::path tmp = tmpPath();
+    std::error_code ec;
+    fs::create_directories(tmp, ec);
+    auto abandon = [&] {
+        fs::remove_all(tmp, ec);
+        return false;
+    };
+    if (!remote->get(RemoteCache::Store::ac, remoteResultName(result_key), tmp / "index"))
+        return abandon();
+    const std::string index = readFile(tmp / "index");
+    fs::remove(tmp / "index", ec);
+
+    std::uint64_t bytes = 0;
+    std::size_t count = 0;
+    for (auto line : split(index, '\n')) {
+        if (line.empty())
+            continue;
+        auto fields = split(line, '\t'); // digest, octal mode
+        unsigned mode = 0;
+        if (fields.size() != 2 || !parseInt(fields[1], mode, 8))
+            return abandon();
+        const std::string digest{fields[0]};
+        const fs::path blob = tmp / std::to_string(count++);
+        if (!remote->get(RemoteCache::Store::cas, digest, blob) || hash::sha256File(blob) != digest)
+            return abandon();
+        fs::permissions(blob, static_cast<fs::perms>(mode) & ~write_perms, ec);
+        bytes += fs::file_size(blob, ec);
+    }
+    if (count == 0)
+        return abandon();
+
+    const fs::path result_dir = dir / "results" / shardedName(result_key);
+    fs::create_directories(result_dir.parent_path(), ec);
+    fs::rename(tmp, result_dir, ec);
+    if (ec) {
+        fs::remove_all(tmp, ec);
+        return fs::exists(result_dir, ec); // downloaded concurrently
+    }
+    stored_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return true;
+}
+
+std::expected<std::vector<bool>, std::string> ObjectCache::materialize(const CacheHit &hit,
+                                                                      const std::vector<fs::path> &outputs) {
+    std::vector<bool> linked(outputs.size(), false);
+    for (std::size_t ii = 0; ii < outputs.size(); ++ii) {
+        const fs::path cached = hit.dir / std::to_string(ii);
+        const fs::path &output = outputs[ii];
+        std::error_code ec;
+        fs::remove(output, ec);
+        fs::create_directories(output.parent_path(), ec);
+        // stored files are read-only, and outputs are unlinked before a command rewrites them, so sharing the
+        // inode cannot corrupt the cache
+        if (!reflink(cached, output)) {
+            linked[ii] = ::link(cached.c_str(), output.c_str()) == 0;
+            if (!linked[ii] && !copyFile(cached, output))
+                return std::unexpected(std::format("Failed to restore {} from the cache", output.string()));
+        }
+        touch(output); // newer than the inputs, whatever the stored copy's age
+    }
+    return linked;
+}
+
+std::expected<void, std::string> ObjectCache::store(std::uint64_t key,
+                                                    const std::vector<fs::path> &outputs,
+                                                    const std::vector<std::string> &deps,
+                                                    const FileHasher &hash_file) {
+    std::string line;
+    hash::Fnv1a result_hash;
+    result_hash.update(key);
+    for (const auto &dep : deps) {
+        if (dep.find_first_of("\t\n") != std::string::npos)
+            return {}; // not representable in the manifest
+        auto dep_hash = hash_file(dep);
+        if (!dep_hash)
+            return {}; // a dependency that vanished mid-build; nothing reliable to record
+        result_hash.update(dep).update(*dep_hash);
+        line += std::format("\t{}\t{}", dep, hash::toHex(*dep_hash));
+    }
+    const std::uint64_t result_key = result_hash.digest();
+    line = hash::toHex(result_key) + line + "\n";
+
+    const fs::path result_dir = dir / "results" / shardedName(result_key);
+    std::error_code ec;
+    if (!fs::exists(result_dir, ec)) {
+        const fs::path tmp = tmpPath();
+        fs::remove_all(tmp, ec);
+        fs::create_directories(tmp, ec);
+        if (ec)
+            return std::unexpected(std::format("Failed to create {}: {}", tmp.string(), ec.message()));
+        std::uint64_t bytes = 0;
+        for (std::size_t ii = 0; ii < outputs.size(); ++ii) {
+            const fs::path cached = tmp / std::to_string(ii);
+            if (!reflink(outputs[ii], cached) && !copyFile(outputs[ii], cached)) {
+                fs::remove_all(tmp, ec);
+                return std::unexpected(std::format("Failed to store {} in the cache", outputs[ii].string()));
+            }
+            fs::permissions(cached, write_perms, fs::perm_options::remove, ec);
+            bytes += fs::file_size(cached, ec);
+        }
+        fs::create_directories(result_dir.parent_path(), ec);
+        fs::rename(tmp, result_dir, ec);
+        if (ec) {
+            fs::remove_all(tmp, ec); // stored concurrently by another build
+        } else {
+            stores.fetch_add(1, std::memory_order_relaxed);
+            stored_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    auto res = addToManifest(key, line);
+    upload(key, result_key, outputs.size(), line);
+    return res;
+}
+
+std::expected<void, std::string> ObjectCache::addToManifest(std::uint64_t key, const std::string &line) {
+    const fs::path manifest = dir / "manifests" / shardedName(key);
+    std::error_code ec;
+    fs::create_directories(manifest.parent_path(), ec);
+    LockedFile file{manifest, LOCK_EX};
+    if (!file.ok())
+        return std::unexpected(std::format("Failed to lock {}", manifest.string()));
+    std::string content = file.read();
+    if (content.find(line) != std::string::npos)
+        return {};
+    std::string extended = withLine(content, line);
+    bool written = extended.size() == content.size() + line.size() ? file.append(line) : file.write(extended);
+    if (!written)
+        return std::unexpected(std::format("Failed to write {}", manifest.string()));
+    return {};
+}
+
+/// Upload a stored result's blobs, its index and the key's extended manifest. Another build uploading the same
+/// manifest at once may overwrite this line, which costs a later miss and nothing else.
+void ObjectCache::upload(std::uint64_t key, std::uint64_t result_key, std::size_t outputs, const std::string &line) {
+    if (remote == nullptr || !remote->writable())
+        return;
+    const fs::path result_dir = dir / "results" / shardedName(result_key);
+    std::string index;
+    for (std::size_t ii = 0; ii < outputs; ++ii) {
+        const fs::path blob = result_dir / std::to_string(ii);
+        struct stat st {};
+        auto digest = hash::sha256File(blob);
+        if (!digest || ::stat(blob.c_str(), &st) != 0 || !remote->put(RemoteCache::Store::cas, *digest, blob))
+            return;
+        index += std::format("{}\t{:o}\n", *digest, st.st_mode & 07777);
+    }
+
+    const fs::path tmp = tmpPath();
+    std::error_code ec;
+    bool uploaded = writeFile(tmp, index) && remote->put(RemoteCache::Store::ac, remoteResultName(result_key), tmp);
+    if (uploaded) {
+        std::string manifest;
+        if (remote->get(RemoteCache::Store::ac, remoteManifestName(key), tmp))
+            manifest = readFile(tmp);
+        if (manifest.find(line) == std::string::npos)
+            uploaded = writeFile(tmp, withLine(manifest, line)) &&
+                       remote->put(RemoteCache::Store::ac, remoteManifestName(key), tmp);
+    }
+    fs::remove(tmp, ec);
+    if (uploaded)
+        uploads.fetch_add(1, std::memory_order_relaxed);
+}
+
+fs::path ObjectCache::tmpPath() {
+    const fs::path tmp_dir = dir / "tmp";
+    std::error_code ec;
+    fs::create_directories(tmp_dir, ec);
+    return tmp_dir / std::format("{}-{}", ::getpid(), tmp_counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+std::expected<void, std::string> ObjectCache::flush() {
+    CacheStats delta{.hits = hits.exchange(0),
+                     .misses = misses.exchange(0),
+                     .stores = stores.exchange(0),
+                     .evictions = 0,
+                     .bytes = stored_bytes.exchange(0),
+                     .remote_hits = remote_hits.exchange(0),
+                     .uploads = uploads.exchange(0)};
+    if (delta.hits == 0 && delta.misses == 0 && delta.stores == 0 && delta.uploads == 0)
+        return {};
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    LockedFile file{dir / "stats", LOCK_EX};
+    if (!file.ok())
+        return std::unexpected(std::format("Failed to lock {}", (dir / "stats").string()));
+    CacheStats stats = parseStats(file.read());
+    stats.hits += delta.hits;
+    stats.misses += delta.misses;
+    stats.stores += delta.stores;
+    stats.bytes += delta.bytes;
+    stats.remote_hits += delta.remote_hits;
+    stats.uploads += delta.uploads;
+    if (stats.bytes > max_bytes) {
+        const auto target = static_cast<std::uint64_t>(static_cast<double>(max_bytes) * evict_to);
+        auto [evicted, left] = evict(dir / "results", target);
+        catalyst::logger.log(LogLevel::DEBUG, "Evicted {} results from the cache, {} bytes left.", evicted, left);
+        stats.evictions += evicted;
+        stats.bytes = left;
+    }
+    if (!file.write(formatStats(stats)))
+        return std::unexpected(std::format("Failed to write {}", (dir / "stats").string()));
+    return {};
+}
+
+std::expected<CacheStats, std::string> ObjectCache::stats(const fs::path &dir) {
+    const fs::path path = dir / "stats";
+    if (std::error_code ec; !fs::exists(path, ec))
+        return CacheStats{};
+    LockedFile file{path, LOCK_SH};
+    if (!file.ok())
+        return std::unexpected(std::format("Failed to read {}: {}", path.string(), std::strerror(errno)));
+    return parseStats(file.read());
+}
+
+fs::path defaultCacheDir() {
+    if (const char *dir = std::getenv("CATALYST_CACHE_DIR"); dir != nullptr && *dir != '\0')
+        return dir;
+    return utils::fs::userCacheDir() / "objects";
+}
+} // namespace catalyst::utils::cache
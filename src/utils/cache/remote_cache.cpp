@@ -0,0 +1,123 @@
+#include "catalyst/utils/cache/remote_cache.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "catalyst/process_exec.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::cache {
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::string_view file_scheme = "file://";
+
+std::string_view storeName(RemoteCache::Store store) {
+    return store == RemoteCache::Store::ac ? "ac" : "cas";
+}
+} // namespace
+
+RemoteCache::RemoteCache(std::string url, bool writable) : url(std::move(url)), write(writable) {
+    while (this->url.ends_with('/'))
+        this->url.pop_back();
+}
+
+bool RemoteCache::get(Store store, const std::string &hash, const fs::path &dest) {
+    if (!reachable() || !isSha256Hex(hash))
+        return false;
+    std::error_code ec;
+    if (url.starts_with(file_scheme)) {
+        const fs::path entry = remoteEntryPath(url.substr(file_scheme.size()), store, hash);
+        return fs::copy_file(entry, dest, fs::copy_options::overwrite_existing, ec) && !ec;
+    }
+
+    const std::string target = std::format("{}/{}/{}", url, storeName(store), hash);
+    auto status = catalyst::processExecStdout({"curl",
+                                               "--silent",
+                                               "--netrc-optional",
+                                               "--connect-timeout",
+                                               "2",
+                                               "--output",
+                                               dest.string(),
+                                               "--write-out",
+                                               "%{http_code}",
+                                               target});
+    if (!status || *status == "000") {
+        markUnreachable(status ? std::format("no response from {}", url) : status.error());
+        fs::remove(dest, ec);
+        return false;
+    }
+    if (*status != "200") {
+        fs::remove(dest, ec); // the body of an error page
+        return false;
+    }
+    return true;
+}
+
+bool RemoteCache::put(Store store, const std::string &hash, const fs::path &src) {
+    if (!write || !reachable() || !isSha256Hex(hash))
+        return false;
+    std::error_code ec;
+    if (url.starts_with(file_scheme)) {
+        const fs::path entry = remoteEntryPath(url.substr(file_scheme.size()), store, hash);
+        fs::create_directories(entry.parent_path(), ec);
+        // written aside and renamed, so a concurrent reader never sees a partial entry
+        const fs::path tmp = entry.parent_path() / std::format(".{}.{}-{}", hash, ::getpid(), tmp_counter++);
+        if (!fs::copy_file(src, tmp, fs::copy_options::overwrite_existing, ec) || ec)
+            return false;
+        fs::rename(tmp, entry, ec);
+        if (ec)
+            fs::remove(tmp, ec);
+        return !ec;
+    }
+
+    const std::string target = std::format("{}/{}/{}", url, storeName(store), hash);
+    auto status = catalyst::processExecStdout({"curl",
+                                               "--silent",
+                                               "--netrc-optional",
+                                               "--connect-timeout",
+                                               "2",
+                                               "--upload-file",
+                                               src.string(),
+                                               "--output",
+                                               "/dev/null",
+                                               "--write-out",
+                                               "%{http_code}",
+                                               target});
+    if (!status || *status == "000") {
+        markUnreachable(status ? std::format("no response from {}", url) : status.error());
+        return false;
+    }
+    if (!status->starts_with('2')) {
+        catalyst::logger.log(LogLevel::DEBUG, "Remote cache rejected {}: HTTP {}", target, *status);
+        return false;
+    }
+    return true;
+}
+
+bool RemoteCache::reachable() {
+    return !unreachable.load(std::memory_order_relaxed);
+}
+
+void RemoteCache::markUnreachable(const std::string &reason) {
+    if (!unreachable.exchange(true))
+        catalyst::logger.log(LogLevel::WARN, "Remote cache unavailable for this build: {}", reason);
+}
+
+fs::path remoteEntryPath(const fs::path &dir, RemoteCache::Store store, const std::string &hash) {
+    return dir / storeName(store) / hash.substr(0, 2) / hash;
+}
+
+bool isSha256Hex(std::string_view hash) {
+    return hash.size() == 64 &&
+           std::ranges::all_of(hash, [](char ch) { return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f'); });
+}
+} // namespace catalyst::utils::cache
@@ -0,0 +1,247 @@
+#include "catalyst/utils/exec/build_log.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::exec {
+namespace fs = std::filesystem;
+
+namespace {
+// One record per line, tab separated; a later record for the same output supersedes earlier ones.
+//   native_log:  <start_ms> <end_ms> <mtime_ns> <command hash, hex> <content hash, hex> <peak rss, KiB> <output>
+//   native_deps: <mtime_ns> <output> <dep>...
+constexpr std::string_view log_header = "catalyst-native-log 3";
+constexpr std::string_view deps_header = "catalyst-native-deps 1";
+
+/// Superseded records tolerated before a file is rewritten on open.
+constexpr std::size_t compaction_slack = 64;
+
+template <typename Int> bool parseField(std::string_view &line, Int &out, int base = 10) {
+    auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), out, base);
+    if (ec != std::errc{} || ptr == line.data() + line.size() || *ptr != '\t')
+        return false;
+    line.remove_prefix(static_cast<std::size_t>(ptr - line.data()) + 1);
+    return true;
+}
+
+std::string_view nextField(std::string_view &line) {
+    std::size_t end = line.find('\t');
+    std::string_view field = line.substr(0, end);
+    line.remove_prefix(end == std::string_view::npos ? line.size() : end + 1);
+    return field;
+}
+
+/// Calls `parse` on every complete line after the header. False if the file is missing, foreign or corrupt;
+/// a torn last line, as left by an interrupted build, is dropped and reported through `torn` instead.
+template <typename Parse>
+bool readRecords(const fs::path &file, std::string_view header, std::size_t &records, bool &torn, Parse &&parse) {
+    std::ifstream in{file, std::ios::binary};
+    if (!in)
+        return false;
+    std::string content{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    std::string_view rest = content;
+    std::size_t end = rest.find('\n');
+    if (end == std::string_view::npos || rest.substr(0, end) != header) {
+        catalyst::logger.log(LogLevel::DEBUG, "Ignoring {}: unknown format", file.string());
+        return false;
+    }
+    rest.remove_prefix(end + 1);
+    while ((end = rest.find('\n')) != std::string_view::npos) {
+        if (!parse(rest.substr(0, end))) {
+            catalyst::logger.log(LogLevel::DEBUG, "Ignoring corrupt {}", file.string());
+            return false;
+        }
+        rest.remove_prefix(end + 1);
+        ++records;
+    }
+    torn = !rest.empty();
+    return true;
+}
+
+std::string formatLog(const std::string &output, const LogEntry &entry) {
+    return std::format("{}\t{}\t{}\t{:x}\t{:x}\t{}\t{}\n",
+                       entry.start_ms,
+                       entry.end_ms,
+                       entry.mtime_ns,
+                       entry.command_hash,
+                       entry.content_hash,
+                       entry.peak_rss_kb,
+                       output);
+}
+
+std::string formatDeps(const std::string &output, const DepsEntry &entry) {
+    std::string line = std::format("{}\t{}", entry.mtime_ns, output);
+    for (const auto &dep : entry.deps) {
+        line += '\t';
+        line += dep;
+    }
+    line += '\n';
+    return line;
+}
+
+/// Replace `file` with `content` atomically, so a crash leaves either the old or the new file.
+std::expected<void, std::string> replaceFile(const fs::path &file, const std::string &content) {
+    fs::path tmp = file;
+    tmp += ".tmp";
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        out << content;
+        if (!out.flush())
+            return std::unexpected(std::format("Failed to write {}", tmp.string()));
+    }
+    std::error_code ec;
+    fs::rename(tmp, file, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to replace {}: {}", file.string(), ec.message()));
+    return {};
+}
+
+bool representable(std::string_view path) {
+    return path.find_first_of("\t\n") == std::string_view::npos;
+}
+} // namespace
+
+BuildLog::BuildLog(fs::path state_dir) : state_dir(std::move(state_dir)) {
+    auto parse_log = [this](std::string_view line) {
+        LogEntry entry;
+        if (!parseField(line, entry.start_ms) || !parseField(line, entry.end_ms) ||
+            !parseField(line, entry.mtime_ns) || !parseField(line, entry.command_hash, 16) ||
+            !parseField(line, entry.content_hash, 16) || !parseField(line, entry.peak_rss_kb) || line.empty())
+            return false;
+        entries.insert_or_assign(std::string{line}, entry);
+        return true;
+    };
+    bool torn = false;
+    bool loaded = readRecords(this->state_dir / "native_log", log_header, log_records, torn, parse_log);
+    if (!loaded)
+        entries.clear();
+    log_valid = loaded && !torn; // appending after a torn line would corrupt the next record
+
+    auto parse_deps = [this](std::string_view line) {
+        DepsEntry entry;
+        if (!parseField(line, entry.mtime_ns))
+            return false;
+        std::string_view output = nextField(line);
+        if (output.empty())
+            return false;
+        while (!line.empty())
+            entry.deps.emplace_back(nextField(line));
+        deps_entries.insert_or_assign(std::string{output}, std::move(entry));
+        return true;
+    };
+    loaded = readRecords(this->state_dir / "native_deps", deps_header, deps_records, torn, parse_deps);
+    if (!loaded)
+        deps_entries.clear();
+    deps_valid = loaded && !torn;
+    catalyst::logger.log(LogLevel::DEBUG,
+                         "Loaded native build log with {} outputs and {} deps records",
+                         entries.size(),
+                         deps_entries.size());
+}
+
+std::expected<void, std::string> BuildLog::open() {
+    std::unique_lock lock{mutex};
+    std::error_code ec;
+    fs::create_directories(state_dir, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", state_dir.string(), ec.message()));
+
+    const fs::path log_path = state_dir / "native_log";
+    if (!log_valid || log_records > 2 * entries.size() + compaction_slack) {
+        std::string content{log_header};
+        content += '\n';
+        for (const auto &[output, entry] : entries)
+            content += formatLog(output, entry);
+        if (auto res = replaceFile(log_path, content); !res)
+            return res;
+        log_records = entries.size();
+        log_valid = true;
+    }
+    const fs::path deps_path = state_dir / "native_deps";
+    if (!deps_valid || deps_records > 2 * deps_entries.size() + compaction_slack) {
+        std::string content{deps_header};
+        content += '\n';
+        for (const auto &[output, entry] : deps_entries)
+            content += formatDeps(output, entry);
+        if (auto res = replaceFile(deps_path, content); !res)
+            return res;
+        deps_records = deps_entries.size();
+        deps_valid = true;
+    }
+
+    log_file.open(log_path, std::ios::binary | std::ios::app);
+    deps_file.open(deps_path, std::ios::binary | std::ios::app);
+    if (!log_file || !deps_file)
+        return std::unexpected(std::format("Failed to open the native build log in {}", state_dir.string()));
+    return {};
+}
+
+std::optional<LogEntry> BuildLog::entry(const std::string &output) const {
+    std::unique_lock lock{mutex};
+    auto it = entries.find(output);
+    if (it == entries.end())
+        return std::nullopt;
+    return it->second;
+}
+
+std::optional<DepsEntry> BuildLog::deps(const std::string &output) const {
+    std::unique_lock lock{mutex};
+    auto it = deps_entries.find(output);
+    if (it == deps_entries.end())
+        return std::nullopt;
+    return it->second;
+}
+
+std::vector<std::string> BuildLog::outputs() const {
+    std::unique_lock lock{mutex};
+    std::vector<std::string> result;
+    result.reserve(entries.size());
+    for (const auto &[output, entry] : entries)
+        result.push_back(output);
+    return result;
+}
+
+std::expected<void, std::string> BuildLog::record(const std::string &output, const LogEntry &entry) {
+    if (!representable(output))
+        return {}; // never logged, so always rebuilt
+    std::unique_lock lock{mutex};
+    entries.insert_or_assign(output, entry);
+    if (!log_file.is_open())
+        return {};
+    ++log_records;
+    if (!(log_file << formatLog(output, entry)).flush())
+        return std::unexpected(std::format("Failed to append to {}", (state_dir / "native_log").string()));
+    return {};
+}
+
+std::expected<void, std::string> BuildLog::recordDeps(const std::string &output, DepsEntry entry) {
+    if (!representable(output) || !std::ranges::all_of(entry.deps, representable))
+        return {};
+    std::string line = formatDeps(output, entry);
+    std::unique_lock lock{mutex};
+    deps_entries.insert_or_assign(output, std::move(entry));
+    if (!deps_file.is_open())
+        return {};
+    ++deps_records;
+    if (!(deps_file << line).flush())
+        return std::unexpected(std::format("Failed to append to {}", (state_dir / "native_deps").string()));
+    return {};
+}
+
+fs::path buildLogDir(const fs::path &build_dir) {
+    return build_dir / ".catalyst";
+}
+} // namespace catalyst::utils::exec
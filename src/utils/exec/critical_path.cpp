@@ -0,0 +1,277 @@
+#include "catalyst/utils/exec/critical_path.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/exec/build_log.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+
+namespace catalyst::utils::exec {
+namespace fs = std::filesystem;
+
+namespace {
+/// The edges in dependency order with who consumes each one's outputs.
+struct Timeline {
+    std::vector<std::int64_t> duration; ///< -1: unknown
+    std::vector<std::vector<std::size_t>> dependents;
+    std::vector<std::size_t> order; ///< inputs first; edges on a cycle are left out
+};
+
+Timeline timeline(const std::vector<Edge> &edges, const Durations &durations) {
+    Timeline result;
+    result.duration.assign(edges.size(), -1);
+    result.dependents.resize(edges.size());
+    std::unordered_map<std::string_view, std::size_t> producers;
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        for (const auto &output : edges[ii].outputs) {
+            producers.emplace(output, ii);
+            if (auto it = durations.find(output); it != durations.end())
+                result.duration[ii] = std::max(result.duration[ii], it->second);
+        }
+    }
+
+    std::vector<std::size_t> waiting(edges.size(), 0);
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        for (const auto *paths : {&edges[ii].inputs, &edges[ii].implicit_deps}) {
+            for (const auto &path : *paths) {
+                if (auto it = producers.find(path); it != producers.end() && it->second != ii) {
+                    result.dependents[it->second].push_back(ii);
+                    ++waiting[ii];
+                }
+            }
+        }
+    }
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        if (waiting[ii] == 0)
+            result.order.push_back(ii);
+    }
+    for (std::size_t next = 0; next < result.order.size(); ++next) {
+        for (std::size_t dependent : result.dependents[result.order[next]]) {
+            if (--waiting[dependent] == 0)
+                result.order.push_back(dependent);
+        }
+    }
+    return result;
+}
+
+/// The longest chain from each edge to the end, and the dependent it continues through (`edges.size()`: none).
+void longestChains(const Timeline &times, std::vector<std::int64_t> &chain, std::vector<std::size_t> &next) {
+    const std::size_t none = times.duration.size();
+    chain.assign(times.duration.size(), 0);
+    next.assign(times.duration.size(), none);
+    for (auto it = times.order.rbegin(); it != times.order.rend(); ++it) {
+        std::int64_t longest = 0;
+        for (std::size_t dependent : times.dependents[*it]) {
+            if (chain[dependent] > longest || next[*it] == none) {
+                longest = std::max(longest, chain[dependent]);
+                next[*it] = dependent;
+            }
+        }
+        chain[*it] = std::max<std::int64_t>(times.duration[*it], 0) + longest;
+    }
+}
+
+std::string_view unescape(std::string_view word, std::string &buffer) {
+    if (word.find('$') == std::string_view::npos)
+        return word;
+    buffer.clear();
+    for (std::size_t ii = 0; ii < word.size(); ++ii) {
+        if (word[ii] == '$' && ii + 1 < word.size())
+            ++ii;
+        buffer += word[ii];
+    }
+    return buffer;
+}
+} // namespace
+
+std::vector<NinjaLogEntry> ninjaLogEntries(const fs::path &build_dir, std::uintmax_t offset) {
+    // `# ninja log v5` or later: <start ms> <end ms> <mtime> <output> <command hash>
+    std::vector<NinjaLogEntry> entries;
+    std::ifstream in{build_dir / ".ninja_log"};
+    std::string line;
+    if (!std::getline(in, line) || !line.starts_with("# ninja log v"))
+        return entries;
+    if (offset != 0 && !in.seekg(static_cast<std::streamoff>(offset)))
+        return entries;
+    while (std::getline(in, line)) {
+        std::string_view rest = line;
+        NinjaLogEntry entry;
+        auto [start_end, start_ec] = std::from_chars(rest.data(), rest.data() + rest.size(), entry.start_ms);
+        if (start_ec != std::errc{} || *start_end != '\t')
+            continue;
+        rest.remove_prefix(static_cast<std::size_t>(start_end - rest.data()) + 1);
+        auto [end_end, end_ec] = std::from_chars(rest.data(), rest.data() + rest.size(), entry.end_ms);
+        if (end_ec != std::errc{} || *end_end != '\t')
+            continue;
+        rest.remove_prefix(static_cast<std::size_t>(end_end - rest.data()) + 1);
+        std::size_t mtime_end = rest.find('\t');
+        std::size_t output_end = rest.find('\t', mtime_end + 1);
+        if (mtime_end == std::string_view::npos || output_end == std::string_view::npos)
+            continue;
+        entry.output = rest.substr(mtime_end + 1, output_end - mtime_end - 1);
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+Durations ninjaDurations(const fs::path &build_dir) {
+    Durations durations; // the last line per output wins
+    for (auto &entry : ninjaLogEntries(build_dir))
+        durations.insert_or_assign(std::move(entry.output), entry.end_ms - entry.start_ms);
+    return durations;
+}
+
+Durations nativeDurations(const fs::path &build_dir) {
+    Durations durations;
+    BuildLog log{buildLogDir(build_dir)};
+    for (auto &output : log.outputs()) {
+        if (auto entry = log.entry(output))
+            durations.emplace(std::move(output), entry->end_ms - entry->start_ms);
+    }
+    return durations;
+}
+
+Durations recordedDurations(const fs::path &build_dir, const std::string &generator) {
+    if (generator == "native")
+        return nativeDurations(build_dir);
+    if (generator == "ninja")
+        return ninjaDurations(build_dir);
+    return {};
+}
+
+Durations bucketDurations(const Durations &durations) {
+    Durations buckets;
+    buckets.reserve(durations.size());
+    for (const auto &[output, duration] : durations) {
+        const auto ms = static_cast<std::uint64_t>(std::max<std::int64_t>(duration, 0));
+        const std::uint64_t top = std::bit_floor(ms);
+        buckets.emplace(output, static_cast<std::int64_t>(top | (ms & (top >> 1))));
+    }
+    return buckets;
+}
+
+std::string durationsDigest(const Durations &durations) {
+    if (durations.empty())
+        return {};
+    std::vector<std::pair<std::string_view, std::int64_t>> sorted(durations.begin(), durations.end());
+    std::ranges::sort(sorted);
+    hash::Fnv1a hasher;
+    for (const auto &[output, duration] : sorted)
+        hasher.update(output).update(static_cast<std::uint64_t>(duration));
+    return hasher.hexDigest();
+}
+
+std::expected<std::vector<Edge>, std::string> readNinjaEdges(const fs::path &build_file) {
+    std::ifstream in{build_file};
+    if (!in)
+        return std::unexpected(std::format("Failed to open {}", build_file.string()));
+    std::vector<Edge> edges;
+    std::string buffer;
+    for (std::string line; std::getline(in, line);) {
+        if (!line.starts_with("build "))
+            continue;
+        // split on unescaped spaces; `$ `, `$:` and `$$` are escapes
+        std::vector<std::string_view> words;
+        std::size_t begin = 6;
+        for (std::size_t ii = begin; ii <= line.size(); ++ii) {
+            if (ii < line.size() && line[ii] == '$') {
+                ++ii;
+            } else if (ii == line.size() || line[ii] == ' ') {
+                if (ii > begin)
+                    words.emplace_back(std::string_view{line}.substr(begin, ii - begin));
+                begin = ii + 1;
+            }
+        }
+        Edge edge;
+        enum class Part { outputs, rule, inputs, implicit, order_only } part = Part::outputs;
+        for (std::string_view word : words) {
+            if (part == Part::outputs && word.ends_with(':') && !word.ends_with("$:")) {
+                if (word.size() > 1)
+                    edge.outputs.emplace_back(unescape(word.substr(0, word.size() - 1), buffer));
+                part = Part::rule;
+            } else if (part == Part::rule) {
+                edge.rule = word;
+                part = Part::inputs;
+            } else if (word == "|") {
+                part = Part::implicit;
+            } else if (word == "||") {
+                part = Part::order_only;
+            } else if (part == Part::outputs) {
+                edge.outputs.emplace_back(unescape(word, buffer));
+            } else if (part == Part::inputs) {
+                edge.inputs.emplace_back(unescape(word, buffer));
+            } else if (part == Part::implicit || part == Part::order_only) {
+                edge.implicit_deps.emplace_back(unescape(word, buffer));
+            }
+        }
+        if (!edge.outputs.empty() && !edge.rule.empty())
+            edges.push_back(std::move(edge));
+    }
+    return edges;
+}
+
+std::vector<std::int64_t> criticalPriorities(const std::vector<Edge> &edges, const Durations &durations) {
+    Timeline times = timeline(edges, durations);
+    std::unordered_map<std::string_view, std::pair<std::int64_t, std::int64_t>> per_rule; // sum, count
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        if (times.duration[ii] < 0)
+            continue;
+        auto &[sum, count] = per_rule[edges[ii].rule];
+        sum += times.duration[ii];
+        ++count;
+    }
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        if (auto it = per_rule.find(edges[ii].rule); times.duration[ii] < 0 && it != per_rule.end())
+            times.duration[ii] = it->second.first / it->second.second;
+    }
+    std::vector<std::int64_t> chain;
+    std::vector<std::size_t> next;
+    longestChains(times, chain, next);
+    return chain;
+}
+
+std::vector<CriticalStep> criticalPath(const std::vector<Edge> &edges, const Durations &durations) {
+    Timeline times = timeline(edges, durations);
+    std::vector<std::int64_t> chain;
+    std::vector<std::size_t> next;
+    longestChains(times, chain, next);
+
+    std::vector<CriticalStep> path;
+    auto first = std::ranges::max_element(chain);
+    if (first == chain.end() || *first <= 0)
+        return path;
+    for (auto edge = static_cast<std::size_t>(first - chain.begin()); edge < edges.size(); edge = next[edge]) {
+        if (edges[edge].rule != "phony")
+            path.push_back({.output = edges[edge].outputs.front(),
+                            .duration_ms = std::max<std::int64_t>(times.duration[edge], 0)});
+    }
+    return path;
+}
+
+std::string formatCriticalPath(const std::vector<CriticalStep> &path) {
+    std::int64_t total = 0;
+    for (const auto &step : path)
+        total += step.duration_ms;
+    std::string text = std::format("Critical path: {:.1f}s", static_cast<double>(total) / 1000);
+    for (const auto &step : path) {
+        text += std::format("\n  {:>7.1f}s {:>4}%  {}",
+                            static_cast<double>(step.duration_ms) / 1000,
+                            total == 0 ? 0 : step.duration_ms * 100 / total,
+                            step.output);
+    }
+    return text;
+}
+} // namespace catalyst::utils::exec
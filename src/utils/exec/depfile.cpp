@@ -0,0 +1,57 @@
+#include "catalyst/utils/exec/depfile.hpp"
+
+#include <expected>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace catalyst::utils::exec {
+std::expected<std::vector<std::string>, std::string> parseDepfile(std::string_view content) {
+    std::vector<std::string> deps;
+    std::unordered_set<std::string> seen;
+    bool in_prerequisites = false; // past the current rule's ':'
+    bool found_rule = false;
+    std::string word;
+
+    auto endWord = [&] {
+        if (word.empty())
+            return;
+        if (in_prerequisites && seen.insert(word).second)
+            deps.push_back(word);
+        word.clear();
+    };
+
+    for (std::size_t pos = 0; pos < content.size(); ++pos) {
+        char c = content[pos];
+        char next = pos + 1 < content.size() ? content[pos + 1] : '\0';
+        if (c == '\\' && (next == '\n' || next == '\r')) {
+            endWord(); // continuation: the rule goes on on the next line
+            pos += next == '\r' && pos + 2 < content.size() && content[pos + 2] == '\n' ? 2 : 1;
+        } else if (c == '\\' && (next == ' ' || next == '#' || next == '\\')) {
+            word.push_back(next);
+            ++pos;
+        } else if (c == '$' && next == '$') {
+            word.push_back('$');
+            ++pos;
+        } else if (c == '\n' || c == '\r') {
+            endWord();
+            in_prerequisites = false; // a new line starts a new rule
+        } else if (c == ' ' || c == '\t') {
+            endWord();
+        } else if (c == ':' && !in_prerequisites && (next == ' ' || next == '\t' || next == '\n' || next == '\r' ||
+                                                     next == '\0')) {
+            word.clear(); // the target
+            in_prerequisites = true;
+            found_rule = true;
+        } else {
+            word.push_back(c);
+        }
+    }
+    endWord();
+
+    if (!found_rule && content.find_first_not_of(" \t\r\n") != std::string_view::npos)
+        return std::unexpected("depfile has no rule");
+    return deps;
+}
+} // namespace catalyst::utils::exec
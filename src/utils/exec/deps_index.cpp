@@ -0,0 +1,110 @@
+#include "catalyst/utils/exec/deps_index.hpp"
+
+#include <cctype>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "catalyst/process_exec.hpp"
+#include "catalyst/utils/exec/build_log.hpp"
+#include "catalyst/utils/exec/depfile.hpp"
+
+namespace catalyst::utils::exec {
+namespace fs = std::filesystem;
+
+namespace {
+std::string normalize(const fs::path &path, const fs::path &build_dir) {
+    return (path.is_absolute() ? path : fs::absolute(build_dir) / path).lexically_normal().string();
+}
+
+/// `ninja -t deps` prints each output's deps under it, indented, in a block ended by a blank line:
+/// `obj/a.o: #deps 2, deps mtime 1700000000000000000 (VALID)`.
+void addNinjaDeps(DepsIndex &index, std::string_view listing, const fs::path &build_dir) {
+    std::string object;
+    std::vector<std::string> deps;
+    auto flush = [&] {
+        if (!object.empty() && !deps.empty())
+            index.add(object, deps, build_dir);
+        object.clear();
+        deps.clear();
+    };
+    std::istringstream in{std::string{listing}};
+    for (std::string line; std::getline(in, line);) {
+        if (line.empty()) {
+            flush();
+        } else if (std::isspace(static_cast<unsigned char>(line.front())) != 0) {
+            std::size_t begin = line.find_first_not_of(" \t");
+            if (!object.empty() && begin != std::string::npos)
+                deps.push_back(line.substr(begin));
+        } else if (std::size_t colon = line.find(": #deps "); colon != std::string::npos) {
+            flush();
+            object = line.substr(0, colon);
+        }
+    }
+    flush();
+}
+} // namespace
+
+std::expected<DepsIndex, std::string> DepsIndex::load(const fs::path &build_dir, const std::string &generator) {
+    DepsIndex index;
+    if (generator == "native") {
+        BuildLog log{buildLogDir(build_dir)};
+        for (const auto &output : log.outputs()) {
+            if (auto entry = log.deps(output); entry && !entry->deps.empty())
+                index.add(output, entry->deps, build_dir);
+        }
+    } else if (generator == "ninja") {
+        auto listing = catalyst::processExecStdout({"ninja", "-C", build_dir.string(), "-t", "deps"});
+        if (!listing)
+            return std::unexpected(std::format("Failed to run ninja -t deps: {}", listing.error()));
+        addNinjaDeps(index, *listing, build_dir);
+    } else {
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it{build_dir / "obj", ec}, end; !ec && it != end; it.increment(ec)) {
+            if (it->path().extension() != ".d")
+                continue;
+            std::ifstream in{it->path(), std::ios::binary};
+            std::string content{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+            auto deps = parseDepfile(content);
+            if (!deps)
+                return std::unexpected(std::format("{}: {}", it->path().string(), deps.error()));
+            fs::path object = it->path();
+            object.replace_extension(); // `-MF $out.d`
+            index.add(object.lexically_relative(build_dir).string(), *deps, build_dir);
+        }
+    }
+    return index;
+}
+
+void DepsIndex::add(const std::string &object, const std::vector<std::string> &deps, const fs::path &build_dir) {
+    ++object_count;
+    for (std::size_t ii = 0; ii < deps.size(); ++ii) {
+        std::string file = normalize(deps[ii], build_dir);
+        if (ii == 0)
+            sources.insert(file);
+        file_readers[std::move(file)].push_back(object);
+    }
+}
+
+const std::vector<std::string> &DepsIndex::readers(const fs::path &file) const {
+    static const std::vector<std::string> none;
+    auto it = file_readers.find(fs::absolute(file).lexically_normal().string());
+    return it == file_readers.end() ? none : it->second;
+}
+
+std::vector<fs::path> DepsIndex::headers() const {
+    std::vector<fs::path> files;
+    for (const auto &[file, objects] : file_readers) {
+        if (!sources.contains(file))
+            files.emplace_back(file);
+    }
+    return files;
+}
+} // namespace catalyst::utils::exec
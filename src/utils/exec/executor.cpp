@@ -0,0 +1,871 @@
+#include "catalyst/utils/exec/executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/exec/build_log.hpp"
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "catalyst/utils/exec/depfile.hpp"
+#include "catalyst/utils/exec/resources.hpp"
+#include "catalyst/utils/exec/spawn.hpp"
+#include "catalyst/utils/fs/file_stat.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/trace/timings.hpp"
+
+namespace catalyst::utils::exec {
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::int64_t missing = -1;
+
+std::int64_t statMtime(const std::string &path) {
+    const auto st = utils::fs::fileStat(path);
+    return st ? st->mtime_ns : missing;
+}
+
+/// Path, size and mtime: what tells a compiler or a prebuilt library apart without reading it.
+std::optional<std::string> fileIdentity(const fs::path &path) {
+    const auto st = utils::fs::fileStat(path);
+    if (!st || !st->regular)
+        return std::nullopt;
+    return std::format(
+        "{}:{}:{}.{}", path.string(), st->size, st->mtime_ns / 1'000'000'000, st->mtime_ns % 1'000'000'000);
+}
+
+/// A file the graph mentions: an output, an input or a header from the deps database.
+struct Node {
+    std::string path;      ///< as spelled in the graph, which is what the log is keyed by
+    std::string resolved;  ///< what to stat
+    int producer = -1;     ///< the edge that builds it
+    bool consumed = false; ///< an input of some edge, so its contents decide whether that edge reruns
+};
+
+struct EdgeState {
+    std::vector<int> outputs;
+    std::vector<std::int64_t> modified; ///< per output, when the log says it counts as modified
+    std::vector<int> inputs;            ///< explicit and implicit, deduplicated
+    std::vector<int> deps;   ///< from the deps database
+    std::vector<int> dependents;
+    int pool = -1;                   ///< index into the build's pools, or -1 if the rule has none
+    std::uint64_t logged_rss_kb = 0; ///< the largest peak RSS the log has for the outputs; 0 if unknown
+    std::uint64_t memory_kb = 0;     ///< what the command is expected to peak at, to schedule it
+    std::int64_t priority = 0;       ///< the longest logged chain of durations from here to the end of the build
+    std::atomic<std::size_t> pending{0}; ///< needed producers of inputs that have not completed yet
+    std::string command;
+    std::string depfile;
+    bool phony = false;
+    bool needed = false;
+    bool logged = false;     ///< every output was last built by this very command
+    bool deps_valid = false; ///< the recorded deps belong to the current output
+    bool maybe_dirty = false;
+    bool cacheable = false;
+};
+
+/// Ready edges, those with the longest logged path to the end of the build first, so the long poles start early.
+/// Ties, such as every edge of a first build, go to the edge unblocked last, whose inputs are likely still in the
+/// page cache.
+class ReadyQueue {
+public:
+    void push(int edge, std::int64_t priority) {
+        {
+            std::unique_lock lock{mutex};
+            heap.push(Entry{.priority = priority, .sequence = sequence++, .edge = edge});
+        }
+        ready.notify_one();
+    }
+
+    /// The next edge, or nullopt once `done()` holds.
+    template <typename Done> std::optional<int> take(Done &&done) {
+        std::unique_lock lock{mutex};
+        ready.wait(lock, [&] { return !heap.empty() || done(); });
+        if (done())
+            return std::nullopt;
+        int edge = heap.top().edge;
+        heap.pop();
+        return edge;
+    }
+
+    void wakeAll() {
+        {
+            std::unique_lock lock{mutex};
+        }
+        ready.notify_all();
+    }
+
+private:
+    struct Entry {
+        std::int64_t priority;
+        std::uint64_t sequence;
+        int edge;
+        bool operator<(const Entry &other) const {
+            return std::tie(priority, sequence) < std::tie(other.priority, other.sequence);
+        }
+    };
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::priority_queue<Entry> heap;
+    std::uint64_t sequence = 0;
+};
+
+/// Decides when a command may start. Its pool must have room and, unless nothing is running, the running commands'
+/// expected memory plus its own must fit the budget and the load must be below the cap; a lone command always
+/// starts, so an edge expected to need more than the whole budget still runs. Waiting workers hold on to their edge
+/// and are woken whenever a command finishes.
+class Admission {
+public:
+    Admission(std::uint64_t budget_kb, double max_load, std::vector<unsigned> depths)
+        : budget_kb(budget_kb), max_load(max_load), depths(std::move(depths)), in_pool(this->depths.size(), 0) {
+    }
+
+    void acquire(int pool, std::uint64_t memory_kb) {
+        std::unique_lock lock{mutex};
+        while (!fits(pool, memory_kb)) {
+            if (max_load > 0)
+                freed.wait_for(lock, std::chrono::milliseconds{250}); // the load changes without anyone finishing
+            else
+                freed.wait(lock);
+        }
+        ++running;
+        memory_in_use_kb += memory_kb;
+        if (pool >= 0)
+            ++in_pool[pool];
+    }
+
+    void release(int pool, std::uint64_t memory_kb) {
+        {
+            std::unique_lock lock{mutex};
+            --running;
+            memory_in_use_kb -= memory_kb;
+            if (pool >= 0)
+                --in_pool[pool];
+        }
+        freed.notify_all();
+    }
+
+private:
+    bool fits(int pool, std::uint64_t memory_kb) const {
+        if (pool >= 0 && depths[pool] != 0 && in_pool[pool] >= depths[pool])
+            return false;
+        if (running == 0)
+            return true;
+        if (budget_kb != 0 && memory_in_use_kb + memory_kb > budget_kb)
+            return false;
+        return max_load <= 0 || loadAverage().value_or(0) < max_load;
+    }
+
+    std::mutex mutex;
+    std::condition_variable freed;
+    const std::uint64_t budget_kb;
+    const double max_load;
+    const std::vector<unsigned> depths;
+    std::vector<unsigned> in_pool;
+    std::size_t running = 0;
+    std::uint64_t memory_in_use_kb = 0;
+};
+
+class Build {
+public:
+    Build(const Graph &graph, const ExecuteOptions &options, BuildLog &log)
+        : graph(graph), options(options), log(log), edges(graph.edges().size()),
+          start(std::chrono::steady_clock::now()) {
+        hash_file = [this](const std::string &path) { return contentHash(path); };
+    }
+
+    std::expected<void, std::string> prepare();
+    std::expected<ExecuteSummary, std::string> run();
+
+private:
+    int intern(const std::string &path);
+    std::expected<std::optional<std::string>, std::string> dirtyReason(int edge) const;
+    /// `slot`: the worker running it, from 1, which is its lane in `build --timings`.
+    void process(int edge, unsigned slot);
+    std::expected<void, std::string> runEdge(int edge, unsigned slot);
+    bool restore(int edge, std::uint64_t key, std::int64_t start_ms, const std::vector<std::int64_t> &before);
+    /// The deps the edge's depfile listed, or nullopt if it has a depfile that could not be read.
+    std::expected<std::optional<std::vector<std::string>>, std::string> ingestDepfile(int edge);
+    void recordDeps(int edge, std::vector<std::string> deps);
+    /// `linked`: per output, whether it was restored as a hard link into the cache; empty if the command ran.
+    void recordOutputs(int edge,
+                       std::int64_t start_ms,
+                       std::int64_t end_ms,
+                       const std::vector<std::int64_t> &before,
+                       std::uint64_t peak_rss_kb,
+                       const std::vector<bool> &linked = {});
+    void estimateMemory();
+    Durations loggedDurations() const;
+    void report(std::string text);
+    std::string statusLine(int edge);
+    std::vector<fs::path> outputPaths(int edge) const;
+    std::optional<std::uint64_t> cacheKey(int edge);
+    std::optional<std::uint64_t> contentHash(const std::string &path);
+    std::optional<std::string> toolIdentity(const std::string &tool);
+    void complete(int edge);
+    void fail(std::string error);
+    std::int64_t elapsedMs() const;
+
+    const Graph &graph;
+    const ExecuteOptions &options;
+    BuildLog &log;
+
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, int> node_ids;
+    std::vector<std::atomic<std::int64_t>> mtimes; ///< refreshed after an edge runs
+    std::vector<EdgeState> edges;
+    std::vector<int> order; ///< needed edges, inputs first
+
+    std::unique_ptr<ReadyQueue> queue;
+    std::unique_ptr<Admission> admission;
+    std::unordered_map<std::string, int> pool_ids;
+    std::vector<unsigned> pool_depths;
+    std::atomic<std::size_t> remaining{0}; ///< needed edges not completed yet
+    std::atomic<std::size_t> total{0};     ///< edges expected to run, for the status line
+    std::atomic<std::size_t> finished{0};
+    std::atomic<std::size_t> up_to_date{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::string first_error;
+    std::mutex console;
+    std::chrono::steady_clock::time_point start;
+
+    cache::FileHasher hash_file;
+    std::mutex hashes_mutex;
+    std::unordered_map<std::string, std::optional<std::uint64_t>> hashes; ///< by resolved path, for this build
+    std::unordered_map<std::string, std::optional<std::string>> tools;
+};
+
+int Build::intern(const std::string &path) {
+    auto [it, inserted] = node_ids.try_emplace(path, static_cast<int>(nodes.size()));
+    if (inserted) {
+        fs::path as_path{path};
+        nodes.push_back(Node{.path = path,
+                             .resolved = as_path.is_absolute() ? path : (options.build_dir / as_path).string(),
+                             .producer = -1,
+                             .consumed = false});
+    }
+    return it->second;
+}
+
+std::expected<void, std::string> Build::prepare() {
+    const auto &graph_edges = graph.edges();
+    for (std::size_t ii = 0; ii < graph_edges.size(); ++ii) {
+        const Edge &edge = graph_edges[ii];
+        EdgeState &state = edges[ii];
+        state.phony = graph.rule(edge) == nullptr;
+        if (state.phony && edge.rule != "phony")
+            return std::unexpected(std::format("unknown rule '{}' for {}", edge.rule, edge.outputs.front()));
+        for (const auto &output : edge.outputs) {
+            int node = intern(output);
+            if (nodes[node].producer >= 0)
+                return std::unexpected(std::format("multiple rules generate {}", output));
+            nodes[node].producer = static_cast<int>(ii);
+            state.outputs.push_back(node);
+        }
+        std::unordered_set<int> seen;
+        for (const auto *paths : {&edge.inputs, &edge.implicit_deps}) {
+            for (const auto &path : *paths) {
+                if (int node = intern(path); seen.insert(node).second) {
+                    state.inputs.push_back(node);
+                    nodes[node].consumed = true;
+                }
+            }
+        }
+    }
+
+    // only what the targets need
+    std::vector<std::string> targets = options.targets.empty() ? graph.defaults() : options.targets;
+    if (targets.empty()) {
+        for (const auto &edge : graph_edges)
+            targets.insert(targets.end(), edge.outputs.begin(), edge.outputs.end());
+    }
+    std::vector<int> stack;
+    for (const auto &target : targets) {
+        auto it = node_ids.find(target);
+        if (it == node_ids.end())
+            return std::unexpected(std::format("unknown target '{}'", target));
+        if (int producer = nodes[it->second].producer; producer >= 0)
+            stack.push_back(producer);
+    }
+    while (!stack.empty()) {
+        int edge = stack.back();
+        stack.pop_back();
+        if (std::exchange(edges[edge].needed, true))
+            continue;
+        for (int input : edges[edge].inputs) {
+            if (int producer = nodes[input].producer; producer >= 0 && !edges[producer].needed)
+                stack.push_back(producer);
+        }
+    }
+
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        EdgeState &state = edges[ii];
+        if (!state.needed)
+            continue;
+        for (int input : state.inputs) {
+            if (int producer = nodes[input].producer; producer >= 0) {
+                edges[producer].dependents.push_back(static_cast<int>(ii));
+                state.pending.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (state.phony)
+            continue;
+        const Edge &edge = graph_edges[ii];
+        state.command = graph.command(edge);
+        state.depfile = graph.depfile(edge);
+        state.cacheable = options.cache != nullptr && options.cacheable_rules.contains(edge.rule);
+        const std::uint64_t command_hash = hash::Fnv1a{}.update(state.command).digest();
+        if (const Rule *rule = graph.rule(edge); rule != nullptr && !rule->pool.empty()) {
+            auto [it, inserted] = pool_ids.try_emplace(rule->pool, static_cast<int>(pool_depths.size()));
+            if (inserted)
+                pool_depths.push_back(graph.poolDepth(edge));
+            state.pool = it->second;
+        }
+        for (const auto &output : edge.outputs) {
+            if (auto entry = log.entry(output))
+                state.logged_rss_kb = std::max(state.logged_rss_kb, entry->peak_rss_kb);
+        }
+        state.logged = std::ranges::all_of(edge.outputs, [&](const std::string &output) {
+            auto entry = log.entry(output);
+            if (!entry || entry->command_hash != command_hash)
+                return false;
+            state.modified.push_back(entry->mtime_ns);
+            return true;
+        });
+        if (!state.depfile.empty()) {
+            if (auto recorded = log.deps(edge.outputs.front())) {
+                state.deps_valid = recorded->mtime_ns == statMtime(nodes[state.outputs.front()].resolved);
+                for (const auto &dep : recorded->deps)
+                    state.deps.push_back(intern(dep));
+            }
+        }
+    }
+
+    estimateMemory();
+    auto priorities = criticalPriorities(graph_edges, loggedDurations());
+    for (std::size_t ii = 0; ii < edges.size(); ++ii)
+        edges[ii].priority = priorities[ii];
+
+    mtimes = std::vector<std::atomic<std::int64_t>>(nodes.size());
+    for (std::size_t ii = 0; ii < nodes.size(); ++ii)
+        mtimes[ii].store(statMtime(nodes[ii].resolved), std::memory_order_relaxed);
+
+    // Kahn's algorithm, which also finds cycles; an edge may run if it is out of date now or anything before it
+    // may run
+    std::vector<std::size_t> waiting(edges.size());
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        waiting[ii] = edges[ii].pending.load(std::memory_order_relaxed);
+        if (edges[ii].needed && waiting[ii] == 0)
+            order.push_back(static_cast<int>(ii));
+    }
+    for (std::size_t next = 0; next < order.size(); ++next) {
+        for (int dependent : edges[order[next]].dependents) {
+            if (--waiting[dependent] == 0)
+                order.push_back(dependent);
+        }
+    }
+    std::size_t needed = 0;
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        if (!edges[ii].needed)
+            continue;
+        ++needed;
+        if (waiting[ii] != 0)
+            return std::unexpected(std::format("dependency cycle involving {}", graph_edges[ii].outputs.front()));
+    }
+
+    std::size_t expected_runs = 0;
+    for (int edge : order) {
+        EdgeState &state = edges[edge];
+        for (int input : state.inputs) {
+            if (int producer = nodes[input].producer; producer >= 0 && edges[producer].maybe_dirty)
+                state.maybe_dirty = true;
+        }
+        if (!state.phony && !state.maybe_dirty) {
+            auto reason = dirtyReason(edge);
+            if (!reason)
+                return std::unexpected(reason.error());
+            state.maybe_dirty = reason->has_value();
+        }
+        if (!state.phony && state.maybe_dirty)
+            ++expected_runs;
+    }
+    remaining.store(needed);
+    total.store(expected_runs);
+    return {};
+}
+
+std::expected<std::optional<std::string>, std::string> Build::dirtyReason(int edge) const {
+    const EdgeState &state = edges[edge];
+    const Edge &graph_edge = graph.edges()[edge];
+    if (!state.logged)
+        return std::format("the command for {} changed or never ran", graph_edge.outputs.front());
+
+    std::int64_t oldest = std::numeric_limits<std::int64_t>::max();
+    for (std::size_t ii = 0; ii < state.outputs.size(); ++ii) {
+        std::int64_t mtime = mtimes[state.outputs[ii]].load(std::memory_order_relaxed);
+        if (mtime == missing)
+            return std::format("{} is missing", nodes[state.outputs[ii]].path);
+        // an output given its old mtime back after an identical rebuild is still as new as that rebuild
+        oldest = std::min(oldest, std::max(mtime, state.modified[ii]));
+    }
+    if (!state.depfile.empty() && !state.deps_valid)
+        return std::format("no dependencies were recorded for {}", graph_edge.outputs.front());
+
+    for (const auto *inputs : {&state.inputs, &state.deps}) {
+        for (int input : *inputs) {
+            std::int64_t mtime = mtimes[input].load(std::memory_order_acquire);
+            if (mtime == missing) {
+                if (inputs == &state.inputs && nodes[input].producer < 0)
+                    return std::unexpected(std::format("'{}', needed by '{}', is missing and no rule makes it",
+                                                       nodes[input].path,
+                                                       graph_edge.outputs.front()));
+                return std::format("{} is missing", nodes[input].path);
+            }
+            if (mtime > oldest)
+                return std::format("{} is newer than {}", nodes[input].path, graph_edge.outputs.front());
+        }
+    }
+    return std::nullopt;
+}
+
+Durations Build::loggedDurations() const {
+    Durations durations;
+    for (const auto &node : nodes) {
+        if (node.producer < 0)
+            continue;
+        if (auto entry = log.entry(node.path))
+            durations.emplace(node.path, entry->end_ms - entry->start_ms);
+    }
+    return durations;
+}
+
+/// From the log, or the average of the rule's logged commands: a new source of a rule is about as heavy as the rest.
+void Build::estimateMemory() {
+    std::unordered_map<std::string_view, std::pair<std::uint64_t, std::uint64_t>> per_rule; // sum, count
+    const auto &graph_edges = graph.edges();
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        if (edges[ii].logged_rss_kb == 0)
+            continue;
+        auto &[sum, count] = per_rule[graph_edges[ii].rule];
+        sum += edges[ii].logged_rss_kb;
+        ++count;
+    }
+    for (std::size_t ii = 0; ii < edges.size(); ++ii) {
+        EdgeState &state = edges[ii];
+        state.memory_kb = state.logged_rss_kb;
+        if (auto it = per_rule.find(graph_edges[ii].rule); state.memory_kb == 0 && it != per_rule.end())
+            state.memory_kb = it->second.first / it->second.second;
+    }
+}
+
+std::expected<ExecuteSummary, std::string> Build::run() {
+    if (total.load() == 0) {
+        catalyst::logger.log(LogLevel::INFO, "No work to do.");
+        return ExecuteSummary{.ran = 0, .up_to_date = remaining.load(), .critical_path = {}};
+    }
+
+    unsigned jobs = options.jobs != 0 ? options.jobs : std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min<std::size_t>(jobs, total.load());
+    queue = std::make_unique<ReadyQueue>();
+    admission = std::make_unique<Admission>(options.memory_budget_kb, options.max_load, pool_depths);
+    for (int edge : order) {
+        if (edges[edge].pending.load(std::memory_order_relaxed) == 0)
+            queue->push(edge, edges[edge].priority);
+    }
+
+    auto done = [this] {
+        return remaining.load(std::memory_order_acquire) == 0 || failed.load(std::memory_order_acquire);
+    };
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(workers);
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            threads.emplace_back([this, &done, slot = static_cast<unsigned>(worker) + 1] {
+                while (auto edge = queue->take(done))
+                    process(*edge, slot);
+            });
+        }
+    }
+
+    if (failed.load())
+        return std::unexpected(first_error);
+    return ExecuteSummary{.ran = finished.load(),
+                          .up_to_date = up_to_date.load(),
+                          .critical_path = criticalPath(graph.edges(), loggedDurations())};
+}
+
+void Build::process(int edge, unsigned slot) {
+    EdgeState &state = edges[edge];
+    if (state.phony) {
+        complete(edge);
+        return;
+    }
+
+    auto reason = dirtyReason(edge);
+    if (!reason) {
+        fail(reason.error());
+        return;
+    }
+    if (!reason->has_value()) {
+        // its inputs were rebuilt without changing
+        if (state.maybe_dirty)
+            total.fetch_sub(1, std::memory_order_relaxed);
+        up_to_date.fetch_add(1, std::memory_order_relaxed);
+        complete(edge);
+        return;
+    }
+    catalyst::logger.log(LogLevel::DEBUG, "Rebuilding: {}", **reason);
+    if (!state.maybe_dirty)
+        total.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto res = runEdge(edge, slot); !res) {
+        fail(res.error());
+        return;
+    }
+    complete(edge);
+}
+
+std::expected<void, std::string> Build::runEdge(int edge, unsigned slot) {
+    EdgeState &state = edges[edge];
+    const Edge &graph_edge = graph.edges()[edge];
+    for (int output : state.outputs) {
+        std::error_code ec;
+        fs::create_directories(fs::path{nodes[output].resolved}.parent_path(), ec);
+    }
+
+    std::vector<std::int64_t> before;
+    for (int output : state.outputs)
+        before.push_back(mtimes[output].load(std::memory_order_relaxed));
+
+    auto record_span = [&](std::int64_t start_us, const char *suffix) {
+        if (!trace::recorder.enabled())
+            return;
+        const std::string description = graph.description(graph_edge);
+        trace::recorder.add({.name = (description.empty() ? graph_edge.outputs.front() : description) + suffix,
+                             .category = graph_edge.rule,
+                             .start_us = start_us,
+                             .end_us = trace::recorder.nowUs(),
+                             .lane = slot});
+    };
+    std::int64_t start_ms = elapsedMs();
+    std::int64_t start_us = trace::recorder.nowUs();
+    std::optional<std::uint64_t> cache_key;
+    if (state.cacheable) {
+        cache_key = cacheKey(edge);
+        if (cache_key && restore(edge, *cache_key, start_ms, before)) {
+            record_span(start_us, " (cached)");
+            return {};
+        }
+        // an output restored from the cache may be a hard link into it, which the command must not write through
+        for (int output : state.outputs) {
+            std::error_code ec;
+            fs::remove(nodes[output].resolved, ec);
+        }
+    }
+
+    admission->acquire(state.pool, state.memory_kb);
+    if (failed.load(std::memory_order_acquire)) {
+        admission->release(state.pool, state.memory_kb);
+        return std::unexpected("cancelled"); // the first error is the one reported
+    }
+    start_ms = elapsedMs(); // the wait for admission is not the command's time
+    start_us = trace::recorder.nowUs();
+    auto result = runCommand(state.command, options.build_dir);
+    const std::int64_t end_ms = elapsedMs();
+    record_span(start_us, "");
+    admission->release(state.pool, state.memory_kb);
+    if (!result)
+        return std::unexpected(result.error());
+
+    std::string text = statusLine(edge);
+    if (result->exit_code != 0) {
+        std::string outputs;
+        for (const auto &output : graph_edge.outputs)
+            outputs += (outputs.empty() ? "" : " ") + output;
+        text += std::format("FAILED: {}\n{}\n", outputs, state.command);
+    }
+    report(text + result->output);
+    if (result->exit_code != 0)
+        return std::unexpected(
+            std::format("{} failed with exit code {}", graph_edge.outputs.front(), result->exit_code));
+
+    auto deps = ingestDepfile(edge);
+    if (!deps)
+        return std::unexpected(deps.error());
+    if (cache_key && deps->has_value()) {
+        if (auto res = options.cache->store(*cache_key, outputPaths(edge), **deps, hash_file); !res)
+            catalyst::logger.log(LogLevel::WARN, "{}", res.error());
+    }
+    recordOutputs(edge, start_ms, end_ms, before, result->peak_rss_kb);
+    if (deps->has_value())
+        recordDeps(edge, std::move(**deps));
+    return {};
+}
+
+bool Build::restore(int edge, std::uint64_t key, std::int64_t start_ms, const std::vector<std::int64_t> &before) {
+    auto hit = options.cache->lookup(key, hash_file);
+    if (!hit)
+        return false;
+    auto linked = options.cache->materialize(*hit, outputPaths(edge));
+    if (!linked) {
+        catalyst::logger.log(LogLevel::WARN, "{}", linked.error());
+        return false;
+    }
+    std::string text = statusLine(edge);
+    text.insert(text.size() - 1, " (cached)");
+    report(std::move(text));
+    recordOutputs(edge, start_ms, elapsedMs(), before, edges[edge].logged_rss_kb, *linked); // restoring is no measure
+    if (!edges[edge].depfile.empty())
+        recordDeps(edge, std::move(hit->deps));
+    return true;
+}
+
+std::expected<std::optional<std::vector<std::string>>, std::string> Build::ingestDepfile(int edge) {
+    const EdgeState &state = edges[edge];
+    if (state.depfile.empty())
+        return std::vector<std::string>{};
+    fs::path depfile{state.depfile};
+    if (depfile.is_relative())
+        depfile = options.build_dir / depfile;
+
+    std::optional<std::vector<std::string>> deps;
+    if (std::ifstream in{depfile, std::ios::binary}) {
+        std::string content{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+        auto parsed = parseDepfile(content);
+        if (!parsed)
+            return std::unexpected(std::format("{}: {}", depfile.string(), parsed.error()));
+        deps = std::move(*parsed);
+    }
+    std::error_code ec;
+    fs::remove(depfile, ec);
+    if (!deps)
+        recordDeps(edge, {}); // the command wrote no depfile; nothing it did can be cached
+    return deps;
+}
+
+void Build::recordDeps(int edge, std::vector<std::string> deps) {
+    const Node &output = nodes[edges[edge].outputs.front()];
+    DepsEntry entry{.mtime_ns = statMtime(output.resolved), .deps = std::move(deps)};
+    if (auto res = log.recordDeps(output.path, std::move(entry)); !res)
+        catalyst::logger.log(LogLevel::WARN, "{}", res.error());
+}
+
+/// Restat the outputs and log them. Early cutoff: an output that something depends on and that came out with the
+/// contents the log recorded gets its mtime from `before` back, so what depends on it stays up to date. A hard link
+/// into the cache is left alone: its inode is shared with the cache and with other builds restored from it.
+void Build::recordOutputs(int edge,
+                          std::int64_t start_ms,
+                          std::int64_t end_ms,
+                          const std::vector<std::int64_t> &before,
+                          std::uint64_t peak_rss_kb,
+                          const std::vector<bool> &linked) {
+    const EdgeState &state = edges[edge];
+    const std::uint64_t command_hash = hash::Fnv1a{}.update(state.command).digest();
+    for (std::size_t ii = 0; ii < state.outputs.size(); ++ii) {
+        const Node &output = nodes[state.outputs[ii]];
+        const std::int64_t modified = statMtime(output.resolved);
+        std::int64_t mtime = modified;
+        std::uint64_t content_hash = 0;
+        const bool shared = ii < linked.size() && linked[ii];
+        if (modified != missing && output.consumed) {
+            content_hash = hash::hashFile(output.resolved).value_or(0);
+            auto logged = log.entry(output.path);
+            if (!shared && content_hash != 0 && logged && logged->content_hash == content_hash &&
+                before[ii] != missing && before[ii] < modified && utils::fs::setMtime(output.resolved, before[ii])) {
+                catalyst::logger.log(
+                    LogLevel::DEBUG, "{} is unchanged; what depends on it stays up to date", output.path);
+                mtime = before[ii];
+            }
+        }
+        mtimes[state.outputs[ii]].store(mtime, std::memory_order_release);
+        if (modified == missing)
+            continue; // not logged, so it runs again next time
+        LogEntry entry{.start_ms = start_ms,
+                       .end_ms = end_ms,
+                       .mtime_ns = modified,
+                       .command_hash = command_hash,
+                       .content_hash = content_hash,
+                       .peak_rss_kb = peak_rss_kb};
+        if (auto res = log.record(output.path, entry); !res)
+            catalyst::logger.log(LogLevel::WARN, "{}", res.error());
+    }
+}
+
+void Build::report(std::string text) {
+    std::unique_lock lock{console};
+    std::print("{}", text);
+    std::fflush(stdout);
+}
+
+std::string Build::statusLine(int edge) {
+    std::string description = graph.description(graph.edges()[edge]);
+    return std::format("[{}/{}] {}\n",
+                       finished.fetch_add(1, std::memory_order_relaxed) + 1,
+                       total.load(std::memory_order_relaxed),
+                       description.empty() ? edges[edge].command : description);
+}
+
+std::vector<fs::path> Build::outputPaths(int edge) const {
+    std::vector<fs::path> paths;
+    for (int output : edges[edge].outputs)
+        paths.emplace_back(nodes[output].resolved);
+    return paths;
+}
+
+/// The command line, the identity of the tool it runs and of the libraries it links by `-l`, and the contents of
+/// every input. Headers are not part of the key; the cache checks them against the depfile of the stored result.
+std::optional<std::uint64_t> Build::cacheKey(int edge) {
+    const EdgeState &state = edges[edge];
+    std::vector<std::string> words;
+    std::istringstream split{state.command};
+    for (std::string word; split >> word;)
+        words.push_back(std::move(word));
+    if (words.empty())
+        return std::nullopt;
+
+    hash::Fnv1a key;
+    key.update("catalyst-object-cache 1").update(state.command);
+    auto tool = toolIdentity(words.front());
+    if (!tool)
+        return std::nullopt;
+    key.update(*tool);
+
+    std::vector<fs::path> library_dirs;
+    for (std::size_t ii = 1; ii < words.size(); ++ii) {
+        if (words[ii] == "-L" && ii + 1 < words.size())
+            library_dirs.emplace_back(words[ii + 1]);
+        else if (words[ii].starts_with("-L"))
+            library_dirs.emplace_back(words[ii].substr(2));
+    }
+    for (auto &dir : library_dirs) {
+        if (dir.is_relative())
+            dir = options.build_dir / dir;
+    }
+    for (const auto &word : words) {
+        if (!word.starts_with("-l") || word.size() == 2)
+            continue;
+        // libraries outside the `-L` directories are system libraries, which are assumed not to change
+        for (const auto &dir : library_dirs) {
+            auto identity = fileIdentity(dir / std::format("lib{}.so", word.substr(2)));
+            if (!identity)
+                identity = fileIdentity(dir / std::format("lib{}.a", word.substr(2)));
+            if (identity) {
+                key.update(*identity);
+                break;
+            }
+        }
+    }
+
+    for (int input : state.inputs) {
+        auto content = contentHash(nodes[input].path);
+        if (!content)
+            return std::nullopt;
+        key.update(nodes[input].path).update(*content);
+    }
+    return key.digest();
+}
+
+/// Hashed at most once per build: a header is read once however many compiles include it.
+std::optional<std::uint64_t> Build::contentHash(const std::string &path) {
+    fs::path resolved{path};
+    if (resolved.is_relative())
+        resolved = options.build_dir / resolved;
+    {
+        std::unique_lock lock{hashes_mutex};
+        if (auto it = hashes.find(resolved.string()); it != hashes.end())
+            return it->second;
+    }
+    auto content = hash::hashFile(resolved);
+    std::unique_lock lock{hashes_mutex};
+    hashes.try_emplace(resolved.string(), content);
+    return content;
+}
+
+std::optional<std::string> Build::toolIdentity(const std::string &tool) {
+    std::unique_lock lock{hashes_mutex};
+    if (auto it = tools.find(tool); it != tools.end())
+        return it->second;
+
+    std::optional<std::string> identity;
+    std::error_code ec;
+    if (tool.find('/') != std::string::npos) {
+        fs::path path{tool};
+        identity = fileIdentity(fs::canonical(path.is_relative() ? options.build_dir / path : path, ec));
+    } else if (const char *env = std::getenv("PATH"); env != nullptr) {
+        std::istringstream dirs{env};
+        for (std::string dir; !identity && std::getline(dirs, dir, ':');) {
+            fs::path candidate = fs::path{dir.empty() ? "." : dir} / tool;
+            if (::access(candidate.c_str(), X_OK) == 0)
+                identity = fileIdentity(fs::canonical(candidate, ec));
+        }
+    }
+    tools.emplace(tool, identity);
+    return identity;
+}
+
+void Build::complete(int edge) {
+    for (int dependent : edges[edge].dependents) {
+        if (edges[dependent].pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            queue->push(dependent, edges[dependent].priority);
+    }
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        queue->wakeAll();
+}
+
+void Build::fail(std::string error) {
+    {
+        std::unique_lock lock{error_mutex};
+        if (first_error.empty())
+            first_error = std::move(error);
+    }
+    failed.store(true, std::memory_order_release);
+    queue->wakeAll();
+}
+
+std::int64_t Build::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+std::expected<ExecuteSummary, std::string> execute(const Graph &graph, const ExecuteOptions &options) {
+    BuildLog log{buildLogDir(options.build_dir)};
+    if (auto res = log.open(); !res)
+        catalyst::logger.log(LogLevel::WARN, "Build log unavailable, the next build may redo work: {}", res.error());
+
+    Build build{graph, options, log};
+    if (auto res = build.prepare(); !res)
+        return std::unexpected(res.error());
+    auto summary = build.run();
+    if (options.cache != nullptr) {
+        if (auto res = options.cache->flush(); !res)
+            catalyst::logger.log(LogLevel::WARN, "{}", res.error());
+    }
+    return summary;
+}
+} // namespace catalyst::utils::exec
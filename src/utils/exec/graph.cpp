@@ -0,0 +1,108 @@
+#include "catalyst/utils/exec/graph.hpp"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace catalyst::utils::exec {
+namespace {
+bool isVarChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+std::string join(const std::vector<std::string> &paths) {
+    std::string joined;
+    for (const auto &path : paths) {
+        if (!joined.empty())
+            joined.push_back(' ');
+        joined += path;
+    }
+    return joined;
+}
+} // namespace
+
+void Graph::setVariable(std::string name, std::string value) {
+    variables.insert_or_assign(std::move(name), std::move(value));
+}
+
+void Graph::addRule(std::string name, Rule rule) {
+    rules.insert_or_assign(std::move(name), std::move(rule));
+}
+
+void Graph::addEdge(Edge edge) {
+    all_edges.push_back(std::move(edge));
+}
+
+void Graph::addDefault(std::string target) {
+    default_targets.push_back(std::move(target));
+}
+
+void Graph::addPool(std::string name, unsigned depth) {
+    pools.insert_or_assign(std::move(name), depth);
+}
+
+const Rule *Graph::rule(const Edge &edge) const {
+    auto it = rules.find(edge.rule);
+    return it == rules.end() ? nullptr : &it->second;
+}
+
+std::string Graph::command(const Edge &edge) const {
+    const Rule *edge_rule = rule(edge);
+    return edge_rule == nullptr ? std::string{} : expand(edge_rule->command, edge);
+}
+
+std::string Graph::description(const Edge &edge) const {
+    const Rule *edge_rule = rule(edge);
+    return edge_rule == nullptr ? std::string{} : expand(edge_rule->description, edge);
+}
+
+std::string Graph::depfile(const Edge &edge) const {
+    const Rule *edge_rule = rule(edge);
+    return edge_rule == nullptr ? std::string{} : expand(edge_rule->depfile, edge);
+}
+
+unsigned Graph::poolDepth(const Edge &edge) const {
+    const Rule *edge_rule = rule(edge);
+    if (edge_rule == nullptr || edge_rule->pool.empty())
+        return 0;
+    auto it = pools.find(edge_rule->pool);
+    return it == pools.end() ? 0 : it->second;
+}
+
+std::string Graph::expand(std::string_view text, const Edge &edge) const {
+    std::string result;
+    result.reserve(text.size());
+    for (std::size_t pos = 0; pos < text.size();) {
+        if (text[pos] != '$' || pos + 1 == text.size()) {
+            result.push_back(text[pos++]);
+            continue;
+        }
+        ++pos;
+        if (text[pos] == '$') {
+            result.push_back('$');
+            ++pos;
+            continue;
+        }
+        std::string_view name;
+        if (text[pos] == '{') {
+            std::size_t close = text.find('}', pos);
+            if (close == std::string_view::npos)
+                close = text.size();
+            name = text.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+        } else {
+            std::size_t start = pos;
+            while (pos < text.size() && isVarChar(text[pos]))
+                ++pos;
+            name = text.substr(start, pos - start);
+        }
+        if (name == "in")
+            result += join(edge.inputs);
+        else if (name == "out")
+            result += join(edge.outputs);
+        else if (auto it = variables.find(std::string{name}); it != variables.end())
+            result += it->second; // unknown variables expand to nothing, as in ninja
+    }
+    return result;
+}
+} // namespace catalyst::utils::exec
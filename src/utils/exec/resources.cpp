@@ -0,0 +1,40 @@
+#include "catalyst/utils/exec/resources.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+
+namespace catalyst::utils::exec {
+std::uint64_t physicalMemoryKb() {
+#if defined(_WIN32)
+    MEMORYSTATUSEX status{};
+    status.dwLength = sizeof(status);
+    if (!::GlobalMemoryStatusEx(&status))
+        return 0;
+    return static_cast<std::uint64_t>(status.ullTotalPhys) / 1024;
+#else
+    const long pages = ::sysconf(_SC_PHYS_PAGES);
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || page_size <= 0)
+        return 0;
+    return static_cast<std::uint64_t>(pages) * static_cast<std::uint64_t>(page_size) / 1024;
+#endif
+}
+
+std::optional<double> loadAverage() {
+#if defined(_WIN32)
+    return std::nullopt; // Windows keeps no load average
+#else
+    double load = 0;
+    if (::getloadavg(&load, 1) != 1)
+        return std::nullopt;
+    return load;
+#endif
+}
+} // namespace catalyst::utils::exec
@@ -0,0 +1,131 @@
+#include "catalyst/utils/exec/spawn.hpp"
+
+#if defined(_WIN32)
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <string>
+
+#if !defined(_WIN32)
+extern char **environ;
+#endif
+
+namespace catalyst::utils::exec {
+#if !defined(_WIN32)
+namespace {
+#if !defined(__linux__)
+/// `text` as a single word for `/bin/sh`.
+std::string shellQuote(const std::string &text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        if (c == '\'')
+            quoted += "'\\''";
+        else
+            quoted += c;
+    }
+    return quoted + "'";
+}
+#endif
+
+/// A pipe whose ends are closed on exec, so commands started concurrently by other threads do not hold our write end
+/// open. Without pipe2 there is a short window in which another thread's fork can inherit it.
+bool cloexecPipe(std::array<int, 2> &fds) {
+#if defined(__linux__)
+    return ::pipe2(fds.data(), O_CLOEXEC) == 0;
+#else
+    if (::pipe(fds.data()) != 0)
+        return false;
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+} // namespace
+
+std::expected<CommandResult, std::string> runCommand(const std::string &command, const std::filesystem::path &cwd) {
+    std::array<int, 2> pipe_fds{};
+    if (!cloexecPipe(pipe_fds))
+        return std::unexpected(std::format("pipe failed: {}", std::strerror(errno)));
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDERR_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+#if defined(__linux__)
+    posix_spawn_file_actions_addchdir_np(&actions, cwd.c_str());
+    const std::string &script = command;
+#else
+    // addchdir_np is a glibc and recent-macOS extension; let the shell change directory instead
+    const std::string script = std::format("cd {} && {}", shellQuote(cwd.string()), command);
+#endif
+
+    const char *shell = "/bin/sh";
+    std::array<char *, 4> argv{const_cast<char *>(shell),
+                               const_cast<char *>("-c"),
+                               const_cast<char *>(script.c_str()),
+                               nullptr};
+    pid_t pid = 0;
+    int spawn_error = ::posix_spawn(&pid, shell, &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(pipe_fds[1]);
+    if (spawn_error != 0) {
+        ::close(pipe_fds[0]);
+        return std::unexpected(std::format("Failed to start {}: {}", shell, std::strerror(spawn_error)));
+    }
+
+    CommandResult result;
+    std::array<char, 4096> buffer{};
+    while (true) {
+        ssize_t count = ::read(pipe_fds[0], buffer.data(), buffer.size());
+        if (count > 0)
+            result.output.append(buffer.data(), static_cast<std::size_t>(count));
+        else if (count == 0 || errno != EINTR)
+            break;
+    }
+    ::close(pipe_fds[0]);
+
+    int status = 0;
+    rusage usage{};
+    while (::wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR)
+            return std::unexpected(std::format("wait4 failed: {}", std::strerror(errno)));
+    }
+    result.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    // the compiler driver waits for cc1plus or the linker, so their peak is included
+#if defined(__APPLE__)
+    result.peak_rss_kb = static_cast<std::uint64_t>(usage.ru_maxrss) / 1024; // bytes on macOS
+#else
+    result.peak_rss_kb = static_cast<std::uint64_t>(usage.ru_maxrss);
+#endif
+    return result;
+}
+#else
+std::expected<CommandResult, std::string> runCommand(const std::string &command, const std::filesystem::path &cwd) {
+    // no posix_spawn: run through cmd.exe, which also merges stderr; the peak RSS is not available
+    const std::string script = std::format("cd /d \"{}\" && {} 2>&1", cwd.string(), command);
+    FILE *pipe = ::_popen(script.c_str(), "r");
+    if (pipe == nullptr)
+        return std::unexpected(std::format("Failed to start {}: {}", command, std::strerror(errno)));
+
+    CommandResult result;
+    std::array<char, 4096> buffer{};
+    while (std::size_t count = std::fread(buffer.data(), 1, buffer.size(), pipe))
+        result.output.append(buffer.data(), count);
+    result.exit_code = ::_pclose(pipe);
+    return result;
+}
+#endif
+} // namespace catalyst::utils::exec
@@ -0,0 +1,62 @@
+#include "catalyst/utils/fs/file_stat.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <system_error>
+
+namespace catalyst::utils::fs {
+namespace stdfs = std::filesystem;
+
+std::optional<FileStat> fileStat(const stdfs::path &path) {
+#if !defined(_WIN32)
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0)
+        return std::nullopt;
+#if defined(__APPLE__)
+    const timespec &mtime = st.st_mtimespec;
+#else
+    const timespec &mtime = st.st_mtim;
+#endif
+    return FileStat{.mtime_ns = static_cast<std::int64_t>(mtime.tv_sec) * 1'000'000'000 + mtime.tv_nsec,
+                    .size = static_cast<std::int64_t>(st.st_size),
+                    .inode = static_cast<std::uint64_t>(st.st_ino),
+                    .regular = S_ISREG(st.st_mode)};
+#else
+    // no single call returns all of it; an inode of 0 leaves the size and mtime to tell files apart
+    std::error_code ec;
+    const auto status = stdfs::status(path, ec);
+    if (ec || !stdfs::exists(status))
+        return std::nullopt;
+    const auto mtime = stdfs::last_write_time(path, ec);
+    if (ec)
+        return std::nullopt;
+    const bool regular = stdfs::is_regular_file(status);
+    const auto size = regular ? stdfs::file_size(path, ec) : 0;
+    const auto sys_mtime = stdfs::file_time_type::clock::to_sys(mtime);
+    return FileStat{
+        .mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(sys_mtime.time_since_epoch()).count(),
+        .size = ec ? 0 : static_cast<std::int64_t>(size),
+        .regular = regular};
+#endif
+}
+
+bool setMtime(const stdfs::path &path, std::int64_t mtime_ns) {
+#if !defined(_WIN32)
+    const timespec times[2] = {{.tv_sec = 0, .tv_nsec = UTIME_OMIT},
+                               {.tv_sec = mtime_ns / 1'000'000'000, .tv_nsec = mtime_ns % 1'000'000'000}};
+    return ::utimensat(AT_FDCWD, path.c_str(), times, 0) == 0;
+#else
+    const std::chrono::sys_time<std::chrono::nanoseconds> sys_mtime{std::chrono::nanoseconds{mtime_ns}};
+    std::error_code ec;
+    stdfs::last_write_time(path, stdfs::file_time_type::clock::from_sys(sys_mtime), ec);
+    return !ec;
+#endif
+}
+} // namespace catalyst::utils::fs
@@ -0,0 +1,190 @@
+#include "catalyst/utils/fs/scan_cache.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "catalyst/utils/fs/file_stat.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::fs {
+namespace stdfs = std::filesystem;
+
+namespace {
+// Line based, one record per line:
+//   D <mtime_ns> <inode> <dir path>
+//   f <name> | d <name>   children of the preceding D
+constexpr std::string_view header = "catalyst-scan-cache 1";
+
+/// Directories touched this recently may still change within the same mtime tick, so they are not cached.
+constexpr std::int64_t racy_window_ns = 2'000'000'000;
+
+template <typename Int> bool parseInt(std::string_view &line, Int &out) {
+    auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), out);
+    if (ec != std::errc{} || ptr == line.data() + line.size() || *ptr != ' ')
+        return false;
+    line.remove_prefix(static_cast<std::size_t>(ptr - line.data()) + 1);
+    return true;
+}
+
+bool isBelow(std::string_view dir, std::string_view root) {
+    return dir.starts_with(root) && (dir.size() == root.size() || dir[root.size()] == '/');
+}
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
+
+ScanCache::ScanCache(stdfs::path file) : file(std::move(file)) {
+    std::ifstream in{this->file, std::ios::binary};
+    if (!in)
+        return;
+    std::string content{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    std::string_view rest = content;
+
+    auto nextLine = [&rest]() -> std::optional<std::string_view> {
+        if (rest.empty())
+            return std::nullopt;
+        std::size_t end = rest.find('\n');
+        std::string_view line = rest.substr(0, end);
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+        return line;
+    };
+
+    if (nextLine() != header) {
+        catalyst::logger.log(LogLevel::DEBUG, "Ignoring scan cache {}: unknown format", this->file.string());
+        return;
+    }
+    Entry *current = nullptr;
+    while (auto line = nextLine()) {
+        if (line->size() < 3 || (*line)[1] != ' ') {
+            catalyst::logger.log(LogLevel::DEBUG, "Ignoring corrupt scan cache {}", this->file.string());
+            entries.clear();
+            return;
+        }
+        char tag = (*line)[0];
+        line->remove_prefix(2);
+        if (tag == 'D') {
+            DirStamp dir_stamp;
+            if (!parseInt(*line, dir_stamp.mtime_ns) || !parseInt(*line, dir_stamp.inode)) {
+                catalyst::logger.log(LogLevel::DEBUG, "Ignoring corrupt scan cache {}", this->file.string());
+                entries.clear();
+                return;
+            }
+            current = &entries[std::string{*line}];
+            current->stamp = dir_stamp;
+        } else if ((tag == 'f' || tag == 'd') && current != nullptr) {
+            current->children.push_back(CachedChild{.name = std::string{*line}, .kind = CachedChild::Kind{tag}});
+        } else {
+            catalyst::logger.log(LogLevel::DEBUG, "Ignoring corrupt scan cache {}", this->file.string());
+            entries.clear();
+            return;
+        }
+    }
+    catalyst::logger.log(
+        LogLevel::DEBUG, "Loaded scan cache {} with {} directories", this->file.string(), entries.size());
+}
+
+std::optional<DirStamp> ScanCache::stamp(const stdfs::path &dir) {
+    const auto st = fileStat(dir);
+    if (!st)
+        return std::nullopt;
+    return DirStamp{.mtime_ns = st->mtime_ns, .inode = st->inode};
+}
+
+std::optional<std::vector<CachedChild>> ScanCache::lookup(const stdfs::path &dir, const DirStamp &stamp) {
+    std::shared_lock lock{mutex};
+    auto it = entries.find(dir.string());
+    if (it == entries.end() || it->second.stamp != stamp) {
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    hit_count.fetch_add(1, std::memory_order_relaxed);
+    it->second.visited.store(true, std::memory_order_relaxed);
+    return it->second.children;
+}
+
+void ScanCache::record(const stdfs::path &dir, const DirStamp &stamp, std::vector<CachedChild> children) {
+    std::string key = dir.string();
+    if (stamp.mtime_ns > nowNs() - racy_window_ns || key.find('\n') != std::string::npos)
+        return;
+    for (const auto &child : children) {
+        if (child.name.find('\n') != std::string::npos)
+            return; // not representable in the cache file; relist every time
+    }
+
+    std::unique_lock lock{mutex};
+    Entry &entry = entries[std::move(key)];
+    entry.stamp = stamp;
+    entry.children = std::move(children);
+    entry.visited.store(true, std::memory_order_relaxed);
+    dirty = true;
+}
+
+void ScanCache::beginWalk(const std::vector<stdfs::path> &roots) {
+    std::unique_lock lock{mutex};
+    for (const auto &root : roots)
+        walked_roots.push_back(root.string());
+}
+
+std::expected<void, std::string> ScanCache::save() {
+    std::unique_lock lock{mutex};
+
+    // listings below a walked root that no walk reached belong to deleted or pruned directories
+    std::erase_if(entries, [this](const auto &item) {
+        if (item.second.visited.load(std::memory_order_relaxed))
+            return false;
+        for (const auto &root : walked_roots) {
+            if (isBelow(item.first, root)) {
+                dirty = true;
+                return true;
+            }
+        }
+        return false;
+    });
+    if (!dirty)
+        return {};
+
+    std::string content{header};
+    content += '\n';
+    for (const auto &[dir, entry] : entries) {
+        content += std::format("D {} {} {}\n", entry.stamp.mtime_ns, entry.stamp.inode, dir);
+        for (const auto &child : entry.children) {
+            content += static_cast<char>(child.kind);
+            content += ' ';
+            content += child.name;
+            content += '\n';
+        }
+    }
+
+    std::error_code ec;
+    if (file.has_parent_path())
+        stdfs::create_directories(file.parent_path(), ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", file.parent_path().string(), ec.message()));
+    if (auto res = writeIfChanged(file, content); !res)
+        return std::unexpected(res.error());
+    dirty = false;
+    catalyst::logger.log(LogLevel::DEBUG, "Saved scan cache {} with {} directories", file.string(), entries.size());
+    return {};
+}
+
+stdfs::path scanCachePath(const stdfs::path &build_dir) {
+    return build_dir / ".catalyst" / "scan_cache";
+}
+} // namespace catalyst::utils::fs
@@ -0,0 +1,16 @@
+#include "catalyst/utils/fs/user_cache_dir.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+
+namespace catalyst::utils::fs {
+namespace stdfs = std::filesystem;
+
+stdfs::path userCacheDir() {
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0')
+        return stdfs::path{xdg} / "catalyst";
+    if (const char *home = std::getenv("HOME"); home != nullptr && *home != '\0')
+        return stdfs::path{home} / ".cache" / "catalyst";
+    return stdfs::temp_directory_path() / "catalyst";
+}
+} // namespace catalyst::utils::fs
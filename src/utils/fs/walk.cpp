@@ -0,0 +1,226 @@
+#include "catalyst/utils/fs/walk.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::fs {
+namespace stdfs = std::filesystem;
+
+namespace {
+struct DirTask {
+    std::size_t root;
+    stdfs::path path;
+};
+
+class WorkStealingWalker {
+public:
+    WorkStealingWalker(const WalkOptions &options, unsigned num_threads)
+        : options(options), queues(num_threads), results(num_threads) {
+    }
+
+    void push(unsigned worker, DirTask task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock{queues[worker].mutex};
+            queues[worker].tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        wake(false);
+    }
+
+    void run() {
+        std::vector<std::jthread> threads;
+        threads.reserve(queues.size() - 1);
+        for (unsigned ii = 1; ii < queues.size(); ++ii)
+            threads.emplace_back([this, ii] { work(ii); });
+        work(0);
+    }
+
+    /// The first error a worker hit, which stopped the walk.
+    std::optional<std::string> error() const {
+        if (!failure)
+            return std::nullopt;
+        try {
+            std::rethrow_exception(failure);
+        } catch (const std::exception &err) {
+            return err.what();
+        } catch (...) {
+            return "unknown error";
+        }
+    }
+
+    std::vector<stdfs::path> take() {
+        std::vector<stdfs::path> files;
+        for (auto &partial : results)
+            files.insert(files.end(), std::make_move_iterator(partial.begin()), std::make_move_iterator(partial.end()));
+        std::ranges::sort(files);
+        auto [first, last] = std::ranges::unique(files);
+        files.erase(first, last);
+        return files;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<DirTask> tasks;
+    };
+
+    std::optional<DirTask> popOwn(unsigned worker) {
+        std::lock_guard lock{queues[worker].mutex};
+        if (queues[worker].tasks.empty())
+            return std::nullopt;
+        DirTask task = std::move(queues[worker].tasks.back());
+        queues[worker].tasks.pop_back();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    std::optional<DirTask> steal(unsigned thief) {
+        for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+            auto &victim = queues[(thief + offset) % queues.size()];
+            std::lock_guard lock{victim.mutex};
+            if (!victim.tasks.empty()) {
+                // take the oldest (shallowest) directory: it is likely to fan out the most
+                DirTask task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Wake idle workers: one for a newly queued directory, all once the walk is over.
+    void wake(bool all) {
+        { std::lock_guard lock{idle_mutex}; } // a worker between its check and its wait must not miss this
+        if (all)
+            idle.notify_all();
+        else
+            idle.notify_one();
+    }
+
+    bool finished() const {
+        return pending.load(std::memory_order_acquire) == 0 || failed.load(std::memory_order_acquire);
+    }
+
+    void work(unsigned worker) {
+        while (!finished()) {
+            std::optional<DirTask> task = popOwn(worker);
+            if (!task)
+                task = steal(worker);
+            if (!task) {
+                // everything queued is taken; sleep until another worker queues more or the walk ends
+                std::unique_lock lock{idle_mutex};
+                idle.wait(lock, [this] { return finished() || queued.load(std::memory_order_acquire) != 0; });
+                continue;
+            }
+            try {
+                list(worker, *task);
+            } catch (...) {
+                // a callback or the filesystem threw; an exception must not escape a jthread
+                std::lock_guard lock{failure_mutex};
+                if (!failure)
+                    failure = std::current_exception();
+                failed.store(true, std::memory_order_release);
+                wake(true);
+            }
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                wake(true);
+        }
+    }
+
+    void list(unsigned worker, const DirTask &task) {
+        std::optional<std::vector<CachedChild>> children;
+        std::optional<DirStamp> stamp;
+        if (options.cache != nullptr && (stamp = ScanCache::stamp(task.path)))
+            children = options.cache->lookup(task.path, *stamp);
+        if (!children) {
+            children = readDir(task.path);
+            if (!children)
+                return;
+            if (stamp)
+                options.cache->record(task.path, *stamp, *children);
+        }
+
+        for (auto &child : *children) {
+            WalkEntry walk_entry{.root = task.root, .path = task.path / child.name, .name = std::move(child.name)};
+            if (child.kind == CachedChild::Kind::Dir) {
+                if (options.descend(walk_entry))
+                    push(worker, DirTask{.root = task.root, .path = std::move(walk_entry.path)});
+            } else if (options.keep(walk_entry)) {
+                results[worker].push_back(std::move(walk_entry.path));
+            }
+        }
+    }
+
+    /// Real subdirectories and regular files of `dir`; symlinked directories and special files are left out.
+    static std::optional<std::vector<CachedChild>> readDir(const stdfs::path &dir) {
+        std::error_code ec;
+        stdfs::directory_iterator it{dir, ec};
+        if (ec) {
+            catalyst::logger.log(LogLevel::WARN, "Skipping unreadable directory {}: {}", dir.string(), ec.message());
+            return std::nullopt;
+        }
+        std::vector<CachedChild> children;
+        // not a range-for: its increment throws when an entry cannot be read
+        for (const stdfs::directory_iterator end; it != end; it.increment(ec)) {
+            const auto &entry = *it;
+            std::error_code entry_ec; // an entry that vanished is just skipped
+            if (entry.is_directory(entry_ec) && !entry.is_symlink(entry_ec))
+                children.push_back(
+                    CachedChild{.name = entry.path().filename().string(), .kind = CachedChild::Kind::Dir});
+            else if (entry.is_regular_file(entry_ec))
+                children.push_back(
+                    CachedChild{.name = entry.path().filename().string(), .kind = CachedChild::Kind::File});
+        }
+        if (ec) {
+            // a partial listing must not be cached as the whole directory
+            catalyst::logger.log(LogLevel::WARN, "Skipping unreadable directory {}: {}", dir.string(), ec.message());
+            return std::nullopt;
+        }
+        return children;
+    }
+
+    const WalkOptions &options;
+    std::vector<Queue> queues;
+    std::vector<std::vector<stdfs::path>> results; // one per worker, merged in take()
+    std::atomic<std::size_t> pending{0}; ///< directories queued or being listed
+    std::atomic<std::size_t> queued{0};  ///< directories queued and not yet taken
+    std::mutex idle_mutex;
+    std::condition_variable idle;
+    std::atomic<bool> failed{false};
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+};
+} // namespace
+
+std::expected<std::vector<stdfs::path>, std::string> parallelWalk(const std::vector<stdfs::path> &roots,
+                                                                  const WalkOptions &options) {
+    unsigned num_threads = options.num_threads != 0 ? options.num_threads : std::thread::hardware_concurrency();
+    if (options.cache != nullptr)
+        options.cache->beginWalk(roots);
+    WorkStealingWalker walker{options, std::max(num_threads, 1U)};
+    for (std::size_t ii = 0; ii < roots.size(); ++ii)
+        walker.push(0, DirTask{.root = ii, .path = roots[ii]});
+    walker.run();
+    if (auto error = walker.error())
+        return std::unexpected(std::format("Failed to walk the source tree: {}", *error));
+    return walker.take();
+}
+} // namespace catalyst::utils::fs
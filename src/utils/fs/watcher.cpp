@@ -0,0 +1,300 @@
+#include "catalyst/utils/fs/watcher.hpp"
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/fs/file_stat.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::fs {
+namespace stdfs = std::filesystem;
+
+namespace {
+#if defined(__linux__)
+constexpr std::uint32_t watch_mask =
+    IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+/// Fold `event` into what is already known about its path within the current batch.
+void coalesce(std::unordered_map<std::string, WatchEvent> &pending, WatchEvent event) {
+    using Kind = WatchEvent::Kind;
+    auto [it, inserted] = pending.try_emplace(event.path.string(), event);
+    if (inserted)
+        return;
+    Kind before = it->second.kind;
+    if (before == Kind::Created && event.kind == Kind::Removed) {
+        pending.erase(it); // a temporary that came and went
+    } else if (before == Kind::Removed && event.kind == Kind::Created) {
+        it->second = std::move(event);
+        it->second.kind = Kind::Modified; // replaced, e.g. an editor's atomic save
+    } else if (before == Kind::Created && event.kind == Kind::Modified) {
+        return; // still new
+    } else {
+        it->second = std::move(event);
+    }
+}
+
+WatchBatch toBatch(std::unordered_map<std::string, WatchEvent> &pending, bool overflow) {
+    WatchBatch batch{.events = {}, .overflow = overflow};
+    batch.events.reserve(pending.size());
+    for (auto &[path, event] : pending)
+        batch.events.push_back(std::move(event));
+    std::ranges::sort(batch.events, {}, &WatchEvent::path);
+    return batch;
+}
+} // namespace
+
+Watcher &Watcher::operator=(Watcher &&other) noexcept {
+    if (this != &other) {
+#if defined(__linux__)
+        if (fd >= 0)
+            ::close(fd);
+#else
+        snapshot = std::move(other.snapshot);
+#endif
+        fd = std::exchange(other.fd, -1);
+        dirs = std::move(other.dirs);
+    }
+    return *this;
+}
+
+Watcher::Watcher(Watcher &&other) noexcept {
+    *this = std::move(other);
+}
+
+std::expected<void, std::string> Watcher::addTree(const stdfs::path &root) {
+    return add(root, true);
+}
+
+std::expected<void, std::string> Watcher::addDir(const stdfs::path &dir) {
+    return add(dir, false);
+}
+
+#if defined(__linux__)
+std::expected<Watcher, std::string> Watcher::create() {
+    int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return std::unexpected(std::format("Failed to initialize inotify: {}", std::strerror(errno)));
+    return Watcher{fd};
+}
+
+Watcher::~Watcher() {
+    if (fd >= 0)
+        ::close(fd);
+}
+
+std::expected<void, std::string> Watcher::add(const stdfs::path &dir, bool recursive) {
+    int wd = ::inotify_add_watch(fd, dir.c_str(), watch_mask);
+    if (wd < 0) {
+        if (errno == ENOSPC)
+            return std::unexpected(std::format("Failed to watch {}: inotify watch limit reached "
+                                               "(raise fs.inotify.max_user_watches)",
+                                               dir.string()));
+        return std::unexpected(std::format("Failed to watch {}: {}", dir.string(), std::strerror(errno)));
+    }
+    dirs[wd] = WatchedDir{.path = dir, .recursive = recursive};
+    if (!recursive)
+        return {};
+
+    std::error_code ec;
+    for (const auto &entry : stdfs::directory_iterator{dir, ec}) {
+        if (entry.is_directory(ec) && !entry.is_symlink(ec)) {
+            if (auto res = add(entry.path(), true); !res)
+                return res;
+        }
+    }
+    if (ec)
+        catalyst::logger.log(LogLevel::WARN, "Failed to list {} for watching: {}", dir.string(), ec.message());
+    return {};
+}
+
+void Watcher::drain(std::unordered_map<std::string, WatchEvent> &pending, bool &overflow) {
+    alignas(inotify_event) char buffer[64 * 1024];
+    while (true) {
+        ssize_t len = ::read(fd, buffer, sizeof(buffer));
+        if (len <= 0)
+            return; // EAGAIN: nothing left to read
+
+        for (ssize_t offset = 0; offset < len;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+            auto dir_it = dirs.find(event->wd);
+            if (dir_it == dirs.end())
+                continue;
+            if (event->mask & IN_IGNORED) {
+                dirs.erase(dir_it); // the directory itself is gone
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF) || event->len == 0)
+                continue; // reported through the parent as well
+
+            WatchEvent watch_event{.path = dir_it->second.path / event->name,
+                                   .kind = WatchEvent::Kind::Modified,
+                                   .is_dir = (event->mask & IN_ISDIR) != 0};
+            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                watch_event.kind = WatchEvent::Kind::Created;
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                watch_event.kind = WatchEvent::Kind::Removed;
+
+            if (watch_event.is_dir && watch_event.kind == WatchEvent::Kind::Created && dir_it->second.recursive) {
+                // files may have landed in the new directory before its watch existed, so report them here
+                if (auto res = add(watch_event.path, true); !res)
+                    catalyst::logger.log(LogLevel::WARN, "{}", res.error());
+                std::error_code ec;
+                for (const auto &entry : stdfs::recursive_directory_iterator{watch_event.path, ec}) {
+                    if (entry.is_regular_file(ec))
+                        coalesce(pending, WatchEvent{.path = entry.path(), .kind = WatchEvent::Kind::Created});
+                }
+            }
+            coalesce(pending, std::move(watch_event));
+        }
+    }
+}
+
+std::expected<WatchBatch, std::string> Watcher::wait(std::chrono::milliseconds quiet,
+                                                     std::chrono::milliseconds max_delay) {
+    using Clock = std::chrono::steady_clock;
+    std::unordered_map<std::string, WatchEvent> pending;
+    bool overflow = false;
+
+    pollfd poll_fd{.fd = fd, .events = POLLIN, .revents = 0};
+    std::optional<Clock::time_point> deadline;
+    while (true) {
+        int timeout = -1;
+        if (deadline) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - Clock::now());
+            timeout = static_cast<int>(std::clamp(left, std::chrono::milliseconds{0}, quiet).count());
+        }
+        int ready = ::poll(&poll_fd, 1, timeout);
+        if (ready < 0) {
+            if (errno == EINTR)
+                continue;
+            return std::unexpected(std::format("Failed to wait for file changes: {}", std::strerror(errno)));
+        }
+        if (ready == 0) {
+            if (!pending.empty() || overflow)
+                break; // quiet long enough, or the batch is due
+            deadline.reset(); // everything so far cancelled out; wait for the next change
+            continue;
+        }
+        drain(pending, overflow);
+        if (!deadline && (!pending.empty() || overflow))
+            deadline = Clock::now() + max_delay;
+        else if (deadline && Clock::now() >= *deadline)
+            break; // changes keep streaming in; report what we have
+    }
+
+    return toBatch(pending, overflow);
+}
+#else
+// no inotify: compare the watched entries' mtimes every `quiet`, which also serves as the debounce
+
+std::expected<Watcher, std::string> Watcher::create() {
+    return Watcher{-1};
+}
+
+Watcher::~Watcher() = default;
+
+std::expected<void, std::string> Watcher::add(const stdfs::path &dir, bool recursive) {
+    std::error_code ec;
+    if (!stdfs::is_directory(dir, ec))
+        return std::unexpected(std::format("Failed to watch {}: not a directory", dir.string()));
+    dirs[static_cast<int>(dirs.size())] = WatchedDir{.path = dir, .recursive = recursive};
+    snapshot = scan();
+    return {};
+}
+
+Watcher::Snapshot Watcher::scan() const {
+    Snapshot entries;
+    auto record = [&](const stdfs::directory_entry &entry) {
+        std::error_code ec;
+        const bool is_dir = entry.is_directory(ec) && !entry.is_symlink(ec);
+        const auto st = fileStat(entry.path());
+        if (st)
+            entries.insert_or_assign(entry.path().string(),
+                                     Stamp{.mtime_ns = st->mtime_ns, .size = st->size, .is_dir = is_dir});
+    };
+    for (const auto &[id, dir] : dirs) {
+        std::error_code ec;
+        if (dir.recursive) {
+            for (stdfs::recursive_directory_iterator it{dir.path, ec}, end; !ec && it != end; it.increment(ec))
+                record(*it);
+        } else {
+            for (stdfs::directory_iterator it{dir.path, ec}, end; !ec && it != end; it.increment(ec))
+                record(*it);
+        }
+        if (ec)
+            catalyst::logger.log(
+                LogLevel::DEBUG, "Failed to list {} for watching: {}", dir.path.string(), ec.message());
+    }
+    return entries;
+}
+
+bool Watcher::poll(std::unordered_map<std::string, WatchEvent> &pending) {
+    Snapshot now = scan();
+    bool changed = false;
+    for (const auto &[path, stamp] : now) {
+        auto it = snapshot.find(path);
+        if (it == snapshot.end()) {
+            coalesce(pending, WatchEvent{.path = path, .kind = WatchEvent::Kind::Created, .is_dir = stamp.is_dir});
+            changed = true;
+        } else if (!stamp.is_dir && (it->second.mtime_ns != stamp.mtime_ns || it->second.size != stamp.size)) {
+            coalesce(pending, WatchEvent{.path = path, .kind = WatchEvent::Kind::Modified, .is_dir = false});
+            changed = true;
+        }
+    }
+    for (const auto &[path, stamp] : snapshot) {
+        if (!now.contains(path)) {
+            coalesce(pending, WatchEvent{.path = path, .kind = WatchEvent::Kind::Removed, .is_dir = stamp.is_dir});
+            changed = true;
+        }
+    }
+    snapshot = std::move(now);
+    return changed;
+}
+
+std::expected<WatchBatch, std::string> Watcher::wait(std::chrono::milliseconds quiet,
+                                                     std::chrono::milliseconds max_delay) {
+    using Clock = std::chrono::steady_clock;
+    std::unordered_map<std::string, WatchEvent> pending;
+    std::optional<Clock::time_point> deadline;
+    while (true) {
+        std::this_thread::sleep_for(quiet);
+        if (poll(pending)) {
+            if (!deadline)
+                deadline = Clock::now() + max_delay;
+            else if (Clock::now() >= *deadline)
+                break; // changes keep streaming in; report what we have
+        } else if (!pending.empty()) {
+            break; // quiet for a whole interval
+        } else {
+            deadline.reset(); // everything so far cancelled out; wait for the next change
+        }
+    }
+    return toBatch(pending, false);
+}
+#endif
+} // namespace catalyst::utils::fs
@@ -0,0 +1,40 @@
+#include "catalyst/utils/fs/write_if_changed.hpp"
+
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace catalyst::utils::fs {
+namespace stdfs = std::filesystem;
+
+std::expected<bool, std::string> writeIfChanged(const stdfs::path &path, std::string_view content) {
+    std::error_code ec;
+    if (auto size = stdfs::file_size(path, ec); !ec && size == content.size()) {
+        std::ifstream existing{path, std::ios::binary};
+        std::string current{std::istreambuf_iterator<char>{existing}, std::istreambuf_iterator<char>{}};
+        if (existing && current == content)
+            return false;
+    }
+
+    // write to a sibling and rename so a concurrent reader never observes a half-written file
+    stdfs::path tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream out{tmp_path, std::ios::binary | std::ios::trunc};
+        if (!out)
+            return std::unexpected(std::format("Failed to open {} for writing", tmp_path.string()));
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if (!out)
+            return std::unexpected(std::format("Failed to write {}", tmp_path.string()));
+    }
+    stdfs::rename(tmp_path, path, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to replace {}: {}", path.string(), ec.message()));
+    return true;
+}
+} // namespace catalyst::utils::fs
@@ -0,0 +1,159 @@
+#include "catalyst/utils/hash/hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace catalyst::utils::hash {
+namespace {
+constexpr std::array<std::uint32_t, 64> sha256_rounds{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr std::uint32_t rotr(std::uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+/// Read `path` in chunks, handing each to `update`. False if it cannot be opened.
+template <typename Update> bool readChunks(const std::filesystem::path &path, Update &&update) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+        return false;
+
+    constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+    std::string buffer(CHUNK_SIZE, '\0');
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        update(std::string_view{buffer.data(), static_cast<std::size_t>(file.gcount())});
+    }
+    return true;
+}
+} // namespace
+
+void Fnv1a::mix(const unsigned char *data, std::size_t size) {
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        state ^= data[ii];
+        state *= PRIME;
+    }
+}
+
+Fnv1a &Fnv1a::update(std::string_view data) {
+    // length prefix keeps ("ab", "c") and ("a", "bc") from colliding
+    update(static_cast<std::uint64_t>(data.size()));
+    mix(reinterpret_cast<const unsigned char *>(data.data()), data.size());
+    return *this;
+}
+
+Fnv1a &Fnv1a::update(std::uint64_t value) {
+    std::array<unsigned char, sizeof(value)> bytes{};
+    for (std::size_t ii = 0; ii < bytes.size(); ++ii)
+        bytes[ii] = static_cast<unsigned char>(value >> (ii * 8));
+    mix(bytes.data(), bytes.size());
+    return *this;
+}
+
+std::string Fnv1a::hexDigest() const {
+    return toHex(state);
+}
+
+std::string toHex(std::uint64_t value) {
+    return std::format("{:016x}", value);
+}
+
+Sha256 &Sha256::update(std::string_view data) {
+    length += data.size();
+    const auto *bytes = reinterpret_cast<const unsigned char *>(data.data());
+    std::size_t size = data.size();
+    if (buffered != 0) {
+        std::size_t take = std::min(size, buffer.size() - buffered);
+        std::copy_n(bytes, take, buffer.begin() + static_cast<std::ptrdiff_t>(buffered));
+        buffered += take;
+        bytes += take;
+        size -= take;
+        if (buffered < buffer.size())
+            return *this;
+        compress(buffer.data());
+        buffered = 0;
+    }
+    for (; size >= buffer.size(); bytes += buffer.size(), size -= buffer.size())
+        compress(bytes);
+    std::copy_n(bytes, size, buffer.begin());
+    buffered = size;
+    return *this;
+}
+
+std::string Sha256::hexDigest() const {
+    Sha256 last = *this;
+    const std::uint64_t bits = length * 8;
+    const unsigned char pad = 0x80;
+    last.update(std::string_view{reinterpret_cast<const char *>(&pad), 1});
+    const std::array<char, 64> zeros{};
+    std::size_t fill = (last.buffered <= 56 ? 56 : 120) - last.buffered;
+    last.update(std::string_view{zeros.data(), fill});
+    std::array<char, 8> size{};
+    for (std::size_t ii = 0; ii < size.size(); ++ii)
+        size[ii] = static_cast<char>(bits >> (56 - 8 * ii));
+    last.update(std::string_view{size.data(), size.size()});
+
+    std::string hex;
+    for (std::uint32_t word : last.state)
+        hex += std::format("{:08x}", word);
+    return hex;
+}
+
+void Sha256::compress(const unsigned char *block) {
+    std::array<std::uint32_t, 64> words{};
+    for (std::size_t ii = 0; ii < 16; ++ii) {
+        for (std::size_t byte = 0; byte < 4; ++byte)
+            words[ii] = words[ii] << 8 | block[ii * 4 + byte];
+    }
+    for (std::size_t ii = 16; ii < 64; ++ii) {
+        std::uint32_t s0 = rotr(words[ii - 15], 7) ^ rotr(words[ii - 15], 18) ^ (words[ii - 15] >> 3);
+        std::uint32_t s1 = rotr(words[ii - 2], 17) ^ rotr(words[ii - 2], 19) ^ (words[ii - 2] >> 10);
+        words[ii] = words[ii - 16] + s0 + words[ii - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state;
+    for (std::size_t ii = 0; ii < 64; ++ii) {
+        std::uint32_t t1 =
+            h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256_rounds[ii] + words[ii];
+        std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state = {state[0] + a, state[1] + b, state[2] + c, state[3] + d,
+             state[4] + e, state[5] + f, state[6] + g, state[7] + h};
+}
+
+std::optional<std::uint64_t> hashFile(const std::filesystem::path &path) {
+    Fnv1a hasher;
+    if (!readChunks(path, [&](std::string_view chunk) { hasher.update(chunk); }))
+        return std::nullopt;
+    return hasher.digest();
+}
+
+std::optional<std::string> sha256File(const std::filesystem::path &path) {
+    Sha256 hasher;
+    if (!readChunks(path, [&](std::string_view chunk) { hasher.update(chunk); }))
+        return std::nullopt;
+    return hasher.hexDigest();
+}
+} // namespace catalyst::utils::hash
@@ -0,0 +1,342 @@
+#include "catalyst/utils/ignore/ignore_set.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace catalyst::utils::ignore {
+
+namespace {
+constexpr std::string_view GLOB_PREFIX = "glob:";
+constexpr std::string_view REGEX_PREFIX = "re:";
+} // namespace
+
+std::expected<IgnoreSet, std::string> IgnoreSet::compile(const std::vector<std::string> &patterns) {
+    IgnoreSet set;
+
+    auto push = [](std::vector<Token> &program, TokenKind kind, char ch = 0, std::uint32_t arg = 0) {
+        program.push_back(Token{.kind = kind, .ch = ch, .arg = arg});
+    };
+
+    // Translate the subset of ECMAScript regex made of literals, escapes, '.', '.*' and '.+'.
+    auto simple_regex = [&](std::string_view re) -> std::optional<std::vector<Token>> {
+        std::vector<Token> program;
+        std::size_t begin = re.starts_with('^') ? 1 : 0;
+        std::size_t end = re.size();
+        if (end > begin && re[end - 1] == '$' && (end < 2 || re[end - 2] != '\\'))
+            --end;
+        for (std::size_t ii = begin; ii < end; ++ii) {
+            char c = re[ii];
+            if (c == '\\') {
+                if (ii + 1 >= end || std::isalnum(static_cast<unsigned char>(re[ii + 1])))
+                    return std::nullopt; // \d, \w, backreferences, ...
+                push(program, TokenKind::Char, re[++ii]);
+            } else if (c == '.') {
+                if (ii + 1 < end && (re[ii + 1] == '*' || re[ii + 1] == '+')) {
+                    if (re[++ii] == '+')
+                        push(program, TokenKind::Any);
+                    push(program, TokenKind::Star);
+                    if (ii + 1 < end && re[ii + 1] == '?')
+                        ++ii; // laziness is irrelevant for a full match
+                } else {
+                    push(program, TokenKind::Any);
+                }
+            } else if (std::string_view{"[](){}|+?*^$"}.find(c) != std::string_view::npos) {
+                return std::nullopt;
+            } else {
+                push(program, TokenKind::Char, c);
+            }
+        }
+        return program;
+    };
+
+    auto glob = [&](std::string_view pattern) {
+        std::vector<Token> program;
+        for (std::size_t ii = 0; ii < pattern.size(); ++ii) {
+            char c = pattern[ii];
+            if (c == '*') {
+                bool double_star = ii + 1 < pattern.size() && pattern[ii + 1] == '*';
+                bool at_segment_start = ii == 0 || pattern[ii - 1] == '/';
+                if (double_star && at_segment_start && ii + 2 < pattern.size() && pattern[ii + 2] == '/') {
+                    push(program, TokenKind::DirsEntry); // "**/": zero or more directories
+                    push(program, TokenKind::DirsInner);
+                    ii += 2;
+                } else if (double_star && at_segment_start && ii + 2 == pattern.size()) {
+                    push(program, TokenKind::Any); // trailing "/**": everything inside
+                    push(program, TokenKind::Star);
+                    ++ii;
+                } else {
+                    push(program, TokenKind::StarNoSlash);
+                    if (double_star)
+                        ++ii;
+                }
+            } else if (c == '?') {
+                push(program, TokenKind::AnyNoSlash);
+            } else if (c == '[' && pattern.find(']', ii + 2) != std::string_view::npos) {
+                std::bitset<256> cls;
+                std::size_t jj = ii + 1;
+                bool negate = pattern[jj] == '!' || pattern[jj] == '^';
+                if (negate)
+                    ++jj;
+                for (bool first = true; jj < pattern.size() && (first || pattern[jj] != ']'); ++jj, first = false) {
+                    auto lo = static_cast<unsigned char>(pattern[jj]);
+                    auto hi = lo;
+                    if (jj + 2 < pattern.size() && pattern[jj + 1] == '-' && pattern[jj + 2] != ']') {
+                        hi = static_cast<unsigned char>(pattern[jj + 2]);
+                        jj += 2;
+                    }
+                    for (unsigned ch = lo; ch <= hi; ++ch)
+                        cls.set(ch);
+                }
+                if (negate)
+                    cls.flip();
+                cls.reset('/');
+                set.classes.push_back(cls);
+                push(program, TokenKind::Class, 0, static_cast<std::uint32_t>(set.classes.size() - 1));
+                ii = jj;
+            } else if (c == '\\' && ii + 1 < pattern.size()) {
+                push(program, TokenKind::Char, pattern[++ii]);
+            } else {
+                push(program, TokenKind::Char, c);
+            }
+        }
+        return program;
+    };
+
+    for (const auto &pattern : patterns) {
+        std::size_t index = set.rules.size();
+        std::string_view body = pattern;
+        Rule rule;
+
+        if (body.starts_with(GLOB_PREFIX)) {
+            body.remove_prefix(GLOB_PREFIX.size());
+            if (body.starts_with('!')) {
+                rule.negate = true;
+                set.has_negation = true;
+                body.remove_prefix(1);
+            }
+            if (body.ends_with('/')) {
+                rule.dir_only = true;
+                body.remove_suffix(1);
+            }
+            if (body.empty())
+                return std::unexpected(std::format("Invalid ignore pattern '{}': empty glob", pattern));
+            set.rules.push_back(rule);
+
+            if (body.find('/') == std::string_view::npos) {
+                set.addProgram(set.by_name, glob(body), index);
+            } else {
+                // anchored: matched against "/<path relative to the ignore file>"
+                if (body.starts_with('/'))
+                    body.remove_prefix(1);
+                set.addProgram(set.by_path, glob("/" + std::string{body}), index);
+            }
+            continue;
+        }
+
+        if (body.starts_with(REGEX_PREFIX))
+            body.remove_prefix(REGEX_PREFIX.size());
+        rule.files_only = true;
+        set.rules.push_back(rule);
+        if (auto program = simple_regex(body)) {
+            set.addProgram(set.by_name, std::move(*program), index);
+            continue;
+        }
+        try {
+            set.by_name.regexes.emplace_back(std::regex{std::string{body}}, index);
+        } catch (const std::regex_error &err) {
+            return std::unexpected(std::format("Invalid ignore pattern '{}': {}", pattern, err.what()));
+        }
+    }
+    return set;
+}
+
+void IgnoreSet::addProgram(Target &target, std::vector<Token> program, std::size_t rule) {
+    auto is_star = [](const Token &t) { return t.kind == TokenKind::Star || t.kind == TokenKind::StarNoSlash; };
+    auto literal = [](auto first, auto last) -> std::optional<std::string> {
+        std::string text;
+        for (; first != last; ++first) {
+            if (first->kind != TokenKind::Char)
+                return std::nullopt;
+            text.push_back(first->ch);
+        }
+        return text;
+    };
+
+    if (auto text = literal(program.begin(), program.end())) {
+        target.exact[*text].push_back(rule);
+        return;
+    }
+    // a name never contains '/', so both star kinds are equivalent there and affixes are exact
+    if (&target == &by_name && !program.empty()) {
+        if (is_star(program.front())) {
+            if (auto text = literal(program.begin() + 1, program.end())) {
+                target.suffixes.emplace_back(std::move(*text), rule);
+                return;
+            }
+        }
+        if (is_star(program.back())) {
+            if (auto text = literal(program.begin(), program.end() - 1)) {
+                target.prefixes.emplace_back(std::move(*text), rule);
+                return;
+            }
+        }
+    }
+
+    target.starts.push_back(static_cast<std::uint32_t>(target.nfa.size()));
+    target.nfa.insert(target.nfa.end(), program.begin(), program.end());
+    target.nfa.push_back(Token{.kind = TokenKind::Accept, .arg = static_cast<std::uint32_t>(rule)});
+}
+
+bool IgnoreSet::consider(std::size_t rule, bool is_dir, std::size_t &best, bool &hit) const {
+    if (rules[rule].dir_only ? !is_dir : rules[rule].files_only && is_dir)
+        return false;
+    if (!has_negation) {
+        hit = true;
+        return true;
+    }
+    best = std::max(best, rule + 1);
+    return false;
+}
+
+void IgnoreSet::runNfa(const Target &target, std::string_view subject, bool is_dir, std::size_t &best, bool &hit)
+    const {
+    if (target.starts.empty())
+        return;
+
+    // scratch space reused across calls; matching is called concurrently from the directory walker
+    thread_local std::vector<std::uint32_t> marks;
+    thread_local std::vector<std::uint32_t> current;
+    thread_local std::vector<std::uint32_t> next;
+    thread_local std::uint32_t generation = 0;
+    if (marks.size() < target.nfa.size()) {
+        marks.assign(target.nfa.size(), 0);
+        generation = 0;
+    }
+
+    const auto &nfa = target.nfa;
+    auto add = [&](std::vector<std::uint32_t> &states, std::uint32_t state) {
+        while (marks[state] != generation) {
+            marks[state] = generation;
+            states.push_back(state);
+            TokenKind kind = nfa[state].kind;
+            if (kind == TokenKind::Star || kind == TokenKind::StarNoSlash)
+                state += 1; // may match nothing
+            else if (kind == TokenKind::DirsEntry)
+                state += 2; // may match no directory at all
+            else
+                break;
+        }
+    };
+
+    current.clear();
+    ++generation;
+    for (std::uint32_t start : target.starts)
+        add(current, start);
+
+    for (char c : subject) {
+        next.clear();
+        ++generation;
+        for (std::uint32_t state : current) {
+            const Token &token = nfa[state];
+            switch (token.kind) {
+                case TokenKind::Char:
+                    if (c == token.ch)
+                        add(next, state + 1);
+                    break;
+                case TokenKind::Any:
+                    add(next, state + 1);
+                    break;
+                case TokenKind::AnyNoSlash:
+                    if (c != '/')
+                        add(next, state + 1);
+                    break;
+                case TokenKind::Class:
+                    if (classes[token.arg].test(static_cast<unsigned char>(c)))
+                        add(next, state + 1);
+                    break;
+                case TokenKind::Star:
+                    add(next, state);
+                    break;
+                case TokenKind::StarNoSlash:
+                    if (c != '/')
+                        add(next, state);
+                    break;
+                case TokenKind::DirsEntry:
+                case TokenKind::DirsInner: {
+                    std::uint32_t inner = token.kind == TokenKind::DirsEntry ? state + 1 : state;
+                    add(next, inner);
+                    if (c == '/')
+                        add(next, inner + 1);
+                    break;
+                }
+                case TokenKind::Accept:
+                    break;
+            }
+        }
+        std::swap(current, next);
+        if (current.empty())
+            return;
+    }
+
+    for (std::uint32_t state : current) {
+        if (nfa[state].kind == TokenKind::Accept && consider(nfa[state].arg, is_dir, best, hit))
+            return;
+    }
+}
+
+void IgnoreSet::collect(const Target &target, std::string_view subject, bool is_dir, std::size_t &best, bool &hit)
+    const {
+    if (!target.exact.empty()) {
+        if (auto it = target.exact.find(subject); it != target.exact.end()) {
+            for (std::size_t rule : it->second) {
+                if (consider(rule, is_dir, best, hit))
+                    return;
+            }
+        }
+    }
+    for (const auto &[prefix, rule] : target.prefixes) {
+        if (subject.starts_with(prefix) && consider(rule, is_dir, best, hit))
+            return;
+    }
+    for (const auto &[suffix, rule] : target.suffixes) {
+        if (subject.ends_with(suffix) && consider(rule, is_dir, best, hit))
+            return;
+    }
+    runNfa(target, subject, is_dir, best, hit);
+    if (hit)
+        return;
+    for (const auto &[regex, rule] : target.regexes) {
+        if (std::regex_match(subject.begin(), subject.end(), regex) && consider(rule, is_dir, best, hit))
+            return;
+    }
+}
+
+bool IgnoreSet::matches(std::string_view rel_path, bool is_dir) const {
+    if (rules.empty())
+        return false;
+
+    std::string_view name = rel_path.substr(rel_path.find_last_of('/') + 1);
+    std::size_t best = 0; // 1 + index of the last matching rule, 0 if none
+    bool hit = false;
+
+    collect(by_name, name, is_dir, best, hit);
+    if (hit)
+        return true;
+    if (!by_path.exact.empty() || !by_path.starts.empty()) {
+        collect(by_path, "/" + std::string{rel_path}, is_dir, best, hit);
+        if (hit)
+            return true;
+    }
+    return best != 0 && !rules[best - 1].negate;
+}
+} // namespace catalyst::utils::ignore
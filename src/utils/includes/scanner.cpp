@@ -0,0 +1,692 @@
+#include "catalyst/utils/includes/scanner.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "catalyst/utils/fs/file_stat.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::includes {
+namespace fs = std::filesystem;
+
+namespace {
+bool isIdentChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isHorizontalSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+class Lexer {
+public:
+    explicit Lexer(std::string_view source) : src(source) {
+    }
+
+    Lexer &run() {
+        bool line_start = true;
+        while (pos < src.size()) {
+            char c = src[pos];
+            if (c == '\n') {
+                line_start = true;
+                ++pos;
+            } else if (skipContinuation() || isHorizontalSpace(c) || skipComment()) {
+                // whitespace and comments keep us at the start of the line
+                if (isHorizontalSpace(c))
+                    ++pos;
+            } else if (line_start && c == '#') {
+                ++pos;
+                directive();
+                line_start = false;
+            } else if (line_start && isIdentChar(c) && moduleDirective()) {
+                line_start = false;
+            } else {
+                line_start = false;
+                token();
+            }
+        }
+        return *this;
+    }
+
+    std::vector<Directive> directives;
+    ModuleInfo module;
+
+private:
+    /// One `#if`, `#ifdef` or `#ifndef` group that is still open.
+    struct Group {
+        bool guard = false; ///< the include guard: the file's first directive, an `#ifndef` followed by `#define`
+    };
+    char peek(std::size_t offset = 0) const {
+        return pos + offset < src.size() ? src[pos + offset] : '\0';
+    }
+
+    /// A backslash-newline splices two physical lines into one logical line.
+    bool skipContinuation() {
+        if (peek() != '\\')
+            return false;
+        if (peek(1) == '\n') {
+            pos += 2;
+            return true;
+        }
+        if (peek(1) == '\r' && peek(2) == '\n') {
+            pos += 3;
+            return true;
+        }
+        return false;
+    }
+
+    bool skipComment() {
+        if (peek() != '/')
+            return false;
+        if (peek(1) == '/') {
+            while (pos < src.size() && src[pos] != '\n') {
+                if (!skipContinuation())
+                    ++pos;
+            }
+            return true;
+        }
+        if (peek(1) == '*') {
+            std::size_t end = src.find("*/", pos + 2);
+            pos = end == std::string_view::npos ? src.size() : end + 2;
+            return true;
+        }
+        return false;
+    }
+
+    void skipHorizontal() {
+        while (pos < src.size()) {
+            if (isHorizontalSpace(src[pos]))
+                ++pos;
+            else if (!skipContinuation() && !(peek() == '/' && peek(1) == '*' && skipComment()))
+                return;
+        }
+    }
+
+    std::string_view identifier() {
+        std::size_t start = pos;
+        while (pos < src.size() && isIdentChar(src[pos]))
+            ++pos;
+        return src.substr(start, pos - start);
+    }
+
+    void directive() {
+        skipHorizontal();
+        std::string_view name = identifier();
+        const bool first = directive_count == 0;
+        if (name != "pragma") // `#pragma once` may precede a guard
+            ++directive_count;
+        if (guard_pending) {
+            guard_pending = false;
+            if (name != "define") {
+                groups.back().guard = false;
+                ++conditional_depth;
+            }
+        }
+        if (name == "if" || name == "ifdef" || name == "ifndef") {
+            groups.push_back(Group{.guard = first && name == "ifndef"});
+            guard_pending = groups.back().guard;
+            conditional_depth += groups.back().guard ? 0 : 1;
+            return;
+        }
+        if (name == "endif") {
+            if (!groups.empty()) {
+                conditional_depth -= groups.back().guard ? 0 : 1;
+                groups.pop_back();
+            }
+            return;
+        }
+        if (name != "include" && name != "include_next" && name != "import")
+            return; // the rest of the line is lexed as ordinary tokens
+        skipHorizontal();
+
+        headerName(); // otherwise a computed include
+    }
+
+    /// `<...>` or `"..."` at the current position, recorded as a directive.
+    bool headerName() {
+        char open = peek();
+        char close = open == '<' ? '>' : open == '"' ? '"' : '\0';
+        if (close == '\0')
+            return false;
+        std::size_t end = src.find_first_of(std::string_view{close == '>' ? ">\n" : "\"\n"}, pos + 1);
+        if (end == std::string_view::npos || src[end] != close)
+            return false;
+        directives.push_back(Directive{.spelling = std::string{src.substr(pos + 1, end - pos - 1)},
+                                       .angled = open == '<',
+                                       .conditional = conditional_depth > 0});
+        pos = end + 1;
+        return true;
+    }
+
+    /// `[export] module name[:partition];` or `[export] import name|:partition|header-name;` at the start of a
+    /// line. Anything else is left for token() to lex, so `import(x)` in ordinary code is not mistaken for one.
+    bool moduleDirective() {
+        const std::size_t start = pos;
+        std::string_view keyword = identifier();
+        bool exported = false;
+        if (keyword == "export") {
+            exported = true;
+            skipHorizontal();
+            keyword = identifier();
+        }
+        if (keyword != "module" && keyword != "import") {
+            pos = start;
+            return false;
+        }
+        skipHorizontal();
+        if (keyword == "import" && headerName())
+            return true; // a header unit depends on its header like an #include does
+
+        std::size_t name_start = pos;
+        while (pos < src.size() && (isIdentChar(src[pos]) || src[pos] == '.' || src[pos] == ':'))
+            ++pos;
+        std::string name{src.substr(name_start, pos - name_start)};
+        skipHorizontal();
+        if (peek() != ';') {
+            pos = start;
+            return false;
+        }
+        ++pos;
+
+        if (keyword == "module") {
+            if (name.empty() || name == ":private")
+                return true; // global or private module fragment
+            module.name = name;
+            module.exported = exported;
+            if (!exported && name.find(':') == std::string::npos)
+                module.imports.push_back(name); // an implementation unit implicitly imports its interface
+        } else if (!name.empty()) {
+            if (name.front() == ':')
+                name = module.name.substr(0, module.name.find(':')) + name;
+            module.imports.push_back(std::move(name));
+        }
+        return true;
+    }
+
+    void token() {
+        char c = src[pos];
+        if (isDigit(c) || (c == '.' && isDigit(peek(1)))) {
+            // pp-number, so that digit separators (1'000) are not taken for character literals
+            ++pos;
+            while (pos < src.size()) {
+                char n = src[pos];
+                char prev = src[pos - 1];
+                if (isIdentChar(n) || n == '.' || (n == '\'' && isIdentChar(peek(1))) ||
+                    ((n == '+' || n == '-') && (prev == 'e' || prev == 'E' || prev == 'p' || prev == 'P')))
+                    ++pos;
+                else
+                    break;
+            }
+        } else if (isIdentChar(c)) {
+            std::string_view ident = identifier();
+            if (peek() == '"' && (ident == "R" || ident == "u8R" || ident == "uR" || ident == "UR" || ident == "LR"))
+                rawString();
+        } else if (c == '"' || c == '\'') {
+            quoted(c);
+        } else {
+            ++pos;
+        }
+    }
+
+    void quoted(char quote) {
+        ++pos;
+        while (pos < src.size() && src[pos] != quote && src[pos] != '\n') {
+            if (src[pos] == '\\')
+                ++pos;
+            ++pos;
+        }
+        if (pos < src.size() && src[pos] == quote)
+            ++pos;
+    }
+
+    void rawString() {
+        std::size_t open = src.find('(', pos + 1);
+        if (open == std::string_view::npos || open - pos - 1 > 16) {
+            ++pos; // not a valid raw string; treat the quote as an ordinary character
+            return;
+        }
+        std::string terminator = ")" + std::string{src.substr(pos + 1, open - pos - 1)} + "\"";
+        std::size_t end = src.find(terminator, open + 1);
+        pos = end == std::string_view::npos ? src.size() : end + terminator.size();
+    }
+
+    std::string_view src;
+    std::size_t pos = 0;
+    std::vector<Group> groups;
+    std::size_t conditional_depth = 0; ///< open groups other than the include guard
+    std::size_t directive_count = 0;
+    bool guard_pending = false; ///< the last directive opened a group that may be the include guard
+};
+
+struct FileStamp {
+    std::int64_t mtime_ns = 0;
+    std::int64_t size = -1;
+
+    bool operator==(const FileStamp &) const = default;
+};
+
+std::optional<FileStamp> statFile(const fs::path &path) {
+    const auto st = utils::fs::fileStat(path);
+    if (!st || !st->regular)
+        return std::nullopt;
+    return FileStamp{.mtime_ns = st->mtime_ns, .size = st->size};
+}
+
+struct CacheEntry {
+    FileStamp stamp;
+    std::uint64_t hash = 0;
+    std::vector<Directive> directives;
+    ModuleInfo module;
+};
+
+using DirectiveCache = std::unordered_map<std::string, CacheEntry>;
+
+constexpr int cache_version = 3;
+
+DirectiveCache loadCache(const fs::path &cache_file) {
+    DirectiveCache cache;
+    std::ifstream file{cache_file};
+    if (!file)
+        return cache;
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (json.value("version", 0) != cache_version)
+            return cache;
+        for (const auto &[path, entry] : json.at("files").items()) {
+            CacheEntry cached{.stamp = {.mtime_ns = entry.at("mtime").get<std::int64_t>(),
+                                        .size = entry.at("size").get<std::int64_t>()},
+                              .hash = entry.at("hash").get<std::uint64_t>(),
+                              .directives = {},
+                              .module = {}};
+            for (const auto &directive : entry.at("includes"))
+                cached.directives.push_back(Directive{.spelling = directive.at(0).get<std::string>(),
+                                                      .angled = directive.at(1).get<bool>(),
+                                                      .conditional = directive.at(2).get<bool>()});
+            if (auto module = entry.find("module"); module != entry.end()) {
+                cached.module.name = module->at("name").get<std::string>();
+                cached.module.exported = module->at("exported").get<bool>();
+                cached.module.imports = module->at("imports").get<std::vector<std::string>>();
+            }
+            cache.emplace(path, std::move(cached));
+        }
+    } catch (const nlohmann::json::exception &err) {
+        catalyst::logger.log(
+            LogLevel::DEBUG, "Ignoring unreadable include cache {}: {}", cache_file.string(), err.what());
+        cache.clear();
+    }
+    return cache;
+}
+
+void saveCache(const fs::path &cache_file, const DirectiveCache &cache) {
+    nlohmann::json files = nlohmann::json::object();
+    for (const auto &[path, entry] : cache) {
+        nlohmann::json includes = nlohmann::json::array();
+        for (const auto &directive : entry.directives)
+            includes.push_back({directive.spelling, directive.angled, directive.conditional});
+        files[path] = {{"mtime", entry.stamp.mtime_ns},
+                       {"size", entry.stamp.size},
+                       {"hash", entry.hash},
+                       {"includes", std::move(includes)}};
+        if (!entry.module.empty())
+            files[path]["module"] = {{"name", entry.module.name},
+                                     {"exported", entry.module.exported},
+                                     {"imports", entry.module.imports}};
+    }
+    nlohmann::json json = {{"version", cache_version}, {"files", std::move(files)}};
+
+    std::error_code ec;
+    fs::create_directories(cache_file.parent_path(), ec);
+    if (auto res = utils::fs::writeIfChanged(cache_file, json.dump()); !res)
+        catalyst::logger.log(LogLevel::WARN, "Failed to save include cache: {}", res.error());
+}
+
+/// Work queue shared by the scanning threads; a file is queued once, the first time it is reached.
+class Scanner {
+public:
+    Scanner(const std::vector<fs::path> &include_dirs, const DirectiveCache &old_cache)
+        : include_dirs(include_dirs), old_cache(old_cache) {
+    }
+
+    void enqueue(const fs::path &file) {
+        std::lock_guard lock{mutex};
+        if (seen.insert(file.string()).second)
+            queue.push_back(file);
+    }
+
+    void run(unsigned num_threads) {
+        std::vector<std::jthread> threads;
+        threads.reserve(num_threads - 1);
+        for (unsigned ii = 1; ii < num_threads; ++ii)
+            threads.emplace_back([this] { work(); });
+        work();
+    }
+
+    std::unordered_map<std::string, std::vector<fs::path>> edges;
+    std::unordered_map<std::string, std::vector<std::string>> external;
+    std::unordered_map<std::string, ModuleInfo> modules;
+    std::unordered_map<std::string, std::vector<std::string>> conditionals;
+    DirectiveCache new_cache;
+    std::size_t reused = 0;
+
+private:
+    void work() {
+        std::unique_lock lock{mutex};
+        while (true) {
+            cv.wait(lock, [this] { return !queue.empty() || active == 0; });
+            if (queue.empty())
+                return; // nothing queued and nobody left to queue more
+            fs::path file = std::move(queue.back());
+            queue.pop_back();
+            ++active;
+            lock.unlock();
+
+            auto [entry, from_cache] = directivesOf(file);
+            std::vector<fs::path> resolved;
+            std::vector<std::string> unresolved;
+            std::unordered_set<std::string> always; // reached by at least one directive outside any #if
+            if (entry) {
+                for (const auto &directive : entry->directives) {
+                    if (auto header = resolve(file, directive)) {
+                        if (!directive.conditional)
+                            always.insert(header->string());
+                        resolved.push_back(std::move(*header));
+                    } else if (directive.angled) {
+                        if (!directive.conditional)
+                            always.insert(directive.spelling);
+                        unresolved.push_back(directive.spelling);
+                    }
+                }
+                std::ranges::sort(resolved);
+                auto [first, last] = std::ranges::unique(resolved);
+                resolved.erase(first, last);
+                std::ranges::sort(unresolved);
+                auto [ufirst, ulast] = std::ranges::unique(unresolved);
+                unresolved.erase(ufirst, ulast);
+            }
+            std::vector<std::string> conditional;
+            for (const auto &header : resolved) {
+                if (!always.contains(header.string()))
+                    conditional.push_back(header.string());
+            }
+            for (const auto &spelling : unresolved) {
+                if (!always.contains(spelling))
+                    conditional.push_back(spelling);
+            }
+
+            lock.lock();
+            for (const auto &header : resolved) {
+                if (seen.insert(header.string()).second)
+                    queue.push_back(header);
+            }
+            if (entry) {
+                reused += from_cache;
+                if (!entry->module.empty())
+                    modules.insert_or_assign(file.string(), entry->module);
+                new_cache.insert_or_assign(file.string(), std::move(*entry));
+            }
+            edges.insert_or_assign(file.string(), std::move(resolved));
+            if (!unresolved.empty())
+                external.insert_or_assign(file.string(), std::move(unresolved));
+            if (!conditional.empty())
+                conditionals.insert_or_assign(file.string(), std::move(conditional));
+            --active;
+            cv.notify_all();
+        }
+    }
+
+    /// Directives of `file`: from the cache when its stamp or, failing that, its content hash is unchanged.
+    std::pair<std::optional<CacheEntry>, bool> directivesOf(const fs::path &file) {
+        auto stamp = statFile(file);
+        if (!stamp)
+            return {std::nullopt, false};
+        auto cached = old_cache.find(file.string());
+        if (cached != old_cache.end() && cached->second.stamp == *stamp)
+            return {cached->second, true};
+
+        std::ifstream in{file, std::ios::binary};
+        std::string content{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+        std::uint64_t hash = utils::hash::Fnv1a{}.update(content).digest();
+        if (cached != old_cache.end() && cached->second.hash == hash) {
+            CacheEntry entry = cached->second; // touched but not changed
+            entry.stamp = *stamp;
+            return {std::move(entry), true};
+        }
+        Lexer lexer{content};
+        lexer.run();
+        return {CacheEntry{.stamp = *stamp,
+                           .hash = hash,
+                           .directives = std::move(lexer.directives),
+                           .module = std::move(lexer.module)},
+                false};
+    }
+
+    std::optional<fs::path> resolve(const fs::path &from, const Directive &directive) {
+        if (!directive.angled) {
+            fs::path local = (from.parent_path() / directive.spelling).lexically_normal();
+            if (exists(local))
+                return local;
+        }
+        {
+            std::lock_guard lock{resolve_mutex};
+            if (auto it = searched.find(directive.spelling); it != searched.end())
+                return it->second;
+        }
+        std::optional<fs::path> found;
+        for (const auto &dir : include_dirs) {
+            fs::path candidate = (dir / directive.spelling).lexically_normal();
+            if (exists(candidate)) {
+                found = std::move(candidate);
+                break;
+            }
+        }
+        std::lock_guard lock{resolve_mutex};
+        searched.emplace(directive.spelling, found);
+        return found;
+    }
+
+    bool exists(const fs::path &path) {
+        {
+            std::lock_guard lock{resolve_mutex};
+            if (auto it = existing.find(path.string()); it != existing.end())
+                return it->second;
+        }
+        bool is_file = statFile(path).has_value();
+        std::lock_guard lock{resolve_mutex};
+        existing.emplace(path.string(), is_file);
+        return is_file;
+    }
+
+    const std::vector<fs::path> &include_dirs;
+    const DirectiveCache &old_cache;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<fs::path> queue;
+    std::unordered_set<std::string> seen;
+    unsigned active = 0;
+
+    std::mutex resolve_mutex;
+    std::unordered_map<std::string, std::optional<fs::path>> searched; ///< -I lookups by spelling
+    std::unordered_map<std::string, bool> existing;                    ///< stat results by path
+};
+} // namespace
+
+std::vector<Directive> extractDirectives(std::string_view source) {
+    return std::move(Lexer{source}.run().directives);
+}
+
+ModuleInfo extractModuleInfo(std::string_view source) {
+    return std::move(Lexer{source}.run().module);
+}
+
+IncludeGraph IncludeGraph::scan(const std::vector<fs::path> &sources,
+                                const std::vector<fs::path> &include_dirs,
+                                const fs::path &cache_file,
+                                unsigned num_threads) {
+    std::vector<fs::path> search_dirs;
+    search_dirs.reserve(include_dirs.size());
+    for (const auto &dir : include_dirs)
+        search_dirs.push_back(fs::absolute(dir).lexically_normal());
+
+    DirectiveCache old_cache = loadCache(cache_file);
+    Scanner scanner{search_dirs, old_cache};
+    for (const auto &source : sources)
+        scanner.enqueue(fs::absolute(source).lexically_normal());
+
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    scanner.run(std::max(num_threads, 1U));
+
+    catalyst::logger.log(LogLevel::DEBUG,
+                         "Scanned includes of {} files, {} served from cache.",
+                         scanner.edges.size(),
+                         scanner.reused);
+    if (scanner.new_cache.size() != old_cache.size() || scanner.reused != scanner.new_cache.size())
+        saveCache(cache_file, scanner.new_cache);
+
+    IncludeGraph graph;
+    graph.edges = std::move(scanner.edges);
+    graph.external = std::move(scanner.external);
+    graph.modules = std::move(scanner.modules);
+    graph.conditionals = std::move(scanner.conditionals);
+    return graph;
+}
+
+const std::vector<fs::path> &IncludeGraph::includes(const fs::path &file) const {
+    static const std::vector<fs::path> none;
+    auto it = edges.find(fs::absolute(file).lexically_normal().string());
+    return it == edges.end() ? none : it->second;
+}
+
+const std::vector<std::string> &IncludeGraph::externalIncludes(const fs::path &file) const {
+    static const std::vector<std::string> none;
+    auto it = external.find(fs::absolute(file).lexically_normal().string());
+    return it == external.end() ? none : it->second;
+}
+
+const ModuleInfo &IncludeGraph::moduleInfo(const fs::path &file) const {
+    static const ModuleInfo none;
+    auto it = modules.find(fs::absolute(file).lexically_normal().string());
+    return it == modules.end() ? none : it->second;
+}
+
+std::vector<fs::path> IncludeGraph::transitiveIncludes(const fs::path &file) const {
+    std::string root = fs::absolute(file).lexically_normal().string();
+    std::unordered_set<std::string> visited{root};
+    std::vector<fs::path> stack{includes(file)};
+    std::vector<fs::path> reached;
+    while (!stack.empty()) {
+        fs::path header = std::move(stack.back());
+        stack.pop_back();
+        if (!visited.insert(header.string()).second)
+            continue;
+        if (auto it = edges.find(header.string()); it != edges.end())
+            stack.insert(stack.end(), it->second.begin(), it->second.end());
+        reached.push_back(std::move(header));
+    }
+    std::ranges::sort(reached);
+    return reached;
+}
+
+std::vector<std::string> IncludeGraph::unconditionalExternalIncludes(const fs::path &file) const {
+    auto only_conditional = [&](const std::string &from, const std::string &target) {
+        auto it = conditionals.find(from);
+        return it != conditionals.end() && std::ranges::find(it->second, target) != it->second.end();
+    };
+    std::string root = fs::absolute(file).lexically_normal().string();
+    std::unordered_set<std::string> visited{root};
+    std::vector<std::string> stack{root};
+    std::set<std::string> reached;
+    while (!stack.empty()) {
+        std::string current = std::move(stack.back());
+        stack.pop_back();
+        if (auto it = external.find(current); it != external.end()) {
+            for (const auto &spelling : it->second) {
+                if (!only_conditional(current, spelling))
+                    reached.insert(spelling);
+            }
+        }
+        if (auto it = edges.find(current); it != edges.end()) {
+            for (const auto &header : it->second) {
+                if (!only_conditional(current, header.string()) && visited.insert(header.string()).second)
+                    stack.push_back(header.string());
+            }
+        }
+    }
+    return {reached.begin(), reached.end()};
+}
+
+std::string IncludeGraph::digest() const {
+    std::map<std::string_view, const std::vector<fs::path> *> sorted;
+    for (const auto &[file, headers] : edges)
+        sorted.emplace(file, &headers);
+    utils::hash::Fnv1a hasher;
+    for (const auto &[file, headers] : sorted) {
+        hasher.update(file);
+        hasher.update(headers->size());
+        for (const auto &header : *headers)
+            hasher.update(header.string());
+        auto it = external.find(std::string{file});
+        hasher.update(it == external.end() ? 0 : it->second.size());
+        if (it != external.end()) {
+            for (const auto &spelling : it->second)
+                hasher.update(spelling);
+        }
+        if (auto mod = modules.find(std::string{file}); mod != modules.end()) {
+            hasher.update(mod->second.name).update(mod->second.exported ? 1 : 0).update(mod->second.imports.size());
+            for (const auto &import : mod->second.imports)
+                hasher.update(import);
+        }
+        auto cond = conditionals.find(std::string{file});
+        hasher.update(cond == conditionals.end() ? 0 : cond->second.size());
+        if (cond != conditionals.end()) {
+            for (const auto &target : cond->second)
+                hasher.update(target);
+        }
+    }
+    return hasher.hexDigest();
+}
+
+std::string IncludeGraph::toJson() const {
+    nlohmann::json json = nlohmann::json::object(); // std::map backed, so keys come out sorted
+    for (const auto &[file, headers] : edges) {
+        nlohmann::json list = nlohmann::json::array();
+        for (const auto &header : headers)
+            list.push_back(header.string());
+        json[file] = std::move(list);
+    }
+    return json.dump(2);
+}
+
+fs::path includeGraphPath(const fs::path &build_dir) {
+    return build_dir / "includes.json";
+}
+
+fs::path includeCachePath(const fs::path &build_dir) {
+    return build_dir / ".catalyst" / "include_cache.json";
+}
+} // namespace catalyst::utils::includes
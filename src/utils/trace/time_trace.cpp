@@ -0,0 +1,226 @@
+#include "catalyst/utils/trace/time_trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace catalyst::utils::trace {
+namespace fs = std::filesystem;
+
+namespace {
+using Totals = std::unordered_map<std::string, TraceTotal>;
+
+/// What one thread read.
+struct Partial {
+    std::vector<TraceUnit> units;
+    Totals headers;
+    Totals templates;
+    Totals template_sets;
+    Totals functions;
+    std::vector<fs::path> unreadable;
+};
+
+void add(Totals &totals, const std::string &name, std::int64_t duration_us, std::size_t count = 1) {
+    auto [it, inserted] = totals.try_emplace(name);
+    if (inserted)
+        it->second.name = name;
+    it->second.total_us += duration_us;
+    it->second.count += count;
+}
+
+void readTrace(const fs::path &path, Partial &partial) {
+    std::ifstream in{path};
+    nlohmann::json trace = nlohmann::json::parse(in, nullptr, false);
+    if (trace.is_discarded() || !trace.contains("traceEvents") || !trace["traceEvents"].is_array()) {
+        partial.unreadable.push_back(path);
+        return;
+    }
+    TraceUnit unit{.trace = path, .total_us = 0, .frontend_us = 0, .backend_us = 0};
+    for (const auto &event : trace["traceEvents"]) {
+        if (!event.is_object() || event.value("ph", "") != "X")
+            continue;
+        const std::string name = event.value("name", "");
+        const std::int64_t duration = event.value("dur", std::int64_t{0});
+        std::string detail;
+        if (auto args = event.find("args"); args != event.end() && args->is_object())
+            detail = args->value("detail", "");
+        if (name == "ExecuteCompiler") {
+            unit.total_us += duration;
+        } else if (name == "Frontend") {
+            unit.frontend_us += duration;
+        } else if (name == "Backend") {
+            unit.backend_us += duration;
+        } else if (name == "Source" && !detail.empty()) {
+            add(partial.headers, detail, duration);
+        } else if ((name == "InstantiateClass" || name == "InstantiateFunction") && !detail.empty()) {
+            add(partial.templates, detail, duration);
+            add(partial.template_sets, detail.substr(0, detail.find('<')), duration);
+        } else if ((name == "CodeGen Function" || name == "OptFunction") && !detail.empty()) {
+            add(partial.functions, detail, duration);
+        }
+    }
+    partial.units.push_back(std::move(unit));
+}
+
+std::vector<TraceTotal> sorted(const Totals &totals) {
+    std::vector<TraceTotal> list;
+    list.reserve(totals.size());
+    for (const auto &[name, total] : totals)
+        list.push_back(total);
+    std::ranges::sort(list, [](const TraceTotal &lhs, const TraceTotal &rhs) {
+        return lhs.total_us != rhs.total_us ? lhs.total_us > rhs.total_us : lhs.name < rhs.name;
+    });
+    return list;
+}
+
+std::string display(std::string_view name, const fs::path &root) {
+    constexpr std::size_t max_name = 240; // template names can run to pages
+    std::string shown{name};
+    if (fs::path path{shown}; path.is_absolute()) {
+        auto relative = path.lexically_relative(root);
+        if (!relative.empty() && !relative.string().starts_with(".."))
+            shown = relative.string();
+    }
+    if (shown.size() > max_name)
+        shown = shown.substr(0, max_name - 3) + "...";
+    return shown;
+}
+
+std::int64_t ms(std::int64_t us) {
+    return us / 1000;
+}
+
+void formatTotals(std::string &text,
+                  std::string_view heading,
+                  std::string_view column,
+                  const std::vector<TraceTotal> &totals,
+                  const fs::path &root,
+                  std::size_t top) {
+    text += std::format("\n## {}\n\n{:>10}  {:>6}  {:>8}  {}\n", heading, "total ms", "count", "avg ms", column);
+    for (std::size_t ii = 0; ii < std::min(top, totals.size()); ++ii) {
+        const TraceTotal &total = totals[ii];
+        text += std::format("{:>10}  {:>6}  {:>8}  {}\n",
+                            ms(total.total_us),
+                            total.count,
+                            ms(total.total_us / static_cast<std::int64_t>(std::max<std::size_t>(total.count, 1))),
+                            display(total.name, root));
+    }
+}
+} // namespace
+
+std::vector<fs::path> findTimeTraces(const fs::path &obj_dir) {
+    std::vector<fs::path> traces;
+    std::error_code ec;
+    for (fs::directory_iterator it{obj_dir, ec}, end; !ec && it != end; it.increment(ec)) {
+        const fs::path &path = it->path();
+        if (path.extension() != ".json")
+            continue;
+        fs::path object = path;
+        object.replace_extension(); // `a.o.json`, from `-o a.o.tmp`
+        if (object.extension() != ".o")
+            object.replace_extension(".o"); // `a.json`, from `-o a.o`
+        if (fs::exists(object, ec))
+            traces.push_back(path);
+    }
+    std::ranges::sort(traces);
+    return traces;
+}
+
+TimeTraceReport aggregateTimeTraces(const std::vector<fs::path> &traces, unsigned jobs) {
+    if (jobs == 0)
+        jobs = std::max(1U, std::thread::hardware_concurrency());
+    std::vector<Partial> partials(std::clamp<std::size_t>(traces.size(), 1, jobs));
+    std::atomic<std::size_t> next{0};
+    {
+        std::vector<std::jthread> threads;
+        for (auto &partial : partials) {
+            threads.emplace_back([&] {
+                for (std::size_t ii; (ii = next.fetch_add(1, std::memory_order_relaxed)) < traces.size();)
+                    readTrace(traces[ii], partial);
+            });
+        }
+    }
+
+    TimeTraceReport report;
+    Totals headers;
+    Totals templates;
+    Totals template_sets;
+    Totals functions;
+    for (auto &partial : partials) {
+        std::ranges::move(partial.units, std::back_inserter(report.units));
+        std::ranges::move(partial.unreadable, std::back_inserter(report.unreadable));
+        for (auto [into, from] : {std::pair{&headers, &partial.headers},
+                                  std::pair{&templates, &partial.templates},
+                                  std::pair{&template_sets, &partial.template_sets},
+                                  std::pair{&functions, &partial.functions}}) {
+            for (const auto &[name, total] : *from)
+                add(*into, name, total.total_us, total.count);
+        }
+    }
+    std::ranges::sort(report.units, [](const TraceUnit &lhs, const TraceUnit &rhs) {
+        return lhs.total_us != rhs.total_us ? lhs.total_us > rhs.total_us : lhs.trace < rhs.trace;
+    });
+    std::ranges::sort(report.unreadable);
+    report.headers = sorted(headers);
+    report.templates = sorted(templates);
+    report.template_sets = sorted(template_sets);
+    report.functions = sorted(functions);
+    return report;
+}
+
+std::string formatTimeTraceReport(const TimeTraceReport &report, const fs::path &root, std::size_t top) {
+    std::int64_t total = 0;
+    std::int64_t frontend = 0;
+    std::int64_t backend = 0;
+    for (const auto &unit : report.units) {
+        total += unit.total_us;
+        frontend += unit.frontend_us;
+        backend += unit.backend_us;
+    }
+    std::string text = std::format("# -ftime-trace: {} translation units, {:.1f}s ({:.1f}s frontend, "
+                                   "{:.1f}s backend)\n",
+                                   report.units.size(),
+                                   static_cast<double>(total) / 1e6,
+                                   static_cast<double>(frontend) / 1e6,
+                                   static_cast<double>(backend) / 1e6);
+
+    text += std::format("\n## Translation units\n\n{:>10}  {:>11}  {:>10}  {}\n",
+                        "total ms",
+                        "frontend ms",
+                        "backend ms",
+                        "trace");
+    for (std::size_t ii = 0; ii < std::min(top, report.units.size()); ++ii) {
+        const TraceUnit &unit = report.units[ii];
+        text += std::format("{:>10}  {:>11}  {:>10}  {}\n",
+                            ms(unit.total_us),
+                            ms(unit.frontend_us),
+                            ms(unit.backend_us),
+                            display(fs::absolute(unit.trace).string(), root));
+    }
+    formatTotals(text, "Headers by parse time", "header", report.headers, root, top);
+    formatTotals(text, "Template instantiations", "template", report.templates, root, top);
+    formatTotals(text, "Templates, over all their instantiations", "template", report.template_sets, root, top);
+    formatTotals(text, "Functions by code generation time", "function", report.functions, root, top);
+
+    if (!report.unreadable.empty()) {
+        text += "\n## Unreadable traces\n\n";
+        for (const auto &trace : report.unreadable)
+            text += display(fs::absolute(trace).string(), root) + "\n";
+    }
+    return text;
+}
+} // namespace catalyst::utils::trace
@@ -0,0 +1,300 @@
+#include "catalyst/utils/trace/timings.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "catalyst/utils/fs/write_if_changed.hpp"
+
+namespace catalyst::utils::trace {
+namespace fs = std::filesystem;
+
+namespace {
+/// Rows of `[name, category, start_us, end_us, lane]`, filled into the page's `spans`.
+constexpr std::string_view html_template = R"html(<!DOCTYPE html>
+<html lang="en">
+<head>
+<meta charset="utf-8">
+<title>@TITLE@</title>
+<style>
+body { font: 13px system-ui, sans-serif; margin: 1.5em; color: #222; }
+h1 { font-size: 1.4em; }
+h2 { font-size: 1.1em; margin-top: 1.8em; }
+table { border-collapse: collapse; }
+td, th { padding: 2px 12px 2px 0; text-align: left; white-space: nowrap; }
+td.n, th.n { text-align: right; font-variant-numeric: tabular-nums; }
+tbody tr:nth-child(even) { background: #f4f4f4; }
+#timeline { border: 1px solid #ccc; }
+.row { display: flex; height: 18px; border-bottom: 1px solid #eee; }
+.label { flex: none; width: 90px; padding-left: 4px; color: #666; font-size: 11px; line-height: 18px; }
+.track { position: relative; flex: 1; }
+.bar { position: absolute; top: 2px; height: 14px; min-width: 1px; border-radius: 2px; overflow: hidden;
+       white-space: nowrap; font-size: 10px; line-height: 14px; color: #fff; padding-left: 2px;
+       box-sizing: border-box; }
+canvas { width: 100%; height: 120px; border: 1px solid #ccc; }
+</style>
+</head>
+<body>
+<h1>@TITLE@</h1>
+<table id="summary"></table>
+<h2>Timeline</h2>
+<div id="timeline"></div>
+<h2>Commands running</h2>
+<canvas id="concurrency"></canvas>
+<h2>Phases</h2>
+<table id="phases"></table>
+<h2>By rule</h2>
+<table id="rules"></table>
+<h2>Slowest commands</h2>
+<table id="slowest"></table>
+<script>
+const spans = @SPANS@;
+const esc = text => text.replace(/[&<>"]/g, c => ({'&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;'})[c]);
+const sec = us => (us / 1e6).toFixed(2) + 's';
+const dur = span => span[3] - span[2];
+const color = category => {
+  if (category === 'phase') return '#607d8b';
+  if (category === 'hook') return '#8d6e63';
+  let hash = 0;
+  for (const c of category) hash = (hash * 31 + c.charCodeAt(0)) >>> 0;
+  return `hsl(${hash % 360}, 55%, 45%)`;
+};
+const table = (id, head, rows) => {
+  document.getElementById(id).innerHTML = '<thead><tr>' + head.map(h => `<th class="${h[1]}">${h[0]}</th>`).join('') +
+    '</tr></thead><tbody>' + rows.map(r => '<tr>' + r.map((c, i) => `<td class="${head[i][1]}">${c}</td>`).join('') +
+    '</tr>').join('') + '</tbody>';
+};
+
+const end = spans.reduce((max, span) => Math.max(max, span[3]), 1);
+const commands = spans.filter(span => span[4] > 0);
+const own = spans.filter(span => span[4] === 0).sort((a, b) => a[2] - b[2] || b[3] - a[3]);
+const command_time = commands.reduce((sum, span) => sum + dur(span), 0);
+const command_start = commands.reduce((min, span) => Math.min(min, span[2]), end);
+const command_end = commands.reduce((max, span) => Math.max(max, span[3]), 0);
+const lanes = commands.reduce((max, span) => Math.max(max, span[4]), 0);
+const events = commands.flatMap(span => [[span[2], 1], [span[3], -1]]).sort((a, b) => a[0] - b[0] || a[1] - b[1]);
+let peak = 0;
+events.reduce((running, event) => (peak = Math.max(peak, running + event[1]), running + event[1]), 0);
+table('summary', [['', ''], ['', 'n']], [
+  ['Total time', sec(end)],
+  ['Commands', commands.length],
+  ['Command time', sec(command_time)],
+  ['Average parallelism',
+   command_end > command_start ? (command_time / (command_end - command_start)).toFixed(1) : '-'],
+  ['Most at once', peak],
+]);
+
+// catalyst's own spans nest: each goes on the first row it does not overlap
+const rows = [];
+const depth = new Map();
+for (const span of own) {
+  let row = 0;
+  while (row < rows.length && rows[row] > span[2]) ++row;
+  rows[row] = span[3];
+  depth.set(span, row);
+}
+const bar = span => `<div class="bar" style="left:${span[2] / end * 100}%;width:${dur(span) / end * 100}%;` +
+  `background:${color(span[1])}" title="${esc(span[0])}: ${sec(dur(span))}">${esc(span[0])}</div>`;
+let timeline = '';
+const addRow = (label, members) => {
+  timeline += `<div class="row"><span class="label">${label}</span><div class="track">` + members.map(bar).join('') +
+    '</div></div>';
+};
+rows.forEach((_, row) => addRow(row === 0 ? 'catalyst' : '', own.filter(span => depth.get(span) === row)));
+for (let lane = 1; lane <= lanes; ++lane) addRow(`worker ${lane}`, commands.filter(span => span[4] === lane));
+document.getElementById('timeline').innerHTML = timeline;
+
+const canvas = document.getElementById('concurrency');
+canvas.width = canvas.clientWidth;
+canvas.height = canvas.clientHeight;
+const ctx = canvas.getContext('2d');
+ctx.fillStyle = '#4a78b5';
+let running = 0;
+for (let ii = 0; ii < events.length; ++ii) {
+  running += events[ii][1];
+  const next = ii + 1 < events.length ? events[ii + 1][0] : events[ii][0];
+  const height = running / Math.max(peak, 1) * (canvas.height - 4);
+  ctx.fillRect(events[ii][0] / end * canvas.width, canvas.height - height, (next - events[ii][0]) / end * canvas.width,
+               height);
+}
+
+table('phases', [['Phase', ''], ['Start', 'n'], ['Duration', 'n']],
+      own.map(span => ['&nbsp;'.repeat(4 * depth.get(span)) + esc(span[0]), sec(span[2]), sec(dur(span))]));
+
+const rules = new Map();
+for (const span of commands) {
+  const entry = rules.get(span[1]) || {count: 0, time: 0};
+  entry.count += 1;
+  entry.time += dur(span);
+  rules.set(span[1], entry);
+}
+table('rules', [['Rule', ''], ['Commands', 'n'], ['Time', 'n'], ['Share', 'n']],
+      [...rules].sort((a, b) => b[1].time - a[1].time).map(([rule, entry]) =>
+        [esc(rule), entry.count, sec(entry.time), (entry.time / Math.max(command_time, 1) * 100).toFixed(1) + '%']));
+
+table('slowest', [['Duration', 'n'], ['Rule', ''], ['Command', '']],
+      [...commands].sort((a, b) => dur(b) - dur(a)).slice(0, 25).map(span =>
+        [sec(dur(span)), esc(span[1]), esc(span[0])]));
+</script>
+</body>
+</html>
+)html";
+
+std::string escapeHtml(std::string_view text) {
+    std::string escaped;
+    for (char c : text) {
+        switch (c) {
+        case '&':
+            escaped += "&amp;";
+            break;
+        case '<':
+            escaped += "&lt;";
+            break;
+        case '>':
+            escaped += "&gt;";
+            break;
+        case '"':
+            escaped += "&quot;";
+            break;
+        default:
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void replaceAll(std::string &text, std::string_view from, std::string_view to) {
+    for (std::size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size()))
+        text.replace(pos, from.size(), to);
+}
+
+/// Names are paths and commands, which need not be UTF-8.
+std::string dump(const nlohmann::json &json) {
+    return json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+} // namespace
+
+Recorder::Recorder() : epoch(std::chrono::steady_clock::now()) {
+}
+
+void Recorder::enable() {
+    std::lock_guard lock{mutex};
+    on = true;
+}
+
+bool Recorder::enabled() const {
+    std::lock_guard lock{mutex};
+    return on;
+}
+
+std::int64_t Recorder::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Recorder::add(Span span) {
+    std::lock_guard lock{mutex};
+    if (on)
+        spans.push_back(std::move(span));
+}
+
+std::vector<Span> Recorder::take() {
+    std::lock_guard lock{mutex};
+    return std::exchange(spans, {});
+}
+
+Phase::Phase(std::string name, std::string category)
+    : name(std::move(name)), category(std::move(category)), start_us(recorder.nowUs()), open(recorder.enabled()) {
+}
+
+Phase::~Phase() {
+    end();
+}
+
+void Phase::end() {
+    if (!open)
+        return;
+    open = false;
+    recorder.add({.name = std::move(name),
+                  .category = std::move(category),
+                  .start_us = start_us,
+                  .end_us = recorder.nowUs(),
+                  .lane = 0});
+}
+
+void assignLanes(std::vector<Span> &commands) {
+    std::vector<std::size_t> order(commands.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, {}, [&](std::size_t ii) { return commands[ii].start_us; });
+    std::vector<std::int64_t> lane_end; // when each lane frees up
+    for (std::size_t ii : order) {
+        auto free = std::ranges::find_if(lane_end, [&](std::int64_t end) { return end <= commands[ii].start_us; });
+        if (free == lane_end.end())
+            free = lane_end.insert(lane_end.end(), 0);
+        *free = commands[ii].end_us;
+        commands[ii].lane = static_cast<unsigned>(free - lane_end.begin()) + 1;
+    }
+}
+
+std::string chromeTrace(const std::vector<Span> &spans) {
+    nlohmann::json events = nlohmann::json::array();
+    unsigned lanes = 0;
+    for (const auto &span : spans)
+        lanes = std::max(lanes, span.lane);
+    for (unsigned lane = 0; lane <= lanes; ++lane) {
+        events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", 1},
+                          {"tid", lane},
+                          {"args", {{"name", lane == 0 ? std::string{"catalyst"} : std::format("worker {}", lane)}}}});
+    }
+    for (const auto &span : spans) {
+        events.push_back({{"name", span.name},
+                          {"cat", span.category},
+                          {"ph", "X"},
+                          {"ts", span.start_us},
+                          {"dur", std::max<std::int64_t>(span.end_us - span.start_us, 0)},
+                          {"pid", 1},
+                          {"tid", span.lane}});
+    }
+    return dump({{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}}) + "\n";
+}
+
+std::string htmlReport(const std::vector<Span> &spans, const std::string &title) {
+    nlohmann::json rows = nlohmann::json::array();
+    for (const auto &span : spans)
+        rows.push_back({span.name, span.category, span.start_us, span.end_us, span.lane});
+    std::string data = dump(rows);
+    replaceAll(data, "</", "<\\/"); // a name must not end the script
+    std::string page{html_template};
+    replaceAll(page, "@TITLE@", escapeHtml(title));
+    replaceAll(page, "@SPANS@", data);
+    return page;
+}
+
+std::expected<fs::path, std::string>
+writeReports(const fs::path &dir, const std::vector<Span> &spans, const std::string &title) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", dir.string(), ec.message()));
+    if (auto res = utils::fs::writeIfChanged(dir / "catalyst-timing.json", chromeTrace(spans)); !res)
+        return std::unexpected(res.error());
+    const fs::path html = dir / "catalyst-timing.html";
+    if (auto res = utils::fs::writeIfChanged(html, htmlReport(spans, title)); !res)
+        return std::unexpected(res.error());
+    return html;
+}
+} // namespace catalyst::utils::trace
@@ -0,0 +1,127 @@
+#include "catalyst/utils/yaml/build_dir.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::yaml {
+namespace fs = std::filesystem;
+
+namespace {
+/// The first setting that commands acting on a finished build read from their own composition and that `built`, the
+/// composition of the build they would act on, has another value for.
+std::optional<std::string_view> divergentSetting(const Snapshot &own, const Snapshot &built) {
+    if (own.manifest.name != built.manifest.name)
+        return "manifest.name";
+    if (own.manifest.type != built.manifest.type)
+        return "manifest.type";
+    if (own.manifest.provides != built.manifest.provides)
+        return "manifest.provides";
+    if (own.meta.generator != built.meta.generator)
+        return "meta.generator";
+    auto dump = [](const Snapshot::Dependency &dep) { return YAML::Dump(dep.node); };
+    if (!std::ranges::equal(own.dependencies, built.dependencies, {}, dump, dump))
+        return "dependencies";
+    return std::nullopt;
+}
+} // namespace
+
+std::string profileDirName(const std::vector<std::string> &profiles) {
+    // the names alone are ambiguous once joined: `a-b` and `a`, `b` would share a directory
+    std::string name;
+    utils::hash::Fnv1a hasher;
+    for (std::size_t ii = 0; ii < profiles.size(); ++ii) {
+        if (ii != 0)
+            hasher.update(std::string_view{"\0", 1});
+        name += profiles[ii] + "-";
+        hasher.update(profiles[ii]);
+    }
+    return name + hasher.hexDigest().substr(0, 8);
+}
+
+std::optional<std::string> multiConfigName(const std::vector<std::string> &profiles,
+                                           const std::vector<std::string> &configs) {
+    if (configs.empty() || profiles.empty() || profiles.front() != "common")
+        return std::nullopt;
+    if (profiles.size() == 1)
+        return "common";
+    if (profiles.size() != 2 || std::ranges::find(configs, profiles.back()) == configs.end())
+        return std::nullopt;
+    return profiles.back();
+}
+
+std::optional<std::string> multiConfigName(const std::vector<std::string> &profiles, const Snapshot &snapshot) {
+    return multiConfigName(profiles, snapshot.manifest.build.configs);
+}
+
+fs::path currentLink(const fs::path &build_dir) {
+    return build_dir.parent_path() / "current";
+}
+
+std::expected<void, std::string> linkCurrent(const Snapshot &snapshot) {
+    if (!snapshot.manifest.dirs.per_profile)
+        return {};
+    const fs::path build_dir = snapshot.manifest.dirs.build;
+    const fs::path link = currentLink(build_dir);
+    std::error_code ec;
+    if (fs::is_symlink(link, ec) && fs::read_symlink(link, ec) == build_dir.filename())
+        return {};
+
+    // a fresh link renamed over the old one, so that `current` always resolves
+    const fs::path staged = link.parent_path() / ".current.tmp";
+    fs::remove(staged, ec);
+    fs::create_directory_symlink(build_dir.filename(), staged, ec);
+    if (!ec)
+        fs::rename(staged, link, ec);
+    if (ec) {
+        std::string error =
+            std::format("Failed to point {} at {}: {}", link.string(), build_dir.string(), ec.message());
+        fs::remove(staged, ec);
+        return std::unexpected(std::move(error));
+    }
+    catalyst::logger.log(LogLevel::DEBUG, "{} now points at {}.", link.string(), build_dir.string());
+    return {};
+}
+
+std::expected<fs::path, std::string> builtDir(const Snapshot &snapshot, bool profiles_named) {
+    const fs::path build_dir = snapshot.manifest.dirs.build;
+    if (profiles_named || !snapshot.manifest.dirs.per_profile)
+        return build_dir;
+    const fs::path link = currentLink(build_dir);
+    std::error_code ec;
+    if (!fs::is_directory(link, ec))
+        return build_dir;
+    const std::string last = fs::read_symlink(link, ec).string();
+
+    // the caller reads the target and its dependencies from its own composition, which must describe this build too
+    std::optional<std::string_view> divergent;
+    try {
+        const Snapshot built = Snapshot::compile(YAML::LoadFile((link / "profile_composition.yaml").string()));
+        divergent = divergentSetting(snapshot, built);
+    } catch (const YAML::Exception &err) {
+        return std::unexpected(std::format(
+            "Failed to read the composition of the last build, {}: {}. Name its profiles with -p.", last, err.what()));
+    }
+    if (divergent) {
+        return std::unexpected(std::format(
+            "The last build, {}, has another {} than the default profiles. Name its profiles with -p.",
+            last,
+            *divergent));
+    }
+    catalyst::logger.log(LogLevel::INFO, "Using the last build, {}.", last);
+    return link;
+}
+} // namespace catalyst::utils::yaml
@@ -0,0 +1,165 @@
+#include "catalyst/utils/yaml/config_cache.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "catalyst/globals.hpp"
+#include "catalyst/utils/fs/file_stat.hpp"
+#include "catalyst/utils/fs/write_if_changed.hpp"
+#include "catalyst/utils/hash/hash.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::yaml {
+namespace fs = std::filesystem;
+
+namespace {
+/// Profile files touched this recently may still change within the same mtime tick, so they are not cached.
+constexpr std::int64_t racy_window_ns = 2'000'000'000;
+
+/// The files `merge2` reads `profiles` from: `CATALYST.yaml` first, then each profile's own file.
+std::vector<fs::path> profileFiles(const std::vector<std::string> &profiles, const fs::path &root_dir) {
+    std::vector<fs::path> files{root_dir / "CATALYST.yaml"};
+    for (const auto &profile : profiles)
+        files.push_back(root_dir / (profile == "common" ? "catalyst.yaml" : std::format("catalyst_{}.yaml", profile)));
+    return files;
+}
+
+/// The header a cache for `profiles` must start with to be valid now, and the newest mtime it stamps.
+/// Text, one field per line, so a stale cache is rejected by a single prefix comparison.
+std::pair<std::string, std::int64_t> expectedHeader(const std::vector<std::string> &profiles,
+                                                    const fs::path &root_dir) {
+    std::string header = std::format("catalyst-config 1 {}\nprofiles", CATALYST_VERSION);
+    for (const auto &profile : profiles)
+        header += ' ' + profile;
+    header += '\n';
+    std::int64_t newest = 0;
+    for (const auto &file : profileFiles(profiles, root_dir)) {
+        const auto st = utils::fs::fileStat(file);
+        if (!st) {
+            header += std::format("missing {}\n", file.string());
+            continue;
+        }
+        newest = std::max(newest, st->mtime_ns);
+        header += std::format("file {} {} {} {}\n", st->mtime_ns, st->size, st->inode, file.string());
+    }
+    header += '\0';
+    return {std::move(header), newest};
+}
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+/// A read-only view of a whole file: mapped where the platform has `mmap`, read into memory otherwise or if
+/// mapping fails. Unmapped on destruction.
+class Mapping {
+public:
+    explicit Mapping(const fs::path &path) {
+#if !defined(_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                mapped = static_cast<const char *>(addr);
+                size = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+        if (mapped != nullptr)
+            return;
+#endif
+        std::ifstream in{path, std::ios::binary};
+        if (in)
+            buffer.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+    }
+    ~Mapping() {
+#if !defined(_WIN32)
+        if (mapped != nullptr)
+            ::munmap(const_cast<char *>(mapped), size);
+#endif
+    }
+    Mapping(const Mapping &) = delete;
+    Mapping &operator=(const Mapping &) = delete;
+
+    std::string_view bytes() const {
+        if (mapped != nullptr)
+            return {mapped, size};
+        return buffer;
+    }
+
+private:
+    const char *mapped = nullptr;
+    std::size_t size = 0;
+    std::string buffer;
+};
+} // namespace
+
+fs::path configCachePath(const std::vector<std::string> &profiles, const fs::path &root_dir) {
+    hash::Fnv1a hasher;
+    for (const auto &profile : profiles)
+        hasher.update(profile).update(std::string_view{"\0", 1});
+    return root_dir / ".catalyst" / "config" / hasher.hexDigest();
+}
+
+std::optional<Snapshot> loadConfigCache(const std::vector<std::string> &profiles, const fs::path &root_dir) {
+    const fs::path path = configCachePath(profiles, root_dir);
+    Mapping mapping{path};
+    const std::string_view bytes = mapping.bytes();
+    if (bytes.empty())
+        return std::nullopt;
+
+    const std::string header = expectedHeader(profiles, root_dir).first;
+    if (!bytes.starts_with(header)) {
+        catalyst::logger.log(LogLevel::DEBUG, "Configuration cache {} is stale.", path.string());
+        return std::nullopt;
+    }
+    auto snapshot = Snapshot::deserialize(bytes.substr(header.size()));
+    if (!snapshot)
+        catalyst::logger.log(LogLevel::DEBUG, "Ignoring corrupt configuration cache {}.", path.string());
+    else
+        catalyst::logger.log(LogLevel::DEBUG, "Loaded the composition from {}.", path.string());
+    return snapshot;
+}
+
+std::expected<void, std::string>
+saveConfigCache(const std::vector<std::string> &profiles, const fs::path &root_dir, const Snapshot &snapshot) {
+    const fs::path path = configCachePath(profiles, root_dir);
+    auto [header, newest] = expectedHeader(profiles, root_dir);
+    if (newest > nowNs() - racy_window_ns) {
+        catalyst::logger.log(LogLevel::DEBUG, "Not caching the composition: a profile was just modified.");
+        return {};
+    }
+
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    if (ec)
+        return std::unexpected(std::format("Failed to create {}: {}", path.parent_path().string(), ec.message()));
+    if (auto res = catalyst::utils::fs::writeIfChanged(path, header + snapshot.serialize()); !res)
+        return std::unexpected(res.error());
+    return {};
+}
+} // namespace catalyst::utils::yaml
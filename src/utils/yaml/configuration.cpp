@@ -6,21 +6,32 @@
 #include <filesystem>
 #include <format>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <yaml-cpp/yaml.h>
 
 #include "catalyst/utils/log/log.hpp"
+#include "catalyst/utils/yaml/build_dir.hpp"
+#include "catalyst/utils/yaml/config_cache.hpp"
+#include "catalyst/utils/yaml/manifest_cache.hpp"
 
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/parse.h"
 
 using catalyst::LogLevel;
 using catalyst::utils::yaml::Configuration;
+using catalyst::utils::yaml::FlatValue;
+using catalyst::utils::yaml::loadManifest;
+using catalyst::utils::yaml::Origin;
+using catalyst::utils::yaml::Provenance;
+using catalyst::utils::yaml::Snapshot;
 namespace fs = std::filesystem;
 
 namespace {
@@ -82,125 +93,166 @@ std::string verMax(std::string s1, std::string s2) {
     return s1;
 }
 
-std::vector<std::string> splitPath(const std::string &key) {
-    std::stringstream ss(key);
-    std::string segment;
-    std::vector<std::string> segments;
-    while (std::getline(ss, segment, '.')) {
-        segments.push_back(segment);
+/// How a sequence's new items read in `config explain`: scalars as they are, anything else by its position.
+std::string describeItems(const YAML::Node &items) {
+    std::string text;
+    for (std::size_t ii = 0; ii < items.size(); ++ii) {
+        if (!text.empty())
+            text += ", ";
+        const YAML::Node &item = items[ii];
+        if (item.IsScalar())
+            text += item.Scalar();
+        else if (item.IsMap() && item["name"] && item["name"].IsScalar())
+            text += item["name"].Scalar();
+        else
+            text += std::format("<entry {}>", ii);
     }
-    return segments;
+    return text;
 }
 
-std::optional<YAML::Node> traverse(const std::string &key, YAML::Node &&root) {
-    std::vector<std::string> segments = splitPath(key);
-    YAML::Node current = YAML::Node(root);
-
-    for (const auto &s : segments) {
-        if (!current[s]) {
-            return std::nullopt;
+/// The defaults as the first entry of every key's history, recorded once per process.
+const Provenance &defaultProvenance() {
+    static const Provenance provenance = [] {
+        Provenance seeded;
+        std::vector<std::pair<std::string, YAML::Node>> pending{{"", getDefaultConfiguration()}};
+        while (!pending.empty()) {
+            auto [prefix, node] = std::move(pending.back());
+            pending.pop_back();
+            for (auto it = node.begin(); it != node.end(); ++it) {
+                std::string key = prefix.empty() ? it->first.Scalar() : prefix + '.' + it->first.Scalar();
+                if (it->second.IsMap()) {
+                    pending.emplace_back(std::move(key), it->second);
+                } else {
+                    std::string value =
+                        it->second.IsScalar() ? it->second.Scalar() : "[" + describeItems(it->second) + "]";
+                    seeded[key].push_back({.kind = Origin::Kind::Default, .profile = "", .value = std::move(value)});
+                }
+            }
         }
-        current = current[s];
-    }
-    return current;
+        return seeded;
+    }();
+    return provenance;
 }
 
-void merge(YAML::Node &composite, const std::string &new_profile_name, const YAML::Node &new_profile) {
-    YAML::Node defaults = getDefaultConfiguration();
-
-    auto check_conflict = [&](const std::string &dotpath, const std::string &incoming_val) {
-        try {
-            auto resolve = [](YAML::Node node, const std::string &path) -> std::string {
-                for (const auto &seg : splitPath(path))
-                    node = node[seg];
-                return node.as<std::string>();
-            };
-            std::string current_val = resolve(YAML::Clone(composite), dotpath);
-            std::string default_val = resolve(YAML::Clone(defaults), dotpath);
-
-            if (current_val != incoming_val && current_val != default_val) {
-                catalyst::logger.log(LogLevel::WARN,
-                                     "Profile '{}' overrides '{}': '{}' -> '{}'",
-                                     new_profile_name,
-                                     dotpath,
-                                     current_val,
-                                     incoming_val);
-            }
-        } catch (...) {
-            catalyst::logger.log(LogLevel::DEBUG, "Could not check conflict for '{}'", dotpath);
+/// Merge one profile into `composite` in a single pass over the schema, appending to each touched key's history.
+/// Only the profile's own nodes are visited; the composite is never searched or copied.
+void merge(YAML::Node &composite,
+           const std::string &new_profile_name,
+           const YAML::Node &new_profile,
+           Provenance &provenance) {
+    auto record = [&](const std::string &dotpath, Origin::Kind kind, std::string value = "") {
+        provenance[dotpath].push_back({.kind = kind, .profile = new_profile_name, .value = std::move(value)});
+    };
+
+    // a profile's value for a scalar key, warning when it replaces another profile's different value
+    auto set = [&](YAML::Node dst_parent, const std::string &key, const std::string &dotpath, const YAML::Node &value) {
+        auto &history = provenance[dotpath];
+        std::string incoming = value.IsScalar() ? value.Scalar() : describeItems(value);
+        if (!history.empty() && history.back().kind == Origin::Kind::Set && history.back().value != incoming) {
+            catalyst::logger.log(LogLevel::WARN,
+                                 "Profile '{}' overrides '{}': '{}' -> '{}'",
+                                 new_profile_name,
+                                 dotpath,
+                                 history.back().value,
+                                 incoming);
         }
+        history.push_back({.kind = Origin::Kind::Set, .profile = new_profile_name, .value = std::move(incoming)});
+        dst_parent[key] = value;
     };
 
     auto merge_scalar =
-        [&](YAML::Node dst_parent, const std::string &key, YAML::Node src_parent, const std::string &dotpath) {
-            if (!src_parent[key].IsDefined())
+        [&](YAML::Node dst_parent, const std::string &key, const YAML::Node &src_parent, const std::string &dotpath) {
+            const YAML::Node &src = src_parent[key];
+            if (!src.IsDefined())
                 return;
-            if (src_parent[key].IsNull()) {
+            if (src.IsNull()) {
                 dst_parent.remove(key);
+                record(dotpath, Origin::Kind::Remove);
             } else {
-                check_conflict(dotpath, src_parent[key].as<std::string>());
-                dst_parent[key] = src_parent[key];
+                set(dst_parent, key, dotpath, src);
             }
         };
 
     auto merge_scalar_validated = [&](YAML::Node dst_parent,
                                       const std::string &key,
-                                      YAML::Node src_parent,
+                                      const YAML::Node &src_parent,
                                       const std::string &dotpath,
                                       std::function<bool(const std::string &)> validator,
                                       const std::string &fallback_on_null = "") {
-        if (!src_parent[key].IsDefined())
+        const YAML::Node &src = src_parent[key];
+        if (!src.IsDefined())
             return;
-        if (src_parent[key].IsNull()) {
-            if (!fallback_on_null.empty())
+        if (src.IsNull()) {
+            if (!fallback_on_null.empty()) {
                 dst_parent[key] = fallback_on_null;
-            else
-                dst_parent.remove(key);
-        } else {
-            auto val = src_parent[key].as<std::string>();
-            if (validator(val)) {
-                check_conflict(dotpath, val);
-                dst_parent[key] = val;
+                record(dotpath, Origin::Kind::Set, fallback_on_null);
             } else {
-                catalyst::logger.log(LogLevel::WARN,
-                                     "Invalid value '{}' for '{}' in profile '{}'. Ignoring.",
-                                     val,
-                                     dotpath,
-                                     new_profile_name);
+                dst_parent.remove(key);
+                record(dotpath, Origin::Kind::Remove);
             }
+        } else if (auto val = src.as<std::string>(); validator(val)) {
+            set(dst_parent, key, dotpath, src);
+        } else {
+            catalyst::logger.log(LogLevel::WARN,
+                                 "Invalid value '{}' for '{}' in profile '{}'. Ignoring.",
+                                 val,
+                                 dotpath,
+                                 new_profile_name);
+            record(dotpath, Origin::Kind::Ignored, val);
         }
     };
 
-    auto merge_sequence = [&](YAML::Node dst_parent, const std::string &key, YAML::Node src_parent) {
-        if (!src_parent[key].IsDefined())
-            return;
-        if (src_parent[key].IsNull()) {
-            dst_parent.remove(key);
-        } else if (src_parent[key].IsSequence()) {
-            for (const auto &item : src_parent[key])
-                dst_parent[key].push_back(item);
-        }
-    };
+    auto merge_sequence =
+        [&](YAML::Node dst_parent, const std::string &key, const YAML::Node &src_parent, const std::string &dotpath) {
+            const YAML::Node &src = src_parent[key];
+            if (!src.IsDefined())
+                return;
+            if (src.IsNull()) {
+                dst_parent.remove(key);
+                record(dotpath, Origin::Kind::Remove);
+            } else if (src.IsSequence()) {
+                YAML::Node dst = dst_parent[key];
+                for (const auto &item : src)
+                    dst.push_back(item);
+                record(dotpath, Origin::Kind::Append, describeItems(src));
+            }
+        };
 
     auto merge_section = [&](YAML::Node dst_parent,
                              const std::string &key,
-                             YAML::Node src_parent,
-                             std::function<void(YAML::Node, YAML::Node)> body) {
-        if (!src_parent[key].IsDefined())
+                             const YAML::Node &src_parent,
+                             const std::string &dotpath,
+                             std::function<void(YAML::Node, const YAML::Node &)> body) {
+        const YAML::Node &src = src_parent[key];
+        if (!src.IsDefined())
             return;
-        if (src_parent[key].IsNull()) {
+        if (src.IsNull()) {
             dst_parent.remove(key);
+            record(dotpath, Origin::Kind::Remove);
         } else {
-            body(dst_parent[key], src_parent[key]);
+            body(dst_parent[key], src);
         }
     };
 
-    merge_section(composite, "meta", new_profile, [&](YAML::Node dst, YAML::Node src) {
-        if (src["min_ver"].IsDefined()) {
-            if (src["min_ver"].IsNull()) {
+    // a section's scalar keys, each under `<dotpath>.<key>`
+    auto merge_scalars = [&](YAML::Node dst,
+                             const YAML::Node &src,
+                             const std::string &dotpath,
+                             std::initializer_list<const char *> keys) {
+        for (const char *key : keys)
+            merge_scalar(dst, key, src, dotpath + '.' + key);
+    };
+
+    merge_section(composite, "meta", new_profile, "meta", [&](YAML::Node dst, const YAML::Node &src) {
+        if (const YAML::Node &min_ver = src["min_ver"]; min_ver.IsDefined()) {
+            if (min_ver.IsNull()) {
                 dst.remove("min_ver");
+                record("meta.min_ver", Origin::Kind::Remove);
             } else {
-                dst["min_ver"] = verMax(dst["min_ver"].as<std::string>(), src["min_ver"].as<std::string>());
+                // the highest minimum wins, so this is not an override
+                std::string highest = verMax(dst["min_ver"].as<std::string>("0.0.0"), min_ver.as<std::string>());
+                record("meta.min_ver", Origin::Kind::Set, highest);
+                dst["min_ver"] = highest;
             }
         }
 
@@ -209,49 +261,90 @@ void merge(YAML::Node &composite, const std::string &new_profile_name, const YAM
             "generator",
             src,
             "meta.generator",
-            [](const std::string &v) { return v == "ninja" || v == "cbe"; },
+            [](const std::string &v) { return v == "ninja" || v == "cbe" || v == "native"; },
             /*fallback_on_null=*/"cbe");
     });
 
-    merge_section(composite, "manifest", new_profile, [&](YAML::Node dst, YAML::Node src) {
-        for (const auto &key : {"name", "type", "version", "provides"})
-            merge_scalar(dst, key, src, std::string("manifest.") + key);
+    merge_section(composite, "manifest", new_profile, "manifest", [&](YAML::Node dst, const YAML::Node &src) {
+        merge_scalars(dst, src, "manifest", {"name", "type", "version", "provides"});
 
-        merge_section(dst, "tooling", src, [&](YAML::Node tdst, YAML::Node tsrc) {
-            for (const auto &key : {"CC", "CXX", "FMT", "LINTER", "CCFLAGS", "CXXFLAGS"})
-                merge_scalar(tdst, key, tsrc, std::string("manifest.tooling.") + key);
+        merge_section(dst, "tooling", src, "manifest.tooling", [&](YAML::Node tdst, const YAML::Node &tsrc) {
+            merge_scalars(tdst, tsrc, "manifest.tooling", {"CC", "CXX", "FMT", "LINTER", "CCFLAGS", "CXXFLAGS"});
         });
 
-        merge_section(dst, "dirs", src, [&](YAML::Node ddst, YAML::Node dsrc) {
-            merge_sequence(ddst, "include", dsrc);
-            merge_sequence(ddst, "source", dsrc);
-            merge_scalar(ddst, "build", dsrc, "manifest.dirs.build");
+        merge_section(dst, "dirs", src, "manifest.dirs", [&](YAML::Node ddst, const YAML::Node &dsrc) {
+            merge_sequence(ddst, "include", dsrc, "manifest.dirs.include");
+            merge_sequence(ddst, "source", dsrc, "manifest.dirs.source");
+            merge_scalars(ddst, dsrc, "manifest.dirs", {"build", "per_profile"});
+        });
+
+        merge_section(dst, "build", src, "manifest.build", [&](YAML::Node bdst, const YAML::Node &bsrc) {
+            merge_section(bdst, "unity", bsrc, "manifest.build.unity", [&](YAML::Node udst, const YAML::Node &usrc) {
+                merge_scalars(udst, usrc, "manifest.build.unity", {"enabled", "batch_bytes"});
+                merge_sequence(udst, "exclude", usrc, "manifest.build.unity.exclude");
+            });
+            merge_section(bdst, "pch", bsrc, "manifest.build.pch", [&](YAML::Node pdst, const YAML::Node &psrc) {
+                merge_scalars(pdst, psrc, "manifest.build.pch", {"header", "max_headers", "min_percent"});
+                merge_sequence(pdst, "exclude", psrc, "manifest.build.pch.exclude");
+            });
+            merge_section(
+                bdst, "parallel", bsrc, "manifest.build.parallel", [&](YAML::Node jdst, const YAML::Node &jsrc) {
+                    merge_scalars(
+                        jdst, jsrc, "manifest.build.parallel", {"jobs", "load", "link_jobs", "memory_percent"});
+                });
+            merge_section(
+                bdst, "time_trace", bsrc, "manifest.build.time_trace", [&](YAML::Node tdst, const YAML::Node &tsrc) {
+                    merge_scalars(tdst, tsrc, "manifest.build.time_trace", {"enabled", "top"});
+                });
+            merge_sequence(bdst, "configs", bsrc, "manifest.build.configs");
+            merge_section(bdst,
+                          "config_header",
+                          bsrc,
+                          "manifest.build.config_header",
+                          [&](YAML::Node hdst, const YAML::Node &hsrc) {
+                              merge_scalars(hdst, hsrc, "manifest.build.config_header", {"mode", "split"});
+                          });
+            merge_section(bdst, "cache", bsrc, "manifest.build.cache", [&](YAML::Node cdst, const YAML::Node &csrc) {
+                merge_scalars(cdst, csrc, "manifest.build.cache", {"enabled", "dir", "max_size_mb"});
+                merge_section(
+                    cdst, "remote", csrc, "manifest.build.cache.remote", [&](YAML::Node rdst, const YAML::Node &rsrc) {
+                        merge_scalars(rdst, rsrc, "manifest.build.cache.remote", {"url", "mode"});
+                    });
+            });
         });
     });
 
-    merge_sequence(composite, "features", new_profile);
-    merge_sequence(composite, "dependencies", new_profile);
+    merge_sequence(composite, "features", new_profile, "features");
+    merge_sequence(composite, "dependencies", new_profile, "dependencies");
 
-    merge_section(composite, "hooks", new_profile, [&](YAML::Node dst, YAML::Node src) {
+    merge_section(composite, "hooks", new_profile, "hooks", [&](YAML::Node dst, const YAML::Node &src) {
         for (const auto &hook : src) {
             auto name = hook.first.as<std::string>();
+            const std::string dotpath = "hooks." + name;
             if (hook.second.IsNull()) {
                 dst.remove(name);
+                record(dotpath, Origin::Kind::Remove);
             } else if (hook.second.IsSequence()) {
+                YAML::Node commands = dst[name];
                 for (const auto &item : hook.second)
-                    dst[name].push_back(item);
+                    commands.push_back(item);
+                record(dotpath, Origin::Kind::Append, describeItems(hook.second));
             } else if (hook.second.IsScalar()) {
                 dst[name].push_back(hook.second);
+                record(dotpath, Origin::Kind::Append, hook.second.Scalar());
             }
         }
     });
 }
 
-void merge2(YAML::Node &composite, const std::string &profile_name, const fs::path &root_dir) {
+void merge2(YAML::Node &composite, const std::string &profile_name, const fs::path &root_dir, Provenance &provenance) {
+    // the parsed files are shared across compositions, and merging aliases the profile's nodes into the composite,
+    // which later edits in place (e.g. manifest.dirs.build), so each composition merges its own copy
     if (fs::exists(root_dir / "CATALYST.yaml")) {
-        if (YAML::Node catalyst_yaml = YAML::LoadFile(root_dir / "CATALYST.yaml"); catalyst_yaml[profile_name]) {
+        const YAML::Node catalyst_yaml = loadManifest(root_dir / "CATALYST.yaml");
+        if (const YAML::Node &profile = catalyst_yaml[profile_name]) {
             catalyst::logger.log(LogLevel::DEBUG, "Found profile '{}' in CATALYST.yaml", profile_name);
-            merge(composite, profile_name, catalyst_yaml[profile_name]);
+            merge(composite, profile_name, YAML::Clone(profile), provenance);
             return;
         }
     }
@@ -269,17 +362,59 @@ void merge2(YAML::Node &composite, const std::string &profile_name, const fs::pa
         throw std::runtime_error(
             std::format("Profile {} not found in {} or CATALYST.yaml", profile_name, profile_path.string()));
     }
-    merge(composite, profile_name, YAML::LoadFile(profile_path));
+    merge(composite, profile_name, YAML::Clone(loadManifest(profile_path)), provenance);
 }
 
 } // namespace
 
-Configuration::Configuration(const std::vector<std::string> &profiles, const std::filesystem::path &root_dir) {
-    std::vector profile_names = profiles;
-    catalyst::logger.log(LogLevel::DEBUG, "Composing profiles: {}.", profile_names);
+struct Configuration::Composition {
+    std::vector<std::string> profiles;
+    fs::path root_dir;
+    std::once_flag once;
+    YAML::Node root;
+    Provenance provenance;
+
+    /// Merge the profiles into `root`, unless done already.
+    void compose() {
+        std::call_once(once, [this] {
+            catalyst::logger.log(LogLevel::DEBUG, "Composing profiles: {}.", profiles);
+
+            root = getDefaultConfiguration();
+            provenance = defaultProvenance();
+            for (const auto &profile_name : profiles) {
+                merge2(root, profile_name, root_dir, provenance);
+            }
 
-    root = getDefaultConfiguration();
+            auto dirs = root["manifest"]["dirs"];
+            const fs::path base =
+                dirs["build"].as<std::string>("").empty() ? "build" : dirs["build"].as<std::string>();
+            // `manifest.build` has no default, and subscripting a missing const node throws
+            std::vector<std::string> configs;
+            if (const auto &build = std::as_const(root)["manifest"]["build"]; build && build.IsMap()) {
+                if (const auto &listed = build["configs"]; listed && listed.IsSequence()) {
+                    for (const auto &config : listed) {
+                        if (config.IsScalar())
+                            configs.push_back(config.Scalar());
+                    }
+                }
+            }
+            if (auto config_name = multiConfigName(profiles, configs)) {
+                dirs["build"] = (base / *config_name).string();
+                provenance["manifest.dirs.build"].push_back(
+                    {.kind = Origin::Kind::Derived, .profile = "", .value = dirs["build"].Scalar()});
+                catalyst::logger.log(LogLevel::DEBUG, "Config {} of the build graph.", *config_name);
+            } else if (dirs["per_profile"] && dirs["per_profile"].as<bool>(false)) {
+                dirs["build"] = (base / profileDirName(profiles)).string();
+                provenance["manifest.dirs.build"].push_back(
+                    {.kind = Origin::Kind::Derived, .profile = "", .value = dirs["build"].Scalar()});
+                catalyst::logger.log(LogLevel::DEBUG, "Building into {}.", dirs["build"].as<std::string>());
+            }
+            catalyst::logger.log(LogLevel::DEBUG, "Profile composition finished.");
+        });
+    }
+};
 
+Configuration::Configuration(const std::vector<std::string> &profiles, const std::filesystem::path &root_dir) {
     // NOTE: PERF: This is possibly more performant than creating a temporary std::unordered_set
     for (size_t ii = 0; ii < profiles.size(); ++ii) {
         for (size_t jj = 0; jj < ii; ++jj) {
@@ -290,74 +425,63 @@ Configuration::Configuration(const std::vector<std::string> &profiles, const std
         }
     }
 
-    for (const auto &profile_name : profile_names) {
-        merge2(root, profile_name, root_dir);
+    composition = std::make_shared<Composition>();
+    composition->profiles = profiles;
+    composition->root_dir = root_dir;
+
+    // the common case for run, test and clean: no profile changed since the last invocation
+    if (auto cached = loadConfigCache(profiles, root_dir)) {
+        compiled = std::make_shared<const Snapshot>(std::move(*cached));
+        return;
     }
 
-    catalyst::logger.log(LogLevel::DEBUG, "Profile composition finished.");
+    composition->compose();
+    compiled = std::make_shared<const Snapshot>(Snapshot::compile(composition->root));
+    if (auto res = saveConfigCache(profiles, root_dir, *compiled); !res)
+        catalyst::logger.log(LogLevel::DEBUG, "Failed to cache the composition: {}", res.error());
 }
 
-bool Configuration::has(const std::string &key) const {
-    std::vector<std::string> segments = splitPath(key);
-    YAML::Node current = YAML::Clone(root);
+const catalyst::utils::yaml::Snapshot &Configuration::snapshot() const {
+    static const Snapshot empty;
+    return compiled ? *compiled : empty;
+}
 
-    for (const auto &segment : segments) {
-        if (!current[segment]) {
-            return false;
-        }
-        current = current[segment];
-    }
-    return true;
+const catalyst::utils::yaml::Provenance &Configuration::provenance() const {
+    static const Provenance empty;
+    if (!composition)
+        return empty;
+    composition->compose();
+    return composition->provenance;
 }
 
-std::optional<std::string> Configuration::getString(const std::string &key) const {
-    std::optional<YAML::Node> res = traverse(key, YAML::Clone(root));
-    if (!res) {
-        return std::nullopt;
-    }
+const YAML::Node &Configuration::getRoot() const & {
+    static const YAML::Node empty;
+    if (!composition)
+        return empty;
+    composition->compose();
+    return composition->root;
+}
 
-    try {
-        return res.value().as<std::string>();
-    } catch (const YAML::Exception &) {
-        return std::nullopt;
-    }
+bool Configuration::has(const std::string &key) const {
+    return snapshot().find(key) != nullptr;
 }
 
-std::optional<int> Configuration::getInt(const std::string &key) const {
-    std::optional<YAML::Node> res = traverse(key, YAML::Clone(root));
-    if (!res) {
-        return std::nullopt;
-    }
+std::optional<std::string> Configuration::getString(const std::string &key) const {
+    const FlatValue *value = snapshot().find(key);
+    return value != nullptr ? value->string : std::nullopt;
+}
 
-    try {
-        return res.value().as<int>();
-    } catch (const YAML::Exception &) {
-        return std::nullopt;
-    }
+std::optional<int> Configuration::getInt(const std::string &key) const {
+    const FlatValue *value = snapshot().find(key);
+    return value != nullptr ? value->integer : std::nullopt;
 }
 
 std::optional<bool> Configuration::getBool(const std::string &key) const {
-    std::optional<YAML::Node> res = traverse(key, YAML::Clone(root));
-    if (!res) {
-        return std::nullopt;
-    }
-
-    try {
-        return res.value().as<bool>();
-    } catch (const YAML::Exception &) {
-        return std::nullopt;
-    }
+    const FlatValue *value = snapshot().find(key);
+    return value != nullptr ? value->boolean : std::nullopt;
 }
 
 std::optional<std::vector<std::string>> Configuration::getStringVector(const std::string &key) const {
-    std::optional<YAML::Node> res = traverse(key, YAML::Clone(root));
-    if (!res) {
-        return std::nullopt;
-    }
-
-    try {
-        return res.value().as<std::vector<std::string>>();
-    } catch (const YAML::Exception &) {
-        return std::nullopt;
-    }
+    const FlatValue *value = snapshot().find(key);
+    return value != nullptr ? value->strings : std::nullopt;
 }
@@ -0,0 +1,46 @@
+#include "catalyst/utils/yaml/manifest_cache.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <yaml-cpp/yaml.h>
+
+#include "catalyst/utils/fs/file_stat.hpp"
+#include "catalyst/utils/log/log.hpp"
+
+namespace catalyst::utils::yaml {
+namespace fs = std::filesystem;
+
+namespace {
+struct Parsed {
+    std::int64_t mtime_ns = 0;
+    std::int64_t size = 0;
+    YAML::Node root;
+};
+
+std::mutex cache_mutex;
+std::unordered_map<std::string, Parsed> cache;
+} // namespace
+
+YAML::Node loadManifest(const fs::path &path) {
+    const auto st = utils::fs::fileStat(path);
+    if (!st)
+        return YAML::LoadFile(path.string()); // throws BadFile, as callers expect
+    const std::int64_t mtime_ns = st->mtime_ns;
+    const std::string key = fs::absolute(path).lexically_normal().string();
+
+    std::scoped_lock lock{cache_mutex};
+    auto it = cache.find(key);
+    if (it != cache.end() && it->second.mtime_ns == mtime_ns && it->second.size == st->size)
+        return it->second.root;
+
+    catalyst::logger.log(LogLevel::DEBUG, "Parsing {}.", key);
+    Parsed parsed{.mtime_ns = mtime_ns, .size = st->size, .root = YAML::LoadFile(key)};
+    YAML::Node root = parsed.root;
+    cache.insert_or_assign(key, std::move(parsed));
+    return root;
+}
+} // namespace catalyst::utils::yaml
@@ -0,0 +1,409 @@
+#include "catalyst/utils/yaml/snapshot.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+namespace catalyst::utils::yaml {
+namespace {
+FlatValue convert(const YAML::Node &node) {
+    FlatValue value;
+    if (node.IsNull()) {
+        value.string = "null";
+    } else if (node.IsScalar()) {
+        value.string = node.Scalar();
+        if (int integer; YAML::convert<int>::decode(node, integer))
+            value.integer = integer;
+        if (bool boolean; YAML::convert<bool>::decode(node, boolean))
+            value.boolean = boolean;
+    } else if (node.IsSequence()) {
+        try {
+            value.strings = node.as<std::vector<std::string>>();
+        } catch (const YAML::Exception &) {
+            // a sequence of maps, like `dependencies`, is only reachable through the typed fields
+        }
+    }
+    return value;
+}
+
+std::string scalar(const YAML::Node &node, std::string_view key) {
+    const YAML::Node &child = node[std::string{key}];
+    return child && child.IsScalar() ? child.Scalar() : std::string{};
+}
+
+std::vector<std::string> scalars(const YAML::Node &node, std::string_view key) {
+    const YAML::Node &child = node[std::string{key}];
+    if (!child || !child.IsSequence())
+        return {};
+    try {
+        return child.as<std::vector<std::string>>();
+    } catch (const YAML::Exception &) {
+        return {};
+    }
+}
+std::vector<Snapshot::HookStep> hookSteps(const YAML::Node &hook) {
+    using Kind = Snapshot::HookStep::Kind;
+    std::vector<Snapshot::HookStep> steps;
+    if (hook.IsScalar()) {
+        steps.push_back({.kind = Kind::Command, .text = hook.Scalar()});
+    } else if (hook.IsSequence()) {
+        for (const auto &item : hook) {
+            if (item.IsScalar()) {
+                // a profile's single command, appended to an earlier profile's list
+                steps.push_back({.kind = Kind::Command, .text = item.Scalar()});
+            } else if (item.IsMap() && item["command"]) {
+                steps.push_back({.kind = Kind::Command, .text = item["command"].as<std::string>()});
+            } else if (item.IsMap() && item["script"]) {
+                steps.push_back({.kind = Kind::Script, .text = item["script"].as<std::string>()});
+            }
+        }
+    }
+    return steps;
+}
+
+// Bumped whenever the encoding below changes.
+constexpr std::uint32_t encoding_version = 2;
+
+class Writer {
+public:
+    template <typename Int> void integer(Int value) {
+        char bytes[sizeof value];
+        std::memcpy(bytes, &value, sizeof value);
+        out.append(bytes, sizeof value);
+    }
+    void string(std::string_view text) {
+        integer(static_cast<std::uint32_t>(text.size()));
+        out.append(text);
+    }
+    void strings(const std::vector<std::string> &texts) {
+        integer(static_cast<std::uint32_t>(texts.size()));
+        for (const auto &text : texts)
+            string(text);
+    }
+    void node(const YAML::Node &node) {
+        if (node.IsScalar()) {
+            out += 's';
+            string(node.Scalar());
+        } else if (node.IsSequence()) {
+            out += 'q';
+            integer(static_cast<std::uint32_t>(node.size()));
+            for (const auto &item : node)
+                this->node(item);
+        } else if (node.IsMap()) {
+            out += 'm';
+            integer(static_cast<std::uint32_t>(node.size()));
+            for (auto it = node.begin(); it != node.end(); ++it) {
+                string(it->first.Scalar());
+                this->node(it->second);
+            }
+        } else {
+            out += 'n';
+        }
+    }
+
+    std::string out;
+};
+
+/// Every read past the end, or of a count larger than the bytes left, fails the whole decode.
+class Reader {
+public:
+    explicit Reader(std::string_view bytes) : rest(bytes) {}
+
+    template <typename Int> Int integer() {
+        Int value{};
+        if (rest.size() < sizeof value) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, rest.data(), sizeof value);
+        rest.remove_prefix(sizeof value);
+        return value;
+    }
+    /// An element count; every element takes at least a byte, so a larger one is corrupt.
+    std::uint32_t count() {
+        auto size = integer<std::uint32_t>();
+        if (size > rest.size())
+            ok = false;
+        return ok ? size : 0;
+    }
+    std::string string() {
+        auto size = integer<std::uint32_t>();
+        if (!ok || size > rest.size()) {
+            ok = false;
+            return {};
+        }
+        std::string text{rest.substr(0, size)};
+        rest.remove_prefix(size);
+        return text;
+    }
+    std::vector<std::string> strings() {
+        std::vector<std::string> texts(count());
+        for (auto &text : texts)
+            text = string();
+        return texts;
+    }
+    YAML::Node node(int depth = 0) {
+        char tag = integer<char>();
+        if (!ok || depth > 64) {
+            ok = false;
+            return {};
+        }
+        switch (tag) {
+        case 's':
+            return YAML::Node{string()};
+        case 'q': {
+            YAML::Node seq{YAML::NodeType::Sequence};
+            for (std::uint32_t ii = 0, size = count(); ok && ii < size; ++ii)
+                seq.push_back(node(depth + 1));
+            return seq;
+        }
+        case 'm': {
+            YAML::Node map{YAML::NodeType::Map};
+            for (std::uint32_t ii = 0, size = count(); ok && ii < size; ++ii) {
+                std::string key = string();
+                map[key] = node(depth + 1);
+            }
+            return map;
+        }
+        case 'n':
+            return YAML::Node{YAML::NodeType::Null};
+        default:
+            ok = false;
+            return {};
+        }
+    }
+
+    bool done() const {
+        return ok && rest.empty();
+    }
+    bool ok = true;
+
+private:
+    std::string_view rest;
+};
+
+enum FlatBits : std::uint8_t {
+    HAS_STRING = 1,
+    HAS_INTEGER = 2,
+    HAS_BOOLEAN = 4,
+    HAS_STRINGS = 8,
+};
+} // namespace
+
+Snapshot Snapshot::compile(const YAML::Node &root) {
+    Snapshot snapshot;
+
+    // the const overloads of operator[] never insert, unlike the ones that made every read clone the tree
+    std::vector<std::pair<std::string, YAML::Node>> pending{{"", root}};
+    while (!pending.empty()) {
+        auto [prefix, node] = std::move(pending.back());
+        pending.pop_back();
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            if (!it->first.IsScalar())
+                continue;
+            std::string key = prefix.empty() ? it->first.Scalar() : prefix + '.' + it->first.Scalar();
+            const YAML::Node child = it->second;
+            snapshot.values.insert_or_assign(key, convert(child));
+            if (child.IsMap())
+                pending.emplace_back(std::move(key), child);
+        }
+    }
+
+    const YAML::Node &meta = root["meta"];
+    if (meta && meta.IsMap()) {
+        snapshot.meta.min_ver = scalar(meta, "min_ver");
+        snapshot.meta.generator = scalar(meta, "generator");
+    }
+    const YAML::Node &manifest = root["manifest"];
+    if (manifest && manifest.IsMap()) {
+        snapshot.manifest.name = scalar(manifest, "name");
+        snapshot.manifest.type = scalar(manifest, "type");
+        snapshot.manifest.version = scalar(manifest, "version");
+        snapshot.manifest.provides = scalar(manifest, "provides");
+        if (const YAML::Node &tooling = manifest["tooling"]; tooling && tooling.IsMap()) {
+            snapshot.manifest.tooling = {.cc = scalar(tooling, "CC"),
+                                         .cxx = scalar(tooling, "CXX"),
+                                         .fmt = scalar(tooling, "FMT"),
+                                         .linter = scalar(tooling, "LINTER"),
+                                         .ccflags = scalar(tooling, "CCFLAGS"),
+                                         .cxxflags = scalar(tooling, "CXXFLAGS")};
+        }
+        if (const YAML::Node &dirs = manifest["dirs"]; dirs && dirs.IsMap()) {
+            bool per_profile = false;
+            if (const YAML::Node &node = dirs["per_profile"]; node)
+                YAML::convert<bool>::decode(node, per_profile);
+            snapshot.manifest.dirs = {.include = scalars(dirs, "include"),
+                                      .source = scalars(dirs, "source"),
+                                      .build = scalar(dirs, "build"),
+                                      .per_profile = per_profile};
+        }
+        if (const YAML::Node &build = manifest["build"]; build && build.IsMap())
+            snapshot.manifest.build.configs = scalars(build, "configs");
+    }
+
+    if (const YAML::Node &deps = root["dependencies"]; deps && deps.IsSequence()) {
+        for (const auto &dep : deps) {
+            if (dep.IsMap())
+                snapshot.dependencies.push_back(
+                    {.name = scalar(dep, "name"), .source = scalar(dep, "source"), .node = dep});
+        }
+    }
+
+    if (const YAML::Node &features = root["features"]; features && features.IsSequence()) {
+        for (const auto &feature_map : features) {
+            if (!feature_map.IsMap())
+                continue; // technically an error but we allow it
+            for (auto it = feature_map.begin(); it != feature_map.end(); ++it) {
+                bool enabled = false;
+                if (it->first.IsScalar() && YAML::convert<bool>::decode(it->second, enabled))
+                    snapshot.features.push_back({.name = it->first.Scalar(), .enabled = enabled});
+            }
+        }
+    }
+
+    if (const YAML::Node &hooks = root["hooks"]; hooks && hooks.IsMap()) {
+        for (auto it = hooks.begin(); it != hooks.end(); ++it) {
+            if (it->first.IsScalar())
+                snapshot.hooks.emplace(it->first.Scalar(), hookSteps(it->second));
+        }
+    }
+    return snapshot;
+}
+
+std::string Snapshot::serialize() const {
+    Writer writer;
+    writer.integer(encoding_version);
+
+    writer.integer(static_cast<std::uint32_t>(values.size()));
+    for (const auto &[key, value] : values) {
+        writer.string(key);
+        const int bits = (value.string ? HAS_STRING : 0) | (value.integer ? HAS_INTEGER : 0) |
+                         (value.boolean ? HAS_BOOLEAN : 0) | (value.strings ? HAS_STRINGS : 0);
+        writer.integer(static_cast<std::uint8_t>(bits));
+        if (value.string)
+            writer.string(*value.string);
+        if (value.integer)
+            writer.integer(static_cast<std::int32_t>(*value.integer));
+        if (value.boolean)
+            writer.integer(static_cast<std::uint8_t>(*value.boolean));
+        if (value.strings)
+            writer.strings(*value.strings);
+    }
+
+    writer.string(meta.min_ver);
+    writer.string(meta.generator);
+    for (const std::string *field : {&manifest.name,
+                                     &manifest.type,
+                                     &manifest.version,
+                                     &manifest.provides,
+                                     &manifest.tooling.cc,
+                                     &manifest.tooling.cxx,
+                                     &manifest.tooling.fmt,
+                                     &manifest.tooling.linter,
+                                     &manifest.tooling.ccflags,
+                                     &manifest.tooling.cxxflags,
+                                     &manifest.dirs.build})
+        writer.string(*field);
+    writer.strings(manifest.dirs.include);
+    writer.strings(manifest.dirs.source);
+    writer.integer(static_cast<std::uint8_t>(manifest.dirs.per_profile));
+    writer.strings(manifest.build.configs);
+
+    writer.integer(static_cast<std::uint32_t>(dependencies.size()));
+    for (const auto &dep : dependencies) {
+        writer.string(dep.name);
+        writer.string(dep.source);
+        writer.node(dep.node);
+    }
+    writer.integer(static_cast<std::uint32_t>(features.size()));
+    for (const auto &feature : features) {
+        writer.string(feature.name);
+        writer.integer(static_cast<std::uint8_t>(feature.enabled));
+    }
+    writer.integer(static_cast<std::uint32_t>(hooks.size()));
+    for (const auto &[name, steps] : hooks) {
+        writer.string(name);
+        writer.integer(static_cast<std::uint32_t>(steps.size()));
+        for (const auto &step : steps) {
+            writer.integer(static_cast<char>(step.kind));
+            writer.string(step.text);
+        }
+    }
+    return std::move(writer.out);
+}
+
+std::optional<Snapshot> Snapshot::deserialize(std::string_view bytes) {
+    Reader reader{bytes};
+    if (reader.integer<std::uint32_t>() != encoding_version)
+        return std::nullopt;
+
+    Snapshot snapshot;
+    for (std::uint32_t ii = 0, size = reader.count(); reader.ok && ii < size; ++ii) {
+        std::string key = reader.string();
+        auto bits = reader.integer<std::uint8_t>();
+        FlatValue value;
+        if (bits & HAS_STRING)
+            value.string = reader.string();
+        if (bits & HAS_INTEGER)
+            value.integer = reader.integer<std::int32_t>();
+        if (bits & HAS_BOOLEAN)
+            value.boolean = reader.integer<std::uint8_t>() != 0;
+        if (bits & HAS_STRINGS)
+            value.strings = reader.strings();
+        snapshot.values.insert_or_assign(std::move(key), std::move(value));
+    }
+
+    snapshot.meta.min_ver = reader.string();
+    snapshot.meta.generator = reader.string();
+    Manifest &manifest = snapshot.manifest;
+    for (std::string *field : {&manifest.name,
+                               &manifest.type,
+                               &manifest.version,
+                               &manifest.provides,
+                               &manifest.tooling.cc,
+                               &manifest.tooling.cxx,
+                               &manifest.tooling.fmt,
+                               &manifest.tooling.linter,
+                               &manifest.tooling.ccflags,
+                               &manifest.tooling.cxxflags,
+                               &manifest.dirs.build})
+        *field = reader.string();
+    manifest.dirs.include = reader.strings();
+    manifest.dirs.source = reader.strings();
+    manifest.dirs.per_profile = reader.integer<std::uint8_t>() != 0;
+    manifest.build.configs = reader.strings();
+
+    for (std::uint32_t ii = 0, size = reader.count(); reader.ok && ii < size; ++ii) {
+        Dependency dep{.name = reader.string(), .source = reader.string(), .node = {}};
+        dep.node = reader.node();
+        snapshot.dependencies.push_back(std::move(dep));
+    }
+    for (std::uint32_t ii = 0, size = reader.count(); reader.ok && ii < size; ++ii) {
+        Feature feature{.name = reader.string(), .enabled = false};
+        feature.enabled = reader.integer<std::uint8_t>() != 0;
+        snapshot.features.push_back(std::move(feature));
+    }
+    for (std::uint32_t ii = 0, size = reader.count(); reader.ok && ii < size; ++ii) {
+        auto &steps = snapshot.hooks[reader.string()];
+        for (std::uint32_t jj = 0, count = reader.count(); reader.ok && jj < count; ++jj) {
+            auto kind = static_cast<HookStep::Kind>(reader.integer<char>());
+            steps.push_back({.kind = kind, .text = reader.string()});
+        }
+    }
+
+    if (!reader.done())
+        return std::nullopt;
+    return snapshot;
+}
+
+const FlatValue *Snapshot::find(std::string_view key) const {
+    auto it = values.find(key);
+    return it == values.end() ? nullptr : &it->second;
+}
+} // namespace catalyst::utils::yaml
@@ -1,6 +1,8 @@
 #include "catalyst/workspace.hpp"
 
 #include <format>
+#include <mutex>
+#include <stdexcept>
 
 #include <yaml-cpp/yaml.h>
 
@@ -11,6 +13,11 @@ namespace catalyst {
 
 namespace fs = std::filesystem;
 
+struct Workspace::MemberConfigs {
+    std::mutex mutex;
+    std::unordered_map<std::string, utils::yaml::Configuration> by_key;
+};
+
 std::optional<Workspace> Workspace::findRoot(const fs::path &start_path) {
     fs::path current = fs::absolute(start_path);
     fs::path root = current.root_path();
@@ -36,6 +43,7 @@ std::optional<Workspace> Workspace::load(const fs::path &workspace_file) {
         YAML::Node node = YAML::LoadFile(workspace_file.string());
         Workspace workspace;
         workspace.root_path = workspace_file.parent_path();
+        workspace.member_configs = std::make_shared<MemberConfigs>();
 
         if (!node.IsMap()) {
             logger.log(LogLevel::ERROR, "WORKSPACE.yaml must be a map");
@@ -93,12 +101,7 @@ std::optional<WorkspaceMember> Workspace::getMemberByPath(const fs::path &path)
 std::optional<WorkspaceMember> Workspace::findPackage(const std::string &package_name) const {
     for (const auto &[key, member] : members) {
         try {
-            std::vector<std::string> profiles = member.profiles;
-            if (profiles.empty())
-                profiles.emplace_back("common");
-
-            utils::yaml::Configuration config(profiles, member.path);
-            auto name_opt = config.getString("manifest.name");
+            auto name_opt = memberConfig(key).getString("manifest.name");
             if (name_opt && *name_opt == package_name) {
                 return member;
             }
@@ -109,4 +112,19 @@ std::optional<WorkspaceMember> Workspace::findPackage(const std::string &package
     return std::nullopt;
 }
 
+const utils::yaml::Configuration &Workspace::memberConfig(const std::string &key) const {
+    const auto member = members.find(key);
+    if (member == members.end())
+        throw std::out_of_range(std::format("No workspace member {}", key));
+
+    std::scoped_lock lock{member_configs->mutex};
+    if (auto it = member_configs->by_key.find(key); it != member_configs->by_key.end())
+        return it->second;
+    std::vector<std::string> profiles = member->second.profiles;
+    if (profiles.empty())
+        profiles.emplace_back("common");
+    return member_configs->by_key.emplace(key, utils::yaml::Configuration{profiles, member->second.path})
+        .first->second;
+}
+
 } // namespace catalyst
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "catalyst/utils/exec/build_log.hpp"
+#include "test.hpp"
+
+namespace {
+namespace fs = std::filesystem;
+using catalyst::utils::exec::BuildLog;
+using catalyst::utils::exec::DepsEntry;
+using catalyst::utils::exec::LogEntry;
+using Strings = std::vector<std::string>;
+
+/// An empty state directory, removed again at the end of the test.
+struct StateDir {
+    fs::path dir = fs::temp_directory_path() /
+                   std::format("catalyst_tests_{}", std::chrono::steady_clock::now().time_since_epoch().count());
+
+    StateDir() {
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+    }
+    ~StateDir() {
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+    void write(std::string_view file, std::string_view content) const {
+        std::ofstream{dir / file, std::ios::binary | std::ios::trunc} << content;
+    }
+    std::string read(std::string_view file) const {
+        std::ifstream in{dir / file, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+};
+
+bool same(const std::optional<LogEntry> &found, const LogEntry &rhs) {
+    if (!found)
+        return false;
+    const LogEntry &lhs = *found;
+    return lhs.start_ms == rhs.start_ms && lhs.end_ms == rhs.end_ms && lhs.mtime_ns == rhs.mtime_ns &&
+           lhs.command_hash == rhs.command_hash && lhs.content_hash == rhs.content_hash &&
+           lhs.peak_rss_kb == rhs.peak_rss_kb;
+}
+
+const LogEntry compiled{.start_ms = 5,
+                        .end_ms = 1250,
+                        .mtime_ns = 1'700'000'000'123'456'789,
+                        .command_hash = 0xdeadbeefcafef00d,
+                        .content_hash = 0xffffffffffffffff,
+                        .peak_rss_kb = 81920};
+
+CATALYST_TEST(build_log_roundtrip) {
+    StateDir state;
+    {
+        BuildLog log{state.dir};
+        CHECK(log.open().has_value());
+        CHECK(log.record("obj/a.o", compiled).has_value());
+        CHECK(log.record("obj/b.o", {.start_ms = 1, .end_ms = 2, .command_hash = 3}).has_value());
+        CHECK(log.recordDeps("obj/a.o", {.mtime_ns = 7, .deps = {"src/a.cpp", "include/a.hpp"}}).has_value());
+    }
+    BuildLog reloaded{state.dir};
+    CHECK(same(reloaded.entry("obj/a.o"), compiled));
+    CHECK(same(reloaded.entry("obj/b.o"), LogEntry{.start_ms = 1, .end_ms = 2, .command_hash = 3}));
+    CHECK(!reloaded.entry("obj/c.o"));
+    auto deps = reloaded.deps("obj/a.o");
+    CHECK(deps && deps->mtime_ns == 7 && deps->deps == Strings({"src/a.cpp", "include/a.hpp"}));
+    CHECK(reloaded.outputs().size() == 2);
+}
+
+CATALYST_TEST(build_log_later_records_supersede) {
+    StateDir state;
+    {
+        BuildLog log{state.dir};
+        CHECK(log.open().has_value());
+        CHECK(log.record("obj/a.o", {.command_hash = 1}).has_value());
+        CHECK(log.record("obj/a.o", compiled).has_value());
+    }
+    BuildLog reloaded{state.dir};
+    CHECK(same(reloaded.entry("obj/a.o"), compiled));
+    CHECK(reloaded.outputs() == Strings({"obj/a.o"}));
+}
+
+CATALYST_TEST(build_log_parse) {
+    StateDir state;
+    state.write("native_log",
+                "catalyst-native-log 3\n"
+                "10\t20\t30\tff\t0\t512\tobj/a.o\n"
+                "1\t2\t3\t4\t5\t6\tobj/with space.o\n");
+    state.write("native_deps", "catalyst-native-deps 1\n9\tobj/a.o\tsrc/a.cpp\n4\tapp\n");
+    BuildLog log{state.dir};
+    CHECK(same(log.entry("obj/a.o"),
+               LogEntry{.start_ms = 10, .end_ms = 20, .mtime_ns = 30, .command_hash = 0xff, .peak_rss_kb = 512}));
+    CHECK(log.entry("obj/with space.o").has_value());
+    auto deps = log.deps("obj/a.o");
+    CHECK(deps && deps->mtime_ns == 9 && deps->deps == Strings({"src/a.cpp"}));
+    auto none = log.deps("app");
+    CHECK(none && none->deps.empty());
+}
+
+CATALYST_TEST(build_log_foreign_or_corrupt_files_start_empty) {
+    StateDir state;
+    // an older format, which lacks the content hash and peak memory columns
+    state.write("native_log", "catalyst-native-log 1\n10\t20\t30\tff\tobj/a.o\n");
+    state.write("native_deps", "");
+    BuildLog old{state.dir};
+    CHECK(old.outputs().empty());
+    CHECK(old.open().has_value());
+    CHECK(state.read("native_log") == "catalyst-native-log 3\n");
+    CHECK(state.read("native_deps") == "catalyst-native-deps 1\n");
+
+    // one bad record drops the whole file, as nothing after it can be trusted either
+    state.write("native_log", "catalyst-native-log 3\n10\t20\t30\tff\t0\t512\tobj/a.o\n10\tx\t30\tff\t0\t0\tobj/b.o\n");
+    state.write("native_deps", "catalyst-native-deps 1\n9\n");
+    BuildLog corrupt{state.dir};
+    CHECK(corrupt.outputs().empty());
+    CHECK(!corrupt.deps("obj/a.o"));
+}
+
+CATALYST_TEST(build_log_torn_last_line) {
+    StateDir state;
+    state.write("native_log", "catalyst-native-log 3\n10\t20\t30\tff\t0\t512\tobj/a.o\n11\t21\t31\tf");
+    {
+        BuildLog log{state.dir};
+        CHECK(log.outputs() == Strings({"obj/a.o"}));
+        // the torn record is compacted away before anything is appended after it
+        CHECK(log.open().has_value());
+        CHECK(log.record("obj/b.o", {.command_hash = 2}).has_value());
+    }
+    CHECK(state.read("native_log") ==
+          "catalyst-native-log 3\n10\t20\t30\tff\t0\t512\tobj/a.o\n0\t0\t0\t2\t0\t0\tobj/b.o\n");
+    BuildLog reloaded{state.dir};
+    CHECK(reloaded.outputs().size() == 2);
+}
+
+CATALYST_TEST(build_log_skips_unrepresentable_paths) {
+    StateDir state;
+    {
+        BuildLog log{state.dir};
+        CHECK(log.open().has_value());
+        CHECK(log.record("obj/tab\there.o", compiled).has_value());
+        CHECK(log.recordDeps("obj/a.o", {.deps = {"new\nline.hpp"}}).has_value());
+    }
+    BuildLog reloaded{state.dir};
+    CHECK(reloaded.outputs().empty());
+    CHECK(!reloaded.deps("obj/a.o"));
+}
+} // namespace
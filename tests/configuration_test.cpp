@@ -0,0 +1,159 @@
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "catalyst/utils/yaml/build_dir.hpp"
+#include "catalyst/utils/yaml/configuration.hpp"
+#include "catalyst/utils/yaml/snapshot.hpp"
+#include "test.hpp"
+
+namespace {
+namespace fs = std::filesystem;
+using catalyst::utils::yaml::Configuration;
+using catalyst::utils::yaml::Origin;
+using catalyst::utils::yaml::Snapshot;
+using Strings = std::vector<std::string>;
+
+const std::vector<std::string> profiles{"common", "extra"};
+
+/// A project directory holding only `CATALYST.yaml`, removed again at the end of the test.
+struct Project {
+    fs::path dir = fs::temp_directory_path() /
+                   std::format("catalyst_tests_{}", std::chrono::steady_clock::now().time_since_epoch().count());
+
+    explicit Project(std::string_view manifest) {
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        write(manifest);
+    }
+    ~Project() {
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+    void write(std::string_view manifest) const {
+        std::ofstream{dir / "CATALYST.yaml", std::ios::binary | std::ios::trunc} << manifest;
+    }
+};
+
+constexpr std::string_view manifest = R"(common:
+  manifest:
+    name: app
+    tooling:
+      CXXFLAGS: -O0
+    dirs:
+      include: [include]
+      source: [src]
+      build: out
+extra:
+  manifest:
+    tooling:
+      CXXFLAGS: -O2
+    dirs:
+      include: null
+      source: [gen]
+      per_profile: true
+)";
+
+std::vector<Origin::Kind> kinds(const std::vector<Origin> &history) {
+    std::vector<Origin::Kind> result;
+    for (const auto &origin : history)
+        result.push_back(origin.kind);
+    return result;
+}
+
+CATALYST_TEST(configuration_merge) {
+    Project project{manifest};
+    Configuration config{profiles, project.dir};
+    const Snapshot &snapshot = config.snapshot();
+    CHECK(snapshot.manifest.name == "app");
+    CHECK(snapshot.manifest.tooling.cxxflags == "-O2");
+    CHECK(snapshot.manifest.tooling.cxx == "clang++"); // the default
+    CHECK(snapshot.manifest.dirs.source == Strings({"src", "gen"}));
+    CHECK(snapshot.manifest.dirs.include.empty());
+    CHECK(!config.has("manifest.dirs.include"));
+    CHECK(snapshot.manifest.dirs.per_profile);
+    const std::string build = (fs::path{"out"} / catalyst::utils::yaml::profileDirName(profiles)).string();
+    CHECK(snapshot.manifest.dirs.build == build);
+    CHECK(config.getString("manifest.dirs.build") == build);
+    CHECK(config.getStringVector("manifest.dirs.source") == std::optional<Strings>(Strings({"src", "gen"})));
+}
+
+CATALYST_TEST(configuration_provenance) {
+    Project project{manifest};
+    Configuration config{profiles, project.dir};
+    const auto &provenance = config.provenance();
+
+    const auto &flags = provenance.at("manifest.tooling.CXXFLAGS");
+    CHECK(kinds(flags) == std::vector({Origin::Kind::Default, Origin::Kind::Set, Origin::Kind::Set}));
+    CHECK(flags.size() == 3 && flags[1].profile == "common" && flags[1].value == "-O0");
+    CHECK(flags.size() == 3 && flags[2].profile == "extra" && flags[2].value == "-O2");
+
+    const auto &source = provenance.at("manifest.dirs.source");
+    CHECK(kinds(source) == std::vector({Origin::Kind::Default, Origin::Kind::Append, Origin::Kind::Append}));
+    CHECK(source.size() == 3 && source[2].profile == "extra" && source[2].value == "gen");
+
+    CHECK(kinds(provenance.at("manifest.dirs.include")).back() == Origin::Kind::Remove);
+    CHECK(kinds(provenance.at("manifest.dirs.build")).back() == Origin::Kind::Derived);
+}
+
+CATALYST_TEST(profile_dir_names) {
+    using catalyst::utils::yaml::profileDirName;
+    CHECK(profileDirName({"common", "asan"}).starts_with("common-asan-"));
+    CHECK(profileDirName({"common", "asan"}).size() == std::string_view{"common-asan-"}.size() + 8);
+    // the hash tells apart lists whose names join to the same prefix
+    CHECK(profileDirName({"a", "b"}) != profileDirName({"a-b"}));
+    CHECK(profileDirName({"a", "b"}) != profileDirName({"b", "a"}));
+}
+
+CATALYST_TEST(built_dir_checks_the_last_build) {
+    using catalyst::utils::yaml::builtDir;
+    Project project{manifest};
+    const fs::path previous = fs::current_path();
+    fs::current_path(project.dir); // the build directory is relative to the project
+    {
+        const Configuration built{profiles, project.dir};
+        const fs::path built_dir = built.snapshot().manifest.dirs.build;
+        const fs::path composition = built_dir / "profile_composition.yaml";
+        fs::create_directories(built_dir);
+        CHECK(catalyst::utils::yaml::linkCurrent(built.snapshot()).has_value());
+        YAML::Emitter emitter;
+        emitter << built.getRoot();
+        std::ofstream{composition, std::ios::binary} << emitter.c_str();
+
+        CHECK(builtDir(built.snapshot(), true) == built_dir);
+        CHECK(builtDir(built.snapshot(), false) == catalyst::utils::yaml::currentLink(built_dir));
+        // `common` alone does not set per_profile, so it never looks at `current`
+        const Configuration common{{"common"}, project.dir};
+        CHECK(builtDir(common.snapshot(), false) == fs::path{common.snapshot().manifest.dirs.build});
+
+        std::ofstream{composition, std::ios::binary | std::ios::trunc} << "manifest:\n  name: other\n";
+        auto refused = builtDir(built.snapshot(), false);
+        CHECK(!refused && refused.error().contains("manifest.name"));
+        fs::remove(composition);
+        CHECK(!builtDir(built.snapshot(), false));
+    }
+    fs::current_path(previous);
+}
+
+CATALYST_TEST(configuration_cache_invalidation) {
+    Project project{manifest};
+    CHECK(Configuration(profiles, project.dir).snapshot().manifest.tooling.cxxflags == "-O2");
+    // the second composition comes from the cache, and still explains itself
+    Configuration cached{profiles, project.dir};
+    CHECK(cached.snapshot().manifest.dirs.source == Strings({"src", "gen"}));
+    CHECK(kinds(cached.provenance().at("manifest.tooling.CXXFLAGS")).size() == 3);
+
+    std::string edited{manifest};
+    edited.replace(edited.rfind("-O2"), 3, "-O3 -g");
+    project.write(edited);
+    CHECK(Configuration(profiles, project.dir).snapshot().manifest.tooling.cxxflags == "-O3 -g");
+}
+} // namespace
@@ -0,0 +1,94 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalyst/utils/exec/critical_path.hpp"
+#include "test.hpp"
+
+namespace {
+using catalyst::utils::exec::bucketDurations;
+using catalyst::utils::exec::criticalPath;
+using catalyst::utils::exec::criticalPriorities;
+using catalyst::utils::exec::CriticalStep;
+using catalyst::utils::exec::Durations;
+using catalyst::utils::exec::durationsDigest;
+using catalyst::utils::exec::Edge;
+using catalyst::utils::exec::formatCriticalPath;
+using Priorities = std::vector<std::int64_t>;
+
+Edge edge(std::string output, std::string rule, std::vector<std::string> inputs,
+          std::vector<std::string> implicit_deps = {}) {
+    return {.outputs = {std::move(output)},
+            .rule = std::move(rule),
+            .inputs = std::move(inputs),
+            .implicit_deps = std::move(implicit_deps)};
+}
+
+// two objects feed a library that the app links with a third object; `all` is phony
+const std::vector<Edge> edges{
+    edge("obj/a.o", "cxx", {"src/a.cpp"}),
+    edge("obj/b.o", "cxx", {"src/b.cpp"}),
+    edge("libcore.a", "ar", {"obj/a.o", "obj/b.o"}),
+    edge("obj/main.o", "cxx", {"src/main.cpp"}),
+    edge("app", "link", {"obj/main.o"}, {"libcore.a"}),
+    edge("all", "phony", {"app"}),
+};
+
+bool same(const std::vector<CriticalStep> &path, const std::vector<CriticalStep> &expected) {
+    if (path.size() != expected.size())
+        return false;
+    for (std::size_t ii = 0; ii < path.size(); ++ii) {
+        if (path[ii].output != expected[ii].output || path[ii].duration_ms != expected[ii].duration_ms)
+            return false;
+    }
+    return true;
+}
+
+CATALYST_TEST(critical_priorities_longest_chain) {
+    const Durations durations{
+        {"obj/a.o", 100}, {"obj/b.o", 400}, {"libcore.a", 50}, {"obj/main.o", 300}, {"app", 200}};
+    // an edge's priority is its own duration plus the longest chain through its dependents
+    CHECK(criticalPriorities(edges, durations) == Priorities({350, 650, 250, 500, 200, 0}));
+}
+
+CATALYST_TEST(critical_priorities_unknown_durations) {
+    // obj/main.o has no duration and counts as the average of the other compiles; the link counts as 0
+    const Durations durations{{"obj/a.o", 100}, {"obj/b.o", 300}, {"libcore.a", 50}};
+    CHECK(criticalPriorities(edges, durations) == Priorities({150, 350, 50, 200, 0, 0}));
+    CHECK(criticalPriorities(edges, {}) == Priorities(edges.size(), 0));
+}
+
+CATALYST_TEST(critical_priorities_cycle) {
+    // edges on a cycle are never ready, so they keep no priority instead of looping
+    const std::vector<Edge> cycle{edge("x", "gen", {"y"}), edge("y", "gen", {"x"}), edge("z", "gen", {})};
+    CHECK(criticalPriorities(cycle, {{"x", 10}, {"y", 10}, {"z", 5}}) == Priorities({0, 0, 5}));
+}
+
+CATALYST_TEST(critical_path_steps) {
+    const Durations durations{
+        {"obj/a.o", 100}, {"obj/b.o", 400}, {"libcore.a", 50}, {"obj/main.o", 300}, {"app", 200}};
+    // the phony `all` ends the chain but is not a step
+    CHECK(same(criticalPath(edges, durations), {{"obj/b.o", 400}, {"libcore.a", 50}, {"app", 200}}));
+    CHECK(criticalPath(edges, {}).empty());
+}
+
+CATALYST_TEST(critical_durations_buckets) {
+    const Durations buckets = bucketDurations({{"a", 0}, {"b", 7}, {"c", 1000}, {"d", 1023}, {"e", 1024}, {"f", -3}});
+    CHECK(buckets == Durations({{"a", 0}, {"b", 6}, {"c", 768}, {"d", 768}, {"e", 1024}, {"f", 0}}));
+    // the digest ignores the order of the map and only changes with a bucket
+    CHECK(durationsDigest({}).empty());
+    CHECK(durationsDigest(bucketDurations({{"a", 1000}, {"b", 40}})) ==
+          durationsDigest(bucketDurations({{"b", 41}, {"a", 1010}})));
+    CHECK(durationsDigest(bucketDurations({{"a", 1000}})) != durationsDigest(bucketDurations({{"a", 1100}})));
+}
+
+CATALYST_TEST(critical_path_format) {
+    const std::string text = formatCriticalPath({{"obj/b.o", 400}, {"libcore.a", 50}, {"app", 550}});
+    CHECK(text == "Critical path: 1.0s\n"
+                  "      0.4s   40%  obj/b.o\n"
+                  "      0.1s    5%  libcore.a\n"
+                  "      0.6s   55%  app");
+}
+} // namespace
@@ -0,0 +1,42 @@
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/exec/depfile.hpp"
+#include "test.hpp"
+
+namespace {
+using catalyst::utils::exec::parseDepfile;
+using Deps = std::vector<std::string>;
+
+CATALYST_TEST(depfile_single_rule) {
+    auto deps = parseDepfile("obj/a.o: src/a.cpp include/a.hpp\n");
+    CHECK(deps && *deps == Deps({"src/a.cpp", "include/a.hpp"}));
+}
+
+CATALYST_TEST(depfile_continuations) {
+    auto deps = parseDepfile("obj/a.o: src/a.cpp \\\n  include/a.hpp \\\r\n  include/b.hpp\n");
+    CHECK(deps && *deps == Deps({"src/a.cpp", "include/a.hpp", "include/b.hpp"}));
+}
+
+CATALYST_TEST(depfile_escapes) {
+    auto deps = parseDepfile("obj/a.o: my\\ dir/a.cpp cost$$.hpp hash\\#.hpp back\\\\slash.hpp\n");
+    CHECK(deps && *deps == Deps({"my dir/a.cpp", "cost$.hpp", "hash#.hpp", "back\\slash.hpp"}));
+}
+
+CATALYST_TEST(depfile_several_rules) {
+    // -MP adds an empty rule per header; targets are dropped and prerequisites deduplicated
+    auto deps = parseDepfile("obj/a.o: src/a.cpp include/a.hpp\ninclude/a.hpp:\nobj/b.o: include/a.hpp x.hpp\n");
+    CHECK(deps && *deps == Deps({"src/a.cpp", "include/a.hpp", "x.hpp"}));
+}
+
+CATALYST_TEST(depfile_drive_letters) {
+    auto deps = parseDepfile("C:/obj/a.o: C:/src/a.cpp D:\\inc\\a.hpp\n");
+    CHECK(deps && *deps == Deps({"C:/src/a.cpp", "D:\\inc\\a.hpp"}));
+}
+
+CATALYST_TEST(depfile_empty_and_malformed) {
+    auto empty = parseDepfile(" \n");
+    CHECK(empty && empty->empty());
+    CHECK(!parseDepfile("no rule here\n"));
+}
+} // namespace
@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "catalyst/utils/hash/hash.hpp"
+#include "test.hpp"
+
+namespace {
+using catalyst::utils::hash::Sha256;
+
+std::string sha256(std::string_view data) {
+    return Sha256{}.update(data).hexDigest();
+}
+
+// test vectors from FIPS 180-2
+CATALYST_TEST(sha256_known_vectors) {
+    CHECK(sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK(sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+          "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    CHECK(sha256(std::string(1'000'000, 'a')) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+CATALYST_TEST(sha256_padding_boundaries) {
+    // 55 bytes still fit the length in the last block, 56 and 64 need another one
+    CHECK(sha256(std::string(55, 'a')) == "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318");
+    CHECK(sha256(std::string(56, 'a')) == "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a");
+    CHECK(sha256(std::string(64, 'a')) == "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+}
+
+CATALYST_TEST(sha256_incremental) {
+    const std::string data(300, 'x');
+    const std::string whole = sha256(data);
+    for (std::size_t split : {std::size_t{0}, std::size_t{1}, std::size_t{63}, std::size_t{64}, std::size_t{65},
+                              std::size_t{200}, data.size()}) {
+        Sha256 hasher;
+        hasher.update(std::string_view{data}.substr(0, split)).update(std::string_view{data}.substr(split));
+        CHECK(hasher.hexDigest() == whole);
+    }
+}
+} // namespace
@@ -0,0 +1,75 @@
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/ignore/ignore_set.hpp"
+#include "test.hpp"
+
+namespace {
+using catalyst::utils::ignore::IgnoreSet;
+
+IgnoreSet compile(const std::vector<std::string> &patterns) {
+    auto set = IgnoreSet::compile(patterns);
+    CHECK(set.has_value());
+    return set ? std::move(*set) : IgnoreSet{};
+}
+
+CATALYST_TEST(ignore_regex_matches_file_names_only) {
+    // legacy patterns only ever saw file names: they must not prune a directory of the same name
+    IgnoreSet set = compile({".*test.*", "impl", "re:legacy_.*", ".*\\.pb\\.cc"});
+    CHECK(set.matches("src/my_test.cpp", false));
+    CHECK(!set.matches("tests", true));
+    CHECK(!set.matches("src/contest", true));
+    CHECK(set.matches("src/impl", false));
+    CHECK(!set.matches("src/impl", true));
+    CHECK(set.matches("legacy_io.cpp", false));
+    CHECK(!set.matches("legacy_dir", true));
+    CHECK(set.matches("proto/msg.pb.cc", false));
+    CHECK(!set.matches("src/main.cpp", false));
+    CHECK(!set.prunesDirs());
+}
+
+CATALYST_TEST(ignore_regex_full_match) {
+    IgnoreSet set = compile({"re:foo[0-9]+\\.cpp", "^main\\.cpp$"});
+    CHECK(set.matches("foo12.cpp", false));
+    CHECK(!set.matches("foo.cpp", false));
+    CHECK(!set.matches("xfoo1.cpp", false));
+    CHECK(set.matches("main.cpp", false));
+    CHECK(!set.matches("main.cppx", false));
+}
+
+CATALYST_TEST(ignore_glob_names_and_paths) {
+    IgnoreSet set = compile({"glob:*_bench.cpp", "glob:third_party", "glob:src/legacy/*.cpp", "glob:gen/**"});
+    CHECK(set.prunesDirs());
+    CHECK(set.matches("a/b/x_bench.cpp", false));
+    CHECK(set.matches("deps/third_party", true)); // unanchored: any depth, files and directories
+    CHECK(set.matches("src/legacy/old.cpp", false));
+    CHECK(!set.matches("other/src/legacy/old.cpp", false)); // anchored to the ignore file
+    CHECK(!set.matches("src/legacy/deeper/old.cpp", false)); // `*` does not cross `/`
+    CHECK(set.matches("gen/a/b.cpp", false));
+    CHECK(!set.matches("gen", true));
+}
+
+CATALYST_TEST(ignore_glob_dirs_only_and_classes) {
+    IgnoreSet set = compile({"glob:build/", "glob:v[0-9].cpp", "glob:**/tmp/*.c"});
+    CHECK(set.matches("build", true));
+    CHECK(!set.matches("build", false));
+    CHECK(set.matches("v1.cpp", false));
+    CHECK(!set.matches("vx.cpp", false));
+    CHECK(set.matches("tmp/a.c", false));
+    CHECK(set.matches("x/y/tmp/a.c", false));
+}
+
+CATALYST_TEST(ignore_glob_negation_last_wins) {
+    IgnoreSet set = compile({"glob:*.cpp", "glob:!keep*.cpp", "glob:keep_not.cpp"});
+    CHECK(set.matches("a.cpp", false));
+    CHECK(!set.matches("keep.cpp", false));
+    CHECK(set.matches("keep_not.cpp", false));
+}
+
+CATALYST_TEST(ignore_invalid_patterns) {
+    CHECK(!IgnoreSet::compile({"re:(unclosed"}));
+    CHECK(!IgnoreSet::compile({"glob:"}));
+    CHECK(IgnoreSet{}.empty());
+    CHECK(!IgnoreSet{}.matches("a.cpp", false));
+}
+} // namespace
@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+
+#include "catalyst/utils/includes/scanner.hpp"
+#include "test.hpp"
+
+namespace {
+using catalyst::utils::includes::Directive;
+using catalyst::utils::includes::extractDirectives;
+using catalyst::utils::includes::extractModuleInfo;
+using catalyst::utils::includes::ModuleInfo;
+using Directives = std::vector<Directive>;
+
+CATALYST_TEST(includes_quoted_and_angled) {
+    auto directives =
+        extractDirectives("#include \"a.hpp\"\n  #  include <vector>\n#include_next <b.h>\n#import \"c.h\"\n");
+    CHECK(directives == Directives({{.spelling = "a.hpp", .angled = false},
+                                    {.spelling = "vector", .angled = true},
+                                    {.spelling = "b.h", .angled = true},
+                                    {.spelling = "c.h", .angled = false}}));
+}
+
+CATALYST_TEST(includes_skip_comments_and_literals) {
+    auto directives = extractDirectives("// #include \"line.hpp\"\n"
+                                        "/* #include \"block.hpp\"\n#include \"block2.hpp\" */\n"
+                                        "const char *s = \"\\n#include \\\"string.hpp\\\"\";\n"
+                                        "const char *r = R\"x(\n#include \"raw.hpp\"\n)x\";\n"
+                                        "#include \"real.hpp\" // trailing comment\n");
+    CHECK(directives == Directives({{.spelling = "real.hpp"}}));
+}
+
+CATALYST_TEST(includes_line_continuation) {
+    // a continued line comment swallows the next line, directive and all
+    auto directives = extractDirectives("#include \\\n  \"split.hpp\"\n// comment \\\n#include \"hidden.hpp\"\n");
+    CHECK(directives == Directives({{.spelling = "split.hpp"}}));
+}
+
+CATALYST_TEST(includes_computed_include_skipped) {
+    auto directives = extractDirectives("#define HEADER \"a.hpp\"\n#include HEADER\n#include \"b.hpp\"\n");
+    CHECK(directives == Directives({{.spelling = "b.hpp"}}));
+}
+
+CATALYST_TEST(includes_conditionals) {
+    auto directives = extractDirectives("#if defined(X)\n#include \"x.hpp\"\n#else\n#include <y.hpp>\n#endif\n"
+                                        "#include \"always.hpp\"\n");
+    CHECK(directives == Directives({{.spelling = "x.hpp", .conditional = true},
+                                    {.spelling = "y.hpp", .angled = true, .conditional = true},
+                                    {.spelling = "always.hpp"}}));
+}
+
+CATALYST_TEST(includes_guard_is_not_conditional) {
+    auto guarded = extractDirectives("#pragma once\n#ifndef A_HPP\n#define A_HPP\n#include <vector>\n"
+                                     "#ifdef DEBUG\n#include \"debug.hpp\"\n#endif\n#endif\n");
+    CHECK(guarded == Directives({{.spelling = "vector", .angled = true},
+                                 {.spelling = "debug.hpp", .conditional = true}}));
+    // an #ifndef that is not followed by its #define is a real conditional
+    auto unguarded = extractDirectives("#ifndef NO_VECTOR\n#include <vector>\n#endif\n");
+    CHECK(unguarded == Directives({{.spelling = "vector", .angled = true, .conditional = true}}));
+}
+
+CATALYST_TEST(includes_module_interface) {
+    const std::string source = "module;\n#include <cstdio>\nexport module m:part;\nimport :other;\nimport n;\n"
+                               "export import o.p;\nimport <vector>;\n";
+    ModuleInfo info = extractModuleInfo(source);
+    CHECK(info.name == "m:part");
+    CHECK(info.exported);
+    CHECK(info.providesBmi());
+    CHECK(info.imports == std::vector<std::string>({"m:other", "n", "o.p"}));
+    CHECK(extractDirectives(source) == Directives({{.spelling = "cstdio", .angled = true},
+                                                   {.spelling = "vector", .angled = true}}));
+}
+
+CATALYST_TEST(includes_module_implementation) {
+    ModuleInfo info = extractModuleInfo("module m;\nimport n;\nint f() { return 0; }\n");
+    CHECK(info.name == "m");
+    CHECK(!info.exported);
+    CHECK(!info.providesBmi());
+    CHECK(info.imports == std::vector<std::string>({"m", "n"})); // an implementation unit imports its interface
+    CHECK(extractModuleInfo("int module = 0;\nint import = module;\n").empty());
+}
+} // namespace
@@ -0,0 +1,121 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "catalyst/utils/yaml/snapshot.hpp"
+#include "test.hpp"
+
+namespace {
+using catalyst::utils::yaml::Snapshot;
+using Kind = Snapshot::HookStep::Kind;
+using Strings = std::vector<std::string>;
+
+constexpr const char *composed = R"(meta:
+  min_ver: 0.0.1
+  generator: ninja
+manifest:
+  name: app
+  type: BINARY
+  version: 1.2.3
+  tooling:
+    CXX: g++
+    CXXFLAGS: -O2 -g
+  dirs:
+    include: [include]
+    source: [src, gen]
+    build: out/common
+    per_profile: true
+  build:
+    configs: [debug, release]
+  jobs: 8
+dependencies:
+  - name: fmt
+    source: git
+    git: https://github.com/fmtlib/fmt.git
+    version: "11.0"
+    include: [include]
+  - source: local
+features:
+  - fast: true
+    tracing: false
+hooks:
+  pre-build: echo one
+  post-build:
+    - command: echo two
+    - script: ./scripts/three.sh
+    - echo four
+)";
+
+CATALYST_TEST(snapshot_serialize_roundtrip) {
+    auto decoded = Snapshot::deserialize(Snapshot::compile(YAML::Load(composed)).serialize());
+    CHECK(decoded.has_value());
+    if (!decoded)
+        return;
+    CHECK(decoded->meta.min_ver == "0.0.1" && decoded->meta.generator == "ninja");
+    const auto &manifest = decoded->manifest;
+    CHECK(manifest.name == "app" && manifest.type == "BINARY" && manifest.version == "1.2.3");
+    CHECK(manifest.tooling.cxx == "g++" && manifest.tooling.cxxflags == "-O2 -g" && manifest.tooling.cc.empty());
+    CHECK(manifest.dirs.include == Strings({"include"}));
+    CHECK(manifest.dirs.source == Strings({"src", "gen"}));
+    CHECK(manifest.dirs.build == "out/common");
+    CHECK(manifest.dirs.per_profile);
+    CHECK(manifest.build.configs == Strings({"debug", "release"}));
+
+    CHECK(decoded->dependencies.size() == 2);
+    if (decoded->dependencies.size() == 2) {
+        const auto &fmt = decoded->dependencies[0];
+        CHECK(fmt.name == "fmt" && fmt.source == "git");
+        CHECK(fmt.node["version"].as<std::string>() == "11.0");
+        CHECK(fmt.node["include"].as<Strings>() == Strings({"include"}));
+        CHECK(decoded->dependencies[1].name.empty() && decoded->dependencies[1].source == "local");
+    }
+
+    CHECK(decoded->features.size() == 2);
+    if (decoded->features.size() == 2) {
+        CHECK(decoded->features[0].name == "fast" && decoded->features[0].enabled);
+        CHECK(decoded->features[1].name == "tracing" && !decoded->features[1].enabled);
+    }
+
+    CHECK(decoded->hooks.size() == 2);
+    const auto &pre = decoded->hooks["pre-build"];
+    CHECK(pre.size() == 1 && pre[0].kind == Kind::Command && pre[0].text == "echo one");
+    const auto &post = decoded->hooks["post-build"];
+    CHECK(post.size() == 3);
+    if (post.size() == 3) {
+        CHECK(post[0].kind == Kind::Command && post[0].text == "echo two");
+        CHECK(post[1].kind == Kind::Script && post[1].text == "./scripts/three.sh");
+        CHECK(post[2].kind == Kind::Command && post[2].text == "echo four");
+    }
+}
+
+CATALYST_TEST(snapshot_flat_values_roundtrip) {
+    auto decoded = Snapshot::deserialize(Snapshot::compile(YAML::Load(composed)).serialize());
+    CHECK(decoded.has_value());
+    if (!decoded)
+        return;
+    const auto *flags = decoded->find("manifest.tooling.CXXFLAGS");
+    CHECK(flags && flags->string == std::optional<std::string>("-O2 -g"));
+    const auto *jobs = decoded->find("manifest.jobs");
+    CHECK(jobs && jobs->integer == std::optional<int>(8));
+    const auto *per_profile = decoded->find("manifest.dirs.per_profile");
+    CHECK(per_profile && per_profile->boolean == std::optional<bool>(true));
+    const auto *source = decoded->find("manifest.dirs.source");
+    CHECK(source && source->strings == std::optional<Strings>(Strings({"src", "gen"})));
+    const auto *tooling = decoded->find("manifest.tooling");
+    CHECK(tooling && !tooling->string && !tooling->strings);
+    CHECK(!decoded->find("manifest.tooling.CC"));
+}
+
+CATALYST_TEST(snapshot_deserialize_rejects_bad_input) {
+    const std::string bytes = Snapshot::compile(YAML::Load(composed)).serialize();
+    CHECK(!Snapshot::deserialize(""));
+    CHECK(!Snapshot::deserialize(bytes.substr(0, 8)));
+    CHECK(!Snapshot::deserialize(bytes.substr(0, bytes.size() - 1)));
+    CHECK(!Snapshot::deserialize(bytes + '\0'));
+    std::string other_version = bytes;
+    ++other_version[0];
+    CHECK(!Snapshot::deserialize(other_version));
+}
+} // namespace
@@ -1,5 +1,49 @@
-#include <iostream>
+// Runs every registered test, or those whose name contains one of the arguments:
+// catalyst test --params depfile sha256
+#include <algorithm>
+#include <cstddef>
+#include <print>
+#include <source_location>
+#include <string_view>
+#include <vector>
 
-int main() {
-    std::cout << "HELLO WORLD!" << std::endl;
+#include "test.hpp"
+
+namespace catalyst::tests {
+namespace {
+std::size_t failures = 0; ///< of the running test
+} // namespace
+
+std::vector<Case> &registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void check(bool passed, std::string_view expression, std::source_location where) {
+    if (passed)
+        return;
+    ++failures;
+    std::println("  {}:{}: CHECK({}) failed", where.file_name(), where.line(), expression);
+}
+} // namespace catalyst::tests
+
+int main(int argc, char **argv) {
+    using catalyst::tests::failures;
+    const std::vector<std::string_view> filters(argv + 1, argv + argc);
+    std::size_t ran = 0;
+    std::size_t failed = 0;
+    for (const auto &[name, run] : catalyst::tests::registry()) {
+        if (!filters.empty() &&
+            std::ranges::none_of(filters, [&](std::string_view filter) { return name.contains(filter); }))
+            continue;
+        failures = 0;
+        run();
+        ++ran;
+        if (failures != 0) {
+            ++failed;
+            std::println("FAILED {}", name);
+        }
+    }
+    std::println("{} of {} tests passed.", ran - failed, ran);
+    return failed == 0 ? 0 : 1;
 }
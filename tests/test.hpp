@@ -0,0 +1,30 @@
+#pragma once
+#include <source_location>
+#include <string_view>
+#include <vector>
+
+// A minimal test registry: each CATALYST_TEST registers itself before main, and main runs them in order.
+namespace catalyst::tests {
+struct Case {
+    std::string_view name;
+    void (*run)();
+};
+
+std::vector<Case> &registry();
+
+struct Register {
+    Register(std::string_view name, void (*run)()) {
+        registry().push_back({name, run});
+    }
+};
+
+/// Record a failed check against the running test; the test goes on, so one run reports every failure.
+void check(bool passed, std::string_view expression, std::source_location where = std::source_location::current());
+} // namespace catalyst::tests
+
+#define CATALYST_TEST(name)                                                                                          \
+    static void name();                                                                                              \
+    static const ::catalyst::tests::Register name##_registered{#name, name};                                         \
+    static void name()
+
+#define CHECK(expression) ::catalyst::tests::check(static_cast<bool>(expression), #expression)